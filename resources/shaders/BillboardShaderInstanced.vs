@@ -0,0 +1,39 @@
+#version 330 core
+
+// Input
+layout(location = 0) in vec3 Position;
+layout(location = 4) in vec2 Tex0;
+layout(location = 12) in vec3 InstancePosition;
+layout(location = 13) in vec2 InstanceScale;
+layout(location = 14) in vec4 InstanceTint;
+
+// Output
+out vec2 TexCoord;
+out vec4 TintColor;
+
+// Uniforms
+layout(std140) uniform MVPBlock
+{
+	mat4 ModelMtx;
+	mat4 ViewMtx;
+	mat4 ProjMtx;
+};
+
+// Main
+void main()
+{
+	mat4 TranslateMtx = mat4(1, 0, 0, InstancePosition.x,
+							 0, 1, 0, InstancePosition.y,
+							 0, 0, 1, InstancePosition.z,
+							 0, 0, 0, 1);
+	mat4 MV = TranslateMtx * ViewMtx;
+	mat4 VP = mat4 (	   1,		 0,		   0, MV[0][3],
+						   0,		 1,		   0, MV[1][3],
+						   0,		 0,		   1, MV[2][3],
+					MV[3][0], MV[3][1], MV[3][2], MV[3][3]) * ProjMtx;
+	
+	gl_Position = vec4(Position,1) * vec4(InstanceScale.xy, 1, 1) * VP;
+
+	TexCoord = vec2(Tex0.x, -Tex0.y);
+	TintColor = InstanceTint;
+}
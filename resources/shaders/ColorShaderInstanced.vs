@@ -0,0 +1,26 @@
+#version 330 core
+
+// Input
+layout(location = 0) in vec3 Position;
+layout(location = 12) in vec3 InstanceCenter;
+layout(location = 13) in vec3 InstanceSize;
+layout(location = 14) in vec4 InstanceColor;
+
+// Output
+out vec4 Color;
+
+// Uniforms
+layout(std140) uniform MVPBlock
+{
+	mat4 ModelMtx;
+	mat4 ViewMtx;
+	mat4 ProjMtx;
+};
+
+// Main
+void main()
+{
+	mat4 VP = ViewMtx * ProjMtx;
+	gl_Position = vec4(Position * InstanceSize + InstanceCenter, 1) * VP;
+	Color = InstanceColor;
+}
@@ -0,0 +1,33 @@
+#ifndef CHEADLESSUIRELAY_H
+#define CHEADLESSUIRELAY_H
+
+#include <Core/IUIRelay.h>
+#include <Common/Log.h>
+
+/** UI relay for command line tools. Messages go to the log and questions are always answered "no". */
+class CHeadlessUIRelay : public IUIRelay
+{
+public:
+    void ShowMessageBox(const TString& rkInfoBoxTitle, const TString& rkMessage) override
+    {
+        warnf("%s: %s", *rkInfoBoxTitle, *rkMessage);
+    }
+
+    void ShowMessageBoxAsync(const TString& rkInfoBoxTitle, const TString& rkMessage) override
+    {
+        ShowMessageBox(rkInfoBoxTitle, rkMessage);
+    }
+
+    bool AskYesNoQuestion(const TString& rkInfoBoxTitle, const TString& rkQuestion) override
+    {
+        warnf("%s: %s (answering no)", *rkInfoBoxTitle, *rkQuestion);
+        return false;
+    }
+
+    bool OpenProject(const TString& /*kPath*/) override
+    {
+        return false;
+    }
+};
+
+#endif // CHEADLESSUIRELAY_H
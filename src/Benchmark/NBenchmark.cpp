@@ -0,0 +1,274 @@
+#include "NBenchmark.h"
+#include <Core/NParallel.h>
+#include <Core/NPerfStats.h>
+#include <Core/GameProject/CGameProject.h>
+#include <Core/GameProject/CResourceEntry.h>
+#include <Core/GameProject/CResourceIterator.h>
+#include <Core/Resource/CResource.h>
+#include <Core/Resource/Cooker/CResourceCooker.h>
+#include <Core/Resource/Model/CModel.h>
+#include <Core/Resource/Script/NGameList.h>
+#include <Common/FileIO.h>
+#include <Common/Log.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <set>
+
+namespace NBenchmark
+{
+
+using NPerfStats::Clock;
+using NPerfStats::JsonString;
+
+/** Time a call and record it under the given phase name */
+template<typename FuncType>
+static void TimePhase(const TString& rkPhase, uint64 NumBytes, uint64 NumItems, FuncType&& Func)
+{
+    const Clock::time_point Start = Clock::now();
+    Func();
+    NPerfStats::RecordPhase(rkPhase, Start, Clock::now(), NumBytes, NumItems);
+}
+
+using FMemoryByType = std::map<EResourceType, SResourceMemoryUsage>;
+
+/** Raise the recorded peaks to the store's current resident memory, per resource type */
+static void SampleResidentMemory(CResourceStore *pStore, FMemoryByType& rPeakMemory)
+{
+    for (const auto& [Type, rkUsage] : pStore->ResidentMemoryByType())
+    {
+        SResourceMemoryUsage& rPeak = rPeakMemory[Type];
+        rPeak.CPUBytes = std::max(rPeak.CPUBytes, rkUsage.CPUBytes);
+        rPeak.GPUBytes = std::max(rPeak.GPUBytes, rkUsage.GPUBytes);
+    }
+}
+
+/** Load, analyze and cook every resource in the project, one at a time */
+static void BenchmarkResources(CResourceStore *pStore, const SBenchmarkOptions& rkOptions, FMemoryByType& rPeakMemory)
+{
+    std::map<EResourceType, uint32> NumProcessed;
+
+    for (CResourceIterator It(pStore); It; ++It)
+    {
+        CResourceEntry *pEntry = *It;
+        uint32& rNumProcessed = NumProcessed[pEntry->ResourceType()];
+
+        // Resources that are already resident can't be timed, and aren't ours to unload afterwards
+        if (rNumProcessed >= rkOptions.MaxResourcesPerType || !pEntry->HasCookedVersion() || pEntry->IsLoaded())
+            continue;
+
+        rNumProcessed++;
+        const TString TypeName = pEntry->TypeInfo()->TypeName();
+
+        // Load
+        CResource *pRes = nullptr;
+        TimePhase("Load." + TypeName, pEntry->Size(), 1, [&] { pRes = pEntry->Load(); });
+
+        if (!pRes)
+        {
+            warnf("Failed to load %s", *pEntry->CookedAssetPath(true));
+            continue;
+        }
+
+        SampleResidentMemory(pStore, rPeakMemory);
+
+        // Dependencies
+        if (pEntry->TypeInfo()->CanHaveDependencies())
+        {
+            uint64 NumDependencies = 0;
+
+            TimePhase("DependencyTree." + TypeName, 0, 1, [&]
+            {
+                auto pTree = pRes->BuildDependencyTree();
+                NumDependencies = pTree->NumChildren();
+            });
+
+            NPerfStats::Record("DependencyTree.Nodes." + TypeName, 0.0, 0, NumDependencies);
+        }
+
+        // Model buffering (CPU side only; there's no GL context to upload to)
+        if (pEntry->ResourceType() == EResourceType::Model)
+        {
+            CModel *pModel = static_cast<CModel*>(pRes);
+            TimePhase("Model.BufferPrep", 0, pModel->GetVertexCount(), [&] { pModel->BuildBufferData(); });
+            SampleResidentMemory(pStore, rPeakMemory);
+            pModel->ClearGLBuffer();
+        }
+
+        // Cooking
+        if (CResourceCooker::CanCookResourceType(pEntry->ResourceType()))
+        {
+            std::vector<char> CookedData;
+            CVectorOutStream CookStream(&CookedData, EEndian::BigEndian);
+            const Clock::time_point Start = Clock::now();
+            const bool Success = CResourceCooker::CookResource(pEntry, CookStream);
+
+            if (Success)
+                NPerfStats::RecordPhase("Cook." + TypeName, Start, Clock::now(), CookedData.size(), 1);
+            else
+                warnf("Failed to cook %s", *pEntry->CookedAssetPath(true));
+        }
+
+        // Unload the resource along with the dependencies it brought in, so the next one loads its own from scratch
+        pStore->UnloadResource(pEntry);
+    }
+}
+
+/** Unload resources that were loaded since the snapshot was taken and that nothing references */
+static void UnloadResourcesSince(CResourceStore *pStore, const std::set<CResourceEntry*>& rkLoadedBefore)
+{
+    for (CResourceIterator It(pStore); It; ++It)
+    {
+        if (It->IsLoaded() && rkLoadedBefore.find(*It) == rkLoadedBefore.end())
+            pStore->UnloadResource(*It);
+    }
+}
+
+/** Write collected stats to the console and to a JSON report */
+static bool WriteReport(const SBenchmarkOptions& rkOptions, const CGameProject *pkProject, double TotalSeconds,
+                        const FMemoryByType& rkPeakMemory)
+{
+    const std::map<TString, NPerfStats::SPhaseStats> Stats = NPerfStats::Snapshot();
+
+    printf("%-40s %8s %12s %12s %12s %12s\n", "Phase", "Count", "Total (ms)", "Mean (ms)", "MB/s", "Items/s");
+
+    TString Json = "{\n";
+    Json += "  \"project\": " + JsonString(pkProject->Name()) + ",\n";
+    Json += "  \"game\": " + JsonString(GetGameShortName(pkProject->Game())) + ",\n";
+    Json += TString::Format("  \"threads\": %u,\n", NParallel::NumWorkerThreads());
+    Json += TString::Format("  \"max_resources_per_type\": %u,\n", rkOptions.MaxResourcesPerType);
+    Json += TString::Format("  \"total_seconds\": %.6f,\n", TotalSeconds);
+    Json += "  \"phases\": [";
+
+    bool First = true;
+
+    for (const auto& [Name, rkPhase] : Stats)
+    {
+        const double MeanSeconds = (rkPhase.NumCalls > 0 ? rkPhase.TotalSeconds / rkPhase.NumCalls : 0.0);
+        const double MBPerSecond = (rkPhase.TotalSeconds > 0.0 ? (rkPhase.NumBytes / (1024.0 * 1024.0)) / rkPhase.TotalSeconds : 0.0);
+        const double ItemsPerSecond = (rkPhase.TotalSeconds > 0.0 ? rkPhase.NumItems / rkPhase.TotalSeconds : 0.0);
+
+        printf("%-40s %8llu %12.3f %12.3f %12.2f %12.1f\n", *Name,
+               static_cast<unsigned long long>(rkPhase.NumCalls),
+               rkPhase.TotalSeconds * 1000.0, MeanSeconds * 1000.0, MBPerSecond, ItemsPerSecond);
+
+        Json += (First ? "\n" : ",\n");
+        Json += "    { \"name\": " + JsonString(Name);
+        Json += TString::Format(", \"count\": %llu", static_cast<unsigned long long>(rkPhase.NumCalls));
+        Json += TString::Format(", \"total_ms\": %.4f", rkPhase.TotalSeconds * 1000.0);
+        Json += TString::Format(", \"mean_ms\": %.4f", MeanSeconds * 1000.0);
+        Json += TString::Format(", \"min_ms\": %.4f", rkPhase.MinSeconds * 1000.0);
+        Json += TString::Format(", \"max_ms\": %.4f", rkPhase.MaxSeconds * 1000.0);
+        Json += TString::Format(", \"bytes\": %llu", static_cast<unsigned long long>(rkPhase.NumBytes));
+        Json += TString::Format(", \"items\": %llu", static_cast<unsigned long long>(rkPhase.NumItems));
+        Json += TString::Format(", \"mb_per_sec\": %.4f", MBPerSecond);
+        Json += TString::Format(", \"items_per_sec\": %.4f }", ItemsPerSecond);
+        First = false;
+    }
+
+    Json += "\n  ],\n";
+
+    // Resources are unloaded between benchmarks, so the peak is what a single resource and its dependencies keep resident
+    printf("\n%-40s %16s %16s\n", "Peak resident memory", "CPU (bytes)", "GPU (bytes)");
+    Json += "  \"peak_resident_memory\": [";
+    First = true;
+
+    for (const auto& [Type, rkUsage] : rkPeakMemory)
+    {
+        const TString TypeName = CResTypeInfo::FindTypeInfo(Type)->TypeName();
+
+        printf("%-40s %16llu %16llu\n", *TypeName,
+               static_cast<unsigned long long>(rkUsage.CPUBytes),
+               static_cast<unsigned long long>(rkUsage.GPUBytes));
+
+        Json += (First ? "\n" : ",\n");
+        Json += "    { \"type\": " + JsonString(TypeName);
+        Json += TString::Format(", \"cpu_bytes\": %llu", static_cast<unsigned long long>(rkUsage.CPUBytes));
+        Json += TString::Format(", \"gpu_bytes\": %llu }", static_cast<unsigned long long>(rkUsage.GPUBytes));
+        First = false;
+    }
+
+    Json += "\n  ]\n}\n";
+
+    CFileOutStream ReportFile(rkOptions.ReportPath, EEndian::BigEndian);
+
+    if (!ReportFile.IsValid())
+    {
+        errorf("Failed to open benchmark report for writing: %s", *rkOptions.ReportPath);
+        return false;
+    }
+
+    ReportFile.WriteBytes(*Json, Json.Size());
+    printf("Report written to %s\n", *rkOptions.ReportPath);
+    return true;
+}
+
+bool Run(const SBenchmarkOptions& rkOptions)
+{
+    NPerfStats::Reset();
+    NPerfStats::SetEnabled(true);
+
+    if (!rkOptions.TracePath.IsEmpty())
+        NPerfStats::StartTrace();
+
+    const Clock::time_point StartTime = Clock::now();
+
+    // Templates are normally lazy-loaded; load them all up front so they're measured on their own
+    TimePhase("Templates.LoadAll", 0, 0, [] { NGameList::LoadAllGameTemplates(); });
+
+    std::unique_ptr<CGameProject> pProject;
+    TimePhase("Project.Open", 0, 0, [&] { pProject = CGameProject::LoadProject(rkOptions.ProjectPath, gpNullProgress); });
+
+    if (!pProject)
+    {
+        errorf("Failed to open project: %s", *rkOptions.ProjectPath);
+        NPerfStats::SetEnabled(false);
+        NPerfStats::StopTrace();
+        return false;
+    }
+
+    CResourceStore *pOldStore = gpResourceStore;
+    CResourceStore *pStore = pProject->ResourceStore();
+    gpResourceStore = pStore;
+
+    FMemoryByType PeakMemory;
+    BenchmarkResources(pStore, rkOptions, PeakMemory);
+
+    if (rkOptions.CookPackages)
+    {
+        for (size_t PackageIdx = 0; PackageIdx < pProject->NumPackages(); PackageIdx++)
+        {
+            CPackage *pPackage = pProject->PackageByIndex(PackageIdx);
+            std::set<CResourceEntry*> LoadedBefore;
+
+            for (CResourceIterator It(pStore); It; ++It)
+            {
+                if (It->IsLoaded())
+                    LoadedBefore.insert(*It);
+            }
+
+            TimePhase("Package.Cook", 0, 1, [&] { pPackage->Cook(gpNullProgress); });
+            SampleResidentMemory(pStore, PeakMemory);
+            UnloadResourcesSince(pStore, LoadedBefore);
+        }
+    }
+
+    const std::chrono::duration<double> TotalTime = Clock::now() - StartTime;
+    NPerfStats::SetEnabled(false);
+    NPerfStats::StopTrace();
+    bool Success = WriteReport(rkOptions, pProject.get(), TotalTime.count(), PeakMemory);
+
+    if (!rkOptions.TracePath.IsEmpty())
+    {
+        Success = NPerfStats::WriteChromeTrace(rkOptions.TracePath) && Success;
+
+        if (Success)
+            printf("Trace written to %s\n", *rkOptions.TracePath);
+    }
+
+    gpResourceStore = pOldStore;
+    return Success;
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef NBENCHMARK_H
+#define NBENCHMARK_H
+
+#include <Common/BasicTypes.h>
+#include <Common/TString.h>
+
+/** Settings for a benchmark run */
+struct SBenchmarkOptions
+{
+    /** Path to the .prj file of the project to benchmark */
+    TString ProjectPath;
+
+    /** Path the JSON report is written to */
+    TString ReportPath = "benchmark.json";
+
+    /** If set, a Chrome trace of the whole run is written to this path */
+    TString TracePath;
+
+    /** Maximum number of resources of each type to process; lets quick runs sample a project */
+    uint32 MaxResourcesPerType = UINT32_MAX;
+
+    /** Also cook every package. This rewrites the project's .pak files! */
+    bool CookPackages = false;
+};
+
+/** Headless performance benchmarks for the load, cook and export paths */
+namespace NBenchmark
+{
+
+/** Run all benchmarks on the given project and write the report. Returns false if the project couldn't be opened. */
+bool Run(const SBenchmarkOptions& rkOptions);
+
+}
+
+#endif // NBENCHMARK_H
@@ -0,0 +1,105 @@
+#include "CHeadlessUIRelay.h"
+#include "NBenchmark.h"
+#include <Core/GameProject/CResourceStore.h>
+#include <Core/Resource/Script/NGameList.h>
+#include <Common/FileUtil.h>
+#include <Common/Log.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/** Returns the value of a "-name=value" commandline parameter, or nullptr if it isn't present */
+static const char* ParseParameter(const char* pkParmName, int argc, char* argv[])
+{
+    const size_t kParmLen = strlen(pkParmName);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], pkParmName, kParmLen) == 0 && argv[i][kParmLen] == '=')
+            return &argv[i][kParmLen + 1];
+    }
+
+    return nullptr;
+}
+
+/** Checks for the existence of a token in the commandline */
+static bool ParseToken(const char* pkToken, int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], pkToken) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+static TString LocateDataDirectory(const char* pkExePath)
+{
+    // The build copies resources/templates next to the bin directory, same as the editor
+    const TString Candidates[] = {
+        FileUtil::MakeAbsolute(TString(pkExePath).GetFileDirectory() + "../"),
+        FileUtil::MakeAbsolute("./"),
+        FileUtil::MakeAbsolute("../"),
+    };
+
+    for (const TString& rkDir : Candidates)
+    {
+        if (FileUtil::IsDirectory(rkDir + "resources") && FileUtil::IsDirectory(rkDir + "templates"))
+            return rkDir;
+    }
+
+    return Candidates[0];
+}
+
+int main(int argc, char *argv[])
+{
+    const char* pkProjectPath = ParseParameter("-project", argc, argv);
+
+    if (!pkProjectPath)
+    {
+        printf("Usage: PrimeWorldEditorBenchmark -project=<Project.prj> [-output=<Report.json>] [-datadir=<Dir>]\n"
+               "                                  [-maxpertype=<Count>] [-cookpackages] [-trace=<Trace.json>]\n"
+               "  -cookpackages rewrites the project's .pak files.\n"
+               "  -trace writes a Chrome trace (chrome://tracing, Perfetto) of the run.\n");
+        return 1;
+    }
+
+    CHeadlessUIRelay UIRelay;
+    gpUIRelay = &UIRelay;
+
+    NLog::InitLog("primeworldeditor-benchmark.log");
+
+    const char* pkDataDir = ParseParameter("-datadir", argc, argv);
+    gDataDir = (pkDataDir ? FileUtil::MakeAbsolute(TString(pkDataDir) + "/") : LocateDataDirectory(argv[0]));
+    gResourcesWritable = false;
+    gTemplatesWritable = false;
+
+    gpEditorStore = new CResourceStore(gDataDir + "resources/");
+
+    if (!gpEditorStore->DatabasePathExists())
+    {
+        printf("Unable to locate PWE resources directory in %s; pass -datadir\n", *gDataDir);
+        return 1;
+    }
+
+    SBenchmarkOptions Options;
+    Options.ProjectPath = FileUtil::MakeAbsolute(pkProjectPath);
+    Options.CookPackages = ParseToken("-cookpackages", argc, argv);
+
+    if (const char* pkOutput = ParseParameter("-output", argc, argv))
+        Options.ReportPath = pkOutput;
+
+    if (const char* pkTrace = ParseParameter("-trace", argc, argv))
+        Options.TracePath = pkTrace;
+
+    if (const char* pkMax = ParseParameter("-maxpertype", argc, argv))
+        Options.MaxResourcesPerType = static_cast<uint32>(strtoul(pkMax, nullptr, 10));
+
+    const bool Success = NBenchmark::Run(Options);
+
+    NGameList::Shutdown();
+    delete gpEditorStore;
+    gpEditorStore = nullptr;
+    return Success ? 0 : 1;
+}
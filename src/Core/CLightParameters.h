@@ -2,6 +2,7 @@
 #define CLIGHTPARAMETERS_H
 
 #include "Core/Resource/Area/CGameArea.h"
+#include "Core/Resource/Script/CScriptTemplate.h"
 #include "Core/Resource/Script/Property/Properties.h"
 
 enum class EWorldLightingOptions
@@ -18,21 +19,11 @@ class CLightParameters
     TEnumRef<EWorldLightingOptions> mWorldLightingOptions;
 
 public:
-    CLightParameters(CStructRef InStruct, EGame Game)
+    /** The child properties are looked up once when the template is loaded */
+    CLightParameters(void* pPropertyData, const CScriptTemplate* pkTemplate)
+        : mLightLayer(pPropertyData, pkTemplate->LightLayerProperty())
+        , mWorldLightingOptions(pPropertyData, pkTemplate->WorldLightingOptionsProperty())
     {
-        if (InStruct.IsValid())
-        {
-            if (Game <= EGame::Prime)
-            {
-                mWorldLightingOptions = TEnumRef<EWorldLightingOptions>(InStruct.DataPointer(), InStruct.Property()->ChildByIndex(0x7));
-                mLightLayer = CIntRef(InStruct.DataPointer(), InStruct.Property()->ChildByIndex(0xD));
-            }
-            else
-            {
-                mWorldLightingOptions = TEnumRef<EWorldLightingOptions>(InStruct.DataPointer(), InStruct.Property()->ChildByID(0x6B5E7509));
-                mLightLayer = CIntRef(InStruct.DataPointer(), InStruct.Property()->ChildByID(0x1F715FD3));
-            }
-        }
     }
 
     int LightLayerIndex() const
@@ -1,5 +1,7 @@
 #include "CRayCollisionTester.h"
+#include "Core/Render/CRenderer.h"
 #include "Core/Scene/CSceneNode.h"
+#include <Common/Math/MathUtil.h>
 
 CRayCollisionTester::CRayCollisionTester(const CRay& rkRay)
     : mRay(rkRay)
@@ -62,3 +64,69 @@ SRayIntersection CRayCollisionTester::TestNodes(const SViewInfo& rkViewInfo)
 
     return Result;
 }
+
+void CRayCollisionTester::CreateSnapshot(const SViewInfo& rkViewInfo)
+{
+    mBoxIntersectList.sort([](const auto& rkLeft, const auto& rkRight) {
+        return rkLeft.Distance < rkRight.Distance;
+    });
+
+    const FRenderOptions Options = rkViewInfo.pRenderer->RenderOptions();
+    mAllowBackfaces = ((Options & ERenderOption::EnableBackfaceCull) == 0);
+
+    mSnapshot.clear();
+    mSnapshot.reserve(mBoxIntersectList.size());
+
+    for (const auto& rkIntersection : mBoxIntersectList)
+    {
+        SSnapshotEntry& rEntry = mSnapshot.emplace_back();
+        rEntry.BoxHit = rkIntersection;
+
+        CSceneNode *pNode = rkIntersection.pNode;
+
+        if (!pNode->GetRaySurfaceTest(rkIntersection.ComponentIndex, rEntry.SurfaceTest))
+            rEntry.Result = pNode->RayNodeIntersectTest(mRay, rkIntersection.ComponentIndex, rkViewInfo);
+    }
+}
+
+SRayIntersection CRayCollisionTester::TestSnapshot() const
+{
+    SRayIntersection Result;
+    Result.Hit = false;
+
+    for (const SSnapshotEntry& rkEntry : mSnapshot)
+    {
+        // Same early out as TestNodes; entries are sorted by bounding box distance
+        if (Result.Hit && Result.Distance < rkEntry.BoxHit.Distance)
+            break;
+
+        SRayIntersection MidResult = rkEntry.Result;
+
+        if (rkEntry.SurfaceTest.pkSurface)
+        {
+            const CTransform4f& rkTransform = rkEntry.SurfaceTest.Transform;
+            const CRay TransformedRay = mRay.Transformed(rkTransform.Inverse());
+            const auto [intersects, distance] = rkEntry.SurfaceTest.pkSurface->IntersectsRay(TransformedRay, mAllowBackfaces);
+
+            MidResult = rkEntry.BoxHit;
+            MidResult.Hit = intersects;
+
+            if (intersects)
+            {
+                const CVector3f WorldHitPoint = rkTransform * TransformedRay.PointOnRay(distance);
+                MidResult.Distance = Math::Distance(mRay.Origin(), WorldHitPoint);
+            }
+        }
+
+        if (MidResult.Hit)
+        {
+            if (!Result.Hit || MidResult.Distance <= Result.Distance)
+                Result = MidResult;
+        }
+    }
+
+    if (Result.Hit)
+        Result.HitPoint = mRay.PointOnRay(Result.Distance);
+
+    return Result;
+}
@@ -4,19 +4,39 @@
 #include "SRayIntersection.h"
 #include "Core/Render/SViewInfo.h"
 #include "Core/Resource/Model/CBasicModel.h"
+#include "Core/Resource/TResPtr.h"
 #include <Common/BasicTypes.h>
 #include <Common/Math/CAABox.h>
 #include <Common/Math/CRay.h>
+#include <Common/Math/CTransform4f.h>
 #include <Common/Math/CVector3f.h>
 
 #include <list>
+#include <vector>
 
 class CSceneNode;
 
+/** Everything needed to test one queued component against the ray without touching its scene node */
+struct SRaySurfaceTest
+{
+    const SSurface *pkSurface = nullptr;
+    CTransform4f Transform;
+    TResPtr<CResource> pOwner; // Keeps the model that owns the surface loaded while the test is pending
+};
+
 class CRayCollisionTester
 {
+    struct SSnapshotEntry
+    {
+        SRayIntersection BoxHit;
+        SRaySurfaceTest SurfaceTest;
+        SRayIntersection Result; // Main thread result, for components that can't provide a surface test
+    };
+
     CRay mRay;
     std::list<SRayIntersection> mBoxIntersectList;
+    std::vector<SSnapshotEntry> mSnapshot;
+    bool mAllowBackfaces = false;
 
 public:
     CRayCollisionTester(const CRay& rkRay);
@@ -26,6 +46,15 @@ public:
     void AddNode(CSceneNode *pNode, uint32 AssetIndex, float Distance);
     void AddNodeModel(CSceneNode *pNode, CBasicModel *pModel);
     SRayIntersection TestNodes(const SViewInfo& rkViewInfo);
+
+    /**
+     * Copy everything the geometry tests need out of the queued nodes so TestSnapshot() can run on another thread.
+     * Components whose node can't provide a surface test are tested immediately on the calling thread.
+     */
+    void CreateSnapshot(const SViewInfo& rkViewInfo);
+
+    /** Equivalent to TestNodes(), but only reads the snapshot and model geometry, so it's safe to call off the main thread */
+    SRayIntersection TestSnapshot() const;
 };
 
 #endif // CRAYCOLLISIONHELPER_H
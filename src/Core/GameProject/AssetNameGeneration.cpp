@@ -9,6 +9,9 @@
 #include "Core/Resource/Scan/SScanParametersMP1.h"
 #include "Core/Resource/Script/CScriptLayer.h"
 #include <Common/Math/MathUtil.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
 
 #define REVERT_AUTO_NAMES 1
 #define PROCESS_PACKAGES 1
@@ -22,7 +25,143 @@
 #define PROCESS_SCANS 1
 #define PROCESS_FONTS 1
 
-void ApplyGeneratedName(CResourceEntry *pEntry, const TString& rkDir, const TString& rkName)
+namespace
+{
+
+/** Planned location of every asset in the store, used to generate names without moving any files until the end */
+class CAssetNamePlan
+{
+    struct SLocation
+    {
+        CVirtualDirectory *pDir = nullptr;
+        TString Name;
+    };
+
+    CResourceStore *mpStore;
+    std::unordered_map<CResourceEntry*, SLocation> mPlannedLocations;
+
+    // Planned asset names in each directory, keyed by uppercase name
+    std::unordered_map<CVirtualDirectory*, std::unordered_multimap<std::string, CResourceEntry*>> mNameIndex;
+
+public:
+    explicit CAssetNamePlan(CResourceStore *pStore)
+        : mpStore(pStore)
+    {
+        for (CResourceIterator It(pStore); It; ++It)
+            mNameIndex[It->Directory()].emplace(*It->Name().ToUpper(), *It);
+    }
+
+    CVirtualDirectory* Directory(CResourceEntry *pEntry) const
+    {
+        const auto Find = mPlannedLocations.find(pEntry);
+        return (Find == mPlannedLocations.cend() ? pEntry->Directory() : Find->second.pDir);
+    }
+
+    TString Name(CResourceEntry *pEntry) const
+    {
+        const auto Find = mPlannedLocations.find(pEntry);
+        return (Find == mPlannedLocations.cend() ? pEntry->Name() : Find->second.Name);
+    }
+
+    TString DirectoryPath(CResourceEntry *pEntry) const  { return Directory(pEntry)->FullPath(); }
+    bool IsNamed(CResourceEntry *pEntry) const           { return Name(pEntry) != pEntry->ID().ToString(); }
+    bool IsCategorized(CResourceEntry *pEntry) const     { return !DirectoryPath(pEntry).CaseInsensitiveCompare(mpStore->DefaultResourceDirPath()); }
+
+    CResourceEntry* FindResource(CVirtualDirectory *pDir, const TString& rkName, EResourceType Type) const
+    {
+        const auto DirFind = mNameIndex.find(pDir);
+        if (DirFind == mNameIndex.cend())
+            return nullptr;
+
+        const auto [Begin, End] = DirFind->second.equal_range(*rkName.ToUpper());
+
+        for (auto It = Begin; It != End; ++It)
+        {
+            if (It->second->ResourceType() == Type)
+                return It->second;
+        }
+
+        return nullptr;
+    }
+
+    /** Plan to move an asset; fails if another asset is already planned to be at that location */
+    bool Move(CResourceEntry *pEntry, CVirtualDirectory *pDir, const TString& rkName)
+    {
+        if (FindResource(pDir, rkName, pEntry->ResourceType()) != nullptr)
+            return false;
+
+        CVirtualDirectory *pOldDir = Directory(pEntry);
+        auto& rOldIndex = mNameIndex[pOldDir];
+        auto [Begin, End] = rOldIndex.equal_range(*Name(pEntry).ToUpper());
+        const auto OldIt = std::find_if(Begin, End, [pEntry](const auto& rkPair) { return rkPair.second == pEntry; });
+        ASSERT(OldIt != End);
+        rOldIndex.erase(OldIt);
+
+        mNameIndex[pDir].emplace(*rkName.ToUpper(), pEntry);
+        mPlannedLocations.insert_or_assign(pEntry, SLocation{pDir, rkName});
+        return true;
+    }
+
+    /** Move every asset to its planned location */
+    void Commit()
+    {
+        std::vector<CResourceEntry*> Pending;
+
+        for (const auto& [pEntry, rkLocation] : mPlannedLocations)
+        {
+            if (pEntry->Directory() != rkLocation.pDir || pEntry->Name() != rkLocation.Name)
+                Pending.push_back(pEntry);
+        }
+
+        std::sort(Pending.begin(), Pending.end(), [](const CResourceEntry *pkLeft, const CResourceEntry *pkRight) {
+            return pkLeft->ID() < pkRight->ID();
+        });
+
+        // An asset can't move until any asset currently at its destination has moved out of the way,
+        // so keep going over the remaining assets until everything has been moved.
+        while (!Pending.empty())
+        {
+            std::vector<CResourceEntry*> Blocked;
+
+            for (CResourceEntry *pEntry : Pending)
+            {
+                const SLocation& rkLocation = mPlannedLocations[pEntry];
+                const TString NewDir = rkLocation.pDir->FullPath();
+
+                if (!pEntry->CanMoveTo(NewDir, rkLocation.Name))
+                {
+                    Blocked.push_back(pEntry);
+                    continue;
+                }
+
+                // Flags are left as-is; generated names never replace hand-picked ones
+                const bool Success = pEntry->MoveAndRename(NewDir, rkLocation.Name,
+                                                           pEntry->HasFlag(EResEntryFlag::AutoResDir),
+                                                           pEntry->HasFlag(EResEntryFlag::AutoResName));
+                if (!Success)
+                    errorf("Failed to move asset %s to %s%s", *pEntry->ID().ToString(), *NewDir, *rkLocation.Name);
+            }
+
+            if (!Blocked.empty() && Blocked.size() == Pending.size())
+            {
+                // The remaining assets are all waiting on each other; move one of them to a temporary name to break the cycle
+                CResourceEntry *pEntry = Blocked.front();
+                const bool Success = pEntry->MoveAndRename(pEntry->DirectoryPath(), pEntry->ID().ToString() + "_tmp",
+                                                           pEntry->HasFlag(EResEntryFlag::AutoResDir),
+                                                           pEntry->HasFlag(EResEntryFlag::AutoResName));
+                if (!Success)
+                {
+                    errorf("Unable to move asset %s to %s%s", *pEntry->ID().ToString(), *mPlannedLocations[pEntry].pDir->FullPath(), *mPlannedLocations[pEntry].Name);
+                    Blocked.erase(Blocked.begin());
+                }
+            }
+
+            Pending = std::move(Blocked);
+        }
+    }
+};
+
+void ApplyGeneratedName(CAssetNamePlan& rPlan, CResourceEntry *pEntry, const TString& rkDir, const TString& rkName)
 {
     ASSERT(pEntry != nullptr);
 
@@ -36,7 +175,7 @@ void ApplyGeneratedName(CResourceEntry *pEntry, const TString& rkDir, const TStr
 
     if (HasCustomDir)
     {
-        pNewDir = pEntry->Directory();
+        pNewDir = rPlan.Directory(pEntry);
     }
     else
     {
@@ -55,7 +194,7 @@ void ApplyGeneratedName(CResourceEntry *pEntry, const TString& rkDir, const TStr
 
     if (HasCustomName)
     {
-        NewName = pEntry->Name();
+        NewName = rPlan.Name(pEntry);
     }
     else
     {
@@ -66,7 +205,7 @@ void ApplyGeneratedName(CResourceEntry *pEntry, const TString& rkDir, const TStr
         NewName = SanitizedName;
         int AppendNum = 0;
 
-        while (CResourceEntry *pConflict = pNewDir->FindChildResource(NewName, pEntry->ResourceType()))
+        while (CResourceEntry *pConflict = rPlan.FindResource(pNewDir, NewName, pEntry->ResourceType()))
         {
             if (pConflict == pEntry)
                 return;
@@ -77,31 +216,39 @@ void ApplyGeneratedName(CResourceEntry *pEntry, const TString& rkDir, const TStr
     }
 
     // Check if we're actually moving anything
-    if (pEntry->Directory() == pNewDir && pEntry->Name() == NewName) return;
+    if (rPlan.Directory(pEntry) == pNewDir && rPlan.Name(pEntry) == NewName) return;
 
-    // Perform the move
-    bool Success = pEntry->MoveAndRename(pNewDir->FullPath(), NewName, true, true);
+    // Plan the move
+    bool Success = rPlan.Move(pEntry, pNewDir, NewName);
     ASSERT(Success);
 }
 
+} // anonymous namespace
+
 void GenerateAssetNames(CGameProject *pProj)
 {
     debugf("*** Generating Asset Names ***");
     CResourceStore *pStore = pProj->ResourceStore();
 
+    // Names are planned for every asset first without touching any files, then applied in one pass at the end.
+    // That way each asset is moved at most once, rather than being reverted and then renamed again.
+    CAssetNamePlan Plan(pStore);
+
 #if REVERT_AUTO_NAMES
     // Revert all auto-generated asset names back to default to prevent name conflicts resulting in inconsistent results.
     debugf("Reverting auto-generated names");
 
+    CVirtualDirectory *pDefaultDir = pStore->GetVirtualDirectory(pStore->DefaultResourceDirPath(), true);
+
     for (CResourceIterator It(pStore); It; ++It)
     {
         bool HasCustomDir = !It->HasFlag(EResEntryFlag::AutoResDir);
         bool HasCustomName = !It->HasFlag(EResEntryFlag::AutoResName);
         if (HasCustomDir && HasCustomName) continue;
 
-        TString NewDir = (HasCustomDir ? It->DirectoryPath() : pStore->DefaultResourceDirPath());
+        CVirtualDirectory *pNewDir = (HasCustomDir ? It->Directory() : pDefaultDir);
         TString NewName = (HasCustomName ? It->Name() : It->ID().ToString());
-        It->MoveAndRename(NewDir, NewName, true, true);
+        Plan.Move(*It, pNewDir, NewName);
     }
 #endif
 
@@ -122,7 +269,7 @@ void GenerateAssetNames(CGameProject *pProj)
             CResourceEntry *pRes = pStore->FindEntry(rkRes.ID);
 
             if (pRes)
-                ApplyGeneratedName(pRes, pPkg->Name(), rkRes.Name);
+                ApplyGeneratedName(Plan, pRes, pPkg->Name(), rkRes.Name);
         }
     }
 #endif
@@ -141,7 +288,7 @@ void GenerateAssetNames(CGameProject *pProj)
 
         TString WorldMasterName = "!" + WorldName + "_Master";
         TString WorldMasterDir = WorldDir + WorldMasterName + '/';
-        ApplyGeneratedName(*It, WorldMasterDir, WorldMasterName);
+        ApplyGeneratedName(Plan, *It, WorldMasterDir, WorldMasterName);
 
         // Move world stuff
         const TString WorldNamesDir = "Strings/Worlds/General/";
@@ -154,16 +301,16 @@ void GenerateAssetNames(CGameProject *pProj)
         CResource *pMapWorld = pWorld->MapWorld();
 
         if (pSaveWorld)
-            ApplyGeneratedName(pSaveWorld->Entry(), WorldMasterDir, WorldMasterName);
+            ApplyGeneratedName(Plan, pSaveWorld->Entry(), WorldMasterDir, WorldMasterName);
 
         if (pMapWorld)
-            ApplyGeneratedName(pMapWorld->Entry(), WorldMasterDir, WorldMasterName);
+            ApplyGeneratedName(Plan, pMapWorld->Entry(), WorldMasterDir, WorldMasterName);
 
-        if (pSkyModel && !pSkyModel->Entry()->IsCategorized())
+        if (pSkyModel && !Plan.IsCategorized(pSkyModel->Entry()))
         {
             // Move sky model
             CResourceEntry *pSkyEntry = pSkyModel->Entry();
-            ApplyGeneratedName(pSkyEntry, WorldDir + "sky/cooked/", WorldName + "_sky");
+            ApplyGeneratedName(Plan, pSkyEntry, WorldDir + "sky/cooked/", WorldName + "_sky");
 
             // Move sky textures
             for (size_t iSet = 0; iSet < pSkyModel->GetMatSetCount(); iSet++)
@@ -179,7 +326,7 @@ void GenerateAssetNames(CGameProject *pProj)
                         CMaterialPass *pPass = pMat->Pass(pass);
 
                         if (pPass->Texture())
-                            ApplyGeneratedName(pPass->Texture()->Entry(), WorldDir + "sky/sourceimages/", pPass->Texture()->Entry()->Name());
+                            ApplyGeneratedName(Plan, pPass->Texture()->Entry(), WorldDir + "sky/sourceimages/", Plan.Name(pPass->Texture()->Entry()));
                     }
                 }
             }
@@ -188,13 +335,13 @@ void GenerateAssetNames(CGameProject *pProj)
         if (pWorldNameTable)
         {
             CResourceEntry *pNameEntry = pWorldNameTable->Entry();
-            ApplyGeneratedName(pNameEntry, WorldNamesDir, WorldName);
+            ApplyGeneratedName(Plan, pNameEntry, WorldNamesDir, WorldName);
         }
 
         if (pDarkWorldNameTable)
         {
             CResourceEntry *pDarkNameEntry = pDarkWorldNameTable->Entry();
-            ApplyGeneratedName(pDarkNameEntry, WorldNamesDir, WorldName + "Dark");
+            ApplyGeneratedName(Plan, pDarkNameEntry, WorldNamesDir, WorldName + "Dark");
         }
 
         // Areas
@@ -212,11 +359,11 @@ void GenerateAssetNames(CGameProject *pProj)
             // Some DKCR worlds reference areas that don't exist
             if (!pAreaEntry)
                 continue;
-            ApplyGeneratedName(pAreaEntry, WorldMasterDir, AreaName);
+            ApplyGeneratedName(Plan, pAreaEntry, WorldMasterDir, AreaName);
 
             CStringTable *pAreaNameTable = pWorld->AreaName(iArea);
             if (pAreaNameTable)
-                ApplyGeneratedName(pAreaNameTable->Entry(), AreaNamesDir, AreaName);
+                ApplyGeneratedName(Plan, pAreaNameTable->Entry(), AreaNamesDir, AreaName);
 
             if (pMapWorld)
             {
@@ -227,7 +374,7 @@ void GenerateAssetNames(CGameProject *pProj)
                 CResourceEntry *pMapEntry = pStore->FindEntry(MapID);
                 ASSERT(pMapEntry != nullptr);
 
-                ApplyGeneratedName(pMapEntry, WorldMasterDir, AreaName);
+                ApplyGeneratedName(Plan, pMapEntry, WorldMasterDir, AreaName);
             }
 
 #if PROCESS_AREAS
@@ -267,9 +414,9 @@ void GenerateAssetNames(CGameProject *pProj)
                     {
                         CTexture *pLightmapTex = pPass->Texture();
                         CResourceEntry *pTexEntry = pLightmapTex->Entry();
-                        if (pTexEntry->IsCategorized()) continue;
+                        if (Plan.IsCategorized(pTexEntry)) continue;
 
-                        ApplyGeneratedName(pTexEntry, AreaCookedDir, TexName);
+                        ApplyGeneratedName(Plan, pTexEntry, AreaCookedDir, TexName);
                         pTexEntry->SetHidden(true);
                         FoundLightmap = true;
                     }
@@ -304,14 +451,14 @@ void GenerateAssetNames(CGameProject *pProj)
                                 CAssetID ScanID = pScanProperty->Value(pInst->PropertyData());
                                 CResourceEntry *pEntry = pStore->FindEntry(ScanID);
 
-                                if (pEntry && !pEntry->IsNamed())
+                                if (pEntry && !Plan.IsNamed(pEntry))
                                 {
                                     TString ScanName = Name.ChopFront(4);
 
                                     if (ScanName.EndsWith(".SCAN", false))
                                         ScanName = ScanName.ChopBack(5);
 
-                                    ApplyGeneratedName(pEntry, pEntry->DirectoryPath(), ScanName);
+                                    ApplyGeneratedName(Plan, pEntry, Plan.DirectoryPath(pEntry), ScanName);
 
                                     CScan *pScan = (CScan*) pEntry->Load();
                                     if (pScan)
@@ -321,7 +468,7 @@ void GenerateAssetNames(CGameProject *pProj)
 
                                         if (pStringEntry)
                                         {
-                                            ApplyGeneratedName(pStringEntry, pStringEntry->DirectoryPath(), ScanName);
+                                            ApplyGeneratedName(Plan, pStringEntry, Plan.DirectoryPath(pStringEntry), ScanName);
                                         }
                                     }
                                 }
@@ -344,14 +491,14 @@ void GenerateAssetNames(CGameProject *pProj)
                                 CAssetID StringID = pStringProperty->Value(pInst->PropertyData());
                                 CResourceEntry *pEntry = pStore->FindEntry(StringID);
 
-                                if (pEntry && !pEntry->IsNamed())
+                                if (pEntry && !Plan.IsNamed(pEntry))
                                 {
                                     TString StringName = Name.ChopBack(5);
 
                                     if (StringName.StartsWith("HUDMemo - "))
                                         StringName = StringName.ChopFront(10);
 
-                                    ApplyGeneratedName(pEntry, pEntry->DirectoryPath(), StringName);
+                                    ApplyGeneratedName(Plan, pEntry, Plan.DirectoryPath(pEntry), StringName);
                                 }
                             }
                         }
@@ -370,12 +517,12 @@ void GenerateAssetNames(CGameProject *pProj)
                             CAssetID ModelID = pModelProperty->Value(pInst->PropertyData());
                             CResourceEntry *pEntry = pStore->FindEntry(ModelID);
 
-                            if (pEntry && !pEntry->IsCategorized())
+                            if (pEntry && !Plan.IsCategorized(pEntry))
                             {
                                 CModel *pModel = (CModel*) pEntry->Load();
 
                                 if (pModel->IsLightmapped())
-                                    ApplyGeneratedName(pEntry, AreaCookedDir, pEntry->Name());
+                                    ApplyGeneratedName(Plan, pEntry, AreaCookedDir, Plan.Name(pEntry));
                             }
                         }
                     }
@@ -388,13 +535,13 @@ void GenerateAssetNames(CGameProject *pProj)
             CResourceEntry *pPortalEntry = pStore->FindEntry(pArea->PortalAreaID());
 
             if (pPathEntry)
-                ApplyGeneratedName(pPathEntry, WorldMasterDir, AreaName);
+                ApplyGeneratedName(Plan, pPathEntry, WorldMasterDir, AreaName);
 
             if (pPoiMapEntry)
-                ApplyGeneratedName(pPoiMapEntry, WorldMasterDir, AreaName);
+                ApplyGeneratedName(Plan, pPoiMapEntry, WorldMasterDir, AreaName);
 
             if (pPortalEntry)
-                ApplyGeneratedName(pPortalEntry, WorldMasterDir, AreaName);
+                ApplyGeneratedName(Plan, pPortalEntry, WorldMasterDir, AreaName);
 
             pStore->DestroyUnreferencedResources();
 #endif
@@ -430,11 +577,11 @@ void GenerateAssetNames(CGameProject *pProj)
                     {
                         CTexture *pLightmapTex = pPass->Texture();
                         CResourceEntry *pTexEntry = pLightmapTex->Entry();
-                        if (pTexEntry->IsNamed() || pTexEntry->IsCategorized())
+                        if (Plan.IsNamed(pTexEntry) || Plan.IsCategorized(pTexEntry))
                             continue;
 
-                        TString TexName = TString::Format("%s_lightmap%zu", *It->Name(), LightmapNum);
-                        ApplyGeneratedName(pTexEntry, pModel->Entry()->DirectoryPath(), TexName);
+                        TString TexName = TString::Format("%s_lightmap%zu", *Plan.Name(*It), LightmapNum);
+                        ApplyGeneratedName(Plan, pTexEntry, Plan.DirectoryPath(pModel->Entry()), TexName);
                         pTexEntry->SetHidden(true);
                         LightmapNum++;
                     }
@@ -455,7 +602,7 @@ void GenerateAssetNames(CGameProject *pProj)
     {
         CAudioGroup *pGroup = (CAudioGroup*) It->Load();
         TString GroupName = pGroup->GroupName();
-        ApplyGeneratedName(*It, kAudioGrpDir, GroupName);
+        ApplyGeneratedName(Plan, *It, kAudioGrpDir, GroupName);
     }
 #endif
 
@@ -468,14 +615,14 @@ void GenerateAssetNames(CGameProject *pProj)
     {
         const auto* pMacro = static_cast<CAudioMacro*>(It->Load());
         TString MacroName = pMacro->MacroName();
-        ApplyGeneratedName(*It, kSfxDir, MacroName);
+        ApplyGeneratedName(Plan, *It, kSfxDir, MacroName);
 
         for (size_t iSamp = 0; iSamp < pMacro->NumSamples(); iSamp++)
         {
             const CAssetID SampleID = pMacro->SampleByIndex(iSamp);
             CResourceEntry* pSample = pStore->FindEntry(SampleID);
 
-            if (pSample != nullptr && !pSample->IsNamed())
+            if (pSample != nullptr && !Plan.IsNamed(pSample))
             {
                 TString SampleName;
 
@@ -484,7 +631,7 @@ void GenerateAssetNames(CGameProject *pProj)
                 else
                     SampleName = TString::Format("%s_%zu", *MacroName, iSamp);
 
-                ApplyGeneratedName(pSample, kSfxDir, SampleName);
+                ApplyGeneratedName(Plan, pSample, kSfxDir, SampleName);
             }
         }
     }
@@ -501,7 +648,7 @@ void GenerateAssetNames(CGameProject *pProj)
 
     for (; It; ++It)
     {
-        TString SetDir = It->DirectoryPath();
+        TString SetDir = Plan.DirectoryPath(*It);
         TString NewSetName;
         auto* pSet = static_cast<CAnimSet*>(It->Load());
 
@@ -512,9 +659,9 @@ void GenerateAssetNames(CGameProject *pProj)
             TString CharName = pkChar->Name;
             if (iChar == 0) NewSetName = CharName;
 
-            if (pkChar->pModel)     ApplyGeneratedName(pkChar->pModel->Entry(), SetDir, CharName);
-            if (pkChar->pSkeleton)  ApplyGeneratedName(pkChar->pSkeleton->Entry(), SetDir, CharName);
-            if (pkChar->pSkin)      ApplyGeneratedName(pkChar->pSkin->Entry(), SetDir, CharName);
+            if (pkChar->pModel)     ApplyGeneratedName(Plan, pkChar->pModel->Entry(), SetDir, CharName);
+            if (pkChar->pSkeleton)  ApplyGeneratedName(Plan, pkChar->pSkeleton->Entry(), SetDir, CharName);
+            if (pkChar->pSkin)      ApplyGeneratedName(Plan, pkChar->pSkin->Entry(), SetDir, CharName);
 
             if (pProj->Game() >= EGame::CorruptionProto && pProj->Game() <= EGame::Corruption && pkChar->ID == 0)
             {
@@ -523,7 +670,7 @@ void GenerateAssetNames(CGameProject *pProj)
                 if (pAnimDataEntry)
                 {
                     TString AnimDataName = TString::Format("%s_animdata", *CharName);
-                    ApplyGeneratedName(pAnimDataEntry, SetDir, AnimDataName);
+                    ApplyGeneratedName(Plan, pAnimDataEntry, SetDir, AnimDataName);
                 }
             }
 
@@ -545,19 +692,19 @@ void GenerateAssetNames(CGameProject *pProj)
                     if (rkOverlay.ModelID.IsValid())
                     {
                         CResourceEntry *pModelEntry = pStore->FindEntry(rkOverlay.ModelID);
-                        ApplyGeneratedName(pModelEntry, SetDir, OverlayName);
+                        ApplyGeneratedName(Plan, pModelEntry, SetDir, OverlayName);
                     }
                     if (rkOverlay.SkinID.IsValid())
                     {
                         CResourceEntry *pSkinEntry = pStore->FindEntry(rkOverlay.SkinID);
-                        ApplyGeneratedName(pSkinEntry, SetDir, OverlayName);
+                        ApplyGeneratedName(Plan, pSkinEntry, SetDir, OverlayName);
                     }
                 }
             }
         }
 
         if (!NewSetName.IsEmpty())
-            ApplyGeneratedName(*It, SetDir, NewSetName);
+            ApplyGeneratedName(Plan, *It, SetDir, NewSetName);
 
         std::set<CAnimPrimitive> AnimPrimitives;
         pSet->GetUniquePrimitives(AnimPrimitives);
@@ -568,11 +715,11 @@ void GenerateAssetNames(CGameProject *pProj)
 
             if (pAnim != nullptr)
             {
-                ApplyGeneratedName(pAnim->Entry(), SetDir, rkPrim.Name());
+                ApplyGeneratedName(Plan, pAnim->Entry(), SetDir, rkPrim.Name());
                 CAnimEventData *pEvents = pAnim->EventData();
 
                 if (pEvents != nullptr)
-                    ApplyGeneratedName(pEvents->Entry(), SetDir, rkPrim.Name());
+                    ApplyGeneratedName(Plan, pEvents->Entry(), SetDir, rkPrim.Name());
             }
         }
     }
@@ -586,7 +733,7 @@ void GenerateAssetNames(CGameProject *pProj)
 
     for (TResourceIterator<EResourceType::StringTable> It(pStore); It; ++It)
     {
-        if (It->IsNamed())
+        if (Plan.IsNamed(*It))
             continue;
 
         auto *pString = static_cast<CStringTable*>(It->Load());
@@ -603,7 +750,7 @@ void GenerateAssetNames(CGameProject *pProj)
             while (Name.EndsWith(".") || TString::IsWhitespace(Name.Back()))
                 Name = Name.ChopBack(1);
 
-            ApplyGeneratedName(pString->Entry(), kStringsDir, Name);
+            ApplyGeneratedName(Plan, pString->Entry(), kStringsDir, Name);
         }
     }
 #endif
@@ -613,7 +760,7 @@ void GenerateAssetNames(CGameProject *pProj)
     debugf("Processing scans");
     for (TResourceIterator<EResourceType::Scan> It(pStore); It; ++It)
     {
-        if (It->IsNamed())
+        if (Plan.IsNamed(*It))
             continue;
 
         auto* pScan = static_cast<CScan*>(It->Load());
@@ -623,23 +770,23 @@ void GenerateAssetNames(CGameProject *pProj)
         {
             const CAssetID StringID = pScan->ScanStringPropertyRef().Get();
             if (const auto* pString = static_cast<CStringTable*>(gpResourceStore->LoadResource(StringID, EResourceType::StringTable)))
-                ScanName = pString->Entry()->Name();
+                ScanName = Plan.Name(pString->Entry());
         }
 
-        ApplyGeneratedName(pScan->Entry(), It->DirectoryPath(), ScanName);
+        ApplyGeneratedName(Plan, pScan->Entry(), Plan.DirectoryPath(*It), ScanName);
 
         if (!ScanName.IsEmpty() && pProj->Game() <= EGame::Prime)
         {
             const auto& kParms = *static_cast<SScanParametersMP1*>(pScan->ScanData().DataPointer());
 
             if (CResourceEntry* pEntry = pStore->FindEntry(kParms.GuiFrame))
-                ApplyGeneratedName(pEntry, pEntry->DirectoryPath(), "ScanFrame");
+                ApplyGeneratedName(Plan, pEntry, Plan.DirectoryPath(pEntry), "ScanFrame");
 
             for (size_t iImg = 0; iImg < kParms.ScanImages.size(); iImg++)
             {
                 const CAssetID ImageID = kParms.ScanImages[iImg].Texture;
                 if (CResourceEntry* pImgEntry = pStore->FindEntry(ImageID))
-                    ApplyGeneratedName(pImgEntry, pImgEntry->DirectoryPath(), TString::Format("%s_Image%zu", *ScanName, iImg));
+                    ApplyGeneratedName(Plan, pImgEntry, Plan.DirectoryPath(pImgEntry), TString::Format("%s_Image%zu", *ScanName, iImg));
             }
         }
     }
@@ -652,15 +799,18 @@ void GenerateAssetNames(CGameProject *pProj)
     {
         if (auto* pFont = static_cast<CFont*>(It->Load()))
         {
-            ApplyGeneratedName(pFont->Entry(), pFont->Entry()->DirectoryPath(), pFont->FontName());
+            ApplyGeneratedName(Plan, pFont->Entry(), Plan.DirectoryPath(pFont->Entry()), pFont->FontName());
 
 
             if (CTexture* pFontTex = pFont->Texture())
-                ApplyGeneratedName(pFontTex->Entry(), pFont->Entry()->DirectoryPath(), pFont->Entry()->Name() + "_tex");
+                ApplyGeneratedName(Plan, pFontTex->Entry(), Plan.DirectoryPath(pFont->Entry()), Plan.Name(pFont->Entry()) + "_tex");
         }
     }
 #endif
 
+    debugf("Moving assets");
+    Plan.Commit();
+
     pStore->RootDirectory()->DeleteEmptySubdirectories();
     pStore->ConditionalSaveStore();
     debugf("*** Asset Name Generation FINISHED ***");
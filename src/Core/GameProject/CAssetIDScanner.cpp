@@ -0,0 +1,192 @@
+#include "CAssetIDScanner.h"
+#include "CResourceIterator.h"
+#include <Common/Math/MathUtil.h>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define PWE_SCANNER_USE_SSSE3 1
+#endif
+
+namespace
+{
+
+/** Number of windows that are byte-swapped and Bloom-tested together */
+constexpr size_t kBatchSize = 16;
+
+/** Number of bytes a full batch may read, including the over-read of the 16-byte vector loads */
+constexpr size_t kBatchReadSpan32 = 12 + 16;
+constexpr size_t kBatchReadSpan64 = 14 + 16;
+
+uint64 NextPowerOfTwo(uint64 Value)
+{
+    uint64 Out = 1;
+    while (Out < Value)
+        Out <<= 1;
+    return Out;
+}
+
+uint64 ReadBE32(const uint8 *pkData)
+{
+    return (static_cast<uint64>(pkData[0]) << 24) |
+           (static_cast<uint64>(pkData[1]) << 16) |
+           (static_cast<uint64>(pkData[2]) << 8) |
+           (static_cast<uint64>(pkData[3]) << 0);
+}
+
+uint64 ReadBE64(const uint8 *pkData)
+{
+    return (ReadBE32(pkData) << 32) | ReadBE32(pkData + 4);
+}
+
+/** Byte-swap the kBatchSize 32-bit windows starting at pkData into pOut */
+void GatherWindows32(const uint8 *pkData, uint64 *pOut)
+{
+#if PWE_SCANNER_USE_SSSE3
+    // Each shuffle turns one 16-byte load into four overlapping byte-swapped windows
+    const __m128i kShuffle = _mm_setr_epi8(3, 2, 1, 0, 4, 3, 2, 1, 5, 4, 3, 2, 6, 5, 4, 3);
+    alignas(16) uint32 Windows[kBatchSize];
+
+    for (size_t Quad = 0; Quad < kBatchSize / 4; Quad++)
+    {
+        __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pkData + Quad * 4));
+        _mm_store_si128(reinterpret_cast<__m128i*>(&Windows[Quad * 4]), _mm_shuffle_epi8(Bytes, kShuffle));
+    }
+
+    for (size_t Idx = 0; Idx < kBatchSize; Idx++)
+        pOut[Idx] = Windows[Idx];
+#else
+    for (size_t Idx = 0; Idx < kBatchSize; Idx++)
+        pOut[Idx] = ReadBE32(pkData + Idx);
+#endif
+}
+
+/** Byte-swap the kBatchSize 64-bit windows starting at pkData into pOut */
+void GatherWindows64(const uint8 *pkData, uint64 *pOut)
+{
+#if PWE_SCANNER_USE_SSSE3
+    // Each shuffle turns one 16-byte load into two overlapping byte-swapped windows
+    const __m128i kShuffle = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 8, 7, 6, 5, 4, 3, 2, 1);
+
+    for (size_t Pair = 0; Pair < kBatchSize / 2; Pair++)
+    {
+        __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pkData + Pair * 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[Pair * 2]), _mm_shuffle_epi8(Bytes, kShuffle));
+    }
+#else
+    for (size_t Idx = 0; Idx < kBatchSize; Idx++)
+        pOut[Idx] = ReadBE64(pkData + Idx);
+#endif
+}
+
+}
+
+void CAssetIDSet::Build(const CResourceStore& rkStore)
+{
+    Clear();
+
+    std::vector<uint64> IDs;
+
+    for (CResourceIterator It(&rkStore); It; ++It)
+        IDs.push_back(It->ID().ToLongLong());
+
+    mNumIDs = static_cast<uint32>(IDs.size());
+
+    if (mNumIDs == 0)
+        return;
+
+    // Keep the table at most half full so probe sequences stay short.
+    // ~16 filter bits per ID with three probes rejects all but ~0.3% of non-IDs.
+    const uint64 NumSlots = NextPowerOfTwo(Math::Max<uint64>(mNumIDs * 2ULL, 16));
+    const uint64 NumBloomBits = NextPowerOfTwo(Math::Max<uint64>(mNumIDs * 16ULL, 64));
+
+    mSlots.assign(NumSlots, skEmptySlot);
+    mSlotMask = NumSlots - 1;
+    mBloomBits.assign(NumBloomBits / 64, 0);
+    mBloomMask = NumBloomBits - 1;
+
+    for (const uint64 ID : IDs)
+    {
+        const uint64 Hashed = Hash(ID);
+        const uint64 A = Hashed & mBloomMask;
+        const uint64 B = (Hashed >> 32) & mBloomMask;
+        const uint64 C = ((Hashed >> 16) ^ (Hashed >> 48)) & mBloomMask;
+        mBloomBits[A >> 6] |= 1ULL << (A & 63);
+        mBloomBits[B >> 6] |= 1ULL << (B & 63);
+        mBloomBits[C >> 6] |= 1ULL << (C & 63);
+
+        uint64 Slot = Hashed & mSlotMask;
+
+        while (mSlots[Slot] != skEmptySlot && mSlots[Slot] != ID)
+            Slot = (Slot + 1) & mSlotMask;
+
+        mSlots[Slot] = ID;
+    }
+}
+
+void CAssetIDSet::Clear()
+{
+    mBloomBits.clear();
+    mSlots.clear();
+    mBloomMask = 0;
+    mSlotMask = 0;
+    mNumIDs = 0;
+}
+
+void CAssetIDScanner::Scan(const uint8 *pkData, size_t Size, EIDLength IDLength, const CAssetIDSet& rkIDSet,
+                           std::vector<SAssetIDHit>& rOut)
+{
+    const bool Is32Bit = (IDLength == EIDLength::k32Bit);
+    const size_t IDSize = (Is32Bit ? 4 : 8);
+
+    if (rkIDSet.IsEmpty() || Size < IDSize)
+        return;
+
+    const size_t NumWindows = Size - IDSize + 1;
+    const size_t BatchReadSpan = (Is32Bit ? kBatchReadSpan32 : kBatchReadSpan64);
+    size_t Offset = 0;
+
+    auto AddHit = [&](size_t HitOffset, uint64 Value)
+    {
+        if (Is32Bit)
+            rOut.push_back(SAssetIDHit{ static_cast<uint32>(HitOffset), CAssetID(static_cast<uint32>(Value)) });
+        else
+            rOut.push_back(SAssetIDHit{ static_cast<uint32>(HitOffset), CAssetID(Value) });
+    };
+
+    // Full batches
+    uint64 Windows[kBatchSize];
+    uint64 Hashes[kBatchSize];
+
+    while (Offset + BatchReadSpan <= Size)
+    {
+        if (Is32Bit)
+            GatherWindows32(pkData + Offset, Windows);
+        else
+            GatherWindows64(pkData + Offset, Windows);
+
+        uint32 CandidateMask = 0;
+
+        for (size_t Idx = 0; Idx < kBatchSize; Idx++)
+        {
+            Hashes[Idx] = CAssetIDSet::Hash(Windows[Idx]);
+            CandidateMask |= static_cast<uint32>(rkIDSet.MayContain(Hashes[Idx])) << Idx;
+        }
+
+        for (size_t Idx = 0; CandidateMask != 0; Idx++, CandidateMask >>= 1)
+        {
+            if ((CandidateMask & 1) && rkIDSet.ContainsHashed(Windows[Idx], Hashes[Idx]))
+                AddHit(Offset + Idx, Windows[Idx]);
+        }
+
+        Offset += kBatchSize;
+    }
+
+    // Remaining windows near the end of the buffer
+    for (; Offset < NumWindows; Offset++)
+    {
+        const uint64 Value = (Is32Bit ? ReadBE32(pkData + Offset) : ReadBE64(pkData + Offset));
+
+        if (rkIDSet.Contains(Value))
+            AddHit(Offset, Value);
+    }
+}
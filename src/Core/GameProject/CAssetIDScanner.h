@@ -0,0 +1,113 @@
+#ifndef CASSETIDSCANNER_H
+#define CASSETIDSCANNER_H
+
+#include <Common/BasicTypes.h>
+#include <Common/CAssetID.h>
+#include <vector>
+
+class CResourceStore;
+
+/**
+ * Compact lookup set of the asset IDs registered in a resource store.
+ * IDs are kept in an open-addressing hash table fronted by a Bloom filter, so
+ * the overwhelming majority of values that aren't asset IDs are rejected with
+ * a couple of bit tests instead of a tree lookup.
+ */
+class CAssetIDSet
+{
+    std::vector<uint64> mBloomBits;
+    std::vector<uint64> mSlots;
+    uint64 mBloomMask = 0;
+    uint64 mSlotMask = 0;
+    uint32 mNumIDs = 0;
+
+    /** Value used to mark empty hash slots. This is the invalid 64-bit ID, so it can never be registered. */
+    static constexpr uint64 skEmptySlot = UINT64_MAX;
+
+public:
+    /** Rebuild the set from all entries in the store that aren't marked for deletion */
+    void Build(const CResourceStore& rkStore);
+    void Clear();
+
+    static uint64 Hash(uint64 Value)
+    {
+        // splitmix64 finalizer
+        Value ^= Value >> 30;
+        Value *= 0xBF58476D1CE4E5B9ULL;
+        Value ^= Value >> 27;
+        Value *= 0x94D049BB133111EBULL;
+        Value ^= Value >> 31;
+        return Value;
+    }
+
+    /** Bloom filter test; false means the value is definitely not a registered ID */
+    bool MayContain(uint64 Hashed) const
+    {
+        const uint64 A = Hashed & mBloomMask;
+        const uint64 B = (Hashed >> 32) & mBloomMask;
+        const uint64 C = ((Hashed >> 16) ^ (Hashed >> 48)) & mBloomMask;
+        return ((mBloomBits[A >> 6] >> (A & 63)) & 1) &
+               ((mBloomBits[B >> 6] >> (B & 63)) & 1) &
+               ((mBloomBits[C >> 6] >> (C & 63)) & 1);
+    }
+
+    /** Exact membership test for a value that has already passed MayContain */
+    bool ContainsHashed(uint64 Value, uint64 Hashed) const
+    {
+        for (uint64 Slot = Hashed & mSlotMask; ; Slot = (Slot + 1) & mSlotMask)
+        {
+            const uint64 SlotValue = mSlots[Slot];
+
+            // Check for the empty marker first; an all-0xFF window would otherwise match it
+            if (SlotValue == skEmptySlot)
+                return false;
+            if (SlotValue == Value)
+                return true;
+        }
+    }
+
+    bool Contains(uint64 Value) const
+    {
+        if (mNumIDs == 0)
+            return false;
+
+        const uint64 Hashed = Hash(Value);
+        return MayContain(Hashed) && ContainsHashed(Value, Hashed);
+    }
+
+    bool Contains(const CAssetID& rkID) const   { return rkID.IsValid() && Contains(rkID.ToLongLong()); }
+    uint32 NumIDs() const                       { return mNumIDs; }
+    bool IsEmpty() const                        { return mNumIDs == 0; }
+};
+
+/** An asset ID found in a scanned buffer, along with the byte offset it was found at */
+struct SAssetIDHit
+{
+    uint32 Offset;
+    CAssetID ID;
+};
+
+/** Result of scanning a whole cooked file ahead of time */
+struct SAssetScanResult
+{
+    uint64 ScannedSize = 0;
+    std::vector<SAssetIDHit> Hits;
+};
+
+/**
+ * Brute-force asset reference scanner for data formats we can't parse yet.
+ * Every 4- or 8-byte big-endian window in the buffer is tested against a set of
+ * registered asset IDs. Windows are byte-swapped in batches (with SSSE3 when
+ * available) and batch-filtered through the set's Bloom filter before probing.
+ */
+class CAssetIDScanner
+{
+    CAssetIDScanner() = default;
+
+public:
+    /** Scan Size bytes starting at pkData; hits are appended to rOut in offset order, including duplicates */
+    static void Scan(const uint8 *pkData, size_t Size, EIDLength IDLength, const CAssetIDSet& rkIDSet,
+                     std::vector<SAssetIDHit>& rOut);
+};
+
+#endif // CASSETIDSCANNER_H
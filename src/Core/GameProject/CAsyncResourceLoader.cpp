@@ -0,0 +1,380 @@
+#include "CAsyncResourceLoader.h"
+#include "CDependencyTree.h"
+#include "CResourceEntry.h"
+#include "CResourceStore.h"
+#include "Core/NParallel.h"
+#include "Core/NPerfStats.h"
+#include "Core/Resource/Factory/CResourceFactory.h"
+#include <Common/FileIO.h>
+#include <algorithm>
+#include <set>
+
+CAsyncResourceLoader::CAsyncResourceLoader(CResourceStore *pStore)
+    : mpStore(pStore)
+{
+}
+
+CAsyncResourceLoader::~CAsyncResourceLoader()
+{
+    Clear();
+
+    {
+        std::lock_guard<std::mutex> Lock(mMutex);
+        mShuttingDown = true;
+    }
+
+    mWorkAvailable.notify_all();
+
+    for (std::thread& rWorker : mWorkers)
+        rWorker.join();
+}
+
+uint32 CAsyncResourceLoader::Prefetch(const CAssetID& rkID)
+{
+    CScopedPerfPhase PerfPhase("AsyncLoad.Prefetch");
+
+    // Walk the dependency trees up front; reading them touches the store, so workers can't do it.
+    // Loaded resources are walked too, because some (areas, for one) don't load everything they reference.
+    std::vector<CResourceEntry*> Entries;
+    std::set<CAssetID> Visited;
+    std::vector<CAssetID> Stack{rkID};
+
+    while (!Stack.empty())
+    {
+        const CAssetID ID = Stack.back();
+        Stack.pop_back();
+
+        if (!ID.IsValid() || !Visited.insert(ID).second)
+            continue;
+
+        CResourceEntry *pEntry = mpStore->FindEntry(ID);
+
+        if (!pEntry)
+            continue;
+
+        // Raw assets are deserialized through the store, so there's nothing to do for them ahead of time
+        if (!pEntry->IsLoaded() && !pEntry->HasRawVersion() && pEntry->HasCookedVersion())
+            Entries.push_back(pEntry);
+
+        if (pEntry->TypeInfo()->CanHaveDependencies())
+        {
+            if (const CDependencyTree *pkTree = pEntry->Dependencies())
+            {
+                std::set<CAssetID> References;
+                pkTree->GetAllResourceReferences(References);
+                Stack.insert(Stack.end(), References.rbegin(), References.rend());
+            }
+        }
+    }
+
+    PerfPhase.AddItems(Entries.size());
+    std::lock_guard<std::mutex> Lock(mMutex);
+
+    const uint32 BatchID = mNextBatchID++;
+    std::vector<CAssetID>& rBatch = mBatches[BatchID];
+    rBatch.reserve(Entries.size());
+
+    for (CResourceEntry *pEntry : Entries)
+    {
+        std::unique_ptr<SItem>& rpItem = mItems[pEntry->ID()];
+
+        if (!rpItem)
+        {
+            rpItem = std::make_unique<SItem>();
+            rpItem->ID = pEntry->ID();
+            rpItem->pEntry = pEntry;
+            rpItem->CookedPath = pEntry->CookedAssetPath();
+            rpItem->ParseOnWorker = CanParseOnWorker(pEntry);
+            mQueue.push_back(rpItem.get());
+        }
+
+        rpItem->NumBatches++;
+        rBatch.push_back(pEntry->ID());
+    }
+
+    // Workers are started on first use and then kept around. Most of their time is spent waiting on file reads,
+    // so a couple of them is enough and leaves the cores to the worker pool.
+    if (mWorkers.empty() && !mQueue.empty())
+    {
+        const uint NumWorkers = std::min(skMaxWorkers, NParallel::NumWorkerThreads());
+
+        for (uint WorkerIdx = 0; WorkerIdx < NumWorkers; WorkerIdx++)
+            mWorkers.emplace_back(&CAsyncResourceLoader::WorkerThread, this);
+    }
+
+    mWorkAvailable.notify_all();
+    return BatchID;
+}
+
+void CAsyncResourceLoader::Release(uint32 BatchID)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    const auto BatchIt = mBatches.find(BatchID);
+
+    if (BatchIt == mBatches.end())
+        return;
+
+    for (const CAssetID& rkID : BatchIt->second)
+    {
+        const auto ItemIt = mItems.find(rkID);
+        ASSERT(ItemIt != mItems.end());
+        SItem *pItem = ItemIt->second.get();
+
+        if (--pItem->NumBatches > 0)
+            continue;
+
+        // Items a worker is busy with are erased by the worker once it's done
+        if (pItem->State == EItemState::InProgress)
+            continue;
+
+        if (pItem->State == EItemState::Queued)
+            RemoveFromQueue(pItem);
+
+        mItems.erase(ItemIt);
+    }
+
+    mBatches.erase(BatchIt);
+}
+
+void CAsyncResourceLoader::LoadAsync(const CAssetID& rkID, FLoadCallback Callback)
+{
+    const uint32 BatchID = Prefetch(rkID);
+    mRequests.push_back({rkID, BatchID, std::move(Callback)});
+}
+
+void CAsyncResourceLoader::Update()
+{
+    // Callbacks may add or clear requests, so take each one out of the list before running it
+    for (size_t RequestIdx = 0; RequestIdx < mRequests.size();)
+    {
+        if (!IsBatchFinished(mRequests[RequestIdx].BatchID))
+        {
+            RequestIdx++;
+            continue;
+        }
+
+        SRequest Request = std::move(mRequests[RequestIdx]);
+        mRequests.erase(mRequests.begin() + RequestIdx);
+
+        CResourceEntry *pEntry = mpStore->FindEntry(Request.ID);
+        CResource *pResource = (pEntry ? pEntry->Load() : nullptr);
+        Request.Callback(pResource);
+        Release(Request.BatchID);
+    }
+}
+
+bool CAsyncResourceLoader::TakePrefetched(const CAssetID& rkID, std::unique_ptr<CResource>& rOutResource, std::vector<uint8>& rOutData)
+{
+    std::unique_lock<std::mutex> Lock(mMutex);
+    const auto It = mItems.find(rkID);
+
+    if (It == mItems.end())
+        return false;
+
+    SItem *pItem = It->second.get();
+
+    // Released items that are still in progress belong to the worker, which erases them when it's done
+    if (pItem->NumBatches == 0)
+        return false;
+
+    // Loading it directly is quicker than waiting for the workers to get to it
+    if (pItem->State == EItemState::Queued)
+    {
+        RemoveFromQueue(pItem);
+        pItem->State = EItemState::Ready;
+        return false;
+    }
+
+    if (pItem->State == EItemState::InProgress)
+    {
+        CScopedPerfPhase PerfPhase("AsyncLoad.Wait");
+        mItemFinished.wait(Lock, [pItem] { return pItem->State == EItemState::Ready; });
+    }
+
+    // The item itself stays until its batches are released, so later prefetches don't queue it again
+    rOutResource = std::move(pItem->pResource);
+    rOutData = std::move(pItem->Data);
+    pItem->Data.clear();
+    return rOutResource || !rOutData.empty();
+}
+
+void CAsyncResourceLoader::Discard(const CAssetID& rkID)
+{
+    std::unique_lock<std::mutex> Lock(mMutex);
+    auto It = mItems.find(rkID);
+
+    if (It == mItems.end())
+        return;
+
+    SItem *pItem = It->second.get();
+
+    if (pItem->State == EItemState::Queued)
+        RemoveFromQueue(pItem);
+
+    pItem->Discarded = true;
+
+    // Wait for the worker to let go of the entry. Once it's done, it erases the item if nothing else wants it.
+    if (pItem->State == EItemState::InProgress)
+    {
+        CScopedPerfPhase PerfPhase("AsyncLoad.Wait");
+        mItemFinished.wait(Lock, [this, &rkID] {
+            const auto WaitIt = mItems.find(rkID);
+            return WaitIt == mItems.end() || WaitIt->second->State != EItemState::InProgress;
+        });
+
+        It = mItems.find(rkID);
+
+        if (It == mItems.end())
+            return;
+
+        pItem = It->second.get();
+    }
+
+    pItem->State = EItemState::Ready;
+    pItem->pEntry = nullptr;
+    pItem->pResource.reset();
+    pItem->Data.clear();
+}
+
+void CAsyncResourceLoader::Clear()
+{
+    std::unique_lock<std::mutex> Lock(mMutex);
+    mQueue.clear();
+    mBatches.clear();
+    mRequests.clear();
+
+    for (auto It = mItems.begin(); It != mItems.end();)
+    {
+        if (It->second->State == EItemState::InProgress)
+        {
+            It->second->NumBatches = 0;
+            It->second->Discarded = true;
+            ++It;
+        }
+        else
+        {
+            It = mItems.erase(It);
+        }
+    }
+
+    // Entries may be about to be deleted, so wait for workers to let go of them
+    mItemFinished.wait(Lock, [this] { return mItems.empty(); });
+}
+
+bool CAsyncResourceLoader::IsIdle() const
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+
+    for (const auto& [ID, pItem] : mItems)
+    {
+        if (pItem->State != EItemState::Ready)
+            return false;
+    }
+
+    return true;
+}
+
+// ************ PRIVATE ************
+void CAsyncResourceLoader::WorkerThread()
+{
+    std::unique_lock<std::mutex> Lock(mMutex);
+
+    while (true)
+    {
+        mWorkAvailable.wait(Lock, [this] { return mShuttingDown || !mQueue.empty(); });
+
+        if (mShuttingDown)
+            return;
+
+        SItem *pItem = mQueue.front();
+        mQueue.pop_front();
+        pItem->State = EItemState::InProgress;
+
+        Lock.unlock();
+        ReadItem(*pItem);
+        Lock.lock();
+
+        pItem->State = EItemState::Ready;
+
+        if (pItem->Discarded)
+        {
+            pItem->pResource.reset();
+            pItem->Data.clear();
+        }
+
+        if (pItem->NumBatches == 0)
+            mItems.erase(pItem->ID);
+
+        mItemFinished.notify_all();
+    }
+}
+
+void CAsyncResourceLoader::RemoveFromQueue(SItem *pItem)
+{
+    const auto It = std::find(mQueue.begin(), mQueue.end(), pItem);
+
+    if (It != mQueue.end())
+        mQueue.erase(It);
+}
+
+bool CAsyncResourceLoader::IsBatchFinished(uint32 BatchID) const
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    const auto BatchIt = mBatches.find(BatchID);
+
+    if (BatchIt == mBatches.end())
+        return true;
+
+    for (const CAssetID& rkID : BatchIt->second)
+    {
+        if (mItems.at(rkID)->State != EItemState::Ready)
+            return false;
+    }
+
+    return true;
+}
+
+void CAsyncResourceLoader::ReadItem(SItem& rItem)
+{
+    {
+        CScopedPerfPhase PerfPhase("AsyncLoad.Read");
+        CFileInStream File(rItem.CookedPath, EEndian::BigEndian);
+
+        // On failure, the resource is just loaded normally later, which reports the error
+        if (!File.IsValid())
+            return;
+
+        rItem.Data.resize(File.Size());
+        File.ReadBytes(rItem.Data.data(), rItem.Data.size());
+        PerfPhase.AddBytes(rItem.Data.size());
+    }
+
+    if (rItem.ParseOnWorker && !rItem.Data.empty())
+    {
+        CScopedPerfPhase PerfPhase("AsyncLoad.Parse");
+        CMemoryInStream Input(rItem.Data.data(), rItem.Data.size(), EEndian::BigEndian);
+        rItem.pResource = CResourceFactory::LoadCookedResource(rItem.pEntry, Input);
+
+        if (rItem.pResource)
+            std::vector<uint8>().swap(rItem.Data);
+    }
+}
+
+bool CAsyncResourceLoader::CanParseOnWorker(const CResourceEntry *pkEntry)
+{
+    // Only types whose cooked loaders never look up other resources or otherwise touch the store. That
+    // includes holding the new resource in a TResPtr, since its reference counting notifies the store.
+    // GL objects aren't created here either; textures are uploaded on first use on the render thread.
+    switch (pkEntry->ResourceType())
+    {
+    case EResourceType::DynamicCollision:
+    case EResourceType::Skeleton:
+    case EResourceType::Skin:
+    case EResourceType::StringTable:
+    case EResourceType::Texture:
+        return true;
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef CASYNCRESOURCELOADER_H
+#define CASYNCRESOURCELOADER_H
+
+#include <Common/BasicTypes.h>
+#include <Common/CAssetID.h>
+#include <Common/TString.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CResource;
+class CResourceEntry;
+class CResourceStore;
+
+/**
+ * Reads and parses resources on worker threads ahead of when they're needed. Prefetching a resource
+ * queues it along with everything in its cached dependency tree, recursively. Workers read the cooked
+ * files into memory, and fully parse the resource types whose loaders never touch the resource store.
+ *
+ * Everything else - loaders that look up other resources, reference counting, store bookkeeping and
+ * GL uploads - still happens on the thread that owns the store. CResourceEntry::Load picks up the
+ * prefetched data, so existing load paths benefit without changes once a prefetch is active.
+ * All public functions must be called from the thread that owns the store.
+ */
+class CAsyncResourceLoader
+{
+public:
+    using FLoadCallback = std::function<void(CResource*)>;
+
+private:
+    enum class EItemState
+    {
+        Queued,
+        InProgress,
+        Ready
+    };
+
+    /** One prefetched resource. Items stay alive as long as any batch that asked for them does. */
+    struct SItem
+    {
+        CAssetID ID;
+        CResourceEntry *pEntry = nullptr;
+        TString CookedPath;
+        bool ParseOnWorker = false;
+        bool Discarded = false;
+        EItemState State = EItemState::Queued;
+        uint32 NumBatches = 0;
+
+        // Results; at most one is filled in
+        std::vector<uint8> Data;
+        std::unique_ptr<CResource> pResource;
+    };
+
+    /** A pending LoadAsync call */
+    struct SRequest
+    {
+        CAssetID ID;
+        uint32 BatchID;
+        FLoadCallback Callback;
+    };
+
+    static constexpr uint skMaxWorkers = 2;
+
+    CResourceStore *mpStore;
+    std::map<CAssetID, std::unique_ptr<SItem>> mItems;
+    std::deque<SItem*> mQueue;
+    std::map<uint32, std::vector<CAssetID>> mBatches;
+    uint32 mNextBatchID = 1;
+    std::vector<SRequest> mRequests;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mItemFinished;
+    std::vector<std::thread> mWorkers;
+    bool mShuttingDown = false;
+
+    void WorkerThread();
+    void RemoveFromQueue(SItem *pItem);
+    bool IsBatchFinished(uint32 BatchID) const;
+    static void ReadItem(SItem& rItem);
+    static bool CanParseOnWorker(const CResourceEntry *pkEntry);
+
+public:
+    explicit CAsyncResourceLoader(CResourceStore *pStore);
+    ~CAsyncResourceLoader();
+
+    CAsyncResourceLoader(const CAsyncResourceLoader&) = delete;
+    CAsyncResourceLoader& operator=(const CAsyncResourceLoader&) = delete;
+
+    /**
+     * Start reading the resource and its dependencies in the background. Returns a batch ID that
+     * keeps the prefetched data alive until it's passed to Release.
+     */
+    uint32 Prefetch(const CAssetID& rkID);
+    void Release(uint32 BatchID);
+
+    /**
+     * Prefetch the resource and its dependencies, then load it. The callback is run from Update once
+     * the prefetch has finished, with the loaded resource or nullptr on failure. Prefetched data is
+     * kept until the callback returns, so it can load dependencies cheaply as well.
+     */
+    void LoadAsync(const CAssetID& rkID, FLoadCallback Callback);
+
+    /** Finish any LoadAsync requests whose data is ready; call regularly, e.g. once per editor tick */
+    void Update();
+
+    /**
+     * Hand over prefetched data for a resource. Blocks if a worker is busy with it; if no worker has
+     * started on it yet, it's dropped so the caller can load it directly rather than wait.
+     * Returns false if there's nothing to hand over.
+     */
+    bool TakePrefetched(const CAssetID& rkID, std::unique_ptr<CResource>& rOutResource, std::vector<uint8>& rOutData);
+
+    /**
+     * Drop prefetched data for a resource whose files have changed or whose entry is about to be deleted.
+     * Blocks if a worker is busy with it, so afterwards no worker touches the entry or its files.
+     * Batches and LoadAsync requests that include it are kept; they just load it directly.
+     */
+    void Discard(const CAssetID& rkID);
+
+    /** Cancel all prefetches and drop pending LoadAsync requests without running their callbacks */
+    void Clear();
+
+    bool IsIdle() const;
+};
+
+/** Prefetches a resource and its dependencies for the lifetime of the scope */
+class CScopedResourcePrefetch
+{
+    CAsyncResourceLoader *mpLoader;
+    uint32 mBatchID;
+
+public:
+    CScopedResourcePrefetch(CAsyncResourceLoader *pLoader, const CAssetID& rkID)
+        : mpLoader(pLoader)
+        , mBatchID(pLoader->Prefetch(rkID))
+    {}
+
+    ~CScopedResourcePrefetch()
+    {
+        mpLoader->Release(mBatchID);
+    }
+
+    CScopedResourcePrefetch(const CScopedResourcePrefetch&) = delete;
+    CScopedResourcePrefetch& operator=(const CScopedResourcePrefetch&) = delete;
+};
+
+#endif // CASYNCRESOURCELOADER_H
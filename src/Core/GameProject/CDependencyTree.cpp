@@ -334,18 +334,89 @@ void CAreaDependencyTree::AddScriptLayer(CScriptLayer *pLayer, const std::vector
         auto pTree = CScriptInstanceDependency::BuildTree(pLayer->InstanceByIndex(iInst));
         ASSERT(pTree != nullptr);
 
-        // Note: MP2+ need to track all instances (not just instances with dependencies) to be able to build the layer module list
-        if (pTree->NumChildren() > 0 || pLayer->Area()->Game() >= EGame::EchoesDemo)
-        {
-            pTree->GetAllResourceReferences(UsedIDs);
-            mChildren.push_back(std::move(pTree));
-        }
+        // Note: all instances are tracked (not just instances with dependencies). MP2+ need this to build the layer
+        // module list, and it lets instance nodes be updated in place when the area is edited.
+        pTree->GetAllResourceReferences(UsedIDs);
+        mChildren.push_back(std::move(pTree));
     }
 
     for (const auto& dep : rkExtraDeps)
         AddDependency(dep);
 }
 
+bool CAreaDependencyTree::HasScriptInstanceNodes(size_t LayerIdx, size_t NumInstances) const
+{
+    if (LayerIdx >= mLayerOffsets.size())
+        return false;
+
+    // Instance nodes come first in each layer, followed by the layer's extra dependencies
+    const size_t StartIdx = mLayerOffsets[LayerIdx];
+    const size_t EndIdx = ScriptLayerEnd(LayerIdx);
+
+    if (EndIdx - StartIdx < NumInstances)
+        return false;
+
+    if (NumInstances > 0 && mChildren[StartIdx + NumInstances - 1]->Type() != EDependencyNodeType::ScriptInstance)
+        return false;
+
+    return StartIdx + NumInstances == EndIdx || mChildren[StartIdx + NumInstances]->Type() != EDependencyNodeType::ScriptInstance;
+}
+
+bool CAreaDependencyTree::InsertScriptInstance(size_t LayerIdx, size_t InstanceIdx, std::unique_ptr<CScriptInstanceDependency>&& pNode)
+{
+    if (LayerIdx >= mLayerOffsets.size())
+        return false;
+
+    const size_t ChildIdx = mLayerOffsets[LayerIdx] + InstanceIdx;
+
+    if (ChildIdx > ScriptLayerEnd(LayerIdx))
+        return false;
+
+    mChildren.insert(mChildren.begin() + ChildIdx, std::move(pNode));
+
+    for (size_t Idx = LayerIdx + 1; Idx < mLayerOffsets.size(); Idx++)
+        mLayerOffsets[Idx]++;
+
+    return true;
+}
+
+bool CAreaDependencyTree::RemoveScriptInstance(size_t LayerIdx, size_t InstanceIdx)
+{
+    if (LayerIdx >= mLayerOffsets.size())
+        return false;
+
+    const size_t ChildIdx = mLayerOffsets[LayerIdx] + InstanceIdx;
+
+    if (ChildIdx >= ScriptLayerEnd(LayerIdx) || mChildren[ChildIdx]->Type() != EDependencyNodeType::ScriptInstance)
+        return false;
+
+    mChildren.erase(mChildren.begin() + ChildIdx);
+
+    for (size_t Idx = LayerIdx + 1; Idx < mLayerOffsets.size(); Idx++)
+        mLayerOffsets[Idx]--;
+
+    return true;
+}
+
+bool CAreaDependencyTree::SetScriptInstance(size_t LayerIdx, size_t InstanceIdx, std::unique_ptr<CScriptInstanceDependency>&& pNode)
+{
+    if (LayerIdx >= mLayerOffsets.size())
+        return false;
+
+    const size_t ChildIdx = mLayerOffsets[LayerIdx] + InstanceIdx;
+
+    if (ChildIdx >= ScriptLayerEnd(LayerIdx) || mChildren[ChildIdx]->Type() != EDependencyNodeType::ScriptInstance)
+        return false;
+
+    mChildren[ChildIdx] = std::move(pNode);
+    return true;
+}
+
+size_t CAreaDependencyTree::ScriptLayerEnd(size_t LayerIdx) const
+{
+    return (LayerIdx == mLayerOffsets.size() - 1 ? mChildren.size() : mLayerOffsets[LayerIdx + 1]);
+}
+
 void CAreaDependencyTree::GetModuleDependencies(EGame Game, std::vector<TString>& rModuleDepsOut, std::vector<uint32>& rModuleLayerOffsetsOut) const
 {
     CGameTemplate *pGame = NGameList::GetGameTemplate(Game);
@@ -216,9 +216,19 @@ public:
     void AddScriptLayer(CScriptLayer *pLayer, const std::vector<CAssetID>& rkExtraDeps);
     void GetModuleDependencies(EGame Game, std::vector<TString>& rModuleDepsOut, std::vector<uint32>& rModuleLayerOffsetsOut) const;
 
+    // Every instance in a layer has a node, in the same order as the layer, so instance nodes can be edited in place.
+    // These fail if the tree doesn't line up with the requested index.
+    bool HasScriptInstanceNodes(size_t LayerIdx, size_t NumInstances) const;
+    bool InsertScriptInstance(size_t LayerIdx, size_t InstanceIdx, std::unique_ptr<CScriptInstanceDependency>&& pNode);
+    bool RemoveScriptInstance(size_t LayerIdx, size_t InstanceIdx);
+    bool SetScriptInstance(size_t LayerIdx, size_t InstanceIdx, std::unique_ptr<CScriptInstanceDependency>&& pNode);
+
     // Accessors
     size_t NumScriptLayers() const                   { return mLayerOffsets.size(); }
     uint32 ScriptLayerOffset(size_t LayerIdx) const  { return mLayerOffsets[LayerIdx]; }
+
+private:
+    size_t ScriptLayerEnd(size_t LayerIdx) const;
 };
 
 #endif // CDEPENDENCYTREE
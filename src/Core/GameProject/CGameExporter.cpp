@@ -26,6 +26,99 @@
 #define TStringToNodString(string) *string
 #endif
 
+namespace
+{
+
+/**
+ * Read the header and resource tables at the start of a pak stored on disc, without touching its resource data.
+ * The returned buffer can be parsed the same way as the start of an extracted pak.
+ */
+std::vector<uint8> ReadPakHeaderFromDisc(const nod::Node& rkNode, EGame Game)
+{
+    std::vector<uint8> Header;
+    std::unique_ptr<nod::IPartReadStream> pStream = rkNode.beginReadStream();
+
+    if (!pStream)
+        return Header;
+
+    const uint64 PakSize = rkNode.size();
+    bool Overrun = false;
+
+    // Append the next Count bytes of the pak to the header and return a pointer to them
+    const auto Read = [&](uint64 Count) -> const uint8*
+    {
+        const size_t Offset = Header.size();
+
+        if (Offset + Count > PakSize)
+        {
+            Overrun = true;
+            Count = PakSize - Offset;
+        }
+
+        Header.resize(Offset + Count);
+        pStream->read(Header.data() + Offset, Count);
+        return Header.data() + Offset;
+    };
+
+    const auto ReadULong = [&]() -> uint32
+    {
+        const uint8 *pkData = Read(4);
+        if (Overrun) return 0;
+        return (pkData[0] << 24) | (pkData[1] << 16) | (pkData[2] << 8) | pkData[3];
+    };
+
+    const uint32 IDLength = static_cast<uint32>(CAssetID::GameIDLength(Game));
+
+    // MP1-MP3Proto
+    if (Game < EGame::Corruption)
+    {
+        Read(8);
+
+        if (Header.size() < PakSize)
+        {
+            const uint32 NumNamedResources = ReadULong();
+
+            for (uint32 iName = 0; iName < NumNamedResources && !Overrun; iName++)
+            {
+                Read(4 + IDLength);
+                Read(ReadULong());
+            }
+
+            const uint32 NumResources = ReadULong();
+            Read(static_cast<uint64>(NumResources) * (16 + IDLength));
+        }
+    }
+    else // MP3 + DKCR
+    {
+        Read(4);
+        const uint32 PakHeaderLen = ReadULong();
+        Read(PakHeaderLen - 8);
+
+        const uint32 NumPakSections = ReadULong();
+        uint64 TableSize = 0;
+
+        for (uint32 iSec = 0; iSec < NumPakSections && !Overrun; iSec++)
+        {
+            const uint32 Type = ReadULong();
+            const uint32 Size = ReadULong();
+
+            // Everything before the data section is needed to parse the pak
+            if (Type != FOURCC('DATA'))
+                TableSize += Size;
+        }
+
+        Read(((Header.size() + 63) & ~63) - Header.size());
+        Read(TableSize);
+    }
+
+    if (Overrun)
+        Header.clear();
+
+    return Header;
+}
+
+} // anonymous namespace
+
 CGameExporter::CGameExporter(EDiscType DiscType, EGame Game, bool FrontEnd, ERegion Region, const TString& rkGameName, const TString& rkGameID, float BuildVersion)
     : mGame(Game)
     , mRegion(Region)
@@ -232,16 +325,25 @@ bool CGameExporter::ExtractDiscNodeRecursive(const nod::Node *pkNode, const TStr
         if (Iter->getKind() == nod::Node::Kind::File)
         {
             TString FilePath = rkDir + Iter->getName().data();
-            bool Success = Iter->extractToDirectory(TStringToNodString(rkDir), rkContext);
-            if (!Success)
-                return false;
 
-            if (FilePath.GetFileExtension().CaseInsensitiveCompare("pak"))
+            // For multi-game Wii discs, don't track packages for frontend unless we're exporting frontend
+            const bool IsTrackedPak = FilePath.GetFileExtension().CaseInsensitiveCompare("pak") &&
+                                      (mDiscType == EDiscType::Normal || mFrontEnd || pkNode->getName() != "fe");
+
+            if (IsTrackedPak && mReadPaksFromDisc)
+            {
+                // Tracked paks are unpacked straight from the disc and recooked later, so there's no need to extract them
+                mDiscPakNodes.insert_or_assign(FilePath, &*Iter);
+            }
+            else
             {
-                // For multi-game Wii discs, don't track packages for frontend unless we're exporting frontend
-                if (mDiscType == EDiscType::Normal || mFrontEnd || pkNode->getName() != "fe")
-                    mPaks.push_back(FilePath);
+                bool Success = Iter->extractToDirectory(TStringToNodString(rkDir), rkContext);
+                if (!Success)
+                    return false;
             }
+
+            if (IsTrackedPak)
+                mPaks.push_back(FilePath);
         }
 
         else
@@ -273,9 +375,25 @@ void CGameExporter::LoadPaks()
     for (auto It = mPaks.begin(); It != mPaks.end(); It++)
     {
         TString PakPath = *It;
-        CFileInStream Pak(PakPath, EEndian::BigEndian);
+        std::unique_ptr<IInputStream> pPakStream;
+        std::vector<uint8> PakHeader;
+
+        if (mReadPaksFromDisc)
+        {
+            const auto Find = mDiscPakNodes.find(PakPath);
+            ASSERT(Find != mDiscPakNodes.cend());
+
+            PakHeader = ReadPakHeaderFromDisc(*Find->second, mGame);
+            pPakStream = std::make_unique<CMemoryInStream>(PakHeader.data(), PakHeader.size(), EEndian::BigEndian);
+        }
+        else
+        {
+            pPakStream = std::make_unique<CFileInStream>(PakPath, EEndian::BigEndian);
+        }
+
+        IInputStream& Pak = *pPakStream;
 
-        if (!Pak.IsValid())
+        if ((mReadPaksFromDisc && PakHeader.empty()) || !Pak.IsValid())
         {
             errorf("Couldn't open pak: %s", *PakPath);
             continue;
@@ -422,6 +540,10 @@ void CGameExporter::LoadPaks()
                     }
                 }
 
+                // The remaining data is resource data, which is read on demand
+                if (PakSections[iSec].Type == "DATA")
+                    break;
+
                 Pak.Seek(Next, SEEK_SET);
             }
         }
@@ -437,13 +559,38 @@ void CGameExporter::LoadPaks()
 #endif
 }
 
-void CGameExporter::LoadResource(const SResourceInstance& rkResource, std::vector<uint8>& rBuffer)
+bool CGameExporter::ReadPakData(const SResourceInstance& rkResource, std::vector<uint8>& rOutData) const
 {
+    rOutData.resize(rkResource.PakSize);
+
+    if (mReadPaksFromDisc)
+    {
+        const auto Find = mDiscPakNodes.find(rkResource.PakFile);
+        if (Find == mDiscPakNodes.cend())
+            return false;
+
+        std::unique_ptr<nod::IPartReadStream> pStream = Find->second->beginReadStream(rkResource.PakOffset);
+        return pStream && pStream->read(rOutData.data(), rOutData.size()) == rOutData.size();
+    }
+
     CFileInStream Pak(rkResource.PakFile, EEndian::BigEndian);
 
-    if (Pak.IsValid())
+    if (!Pak.IsValid())
+        return false;
+
+    Pak.Seek(rkResource.PakOffset, SEEK_SET);
+    Pak.ReadBytes(rOutData.data(), rOutData.size());
+    return true;
+}
+
+void CGameExporter::LoadResource(const SResourceInstance& rkResource, std::vector<uint8>& rBuffer)
+{
+    // Read the resource's data as it's stored in the pak, then unpack it in memory
+    std::vector<uint8> PakData;
+
+    if (ReadPakData(rkResource, PakData))
     {
-        Pak.Seek(rkResource.PakOffset, SEEK_SET);
+        CMemoryInStream Pak(PakData.data(), PakData.size(), EEndian::BigEndian);
 
         // Handle compression
         if (rkResource.Compressed)
@@ -452,7 +599,8 @@ void CGameExporter::LoadResource(const SResourceInstance& rkResource, std::vecto
 
             if (mGame <= EGame::CorruptionProto)
             {
-                std::vector<uint8> CompressedData(rkResource.PakSize);
+                // The stored size includes the uncompressed size
+                std::vector<uint8> CompressedData(rkResource.PakSize - 4);
 
                 const uint32 UncompressedSize = Pak.ReadULong();
                 rBuffer.resize(UncompressedSize);
@@ -527,10 +675,13 @@ void CGameExporter::LoadResource(const SResourceInstance& rkResource, std::vecto
         }
         else // Handle uncompressed
         {
-            rBuffer.resize(rkResource.PakSize);
-            Pak.ReadBytes(rBuffer.data(), rBuffer.size());
+            rBuffer = std::move(PakData);
         }
     }
+    else
+    {
+        errorf("Couldn't read resource %s from pak: %s", *rkResource.ResourceID.ToString(), *rkResource.PakFile);
+    }
 }
 
 void CGameExporter::ExportCookedResources()
@@ -605,11 +756,19 @@ void CGameExporter::ExportResourceEditorData()
 
             // Set flags, save metadata
             It->SaveMetadata(true);
+            mpProgress->ReportProcessed(0, 1);
         }
     }
 
     if (!mpProgress->ShouldCancel())
     {
+        // The original paks weren't extracted, so they'll need to be cooked before the disc can be built
+        if (mReadPaksFromDisc)
+        {
+            for (size_t iPkg = 0; iPkg < mpProject->NumPackages(); iPkg++)
+                mpProject->PackageByIndex(iPkg)->MarkDirty();
+        }
+
         // All resources should have dependencies generated, so save the project files
         SCOPED_TIMER(SaveResourceDatabase);
 #if EXPORT_COOKED
@@ -657,6 +816,8 @@ void CGameExporter::ExportResource(SResourceInstance& rRes)
         if (Out.IsValid())
             Out.WriteBytes(ResourceData.data(), ResourceData.size());
 
+        mpProgress->ReportProcessed(ResourceData.size(), 1);
+
         ASSERT(pEntry->HasCookedVersion());
 #endif
 
@@ -42,6 +42,10 @@ class CGameExporter
     nod::DiscBase *mpDisc = nullptr;
     EDiscType mDiscType;
     bool mFrontEnd;
+    bool mReadPaksFromDisc = false;
+
+    // Paks that are read straight from the disc instead of being extracted, keyed by the path they would be extracted to
+    std::map<TString, const nod::Node*> mDiscPakNodes;
 
     // Resources
     TStringList mPaks;
@@ -79,6 +83,13 @@ public:
     void LoadResource(const CAssetID& rkID, std::vector<uint8>& rBuffer);
     bool ShouldExportDiscNode(const nod::Node *pkNode, bool IsInRoot) const;
 
+    /**
+     * When enabled, packages are read directly from the disc partition rather than being extracted to the
+     * export directory first. Only the unpacked assets and the non-pak disc files are written; the project's
+     * packages are flagged for recook, since the original paks won't exist in the project's disc directory.
+     */
+    void SetReadPaksFromDisc(bool Enable)   { mReadPaksFromDisc = Enable; }
+
     TString ProjectPath() const  { return mProjectPath; }
 
 protected:
@@ -86,6 +97,7 @@ protected:
     bool ExtractDiscNodeRecursive(const nod::Node *pkNode, const TString& rkDir, bool RootNode, const nod::ExtractionContext& rkContext);
     void LoadPaks();
     void LoadResource(const SResourceInstance& rkResource, std::vector<uint8>& rBuffer);
+    bool ReadPakData(const SResourceInstance& rkResource, std::vector<uint8>& rOutData) const;
     void ExportCookedResources();
     void ExportResourceEditorData();
     void ExportResource(SResourceInstance& rRes);
@@ -2,14 +2,106 @@
 #include "DependencyListBuilders.h"
 #include "CGameProject.h"
 #include "Core/CompressionUtil.h"
+#include "Core/NPerfStats.h"
+#include "Core/SafeFileUtil.h"
 #include "Core/Resource/Cooker/CWorldCooker.h"
 #include <Common/Macros.h>
 #include <Common/FileIO.h>
 #include <Common/FileUtil.h>
+#include <Common/Hash/CFNV1A.h>
+#include <Common/Math/MathUtil.h>
 #include <Common/Serialization/XML.h>
+#include <map>
+#include <memory>
 
 using namespace tinyxml2;
 
+namespace
+{
+
+constexpr uint32 kCookCacheMagic = FOURCC('PKCC');
+constexpr uint32 kCookCacheVersion = 2;
+
+/** Size of the buffer used to copy unchanged asset data from the previous pak */
+constexpr uint32 kCopyChunkSize = 0x100000;
+
+/** State of an asset at the time it was written to a pak, and where its data ended up */
+struct SCookedAssetRecord
+{
+    uint64 CookedSize = 0;
+    uint64 CookedHash = 0; // FNV-1a of the cooked file's contents
+    uint32 DataOffset = 0; // Absolute offset in the pak
+    uint32 DataSize = 0;   // Including alignment padding
+    bool Compressed = false;
+};
+
+/** Read the cook cache for a pak; fails if the cache is missing or the pak has been modified since the cache was written */
+bool ReadCookCache(const TString& rkCachePath, const TString& rkPakPath, std::map<uint64, SCookedAssetRecord>& rOutRecords)
+{
+    if (!FileUtil::Exists(rkCachePath) || !FileUtil::Exists(rkPakPath))
+        return false;
+
+    CFileInStream Cache(rkCachePath, EEndian::BigEndian);
+
+    if (!Cache.IsValid() || Cache.ReadULong() != kCookCacheMagic || Cache.ReadULong() != kCookCacheVersion)
+        return false;
+
+    const uint64 PakSize = Cache.ReadULongLong();
+    const uint64 PakModifiedTime = Cache.ReadULongLong();
+
+    if (PakSize != static_cast<uint64>(FileUtil::FileSize(rkPakPath)) ||
+        PakModifiedTime != static_cast<uint64>(FileUtil::LastModifiedTime(rkPakPath)))
+    {
+        return false;
+    }
+
+    const uint32 NumRecords = Cache.ReadULong();
+
+    for (uint32 RecordIdx = 0; RecordIdx < NumRecords; RecordIdx++)
+    {
+        const uint64 ID = Cache.ReadULongLong();
+        SCookedAssetRecord& rRecord = rOutRecords[ID];
+        rRecord.CookedSize = Cache.ReadULongLong();
+        rRecord.CookedHash = Cache.ReadULongLong();
+        rRecord.DataOffset = Cache.ReadULong();
+        rRecord.DataSize = Cache.ReadULong();
+        rRecord.Compressed = Cache.ReadULong() != 0;
+    }
+
+    return true;
+}
+
+/** Write the cook cache for a freshly written pak */
+void WriteCookCache(const TString& rkCachePath, const TString& rkPakPath, const std::vector<std::pair<uint64, SCookedAssetRecord>>& rkRecords)
+{
+    FileUtil::MakeDirectory(rkCachePath.GetFileDirectory());
+    CFileOutStream Cache(rkCachePath, EEndian::BigEndian);
+
+    if (!Cache.IsValid())
+    {
+        warnf("Unable to write package cook cache: %s", *rkCachePath);
+        return;
+    }
+
+    Cache.WriteULong(kCookCacheMagic);
+    Cache.WriteULong(kCookCacheVersion);
+    Cache.WriteULongLong(static_cast<uint64>(FileUtil::FileSize(rkPakPath)));
+    Cache.WriteULongLong(static_cast<uint64>(FileUtil::LastModifiedTime(rkPakPath)));
+    Cache.WriteULong(static_cast<uint32>(rkRecords.size()));
+
+    for (const auto& [ID, rkRecord] : rkRecords)
+    {
+        Cache.WriteULongLong(ID);
+        Cache.WriteULongLong(rkRecord.CookedSize);
+        Cache.WriteULongLong(rkRecord.CookedHash);
+        Cache.WriteULong(rkRecord.DataOffset);
+        Cache.WriteULong(rkRecord.DataSize);
+        Cache.WriteULong(rkRecord.Compressed ? 1 : 0);
+    }
+}
+
+}
+
 bool CPackage::Load()
 {
     const TString DefPath = DefinitionPath(false);
@@ -60,13 +152,43 @@ void CPackage::UpdateDependencyCache() const
     mCacheDirty = false;
 }
 
+void CPackage::AddCachedDependencies(const std::set<CAssetID>& rkIDs) const
+{
+    // A dirty cache is rebuilt in full the next time it's used. References that are no longer used
+    // are left in the cache until then; this only makes ContainsAsset() err on the side of recooking.
+    if (mCacheDirty)
+        return;
+
+    const CResourceStore *pkStore = mpProject->ResourceStore();
+    std::vector<CAssetID> PendingIDs(rkIDs.cbegin(), rkIDs.cend());
+
+    while (!PendingIDs.empty())
+    {
+        const CAssetID ID = PendingIDs.back();
+        PendingIDs.pop_back();
+
+        // Assets already in the cache were added along with their own dependencies
+        if (!mCachedDependencies.insert(ID).second)
+            continue;
+
+        const CResourceEntry *pkEntry = pkStore->FindEntry(ID);
+
+        if (pkEntry && pkEntry->Dependencies())
+        {
+            std::set<CAssetID> References;
+            pkEntry->Dependencies()->GetAllResourceReferences(References);
+            PendingIDs.insert(PendingIDs.end(), References.cbegin(), References.cend());
+        }
+    }
+}
+
 void CPackage::MarkDirty()
 {
+    // Dependency list changes are applied by whoever changed them; see AddCachedDependencies()
     if (!mNeedsRecook)
     {
         mNeedsRecook = true;
         Save();
-        UpdateDependencyCache();
     }
 }
 
@@ -79,12 +201,34 @@ void CPackage::Cook(IProgressNotifier *pProgress)
 
     CPackageDependencyListBuilder Builder(this);
     std::list<CAssetID> AssetList;
-    Builder.BuildDependencyList(true, AssetList);
+    {
+        CScopedPerfPhase PerfPhase("Package.BuildDependencyList");
+        Builder.BuildDependencyList(true, AssetList);
+        PerfPhase.AddItems(AssetList.size());
+    }
     debugf("%d assets in %s.pak", AssetList.size(), *Name());
 
-    // Write new pak
+    // Load the previous pak's contents. Assets whose cooked data hasn't changed since it was
+    // written are copied over verbatim instead of being compressed again.
     const TString PakPath = CookedPackagePath(false);
-    CFileOutStream Pak(PakPath, EEndian::BigEndian);
+    const TString CachePath = CookCachePath(false);
+    std::map<uint64, SCookedAssetRecord> PreviousAssets;
+    std::unique_ptr<CFileInStream> pPreviousPak;
+
+    if (ReadCookCache(CachePath, PakPath, PreviousAssets))
+    {
+        pPreviousPak = std::make_unique<CFileInStream>(PakPath, EEndian::BigEndian);
+
+        if (!pPreviousPak->IsValid())
+        {
+            pPreviousPak.reset();
+            PreviousAssets.clear();
+        }
+    }
+
+    // Write new pak. It's written next to the old one and swapped in once it's complete.
+    const TString TempPakPath = PakPath + ".tmp";
+    CFileOutStream Pak(TempPakPath, EEndian::BigEndian);
 
     if (!Pak.IsValid())
     {
@@ -167,15 +311,41 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         uint32 Offset;
         uint32 Size;
         bool Compressed;
+        SCookedAssetRecord Record;
     };
     std::vector<SResourceTableInfo> ResourceTableData(AssetList.size());
     uint32 ResIdx = 0;
+    uint32 NumReusedAssets = 0;
     const uint32 ResDataOffset = Pak.Tell();
 
+    // Runs of reused assets that are contiguous in the previous pak are copied together
+    uint32 PendingCopyOffset = 0;
+    uint32 PendingCopySize = 0;
+    std::vector<uint8> CopyBuffer;
+
+    auto FlushPendingCopy = [&]()
+    {
+        if (PendingCopySize == 0)
+            return;
+
+        CopyBuffer.resize(Math::Min(PendingCopySize, kCopyChunkSize));
+        pPreviousPak->Seek(PendingCopyOffset, SEEK_SET);
+
+        for (uint32 Remaining = PendingCopySize; Remaining > 0; )
+        {
+            const uint32 ChunkSize = Math::Min(Remaining, kCopyChunkSize);
+            pPreviousPak->ReadBytes(CopyBuffer.data(), ChunkSize);
+            Pak.WriteBytes(CopyBuffer.data(), ChunkSize);
+            Remaining -= ChunkSize;
+        }
+
+        PendingCopySize = 0;
+    };
+
     for (auto Iter = AssetList.begin(); Iter != AssetList.end() && !pProgress->ShouldCancel(); Iter++, ResIdx++)
     {
         // Initialize entry, recook assets if needed
-        const uint32 AssetOffset = Pak.Tell();
+        const uint32 AssetOffset = Pak.Tell() + PendingCopySize;
         const CAssetID ID = *Iter;
         CResourceEntry *pEntry = gpResourceStore->FindEntry(ID);
         ASSERT(pEntry != nullptr);
@@ -205,6 +375,40 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         std::vector<uint8> ResourceData(ResourceSize);
         CookedAsset.ReadBytes(ResourceData.data(), ResourceData.size());
 
+        // Assets are matched on their contents; sizes and timestamps can stay the same across an edit
+        CFNV1A Hash(CFNV1A::EHashLength::k64Bit);
+        Hash.HashData(ResourceData.data(), ResourceData.size());
+
+        SCookedAssetRecord& rRecord = rTableInfo.Record;
+        rRecord.CookedSize = ResourceSize;
+        rRecord.CookedHash = Hash.GetHash64();
+        rRecord.DataOffset = AssetOffset;
+
+        // Reuse the data from the previous pak if the cooked asset is the same one that was written there
+        const auto PreviousIter = PreviousAssets.find(ID.ToLongLong());
+
+        if (PreviousIter != PreviousAssets.cend() &&
+            PreviousIter->second.CookedSize == rRecord.CookedSize &&
+            PreviousIter->second.CookedHash == rRecord.CookedHash)
+        {
+            const SCookedAssetRecord& rkPrevious = PreviousIter->second;
+
+            if (PendingCopySize > 0 && PendingCopyOffset + PendingCopySize != rkPrevious.DataOffset)
+                FlushPendingCopy();
+
+            if (PendingCopySize == 0)
+                PendingCopyOffset = rkPrevious.DataOffset;
+
+            PendingCopySize += rkPrevious.DataSize;
+            rTableInfo.Size = rRecord.DataSize = rkPrevious.DataSize;
+            rTableInfo.Compressed = rRecord.Compressed = rkPrevious.Compressed;
+            NumReusedAssets++;
+            pProgress->ReportProcessed(rkPrevious.DataSize, 1);
+            continue;
+        }
+
+        FlushPendingCopy();
+
         // Check if this asset should be compressed; there are a few resource types that are
         // always compressed, and some types that are compressed if they're over a certain size
         const EResourceType Type = pEntry->ResourceType();
@@ -289,15 +493,18 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         }
 
         Pak.WriteToBoundary(Alignment, 0xFF);
-        rTableInfo.Size = Pak.Tell() - AssetOffset;
+        rTableInfo.Size = rRecord.DataSize = Pak.Tell() - AssetOffset;
+        rRecord.Compressed = rTableInfo.Compressed;
+        pProgress->ReportProcessed(ResourceSize, 1);
     }
+    FlushPendingCopy();
     ResDataSize = Pak.Tell() - ResDataOffset;
 
     // If we cancelled, don't finish writing the pak; delete the file instead and make sure the package is flagged for recook
     if (pProgress->ShouldCancel())
     {
         Pak.Close();
-        FileUtil::DeleteFile(PakPath);
+        FileUtil::DeleteFile(TempPakPath);
         mNeedsRecook = true;
     }
     else
@@ -330,9 +537,32 @@ void CPackage::Cook(IProgressNotifier *pProgress)
             Pak.WriteULong(rkInfo.Offset);
         }
 
-        // Clear recook flag
-        mNeedsRecook = false;
-        debugf("Finished writing %s", *PakPath);
+        // Replace the previous pak. If that fails, the previous pak and its cook cache are left as they were.
+        Pak.Close();
+        pPreviousPak.reset();
+
+        if (SafeFileUtil::ReplaceFile(TempPakPath, PakPath))
+        {
+            FileUtil::DeleteFile(CachePath);
+
+            std::vector<std::pair<uint64, SCookedAssetRecord>> CacheRecords;
+            CacheRecords.reserve(ResourceTableData.size());
+
+            for (const SResourceTableInfo& rkInfo : ResourceTableData)
+                CacheRecords.emplace_back(rkInfo.pEntry->ID().ToLongLong(), rkInfo.Record);
+
+            WriteCookCache(CachePath, PakPath, CacheRecords);
+
+            // Clear recook flag
+            mNeedsRecook = false;
+            debugf("Finished writing %s (%u/%zu assets reused)", *PakPath, NumReusedAssets, AssetList.size());
+        }
+        else
+        {
+            errorf("Couldn't cook package %s; unable to replace the previous pak", *CookedPackagePath(true));
+            FileUtil::DeleteFile(TempPakPath);
+            mNeedsRecook = true;
+        }
     }
 
     Save();
@@ -448,6 +678,12 @@ TString CPackage::DefinitionPath(bool Relative) const
     return Relative ? RelPath : mpProject->PackagesDir(false) + RelPath;
 }
 
+TString CPackage::CookCachePath(bool Relative) const
+{
+    TString RelPath = mPakPath + mPakName + ".pkc";
+    return Relative ? RelPath : mpProject->PackagesDir(false) + RelPath;
+}
+
 TString CPackage::CookedPackagePath(bool Relative) const
 {
     TString RelPath = mPakPath + mPakName + ".pak";
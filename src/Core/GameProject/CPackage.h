@@ -58,6 +58,7 @@ public:
     void Serialize(IArchive& rArc);
     void AddResource(const TString& rkName, const CAssetID& rkID, const CFourCC& rkType);
     void UpdateDependencyCache() const;
+    void AddCachedDependencies(const std::set<CAssetID>& rkIDs) const;
     void MarkDirty();
 
     void Cook(IProgressNotifier *pProgress);
@@ -67,6 +68,9 @@ public:
     TString DefinitionPath(bool Relative) const;
     TString CookedPackagePath(bool Relative) const;
 
+    /** Records where each asset's data is in the last cooked pak, so the next cook can reuse it */
+    TString CookCachePath(bool Relative) const;
+
     // Accessors
     TString Name() const                                         { return mPakName; }
     TString Path() const                                         { return mPakPath; }
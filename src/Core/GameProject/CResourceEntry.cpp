@@ -1,15 +1,33 @@
 #include "CResourceEntry.h"
+#include "CAsyncResourceLoader.h"
 #include "CGameProject.h"
 #include "CResourceStore.h"
+#include "Core/SafeFileUtil.h"
 #include "Core/Resource/CResource.h"
 #include "Core/Resource/Cooker/CResourceCooker.h"
 #include "Core/Resource/Factory/CResourceFactory.h"
 #include <Common/FileIO.h>
 #include <Common/FileUtil.h>
 #include <Common/TString.h>
+#include <Common/Serialization/Binary.h>
 #include <Common/Serialization/CXMLReader.h>
 #include <Common/Serialization/CXMLWriter.h>
 
+namespace
+{
+
+// Raw assets are saved in the tagged binary archive format; XML is only used for explicit export/import.
+// Files without this magic are XML, from older versions or edited by hand.
+constexpr uint32 kRawAssetMagic = FOURCC('RSRW');
+
+bool IsBinaryRawAsset(const TString& rkPath)
+{
+    CFileInStream File(rkPath, EEndian::BigEndian);
+    return File.IsValid() && File.ReadULong() == kRawAssetMagic;
+}
+
+}
+
 CResourceEntry::CResourceEntry(CResourceStore *pStore)
     : mpStore(pStore)
     , mID(CAssetID::InvalidID(pStore->Game()))
@@ -147,8 +165,13 @@ void CResourceEntry::SerializeEntryInfo(IArchive& rArc, bool MetadataOnly)
         TString Dir = (mpDirectory ? mpDirectory->FullPath() : "");
 
         rArc << SerialParameter("Name", mName)
-             << SerialParameter("Directory", Dir)
-             << SerialParameter("Dependencies", mpDependencies);
+             << SerialParameter("Directory", Dir);
+
+        // Newer database caches keep dependency trees in a separate file that is read on demand
+        if (rArc.FileVersion() < static_cast<uint16>(EDatabaseVersion::ShardedDependencies))
+            rArc << SerialParameter("Dependencies", mpDependencies);
+        else if (rArc.IsReader())
+            mDependenciesCached = true;
 
         if (rArc.IsReader())
         {
@@ -159,9 +182,29 @@ void CResourceEntry::SerializeEntryInfo(IArchive& rArc, bool MetadataOnly)
     }
 }
 
-void CResourceEntry::UpdateDependencies()
+void CResourceEntry::UpdateDependencies(std::set<CAssetID> *pOutNewReferences /*= nullptr*/)
 {
+    // Resources that are already loaded may be able to bring their existing tree up to date in place
+    if (IsLoaded() && mpTypeInfo->CanHaveDependencies())
+    {
+        std::set<CAssetID> NewReferences;
+        CDependencyTree *pTree = Dependencies();
+
+        if (pTree && mpResource->UpdateDependencyTree(pTree, NewReferences))
+        {
+            mpStore->SetDependencyShardDirty(ResourceType());
+            mpStore->SetCacheDirty();
+
+            if (pOutNewReferences)
+                pOutNewReferences->insert(NewReferences.cbegin(), NewReferences.cend());
+
+            return;
+        }
+    }
+
     mpDependencies.reset();
+    mDependenciesCached = false;
+    mpStore->SetDependencyShardDirty(ResourceType());
 
     if (!mpTypeInfo->CanHaveDependencies())
     {
@@ -184,10 +227,51 @@ void CResourceEntry::UpdateDependencies()
     mpDependencies = mpResource->BuildDependencyTree();
     mpStore->SetCacheDirty();
 
+    if (pOutNewReferences)
+        mpDependencies->GetAllResourceReferences(*pOutNewReferences);
+
     if (!WasLoaded)
         mpStore->DestroyUnreferencedResources();
 }
 
+CDependencyTree* CResourceEntry::Dependencies() const
+{
+    if (mDependenciesCached)
+    {
+        mDependenciesCached = false;
+        std::vector<char> Data;
+
+        if (mpStore->ReadCachedDependencies(ResourceType(), mID, Data))
+        {
+            CBasicBinaryReader Reader(Data.data(), Data.size(), CSerialVersion(mpStore->DependencyArchiveVersion(), 0, Game()));
+            Reader << SerialParameter("Dependencies", mpDependencies);
+        }
+
+        if (!mpDependencies)
+        {
+            warnf("%s: Dependencies missing from the dependency cache; rebuilding", *CookedAssetPath(true));
+            const_cast<CResourceEntry*>(this)->UpdateDependencies();
+        }
+    }
+
+    return mpDependencies.get();
+}
+
+bool CResourceEntry::WriteDependencies(std::vector<char>& rOutData) const
+{
+    // Callers copy cached trees straight out of the dependency cache rather than reading them in
+    ASSERT(!mDependenciesCached);
+
+    if (!mpDependencies)
+        return false;
+
+    rOutData.clear();
+    CVectorOutStream MemStream(&rOutData, EEndian::BigEndian);
+    CBasicBinaryWriter Writer(&MemStream, CSerialVersion(IArchive::skCurrentArchiveVersion, 0, Game()));
+    Writer << SerialParameter("Dependencies", mpDependencies);
+    return true;
+}
+
 bool CResourceEntry::HasRawVersion() const
 {
     return FileUtil::Exists(RawAssetPath());
@@ -282,23 +366,20 @@ bool CResourceEntry::Save(bool SkipCacheSave /*= false*/, bool FlagForRecook /*=
         Load();
         if (!mpResource) return false;
 
-        // Note: We call Serialize directly for resources to avoid having a redundant resource root node in the output file.
         TString Path = RawAssetPath();
         TString Dir = Path.GetFileDirectory();
         FileUtil::MakeDirectory(Dir);
 
-        TString SerialName = mpTypeInfo->TypeName();
-        SerialName.RemoveWhitespace();
-
-        CXMLWriter Writer(Path, SerialName, 0, Game());
-        mpResource->Serialize(Writer);
+        CBinaryWriter Writer(Path, kRawAssetMagic, 0, Game());
 
-        if (!Writer.Save())
+        if (!Writer.IsValid())
         {
             errorf("Failed to save raw resource: %s", *Path);
             return false;
         }
 
+        mpResource->Serialize(Writer);
+
         if (FlagForRecook)
         {
             SetFlag(EResEntryFlag::NeedsRecook);
@@ -320,22 +401,29 @@ bool CResourceEntry::Save(bool SkipCacheSave /*= false*/, bool FlagForRecook /*=
     // Resource has been saved; now make sure metadata, dependencies, and packages are all up to date
     SetFlag(EResEntryFlag::HasBeenModified);
     SaveMetadata();
-    UpdateDependencies();
+
+    std::set<CAssetID> NewReferences;
+    UpdateDependencies(&NewReferences);
 
     if (!SkipCacheSave)
     {
         mpStore->ConditionalSaveStore();
     }
 
-    // Flag dirty any packages that contain this resource.
+    // Flag dirty any packages that contain this resource, and add anything it now references to their dependency lists.
     if (FlagForRecook)
     {
         for (size_t iPkg = 0; iPkg < mpStore->Project()->NumPackages(); iPkg++)
         {
             CPackage *pPkg = mpStore->Project()->PackageByIndex(iPkg);
 
-            if (!pPkg->NeedsRecook() && pPkg->ContainsAsset(ID()))
-                pPkg->MarkDirty();
+            if (pPkg->ContainsAsset(ID()))
+            {
+                pPkg->AddCachedDependencies(NewReferences);
+
+                if (!pPkg->NeedsRecook())
+                    pPkg->MarkDirty();
+            }
         }
     }
 
@@ -345,6 +433,68 @@ bool CResourceEntry::Save(bool SkipCacheSave /*= false*/, bool FlagForRecook /*=
     return true;
 }
 
+bool CResourceEntry::ExportRawXML(const TString& rkPath)
+{
+    ASSERT(mpTypeInfo->CanBeSerialized());
+    const bool WasLoaded = IsLoaded();
+
+    Load();
+    if (!mpResource) return false;
+
+    // Note: We call Serialize directly for resources to avoid having a redundant resource root node in the output file.
+    TString SerialName = mpTypeInfo->TypeName();
+    SerialName.RemoveWhitespace();
+
+    CXMLWriter Writer(rkPath, SerialName, 0, Game());
+    mpResource->Serialize(Writer);
+    const bool Success = Writer.Save();
+
+    if (!Success)
+        errorf("Failed to export raw resource: %s", *rkPath);
+
+    // Only unload what the export loaded itself
+    if (!WasLoaded)
+        mpStore->UnloadResource(this);
+
+    return Success;
+}
+
+bool CResourceEntry::ImportRawXML(const TString& rkPath)
+{
+    ASSERT(mpTypeInfo->CanBeSerialized());
+
+    // The imported data replaces the resource outright, so it can't be in use
+    if (IsLoaded())
+    {
+        if (mpResource->IsReferenced())
+        {
+            errorf("%s: Unable to import raw resource while it is in use", *CookedAssetPath(true));
+            return false;
+        }
+
+        mpStore->UnloadResource(this);
+    }
+
+    CXMLReader Reader(rkPath);
+
+    if (!Reader.IsValid())
+    {
+        errorf("Failed to open raw resource for import: %s", *rkPath);
+        return false;
+    }
+
+    mpResource = CResourceFactory::CreateResource(this);
+    if (!mpResource) return false;
+
+    CResourceStore *pOldStore = gpResourceStore;
+    gpResourceStore = mpStore;
+    mpResource->Serialize(Reader);
+    gpResourceStore = pOldStore;
+
+    mpStore->TrackLoadedResource(this);
+    return Save();
+}
+
 bool CResourceEntry::Cook()
 {
     Load();
@@ -354,15 +504,36 @@ bool CResourceEntry::Cook()
     TString Dir = Path.GetFileDirectory();
     FileUtil::MakeDirectory(Dir);
 
-    // Attempt to open output cooked file
-    CFileOutStream File(Path, EEndian::BigEndian);
-    if (!File.IsValid())
+    // Cook to a temporary file and swap it in afterwards. The previous cooked file stays intact
+    // while cooking, since some resources read their original data back from it.
+    const TString TempPath = Path + ".tmp";
+    bool Success = false;
     {
-        errorf("Failed to open cooked file for writing: %s", *Path);
-        return false;
+        CFileOutStream File(TempPath, EEndian::BigEndian);
+        if (!File.IsValid())
+        {
+            errorf("Failed to open cooked file for writing: %s", *TempPath);
+            return false;
+        }
+
+        Success = CResourceCooker::CookResource(this, File);
     }
 
-    bool Success = CResourceCooker::CookResource(this, File);
+    if (Success)
+    {
+        mpStore->AsyncLoader()->Discard(mID);
+        Success = SafeFileUtil::ReplaceFile(TempPath, Path);
+
+        if (!Success)
+        {
+            errorf("Failed to replace cooked file: %s", *Path);
+            FileUtil::DeleteFile(TempPath);
+        }
+    }
+    else
+    {
+        FileUtil::DeleteFile(TempPath);
+    }
 
     if (Success)
     {
@@ -393,19 +564,18 @@ CResource* CResourceEntry::Load()
             CResourceStore *pOldStore = gpResourceStore;
             gpResourceStore = mpStore;
 
-            CXMLReader Reader(RawAssetPath());
+            const TString RawPath = RawAssetPath();
+            const bool LoadSuccess = ReadRawAsset(RawPath, *mpResource);
+            gpResourceStore = pOldStore;
 
-            if (!Reader.IsValid())
+            if (!LoadSuccess)
             {
-                errorf("Failed to load raw resource; falling back on cooked. Raw path: %s", *RawAssetPath());
+                errorf("Failed to load raw resource; falling back on cooked. Raw path: %s", *RawPath);
                 mpResource.reset();
             }
-
             else
             {
-                mpResource->Serialize(Reader);
                 mpStore->TrackLoadedResource(this);
-                gpResourceStore = pOldStore;
             }
         }
 
@@ -414,6 +584,24 @@ CResource* CResourceEntry::Load()
     }
 
     ASSERT(!mpResource);
+
+    // Use the data the async loader already read or parsed on a worker thread, if it has any
+    std::unique_ptr<CResource> pPrefetched;
+    std::vector<uint8> PrefetchedData;
+
+    if (mpStore->AsyncLoader()->TakePrefetched(mID, pPrefetched, PrefetchedData))
+    {
+        if (pPrefetched)
+        {
+            mpResource = std::move(pPrefetched);
+            mpStore->TrackLoadedResource(this);
+            return mpResource.get();
+        }
+
+        CMemoryInStream Input(PrefetchedData.data(), PrefetchedData.size(), EEndian::BigEndian);
+        return LoadCooked(Input);
+    }
+
     if (HasCookedVersion())
     {
         CFileInStream File(CookedAssetPath(), EEndian::BigEndian);
@@ -434,6 +622,30 @@ CResource* CResourceEntry::Load()
     }
 }
 
+bool CResourceEntry::ReadRawAsset(const TString& rkPath, CResource& rResource)
+{
+    if (IsBinaryRawAsset(rkPath))
+    {
+        CBinaryReader Reader(rkPath, kRawAssetMagic);
+
+        if (!Reader.IsValid())
+            return false;
+
+        rResource.Serialize(Reader);
+        return true;
+    }
+    else
+    {
+        CXMLReader Reader(rkPath);
+
+        if (!Reader.IsValid())
+            return false;
+
+        rResource.Serialize(Reader);
+        return true;
+    }
+}
+
 CResource* CResourceEntry::LoadCooked(IInputStream& rInput)
 {
     // Overload to allow for load from an arbitrary input stream.
@@ -587,6 +799,9 @@ bool CResourceEntry::MoveAndRename(const TString& rkDir, const TString& rkName,
     // If we succeeded, finish the move
     if (FSMoveSuccess)
     {
+        if (mName != OldName && pOldDir != nullptr)
+            pOldDir->OnChildResourceRenamed(this, OldName);
+
         if (mpDirectory != pOldDir && pOldDir != nullptr)
         {
             FSMoveSuccess = pOldDir->RemoveChildResource(this);
@@ -647,7 +862,13 @@ void CResourceEntry::MarkDeleted(bool InDeleted)
     // un-does the deletion.
     if (IsMarkedForDeletion() != InDeleted)
     {
+        // Deleted entries are dropped from the dependency cache, so keep our tree in memory in case we're restored
+        if (InDeleted)
+            Dependencies();
+
         SetFlagEnabled(EResEntryFlag::MarkedForDeletion, InDeleted);
+        mpStore->InvalidateRegisteredIDSet();
+        mpStore->SetDependencyShardDirty(ResourceType());
 
         // Restore old name/directory if un-deleting
         if (!InDeleted)
@@ -675,6 +896,9 @@ void CResourceEntry::MarkDeleted(bool InDeleted)
         // If we are deleting...
         if (InDeleted)
         {
+            // Remove from parent directory. This is done first, while the directory can still find us by name.
+            mpDirectory->RemoveChildResource(this);
+
             // Temporarily store our directory path in the name string.
             // This is a hack, but we can't store the directory pointer because it may have been
             // deleted and remade by the user by the time the resource is un-deleted, which
@@ -682,9 +906,6 @@ void CResourceEntry::MarkDeleted(bool InDeleted)
             // the '|' character is safe because this character is not allowed in filenames
             // (which is enforced in FileUtil::IsValidName()).
             mName = mName + "|" + mpDirectory->FullPath();
-
-            // Remove from parent directory.
-            mpDirectory->RemoveChildResource(this);
             mpDirectory = nullptr;
 
             // Move any resource files out of the project into a temporary folder.
@@ -9,6 +9,8 @@
 #include <Common/CFourCC.h>
 #include <Common/Flags.h>
 #include <memory>
+#include <set>
+#include <vector>
 
 class CDependencyTree;
 class CGameProject;
@@ -32,13 +34,14 @@ class CResourceEntry
     std::unique_ptr<CResource> mpResource;
     CResTypeInfo *mpTypeInfo = nullptr;
     CResourceStore *mpStore;
-    std::unique_ptr<CDependencyTree> mpDependencies;
+    mutable std::unique_ptr<CDependencyTree> mpDependencies;
     CAssetID mID;
     CVirtualDirectory *mpDirectory = nullptr;
     TString mName;
     FResEntryFlags mFlags;
 
     mutable bool mMetadataDirty = false;
+    mutable bool mDependenciesCached = false; // Dependency tree is in the store's dependency cache and hasn't been read yet
     mutable uint64 mCachedSize = UINT64_MAX;
     mutable TString mCachedUppercaseName; // This is used to speed up case-insensitive sorting and filtering.
 
@@ -52,12 +55,18 @@ public:
     static std::unique_ptr<CResourceEntry> BuildFromArchive(CResourceStore *pStore, IArchive& rArc);
     static std::unique_ptr<CResourceEntry> BuildFromDirectory(CResourceStore *pStore, CResTypeInfo *pTypeInfo,
                                                               const TString& rkDirPath, const TString& rkName);
+
+    /** Deserialize a raw asset file (binary or XML) into an existing resource without registering it with the store */
+    static bool ReadRawAsset(const TString& rkPath, CResource& rResource);
+
     ~CResourceEntry();
 
     bool LoadMetadata();
     bool SaveMetadata(bool ForceSave = false);
     void SerializeEntryInfo(IArchive& rArc, bool MetadataOnly);
-    void UpdateDependencies();
+    void UpdateDependencies(std::set<CAssetID> *pOutNewReferences = nullptr);
+    CDependencyTree* Dependencies() const;
+    bool WriteDependencies(std::vector<char>& rOutData) const;
 
     bool HasRawVersion() const;
     bool HasCookedVersion() const;
@@ -72,6 +81,8 @@ public:
     bool NeedsRecook() const;
     bool Save(bool SkipCacheSave = false, bool FlagForRecook = true);
     bool Cook();
+    bool ExportRawXML(const TString& rkPath);
+    bool ImportRawXML(const TString& rkPath);
     CResource* Load();
     CResource* LoadCooked(IInputStream& rInput);
     bool Unload();
@@ -97,12 +108,12 @@ public:
     bool IsMarkedForDeletion() const         { return HasFlag(EResEntryFlag::MarkedForDeletion); }
 
     bool IsLoaded() const                    { return mpResource != nullptr; }
+    bool HasCachedDependencies() const       { return mDependenciesCached; }
     bool IsCategorized() const               { return mpDirectory && !mpDirectory->FullPath().CaseInsensitiveCompare( mpStore->DefaultResourceDirPath() ); }
     bool IsNamed() const                     { return mName != mID.ToString(); }
     CResource* Resource() const              { return mpResource.get(); }
     CResTypeInfo* TypeInfo() const           { return mpTypeInfo; }
     CResourceStore* ResourceStore() const    { return mpStore; }
-    CDependencyTree* Dependencies() const    { return mpDependencies.get(); }
     CAssetID ID() const                      { return mID; }
     CVirtualDirectory* Directory() const     { return mpDirectory; }
     TString DirectoryPath() const            { return mpDirectory->FullPath(); }
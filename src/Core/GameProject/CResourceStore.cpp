@@ -1,10 +1,16 @@
 #include "CResourceStore.h"
+#include "CAsyncResourceLoader.h"
 #include "CGameExporter.h"
 #include "CGameProject.h"
 #include "CResourceIterator.h"
 #include "Core/IUIRelay.h"
+#include "Core/NParallel.h"
+#include "Core/NPerfStats.h"
+#include "Core/SafeFileUtil.h"
 #include "Core/Resource/CResource.h"
+#include "Core/Resource/Factory/CUnsupportedFormatLoader.h"
 #include <Common/Macros.h>
+#include <Common/FileIO.h>
 #include <Common/FileUtil.h>
 #include <Common/Log.h>
 #include <Common/Serialization/Binary.h>
@@ -18,8 +24,18 @@ bool gTemplatesWritable = false;
 CResourceStore *gpResourceStore = nullptr;
 CResourceStore *gpEditorStore = nullptr;
 
+namespace
+{
+
+// Dependency cache layout: header with one (type, offset, size) record per shard, followed by the shards.
+// Each shard holds a table of (asset ID, offset, size) records followed by the serialized trees.
+constexpr uint32 kDependencyCacheMagic = FOURCC('DEPS');
+
+}
+
 // Constructor for editor store
 CResourceStore::CResourceStore(const TString& rkDatabasePath)
+    : mpAsyncLoader(std::make_unique<CAsyncResourceLoader>(this))
 {
     mpDatabaseRoot = new CVirtualDirectory(this);
     mDatabasePath = FileUtil::MakeAbsolute(rkDatabasePath.GetFileDirectory());
@@ -30,12 +46,14 @@ CResourceStore::CResourceStore(const TString& rkDatabasePath)
 // Main constructor for game projects and game exporter
 CResourceStore::CResourceStore(CGameProject *pProject)
     : mGame(EGame::Invalid)
+    , mpAsyncLoader(std::make_unique<CAsyncResourceLoader>(this))
 {
     SetProject(pProject);
 }
 
 CResourceStore::~CResourceStore()
 {
+    mpAsyncLoader->Clear();
     CloseProject();
     DestroyUnreferencedResources();
 }
@@ -89,6 +107,8 @@ bool CResourceStore::SerializeDatabaseCache(IArchive& rArc)
                     rArc.ParamEnd();
                 }
             }
+
+            InvalidateRegisteredIDSet();
         }
         else
         {
@@ -132,6 +152,7 @@ bool CResourceStore::SerializeDatabaseCache(IArchive& rArc)
 
 bool CResourceStore::LoadDatabaseCache()
 {
+    CScopedPerfPhase PerfPhase("Database.LoadCache");
     ASSERT(!mDatabasePath.IsEmpty());
     TString Path = DatabasePath();
 
@@ -162,6 +183,19 @@ bool CResourceStore::LoadDatabaseCache()
         }
 
         mGame = Reader.Game();
+
+        if (Reader.FileVersion() < static_cast<uint16>(EDatabaseVersion::ShardedDependencies))
+        {
+            // Dependencies were loaded inline; move them out to the dependency cache on the next save
+            for (CResourceIterator It(this); It; ++It)
+                SetDependencyShardDirty(It->ResourceType());
+
+            mDatabaseCacheDirty = true;
+        }
+        else if (!LoadDependencyCacheHeader())
+        {
+            warnf("Failed to load the dependency cache; dependencies will be rebuilt as they are requested");
+        }
     }
 
     return true;
@@ -172,7 +206,11 @@ bool CResourceStore::SaveDatabaseCache()
     TString Path = DatabasePath();
     debugf("Saving database cache...");
 
-    CBasicBinaryWriter Writer(Path, FOURCC('CACH'), 0, mGame);
+    // Dependencies go first so the database never refers to a dependency cache that failed to save
+    if (!SaveDependencyCache())
+        return false;
+
+    CBasicBinaryWriter Writer(Path, FOURCC('CACH'), static_cast<uint16>(EDatabaseVersion::Current), mGame);
 
     if (!Writer.IsValid())
         return false;
@@ -188,6 +226,293 @@ void CResourceStore::ConditionalSaveStore()
         SaveDatabaseCache();
 }
 
+bool CResourceStore::ReadCachedDependencies(EResourceType Type, const CAssetID& rkID, std::vector<char>& rOutData)
+{
+    const SDependencyShard *pkShard = LoadDependencyShard(Type);
+
+    if (!pkShard)
+        return false;
+
+    const auto Iter = pkShard->Blobs.find(rkID);
+
+    if (Iter == pkShard->Blobs.cend())
+        return false;
+
+    CFileInStream File(DependencyCachePath(), EEndian::BigEndian);
+
+    if (!File.IsValid())
+        return false;
+
+    const auto [Offset, Size] = Iter->second;
+    File.Seek(pkShard->Offset + Offset, SEEK_SET);
+    rOutData.resize(Size);
+    File.ReadBytes(rOutData.data(), Size);
+    return true;
+}
+
+void CResourceStore::SetDependencyShardDirty(EResourceType Type)
+{
+    mDirtyDependencyShards.insert(Type);
+}
+
+bool CResourceStore::LoadDependencyCacheHeader()
+{
+    mDependencyShards.clear();
+    const TString Path = DependencyCachePath();
+
+    if (!FileUtil::Exists(Path))
+        return false;
+
+    CFileInStream File(Path, EEndian::BigEndian);
+
+    if (!File.IsValid() || File.ReadULong() != kDependencyCacheMagic)
+        return false;
+
+    mDependencyArchiveVersion = File.ReadUShort();
+    const uint32 NumShards = File.ReadULong();
+
+    for (uint32 ShardIdx = 0; ShardIdx < NumShards; ShardIdx++)
+    {
+        const auto Type = static_cast<EResourceType>(File.ReadULong());
+        SDependencyShard& rShard = mDependencyShards[Type];
+        rShard.Offset = File.ReadULong();
+        rShard.Size = File.ReadULong();
+    }
+
+    return true;
+}
+
+CResourceStore::SDependencyShard* CResourceStore::LoadDependencyShard(EResourceType Type)
+{
+    const auto Iter = mDependencyShards.find(Type);
+
+    if (Iter == mDependencyShards.end())
+        return nullptr;
+
+    SDependencyShard& rShard = Iter->second;
+
+    if (!rShard.TableLoaded)
+    {
+        rShard.TableLoaded = true;
+        CFileInStream File(DependencyCachePath(), EEndian::BigEndian);
+
+        if (!File.IsValid())
+            return nullptr;
+
+        File.Seek(rShard.Offset, SEEK_SET);
+        const EIDLength IDLength = CAssetID::GameIDLength(mGame);
+        const uint32 NumTrees = File.ReadULong();
+
+        for (uint32 TreeIdx = 0; TreeIdx < NumTrees; TreeIdx++)
+        {
+            const CAssetID ID(File, IDLength);
+            const uint32 Offset = File.ReadULong();
+            const uint32 Size = File.ReadULong();
+            rShard.Blobs.insert_or_assign(ID, std::make_pair(Offset, Size));
+        }
+    }
+
+    return &rShard;
+}
+
+bool CResourceStore::SaveDependencyCache()
+{
+    CScopedPerfPhase PerfPhase("Database.SaveDependencies");
+    const TString Path = DependencyCachePath();
+
+    // Cached trees can only be copied across as-is if they were written with the current archive version
+    const bool CanCopyTrees = (mDependencyArchiveVersion == static_cast<uint16>(IArchive::skCurrentArchiveVersion) &&
+                               FileUtil::Exists(Path));
+
+    if (CanCopyTrees && mDirtyDependencyShards.empty())
+        return true;
+
+    std::map<EResourceType, std::vector<CResourceEntry*>> EntriesByType;
+
+    for (CResourceIterator It(this); It; ++It)
+    {
+        if (!CanCopyTrees && It->HasCachedDependencies())
+            It->Dependencies();
+
+        EntriesByType[It->ResourceType()].push_back(*It);
+    }
+
+    // Unchanged shards are copied straight from the existing file. Dirty shards are rebuilt; trees that
+    // were never read in are copied from the existing file, and the rest are serialized in parallel.
+    struct SShardData
+    {
+        EResourceType Type;
+        std::vector<CResourceEntry*> Entries;
+        std::vector<std::vector<char>> Trees;
+        std::vector<char> Data;
+    };
+    std::vector<SShardData> Shards;
+    std::vector<std::pair<const CResourceEntry*, std::vector<char>*>> SerializeQueue;
+
+    // The existing file is opened once, and each old shard is read out of it in one go
+    std::unique_ptr<CFileInStream> pOldFile;
+
+    if (CanCopyTrees)
+    {
+        pOldFile = std::make_unique<CFileInStream>(Path, EEndian::BigEndian);
+
+        if (!pOldFile->IsValid())
+            pOldFile.reset();
+    }
+
+    std::vector<char> OldShardData;
+
+    for (auto& [Type, rEntries] : EntriesByType)
+    {
+        SShardData& rShard = Shards.emplace_back();
+        rShard.Type = Type;
+
+        const auto OldShard = mDependencyShards.find(Type);
+        OldShardData.clear();
+
+        if (pOldFile && OldShard != mDependencyShards.cend() &&
+            static_cast<uint64>(OldShard->second.Offset) + OldShard->second.Size <= pOldFile->Size())
+        {
+            pOldFile->Seek(OldShard->second.Offset, SEEK_SET);
+            OldShardData.resize(OldShard->second.Size);
+            pOldFile->ReadBytes(OldShardData.data(), OldShardData.size());
+        }
+
+        const bool IsDirty = (mDirtyDependencyShards.find(Type) != mDirtyDependencyShards.cend());
+
+        if (!IsDirty && !OldShardData.empty())
+        {
+            rShard.Data = std::move(OldShardData);
+            continue;
+        }
+
+        // Only consult the old shard's table if its data was actually read
+        const SDependencyShard *pkOldShard = (OldShardData.empty() ? nullptr : LoadDependencyShard(Type));
+
+        auto CopyOldTree = [pkOldShard, &OldShardData](const CAssetID& rkID, std::vector<char>& rOutTree)
+        {
+            if (!pkOldShard)
+                return false;
+
+            const auto Blob = pkOldShard->Blobs.find(rkID);
+
+            if (Blob == pkOldShard->Blobs.cend())
+                return false;
+
+            const auto [Offset, Size] = Blob->second;
+
+            if (static_cast<size_t>(Offset) + Size > OldShardData.size())
+                return false;
+
+            rOutTree.assign(OldShardData.cbegin() + Offset, OldShardData.cbegin() + Offset + Size);
+            return true;
+        };
+
+        rShard.Entries = std::move(rEntries);
+        rShard.Trees.resize(rShard.Entries.size());
+
+        for (size_t EntryIdx = 0; EntryIdx < rShard.Entries.size(); EntryIdx++)
+        {
+            const CResourceEntry *pkEntry = rShard.Entries[EntryIdx];
+
+            if (pkEntry->HasCachedDependencies())
+            {
+                if (CopyOldTree(pkEntry->ID(), rShard.Trees[EntryIdx]))
+                    continue;
+
+                // The tree can't be copied, so read it in the usual way, which rebuilds it if necessary
+                pkEntry->Dependencies();
+            }
+
+            SerializeQueue.emplace_back(pkEntry, &rShard.Trees[EntryIdx]);
+        }
+    }
+
+    pOldFile.reset();
+
+    NParallel::ParallelFor(SerializeQueue.size(), [&SerializeQueue](size_t Index)
+    {
+        SerializeQueue[Index].first->WriteDependencies(*SerializeQueue[Index].second);
+    });
+
+    // Build the tables for the rebuilt shards
+    const uint32 IDSize = static_cast<uint32>(CAssetID::GameIDLength(mGame));
+
+    for (SShardData& rShard : Shards)
+    {
+        if (rShard.Entries.empty())
+            continue;
+
+        uint32 NumTrees = 0;
+
+        for (const auto& rkTree : rShard.Trees)
+        {
+            if (!rkTree.empty())
+                NumTrees++;
+        }
+
+        CVectorOutStream ShardOut(&rShard.Data, EEndian::BigEndian);
+        ShardOut.WriteULong(NumTrees);
+        uint32 TreeOffset = 4 + NumTrees * (IDSize + 8);
+
+        for (size_t EntryIdx = 0; EntryIdx < rShard.Entries.size(); EntryIdx++)
+        {
+            const std::vector<char>& rkTree = rShard.Trees[EntryIdx];
+
+            if (rkTree.empty())
+                continue;
+
+            rShard.Entries[EntryIdx]->ID().Write(ShardOut);
+            ShardOut.WriteULong(TreeOffset);
+            ShardOut.WriteULong(static_cast<uint32>(rkTree.size()));
+            TreeOffset += static_cast<uint32>(rkTree.size());
+        }
+
+        for (const auto& rkTree : rShard.Trees)
+            ShardOut.WriteBytes(rkTree.data(), rkTree.size());
+    }
+
+    // Write the new file alongside the old one, since unchanged shards may still be read out of it
+    const TString TempPath = Path + ".tmp";
+    {
+        CFileOutStream File(TempPath, EEndian::BigEndian);
+
+        if (!File.IsValid())
+        {
+            errorf("Failed to save dependency cache: %s", *Path);
+            return false;
+        }
+
+        File.WriteULong(kDependencyCacheMagic);
+        File.WriteUShort(static_cast<uint16>(IArchive::skCurrentArchiveVersion));
+        File.WriteULong(static_cast<uint32>(Shards.size()));
+        uint32 ShardOffset = 10 + static_cast<uint32>(Shards.size()) * 12;
+
+        for (const SShardData& rkShard : Shards)
+        {
+            File.WriteULong(static_cast<uint32>(rkShard.Type));
+            File.WriteULong(ShardOffset);
+            File.WriteULong(static_cast<uint32>(rkShard.Data.size()));
+            ShardOffset += static_cast<uint32>(rkShard.Data.size());
+        }
+
+        for (const SShardData& rkShard : Shards)
+            File.WriteBytes(rkShard.Data.data(), rkShard.Data.size());
+    }
+
+    if (!SafeFileUtil::ReplaceFile(TempPath, Path))
+    {
+        errorf("Failed to replace dependency cache: %s", *Path);
+        FileUtil::DeleteFile(TempPath);
+        return false;
+    }
+
+    // Shard offsets have changed, so tables will need to be reloaded for any trees that still haven't been read
+    mDirtyDependencyShards.clear();
+    LoadDependencyCacheHeader();
+    return true;
+}
+
 void CResourceStore::SetProject(CGameProject *pProj)
 {
     if (mpProj == pProj)
@@ -228,7 +553,7 @@ void CResourceStore::CloseProject()
 
         for (const auto& entry : mLoadedResources)
         {
-            const CResourceEntry *pEntry = entry.second;
+            const CResourceEntry *pEntry = entry.second.pEntry;
             warnf("\t%s.%s", *pEntry->Name(), *pEntry->CookedExtension().ToString());
         }
 
@@ -237,6 +562,9 @@ void CResourceStore::CloseProject()
 
     // Delete all entries from old project
     mResourceEntries.clear();
+    InvalidateRegisteredIDSet();
+    mDependencyShards.clear();
+    mDirtyDependencyShards.clear();
 
     // Clear deleted files from previous runs
     const TString DeletedPath = DeletedResourcePath();
@@ -330,18 +658,20 @@ bool CResourceStore::AreAllEntriesValid() const
 void CResourceStore::ClearDatabase()
 {
     // THIS OPERATION REQUIRES THAT ALL RESOURCES ARE UNREFERENCED
+    mpAsyncLoader->Clear();
     DestroyUnreferencedResources();
 
     if (!mLoadedResources.empty())
     {
         debugf("ERROR: Resources still loaded:");
-        for (const auto& [asset, entry] : mLoadedResources)
-            debugf("\t[%s] %s", *asset.ToString(), *entry->CookedAssetPath(true));
+        for (const auto& [asset, loaded] : mLoadedResources)
+            debugf("\t[%s] %s", *asset.ToString(), *loaded.pEntry->CookedAssetPath(true));
         ASSERT(false);
     }
 
     // Clear out existing resource entries and directories
     mResourceEntries.clear();
+    InvalidateRegisteredIDSet();
 
     delete mpDatabaseRoot;
     mpDatabaseRoot = new CVirtualDirectory(this);
@@ -352,6 +682,7 @@ void CResourceStore::ClearDatabase()
 bool CResourceStore::BuildFromDirectory(bool ShouldGenerateCacheFile)
 {
     ASSERT(mResourceEntries.empty());
+    CScopedPerfPhase PerfPhase("Database.BuildFromDirectory");
 
     // Get list of resources
     TString ResDir = ResourcesDir();
@@ -396,6 +727,9 @@ bool CResourceStore::BuildFromDirectory(bool ShouldGenerateCacheFile)
         }
     }
 
+    InvalidateRegisteredIDSet();
+    PerfPhase.AddItems(mResourceEntries.size());
+
     // Generate new cache file
     if (ShouldGenerateCacheFile)
     {
@@ -408,9 +742,16 @@ bool CResourceStore::BuildFromDirectory(bool ShouldGenerateCacheFile)
             mpProj->AudioManager()->LoadAssets();
 
         // Update dependencies
+        CScopedPerfPhase DependencyPhase("Database.UpdateDependencies");
+        PrescanAssetReferences();
+
         for (CResourceIterator It(this); It; ++It)
             It->UpdateDependencies();
 
+        DependencyPhase.AddItems(mResourceEntries.size());
+
+        mPrescannedReferences.clear();
+
         // Update database file
         mDatabaseCacheDirty = true;
         ConditionalSaveStore();
@@ -436,6 +777,75 @@ bool CResourceStore::IsResourceRegistered(const CAssetID& rkID) const
     return FindEntry(rkID) != nullptr;
 }
 
+std::shared_ptr<const CAssetIDSet> CResourceStore::RegisteredIDSet() const
+{
+    // Callers get their own reference, so the set stays valid for them even if it's invalidated meanwhile
+    std::lock_guard<std::mutex> Lock(mRegisteredIDSetMutex);
+
+    if (!mpRegisteredIDSet)
+    {
+        auto pIDSet = std::make_shared<CAssetIDSet>();
+        pIDSet->Build(*this);
+        mpRegisteredIDSet = std::move(pIDSet);
+    }
+
+    return mpRegisteredIDSet;
+}
+
+void CResourceStore::InvalidateRegisteredIDSet()
+{
+    std::lock_guard<std::mutex> Lock(mRegisteredIDSetMutex);
+    mpRegisteredIDSet.reset();
+}
+
+void CResourceStore::PrescanAssetReferences()
+{
+    // Formats we can't parse are searched for asset IDs by brute force, which is by far the slowest
+    // part of their dependency update. Scan all of them across worker threads before the (serial)
+    // dependency pass so the loaders only need to filter the precomputed results.
+    std::vector<CResourceEntry*> Entries;
+
+    for (CResourceIterator It(this); It; ++It)
+    {
+        if (CUnsupportedFormatLoader::UsesReferenceScan(*It) && !It->HasRawVersion() && It->HasCookedVersion())
+            Entries.push_back(*It);
+    }
+
+    if (Entries.empty())
+        return;
+
+    const std::shared_ptr<const CAssetIDSet> pkIDSet = RegisteredIDSet();
+    const EIDLength IDLength = CAssetID::GameIDLength(mGame);
+    std::vector<SAssetScanResult> Results(Entries.size());
+
+    NParallel::ParallelFor(Entries.size(), [&](size_t Idx)
+    {
+        CFileInStream File(Entries[Idx]->CookedAssetPath(), EEndian::BigEndian);
+
+        if (!File.IsValid())
+            return;
+
+        std::vector<uint8> Data(File.Size());
+        File.ReadBytes(Data.data(), Data.size());
+
+        SAssetScanResult& rResult = Results[Idx];
+        rResult.ScannedSize = Data.size();
+        CAssetIDScanner::Scan(Data.data(), Data.size(), IDLength, *pkIDSet, rResult.Hits);
+    });
+
+    for (size_t Idx = 0; Idx < Entries.size(); Idx++)
+    {
+        if (Results[Idx].ScannedSize > 0)
+            mPrescannedReferences.insert_or_assign(Entries[Idx]->ID(), std::move(Results[Idx]));
+    }
+}
+
+const SAssetScanResult* CResourceStore::FindPrescannedReferences(const CAssetID& rkID) const
+{
+    const auto Found = mPrescannedReferences.find(rkID);
+    return (Found == mPrescannedReferences.cend() ? nullptr : &Found->second);
+}
+
 CResourceEntry* CResourceStore::CreateNewResource(const CAssetID& rkID, EResourceType Type, const TString& rkDir, const TString& rkName, bool ExistingResource /*= false*/)
 {
     CResourceEntry *pEntry = FindEntry(rkID);
@@ -454,6 +864,7 @@ CResourceEntry* CResourceStore::CreateNewResource(const CAssetID& rkID, EResourc
 
             mResourceEntries.insert_or_assign(rkID, std::move(res));
             mDatabaseCacheDirty = true;
+            InvalidateRegisteredIDSet();
 
             if (resPtr->IsLoaded())
             {
@@ -546,49 +957,125 @@ void CResourceStore::TrackLoadedResource(CResourceEntry *pEntry)
 {
     ASSERT(pEntry->IsLoaded());
     ASSERT(mLoadedResources.find(pEntry->ID()) == mLoadedResources.end());
-    mLoadedResources.insert_or_assign(pEntry->ID(), pEntry);
+
+    SLoadedResource& rLoaded = mLoadedResources[pEntry->ID()];
+    rLoaded.pEntry = pEntry;
+
+    // Nothing holds a reference to a freshly loaded resource yet
+    if (!pEntry->Resource()->IsReferenced())
+        OnResourceUnreferenced(pEntry);
+    else
+        UpdateMemoryUsage(rLoaded);
+}
+
+void CResourceStore::OnResourceReferenced(CResourceEntry *pEntry)
+{
+    const auto It = mLoadedResources.find(pEntry->ID());
+
+    // Not tracked until loading finishes
+    if (It == mLoadedResources.end() || It->second.pEntry != pEntry)
+        return;
+
+    SLoadedResource& rLoaded = It->second;
+
+    if (rLoaded.IsEvictable)
+    {
+        mEvictionQueue.erase(rLoaded.EvictionPos);
+        rLoaded.IsEvictable = false;
+    }
+
+    UpdateMemoryUsage(rLoaded);
+}
+
+void CResourceStore::OnResourceUnreferenced(CResourceEntry *pEntry)
+{
+    const auto It = mLoadedResources.find(pEntry->ID());
+
+    // Resources that are still being loaded are tracked once loading finishes
+    if (It == mLoadedResources.end() || It->second.pEntry != pEntry)
+        return;
+
+    SLoadedResource& rLoaded = It->second;
+
+    if (rLoaded.IsEvictable)
+        mEvictionQueue.erase(rLoaded.EvictionPos);
+
+    rLoaded.EvictionPos = mEvictionQueue.insert(mEvictionQueue.end(), pEntry);
+    rLoaded.IsEvictable = true;
+
+    UpdateMemoryUsage(rLoaded);
 }
 
 void CResourceStore::DestroyUnreferencedResources()
 {
-    // This can be updated to avoid the do-while loop when reference lookup is implemented.
-    uint32 NumDeleted;
+    // Unloading a resource releases its dependencies, which appends any that became unreferenced to the
+    // queue, so a single pass over the queue destroys everything that isn't referenced.
+    while (!mEvictionQueue.empty())
+        UnloadTrackedResource(mEvictionQueue.front());
+}
+
+bool CResourceStore::UnloadResource(CResourceEntry *pEntry)
+{
+    const auto It = mLoadedResources.find(pEntry->ID());
+
+    if (It == mLoadedResources.end() || pEntry->Resource()->IsReferenced())
+        return false;
 
-    do
+    if (It->second.IsEvictable)
     {
-        NumDeleted = 0;
-        auto It = mLoadedResources.begin();
+        mEvictionQueue.erase(It->second.EvictionPos);
+        It->second.IsEvictable = false;
+    }
 
-        while (It != mLoadedResources.end())
-        {
-            CResourceEntry *pEntry = It->second;
+    // Unloading releases the resource's dependencies, and any that nothing else uses anymore are appended to the
+    // queue. Those are unloaded as well; resources that were already in the queue beforehand are left alone.
+    const bool HadQueuedResources = !mEvictionQueue.empty();
+    const auto LastQueued = (HadQueuedResources ? std::prev(mEvictionQueue.end()) : mEvictionQueue.end());
 
-            if (!pEntry->Resource()->IsReferenced() && pEntry->Unload())
-            {
-                It = mLoadedResources.erase(It);
-                NumDeleted++;
-            }
-            else
-            {
-                ++It;
-            }
-        }
-    } while (NumDeleted > 0);
+    if (!UnloadTrackedResource(pEntry))
+        return false;
+
+    while (true)
+    {
+        const auto NextIt = (HadQueuedResources ? std::next(LastQueued) : mEvictionQueue.begin());
+
+        if (NextIt == mEvictionQueue.end())
+            break;
+
+        UnloadTrackedResource(*NextIt);
+    }
+
+    return true;
+}
+
+void CResourceStore::TrimResidentMemory()
+{
+    while (mResidentMemory.Total() > mMemoryBudget && !mEvictionQueue.empty())
+        UnloadTrackedResource(mEvictionQueue.front());
+}
+
+std::map<EResourceType, SResourceMemoryUsage> CResourceStore::ResidentMemoryByType()
+{
+    std::map<EResourceType, SResourceMemoryUsage> Out;
+
+    for (auto& [ID, rLoaded] : mLoadedResources)
+    {
+        UpdateMemoryUsage(rLoaded);
+        Out[rLoaded.pEntry->ResourceType()] += rLoaded.Memory;
+    }
+
+    return Out;
 }
 
 bool CResourceStore::DeleteResourceEntry(CResourceEntry *pEntry)
 {
     const CAssetID ID = pEntry->ID();
 
-    if (pEntry->IsLoaded())
-    {
-        if (!pEntry->Unload())
-            return false;
+    if (pEntry->IsLoaded() && !UnloadTrackedResource(pEntry))
+        return false;
 
-        const auto It = mLoadedResources.find(ID);
-        ASSERT(It != mLoadedResources.end());
-        mLoadedResources.erase(It);
-    }
+    // A worker may still be reading the entry's file, so drop its prefetch before it goes away
+    mpAsyncLoader->Discard(ID);
 
     if (pEntry->Directory())
         pEntry->Directory()->RemoveChildResource(pEntry);
@@ -596,6 +1083,7 @@ bool CResourceStore::DeleteResourceEntry(CResourceEntry *pEntry)
     const auto It = mResourceEntries.find(ID);
     ASSERT(It != mResourceEntries.end());
     mResourceEntries.erase(It);
+    InvalidateRegisteredIDSet();
 
     delete pEntry;
     return true;
@@ -704,3 +1192,33 @@ TString CResourceStore::StaticDefaultResourceDirPath(EGame Game)
 {
     return Game < EGame::CorruptionProto ? "Uncategorized/" : "uncategorized/";
 }
+
+// ************ PRIVATE ************
+void CResourceStore::UpdateMemoryUsage(SLoadedResource& rLoaded)
+{
+    // Re-measured whenever the resource changes hands, to pick up GL buffers created since it was loaded
+    mResidentMemory -= rLoaded.Memory;
+    rLoaded.Memory = rLoaded.pEntry->Resource()->MemoryUsage();
+    mResidentMemory += rLoaded.Memory;
+}
+
+bool CResourceStore::UnloadTrackedResource(CResourceEntry *pEntry)
+{
+    auto It = mLoadedResources.find(pEntry->ID());
+    ASSERT(It != mLoadedResources.end());
+
+    if (It->second.IsEvictable)
+    {
+        mEvictionQueue.erase(It->second.EvictionPos);
+        It->second.IsEvictable = false;
+    }
+
+    if (!pEntry->Unload())
+        return false;
+
+    // Unloading may have released and queued up other resources; look the entry up again
+    It = mLoadedResources.find(pEntry->ID());
+    mResidentMemory -= It->second.Memory;
+    mLoadedResources.erase(It);
+    return true;
+}
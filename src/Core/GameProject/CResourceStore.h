@@ -1,23 +1,31 @@
 #ifndef CRESOURCESTORE_H
 #define CRESOURCESTORE_H
 
+#include "CAssetIDScanner.h"
 #include "CVirtualDirectory.h"
 #include "Core/Resource/EResType.h"
+#include "Core/Resource/SResourceMemoryUsage.h"
 #include <Common/CAssetID.h>
 #include <Common/CFourCC.h>
 #include <Common/FileUtil.h>
 #include <Common/TString.h>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
 
+class CAsyncResourceLoader;
 class CGameExporter;
 class CGameProject;
+class CParticleEffect;
 class CResource;
 
 enum class EDatabaseVersion
 {
     Initial,
+    ShardedDependencies,
     // Add new versions before this line
 
     Max,
@@ -32,9 +40,50 @@ class CResourceStore
     EGame mGame{EGame::Prime};
     CVirtualDirectory *mpDatabaseRoot = nullptr;
     std::map<CAssetID, std::unique_ptr<CResourceEntry>> mResourceEntries;
-    std::map<CAssetID, CResourceEntry*> mLoadedResources;
     bool mDatabaseCacheDirty = false;
 
+    // Loaded resources, along with their last measured memory usage
+    struct SLoadedResource
+    {
+        CResourceEntry *pEntry = nullptr;
+        SResourceMemoryUsage Memory;
+        bool IsEvictable = false;
+        std::list<CResourceEntry*>::iterator EvictionPos;
+    };
+    std::map<CAssetID, SLoadedResource> mLoadedResources;
+
+    // Loaded resources that aren't referenced by anything, least recently released first
+    std::list<CResourceEntry*> mEvictionQueue;
+    SResourceMemoryUsage mResidentMemory;
+    uint64 mMemoryBudget = UINT64_MAX;
+
+    // Lookup set for brute-force asset reference scans; built on demand and dropped whenever entries change
+    mutable std::shared_ptr<const CAssetIDSet> mpRegisteredIDSet;
+    mutable std::mutex mRegisteredIDSetMutex;
+
+    // Asset reference scan results computed up front on worker threads during database rebuilds
+    std::map<CAssetID, SAssetScanResult> mPrescannedReferences;
+
+    // Dependency trees are stored outside the database cache, sharded by resource type, and only
+    // read in when an entry's dependencies are first requested
+    struct SDependencyShard
+    {
+        uint32 Offset = 0;
+        uint32 Size = 0;
+        bool TableLoaded = false;
+        std::map<CAssetID, std::pair<uint32, uint32>> Blobs; // Offset relative to the shard, size
+    };
+    std::map<EResourceType, SDependencyShard> mDependencyShards;
+    std::set<EResourceType> mDirtyDependencyShards;
+    uint16 mDependencyArchiveVersion = 0;
+
+    // Background reads of resources that are about to be loaded. Declared after the entries so it's
+    // destroyed first, since its workers hold entry pointers.
+    std::unique_ptr<CAsyncResourceLoader> mpAsyncLoader;
+
+    // Compiled particle effects, shared between every preview of the same asset
+    std::map<CAssetID, std::weak_ptr<const CParticleEffect>> mParticleEffects;
+
     // Directory paths
     TString mDatabasePath;
     bool mDatabasePathExists = false;
@@ -57,6 +106,10 @@ public:
     TString DeletedResourcePath() const;
 
     bool IsResourceRegistered(const CAssetID& rkID) const;
+    std::shared_ptr<const CAssetIDSet> RegisteredIDSet() const;
+    void InvalidateRegisteredIDSet();
+    void PrescanAssetReferences();
+    const SAssetScanResult* FindPrescannedReferences(const CAssetID& rkID) const;
     CResourceEntry* CreateNewResource(const CAssetID& rkID, EResourceType Type, const TString& rkDir, const TString& rkName, bool ExistingResource = false);
     CResourceEntry* FindEntry(const CAssetID& rkID) const;
     CResourceEntry* FindEntry(const TString& rkPath) const;
@@ -69,10 +122,23 @@ public:
     CResource* LoadResource(const CAssetID& rkID);
     CResource* LoadResource(const CAssetID& rkID, EResourceType Type);
     CResource* LoadResource(const TString& rkPath);
+
+    /**
+     * Loaded resource bookkeeping, called by CResourceEntry and by CResource::Lock/Release. Like the rest
+     * of the store, these aren't thread safe and must only be called from the thread that owns the store.
+     */
     void TrackLoadedResource(CResourceEntry *pEntry);
+    void OnResourceReferenced(CResourceEntry *pEntry);
+    void OnResourceUnreferenced(CResourceEntry *pEntry);
     void DestroyUnreferencedResources();
+    bool UnloadResource(CResourceEntry *pEntry);
+    void TrimResidentMemory();
+    std::map<EResourceType, SResourceMemoryUsage> ResidentMemoryByType();
     bool DeleteResourceEntry(CResourceEntry *pEntry);
 
+    bool ReadCachedDependencies(EResourceType Type, const CAssetID& rkID, std::vector<char>& rOutData);
+    void SetDependencyShardDirty(EResourceType Type);
+
     void ImportNamesFromPakContentsTxt(const TString& rkTxtPath, bool UnnamedOnly);
 
     static bool IsValidResourcePath(const TString& rkPath, const TString& rkName);
@@ -85,13 +151,28 @@ public:
     bool DatabasePathExists() const          { return mDatabasePathExists; }
     TString ResourcesDir() const             { return IsEditorStore() ? DatabaseRootPath() : DatabaseRootPath() + "Resources/"; }
     TString DatabasePath() const             { return DatabaseRootPath() + "ResourceDatabaseCache.bin"; }
+    TString DependencyCachePath() const      { return DatabaseRootPath() + "ResourceDependencyCache.bin"; }
     CVirtualDirectory* RootDirectory() const { return mpDatabaseRoot; }
     uint32 NumTotalResources() const         { return mResourceEntries.size(); }
     uint32 NumLoadedResources() const        { return mLoadedResources.size(); }
+    uint32 NumEvictableResources() const     { return mEvictionQueue.size(); }
+    SResourceMemoryUsage ResidentMemory() const { return mResidentMemory; }
+    uint64 MemoryBudget() const              { return mMemoryBudget; }
+    uint16 DependencyArchiveVersion() const  { return mDependencyArchiveVersion; }
+    CAsyncResourceLoader* AsyncLoader() const { return mpAsyncLoader.get(); }
+    std::map<CAssetID, std::weak_ptr<const CParticleEffect>>& ParticleEffectCache() { return mParticleEffects; }
     bool IsCacheDirty() const                { return mDatabaseCacheDirty; }
 
     void SetCacheDirty()                     { mDatabaseCacheDirty = true; }
+    void SetMemoryBudget(uint64 Bytes)       { mMemoryBudget = Bytes; }
     bool IsEditorStore() const               { return mpProj == nullptr; }
+
+private:
+    void UpdateMemoryUsage(SLoadedResource& rLoaded);
+    bool UnloadTrackedResource(CResourceEntry *pEntry);
+    bool LoadDependencyCacheHeader();
+    SDependencyShard* LoadDependencyShard(EResourceType Type);
+    bool SaveDependencyCache();
 };
 
 extern TString gDataDir;
@@ -145,14 +145,15 @@ CResourceEntry* CVirtualDirectory::FindChildResource(const TString& rkPath)
 
 CResourceEntry* CVirtualDirectory::FindChildResource(const TString& rkName, EResourceType Type)
 {
-    const auto it = std::find_if(mResources.begin(), mResources.end(), [&](const auto* resource) {
-        return rkName.CaseInsensitiveCompare(resource->Name()) && resource->ResourceType() == Type;
-    });
+    const auto [Begin, End] = mResourceNameIndex.equal_range(*rkName.ToUpper());
 
-    if (it == mResources.cend())
-        return nullptr;
+    for (auto It = Begin; It != End; ++It)
+    {
+        if (It->second->ResourceType() == Type)
+            return It->second;
+    }
 
-    return *it;
+    return nullptr;
 }
 
 bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
@@ -161,7 +162,7 @@ bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
     {
         if (pEntry != nullptr)
         {
-            mResources.push_back(pEntry);
+            AddChildResource(pEntry);
             return true;
         }
 
@@ -218,7 +219,7 @@ bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
             }
 
             if (pEntry != nullptr)
-                pSubdir->mResources.push_back(pEntry);
+                pSubdir->AddChildResource(pEntry);
 
             return true;
         }
@@ -269,9 +270,33 @@ bool CVirtualDirectory::RemoveChildResource(CResourceEntry *pEntry)
         return false;
 
     mResources.erase(it);
+
+    // The entry is indexed under its current name, unless it was renamed without telling us
+    auto [Begin, End] = mResourceNameIndex.equal_range(*pEntry->Name().ToUpper());
+    auto IndexIt = std::find_if(Begin, End, [pEntry](const auto& rkPair) { return rkPair.second == pEntry; });
+
+    if (IndexIt == End)
+    {
+        IndexIt = std::find_if(mResourceNameIndex.begin(), mResourceNameIndex.end(), [pEntry](const auto& rkPair) { return rkPair.second == pEntry; });
+        ASSERT(IndexIt != mResourceNameIndex.end());
+    }
+
+    mResourceNameIndex.erase(IndexIt);
     return true;
 }
 
+void CVirtualDirectory::OnChildResourceRenamed(CResourceEntry *pEntry, const TString& rkOldName)
+{
+    auto [Begin, End] = mResourceNameIndex.equal_range(*rkOldName.ToUpper());
+    const auto IndexIt = std::find_if(Begin, End, [pEntry](const auto& rkPair) { return rkPair.second == pEntry; });
+
+    if (IndexIt != End)
+    {
+        mResourceNameIndex.erase(IndexIt);
+        mResourceNameIndex.emplace(*pEntry->Name().ToUpper(), pEntry);
+    }
+}
+
 void CVirtualDirectory::SortSubdirectories()
 {
     std::sort(mSubdirectories.begin(), mSubdirectories.end(), [](const auto* pLeft, const auto* pRight) {
@@ -395,6 +420,13 @@ bool CVirtualDirectory::SetParent(CVirtualDirectory *pParent)
     }
 }
 
+// ************ PRIVATE ************
+void CVirtualDirectory::AddChildResource(CResourceEntry *pEntry)
+{
+    mResources.push_back(pEntry);
+    mResourceNameIndex.emplace(*pEntry->Name().ToUpper(), pEntry);
+}
+
 // ************ STATIC ************
 bool CVirtualDirectory::IsValidDirectoryName(const TString& rkName)
 {
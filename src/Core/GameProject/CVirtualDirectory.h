@@ -5,6 +5,8 @@
 #include "Core/Resource/EResType.h"
 #include <Common/Macros.h>
 #include <Common/TString.h>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 class CResourceEntry;
@@ -18,6 +20,11 @@ class CVirtualDirectory
     std::vector<CVirtualDirectory*> mSubdirectories;
     std::vector<CResourceEntry*> mResources;
 
+    // Resources keyed by uppercase name, so lookups by name don't have to scan the whole directory
+    std::unordered_multimap<std::string, CResourceEntry*> mResourceNameIndex;
+
+    void AddChildResource(CResourceEntry *pEntry);
+
 public:
     explicit CVirtualDirectory(CResourceStore *pStore);
     CVirtualDirectory(const TString& rkName, CResourceStore *pStore);
@@ -37,6 +44,7 @@ public:
     bool AddChild(CVirtualDirectory *pDir);
     bool RemoveChildDirectory(CVirtualDirectory *pSubdir);
     bool RemoveChildResource(CResourceEntry *pEntry);
+    void OnChildResourceRenamed(CResourceEntry *pEntry, const TString& rkOldName);
     void SortSubdirectories();
     bool Rename(const TString& rkNewName);
     bool Delete();
@@ -1,3 +1,33 @@
 #include "IProgressNotifier.h"
 
 CNullProgressNotifier *gpNullProgress = new CNullProgressNotifier();
+
+SProgressTelemetry IProgressNotifier::Telemetry() const
+{
+    SProgressTelemetry Out;
+    Out.ElapsedSeconds = std::chrono::duration<double>(NPerfStats::Clock::now() - mTaskStartTime).count();
+    Out.NumBytes = mTaskBytes.load(std::memory_order_relaxed);
+    Out.NumItems = mTaskItems.load(std::memory_order_relaxed);
+
+    // Estimates made in the first couple percent of a task are mostly noise
+    const double Fraction = mTaskFraction;
+
+    if (Fraction >= 0.02 && Fraction < 1.0)
+        Out.RemainingSeconds = Out.ElapsedSeconds * (1.0 - Fraction) / Fraction;
+
+    return Out;
+}
+
+// ************ PRIVATE ************
+void IProgressNotifier::EndTask()
+{
+    const NPerfStats::Clock::time_point Now = NPerfStats::Clock::now();
+
+    if (mRecordTaskPhases && !mTaskName.IsEmpty() && NPerfStats::IsActive())
+        NPerfStats::RecordPhase("Task: " + mTaskName, mTaskStartTime, Now, mTaskBytes, mTaskItems);
+
+    mTaskStartTime = Now;
+    mTaskFraction = 0.0;
+    mTaskBytes = 0;
+    mTaskItems = 0;
+}
@@ -1,8 +1,22 @@
 #ifndef IPROGRESSNOTIFIER_H
 #define IPROGRESSNOTIFIER_H
 
+#include "NPerfStats.h"
 #include <Common/Common.h>
 #include <Common/Math/MathUtil.h>
+#include <atomic>
+
+/** Elapsed time, throughput and estimated time remaining for the current task */
+struct SProgressTelemetry
+{
+    double ElapsedSeconds = 0.0;
+    double RemainingSeconds = -1.0; // Negative until enough progress has been made to estimate
+    uint64 NumBytes = 0;
+    uint64 NumItems = 0;
+
+    double BytesPerSecond() const   { return ElapsedSeconds > 0.0 ? (double) NumBytes / ElapsedSeconds : 0.0; }
+    double ItemsPerSecond() const   { return ElapsedSeconds > 0.0 ? (double) NumItems / ElapsedSeconds : 0.0; }
+};
 
 class IProgressNotifier
 {
@@ -10,12 +24,28 @@ class IProgressNotifier
     int mTaskIndex = 0;
     int mTaskCount = 1;
 
+    // Telemetry for the current task. The counters may be updated from worker threads.
+    NPerfStats::Clock::time_point mTaskStartTime = NPerfStats::Clock::now();
+    std::atomic<double> mTaskFraction{0.0};
+    std::atomic<uint64> mTaskBytes{0};
+    std::atomic<uint64> mTaskItems{0};
+
+    void EndTask();
+
+protected:
+    /** Whether finished tasks are recorded as perf phases ("Task: <name>") when stats or a trace are being collected */
+    bool mRecordTaskPhases = true;
+
 public:
     IProgressNotifier() = default;
-    virtual ~IProgressNotifier() = default;
+    virtual ~IProgressNotifier()
+    {
+        EndTask();
+    }
 
     void SetNumTasks(int NumTasks)
     {
+        EndTask();
         mTaskName = "";
         mTaskIndex = 0;
         mTaskCount = NumTasks;
@@ -23,6 +53,7 @@ public:
 
     void SetTask(int TaskIndex, TString TaskName)
     {
+        EndTask();
         mTaskName = std::move(TaskName);
         mTaskIndex = TaskIndex;
         mTaskCount = Math::Max(mTaskCount, TaskIndex + 1);
@@ -40,6 +71,7 @@ public:
         double TaskPercent = 1.f / (double) TaskCount;
         double StepPercent = (StepCount >= 0 ? (double) StepIndex / (double) StepCount : 0.f);
         double ProgressPercent = (TaskPercent * mTaskIndex) + (TaskPercent * StepPercent);
+        mTaskFraction = StepPercent;
         UpdateProgress(mTaskName, rkStepDesc, (float) ProgressPercent);
     }
 
@@ -55,6 +87,15 @@ public:
         Report(0, 0, "");
     }
 
+    /** Add to the amount of data processed by the current task. Safe to call from any thread. */
+    void ReportProcessed(uint64 NumBytes, uint64 NumItems = 0)
+    {
+        mTaskBytes.fetch_add(NumBytes, std::memory_order_relaxed);
+        mTaskItems.fetch_add(NumItems, std::memory_order_relaxed);
+    }
+
+    SProgressTelemetry Telemetry() const;
+
     virtual bool ShouldCancel() const = 0;
 
 protected:
@@ -65,6 +106,9 @@ protected:
 class CNullProgressNotifier : public IProgressNotifier
 {
 public:
+    // Shared by unrelated callers, so its tasks don't mean anything as phases
+    CNullProgressNotifier() { mRecordTaskPhases = false; }
+
     bool ShouldCancel() const override{ return false; }
 protected:
     void UpdateProgress(const TString&, const TString&, float) override {}
@@ -1,9 +1,15 @@
 #include "NCoreTests.h"
 #include "IUIRelay.h"
+#include "NParallel.h"
 #include "Core/GameProject/CGameProject.h"
 #include "Core/GameProject/CResourceEntry.h"
 #include "Core/GameProject/CResourceIterator.h"
+#include "Core/Resource/CResTypeInfo.h"
 #include "Core/Resource/Cooker/CResourceCooker.h"
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <map>
 
 namespace NCoreTests
 {
@@ -46,23 +52,60 @@ bool ParseToken(const char* pkToken, int argc, char* argv[])
     return false;
 }
 
+/** Parses a comma-separated list of resource types. "All" selects every cookable type. */
+bool ParseResourceTypes(const char* pkTypes, std::vector<EResourceType>& rOutTypes)
+{
+    if (!pkTypes)
+        return false;
+
+    if (strcmp(pkTypes, "All") == 0)
+    {
+        rOutTypes.clear();
+        return true;
+    }
+
+    const TStringList TypeNames = TString(pkTypes).Split(",");
+
+    for (const TString& kTypeName : TypeNames)
+    {
+        EResourceType Type = TEnumReflection<EResourceType>::ConvertStringToValue(*kTypeName);
+
+        if (Type == EResourceType::Invalid)
+            return false;
+
+        rOutTypes.push_back(Type);
+    }
+
+    return !rOutTypes.empty();
+}
+
 /** Check commandline input to see if the user is running a test */
 bool RunTests(int argc, char* argv[])
 {
     if( ParseToken("ValidateCooker", argc, argv) )
     {
         // Fetch parameters
-        const char* pkType = ParseParameter("-type", argc, argv);
-        EResourceType Type = TEnumReflection<EResourceType>::ConvertStringToValue(pkType);
-        bool AllowDump = ParseToken("-allowdump", argc, argv);
+        SCookerValidationOptions Options;
+        const bool ValidTypes = ParseResourceTypes(ParseParameter("-type", argc, argv), Options.Types);
+        Options.DumpInvalidFileContents = ParseToken("-allowdump", argc, argv);
+
+        if (const char* pkThreads = ParseParameter("-threads", argc, argv))
+            Options.NumThreads = static_cast<uint>(strtoul(pkThreads, nullptr, 10));
 
-        if( Type == EResourceType::Invalid )
+        if (const char* pkSince = ParseParameter("-since", argc, argv))
+            Options.SinceSnapshotPath = pkSince;
+
+        if (const char* pkSnapshot = ParseParameter("-writesnapshot", argc, argv))
+            Options.OutputSnapshotPath = pkSnapshot;
+
+        if( !ValidTypes )
         {
-            gpUIRelay->ShowMessageBox("ValidateCooker", "Usage: ValidateCooker -type=<ResourceType> [-allowdump] [-project=<Project>]");
+            gpUIRelay->ShowMessageBox("ValidateCooker", "Usage: ValidateCooker -type=<ResourceType[,ResourceType...]|All> [-allowdump] [-threads=<Count>] "
+                                                        "[-since=<Snapshot>] [-writesnapshot=<Snapshot>] [-project=<Project>]");
         }
         else if( gpUIRelay->OpenProject(ParseParameter("-project", argc, argv)) )
         {
-            ValidateCooker(Type, AllowDump);
+            ValidateCookers(Options);
         }
         return true;
     }
@@ -74,132 +117,432 @@ bool RunTests(int argc, char* argv[])
 /** Validate all cooker output for the given resource type matches the original asset data */
 bool ValidateCooker(EResourceType ResourceType, bool DumpInvalidFileContents)
 {
-    debugf( "Validating output of %s cooker...",
-            TEnumReflection<EResourceType>::ConvertValueToString(ResourceType) );
+    SCookerValidationOptions Options;
+    Options.Types.push_back(ResourceType);
+    Options.DumpInvalidFileContents = DumpInvalidFileContents;
+    return ValidateCookers(Options);
+}
 
-    // There must be a project loaded
+/** Size and timestamps of an asset at the time a snapshot was written */
+struct SAssetSnapshotRecord
+{
+    uint64 CookedSize;
+    uint64 CookedModifiedTime;
+    uint64 RawModifiedTime;
+};
+
+static constexpr uint32 kSnapshotMagic = FOURCC('VSNP');
+static constexpr uint32 kSnapshotVersion = 1;
+
+/** Gathers the current snapshot record for an entry */
+static SAssetSnapshotRecord MakeSnapshotRecord(CResourceEntry* pEntry)
+{
+    SAssetSnapshotRecord Record;
+    Record.CookedSize = pEntry->HasCookedVersion() ? static_cast<uint64>(FileUtil::FileSize(pEntry->CookedAssetPath())) : 0;
+    Record.CookedModifiedTime = pEntry->HasCookedVersion() ? static_cast<uint64>(FileUtil::LastModifiedTime(pEntry->CookedAssetPath())) : 0;
+    Record.RawModifiedTime = pEntry->HasRawVersion() ? static_cast<uint64>(FileUtil::LastModifiedTime(pEntry->RawAssetPath())) : 0;
+    return Record;
+}
+
+/** Reads a snapshot written by WriteAssetSnapshot */
+static bool ReadAssetSnapshot(const TString& rkPath, std::map<uint64, SAssetSnapshotRecord>& rOutRecords)
+{
+    CFileInStream File(rkPath, EEndian::BigEndian);
+
+    if (!File.IsValid() || File.ReadULong() != kSnapshotMagic)
+    {
+        errorf("Failed to read asset snapshot: %s", *rkPath);
+        return false;
+    }
+
+    if (File.ReadULong() != kSnapshotVersion)
+    {
+        errorf("Unsupported asset snapshot version: %s", *rkPath);
+        return false;
+    }
+
+    const uint32 NumRecords = File.ReadULong();
+
+    for (uint32 RecordIdx = 0; RecordIdx < NumRecords; RecordIdx++)
+    {
+        const uint64 ID = File.ReadULongLong();
+        SAssetSnapshotRecord& rRecord = rOutRecords[ID];
+        rRecord.CookedSize = File.ReadULongLong();
+        rRecord.CookedModifiedTime = File.ReadULongLong();
+        rRecord.RawModifiedTime = File.ReadULongLong();
+    }
+
+    return true;
+}
+
+/** Write the size and timestamps of every asset in the current project so later validation runs can skip unchanged assets */
+bool WriteAssetSnapshot(const TString& rkPath)
+{
     CResourceStore* pStore = gpResourceStore;
-    CGameProject* pProject = (pStore ? pStore->Project() : nullptr);
 
-    if (!pProject)
+    if (!pStore)
     {
-        errorf("Cooker unit test failed; no project loaded");
+        errorf("Failed to write asset snapshot; no project loaded");
         return false;
     }
 
-    TString ResourcesDir = pProject->ResourcesDir(false);
-    uint NumValid = 0, NumInvalid = 0;
+    CFileOutStream File(rkPath, EEndian::BigEndian);
+
+    if (!File.IsValid())
+    {
+        errorf("Failed to open asset snapshot for writing: %s", *rkPath);
+        return false;
+    }
+
+    File.WriteULong(kSnapshotMagic);
+    File.WriteULong(kSnapshotVersion);
+    const uint32 NumRecordsOffset = File.Tell();
+    File.WriteULong(0);
+    uint32 NumRecords = 0;
 
-    // Iterate through all resources
     for (CResourceIterator It(pStore); It; ++It)
     {
-        if (It->ResourceType() != ResourceType || !It->HasCookedVersion())
-            continue;
+        const SAssetSnapshotRecord Record = MakeSnapshotRecord(*It);
+        File.WriteULongLong(It->ID().ToLongLong());
+        File.WriteULongLong(Record.CookedSize);
+        File.WriteULongLong(Record.CookedModifiedTime);
+        File.WriteULongLong(Record.RawModifiedTime);
+        NumRecords++;
+    }
 
-        // Get original cooked data
-        TString CookedPath = It->CookedAssetPath(true);
-        CFileInStream FileStream(ResourcesDir / CookedPath, EEndian::BigEndian);
+    File.Seek(NumRecordsOffset, SEEK_SET);
+    File.WriteULong(NumRecords);
+    debugf("Wrote asset snapshot with %d assets to %s", NumRecords, *rkPath);
+    return true;
+}
 
-        if (!FileStream.IsValid())
-            continue;
+/**
+ * Whether the cooker for a type only reads from the resource being cooked.
+ * Area, scan and world cookers build dependency lists and may load other
+ * resources, which isn't thread-safe, so those are cooked on the main thread.
+ */
+static bool CanCookOnWorkerThread(EResourceType Type)
+{
+    switch (Type)
+    {
+    case EResourceType::Model:
+    case EResourceType::StaticGeometryMap:
+    case EResourceType::StringTable:
+    case EResourceType::Tweaks:
+        return true;
 
-        std::vector<uint8> OriginalData( FileStream.Size() );
-        FileStream.ReadBytes(OriginalData.data(), OriginalData.size());
-        FileStream.Close();
+    default:
+        return false;
+    }
+}
 
-        // Generate new cooked data
-        std::vector<char> NewData;
-        CVectorOutStream MemoryStream(&NewData, EEndian::BigEndian);
-        CResourceCooker::CookResource(*It, MemoryStream);
+using ValidationClock = std::chrono::steady_clock;
 
-        // Start our comparison by making sure the sizes match up
-        const uint kAlignment           = (It->Game() >= EGame::Corruption ? 64 : 32);
-        const uint kAlignedOriginalSize = VAL_ALIGN( (uint) OriginalData.size(), kAlignment );
-        const uint kAlignedNewSize      = VAL_ALIGN( (uint) NewData.size(), kAlignment );
-        const char* pkInvalidReason     = "";
-        bool IsValid                    = false;
+/** A single asset being validated */
+struct SCookerValidationJob
+{
+    CResourceEntry* pEntry = nullptr;
+    TString CookedPath;
+    std::vector<char> NewData;
+    bool IsCooked = false;
+    bool IsValid = false;
+    const char* pkInvalidReason = "";
+    uint64 FirstMismatchOffset = 0;
+    double CookSeconds = 0.0;
+    double CompareSeconds = 0.0;
+};
 
-        if( kAlignedOriginalSize == kAlignedNewSize &&
-            OriginalData.size() >= NewData.size() )
-        {
-            // Compare actual data. Note that the original asset can have alignment padding
-            // at the end, which is applied by the pak but usually preserved in extracted
-            // files. We do not include this in the comparison as missing padding does not
-            // indicate malformed data.
-            uint DataSize = Math::Min(OriginalData.size(), NewData.size());
+/** Per-type results */
+struct SCookerValidationSummary
+{
+    uint NumValid = 0;
+    uint NumInvalid = 0;
+    uint64 NumBytes = 0;
+    double CookSeconds = 0.0;
+    double CompareSeconds = 0.0;
+};
 
-            if( memcmp(OriginalData.data(), NewData.data(), DataSize) == 0 )
-            {
-                // Verify any missing data at the end is padding.
-                bool MissingData = false;
+/** Cooks a job's asset into its output buffer */
+static void CookValidationJob(SCookerValidationJob& rJob)
+{
+    const ValidationClock::time_point Start = ValidationClock::now();
+    CVectorOutStream MemoryStream(&rJob.NewData, EEndian::BigEndian);
+    CResourceCooker::CookResource(rJob.pEntry, MemoryStream);
+    rJob.IsCooked = true;
 
-                if( OriginalData.size() > NewData.size() )
-                {
-                    for( uint i=DataSize; i<OriginalData.size(); i++ )
-                    {
-                        if( OriginalData[i] != 0xFF )
-                        {
-                            MissingData = true;
-                            break;
-                        }
-                    }
-                }
+    const std::chrono::duration<double> Elapsed = ValidationClock::now() - Start;
+    rJob.CookSeconds = Elapsed.count();
+}
 
-                if( !MissingData )
-                {
-                    // All tests passed!
-                    IsValid = true;
-                }
-                else
-                {
-                    pkInvalidReason = "missing data";
-                }
+/** Compares a job's cooked output against the original cooked file */
+static void CompareValidationData(SCookerValidationJob& rJob, const TString& rkResourcesDir, bool DumpFileContents)
+{
+    // Get original cooked data
+    CFileInStream FileStream(rkResourcesDir / rJob.CookedPath, EEndian::BigEndian);
+
+    if (!FileStream.IsValid())
+    {
+        rJob.pkInvalidReason = "couldn't open original file";
+        return;
+    }
+
+    std::vector<uint8> OriginalData( FileStream.Size() );
+    FileStream.ReadBytes(OriginalData.data(), OriginalData.size());
+    FileStream.Close();
+
+    const std::vector<char>& rkNewData = rJob.NewData;
+    const uint8* pkNewData = reinterpret_cast<const uint8*>(rkNewData.data());
+
+    // Find the first byte that differs between the two files
+    const size_t DataSize = Math::Min(OriginalData.size(), rkNewData.size());
+    const auto Mismatch = std::mismatch(OriginalData.begin(), OriginalData.begin() + DataSize, pkNewData);
+    rJob.FirstMismatchOffset = static_cast<uint64>(Mismatch.first - OriginalData.begin());
+
+    // Start our comparison by making sure the sizes match up
+    const uint kAlignment           = (rJob.pEntry->Game() >= EGame::Corruption ? 64 : 32);
+    const uint kAlignedOriginalSize = VAL_ALIGN( (uint) OriginalData.size(), kAlignment );
+    const uint kAlignedNewSize      = VAL_ALIGN( (uint) rkNewData.size(), kAlignment );
+
+    if( kAlignedOriginalSize == kAlignedNewSize &&
+        OriginalData.size() >= rkNewData.size() )
+    {
+        // Compare actual data. Note that the original asset can have alignment padding
+        // at the end, which is applied by the pak but usually preserved in extracted
+        // files. We do not include this in the comparison as missing padding does not
+        // indicate malformed data.
+        if( rJob.FirstMismatchOffset == DataSize )
+        {
+            // Verify any missing data at the end is padding.
+            const auto MissingData = std::find_if(OriginalData.begin() + DataSize, OriginalData.end(),
+                                                  [](uint8 Byte) { return Byte != 0xFF; });
+
+            if( MissingData == OriginalData.end() )
+            {
+                // All tests passed!
+                rJob.IsValid = true;
             }
             else
             {
-                pkInvalidReason = "data mismatch";
+                rJob.pkInvalidReason = "missing data";
+                rJob.FirstMismatchOffset = static_cast<uint64>(MissingData - OriginalData.begin());
             }
         }
         else
         {
-            pkInvalidReason = "size mismatch";
+            rJob.pkInvalidReason = "data mismatch";
         }
+    }
+    else
+    {
+        rJob.pkInvalidReason = "size mismatch";
+    }
 
-        // Print test results
-        if( IsValid )
+    if( DumpFileContents )
+    {
+        TString DumpPath = "dump" / rJob.CookedPath;
+        FileUtil::MakeDirectory( DumpPath.GetFileDirectory() );
+
+        CFileOutStream DumpFile(DumpPath, EEndian::BigEndian);
+        DumpFile.WriteBytes( rkNewData.data(), rkNewData.size() );
+        DumpFile.Close();
+    }
+}
+
+/** Runs the comparison for a job and records how long it took, whichever way it exits */
+static void CompareValidationJob(SCookerValidationJob& rJob, const TString& rkResourcesDir, bool DumpFileContents)
+{
+    const ValidationClock::time_point Start = ValidationClock::now();
+    CompareValidationData(rJob, rkResourcesDir, DumpFileContents);
+
+    const std::chrono::duration<double> Elapsed = ValidationClock::now() - Start;
+    rJob.CompareSeconds = Elapsed.count();
+}
+
+/** Validate cooker output for several resource types in a single pass, cooking and comparing in parallel */
+bool ValidateCookers(const SCookerValidationOptions& rkOptions)
+{
+    // There must be a project loaded
+    CResourceStore* pStore = gpResourceStore;
+    CGameProject* pProject = (pStore ? pStore->Project() : nullptr);
+
+    if (!pProject)
+    {
+        errorf("Cooker unit test failed; no project loaded");
+        return false;
+    }
+
+    std::vector<EResourceType> Types = rkOptions.Types;
+
+    if (Types.empty())
+    {
+        std::list<CResTypeInfo*> TypeInfos;
+        CResTypeInfo::GetAllTypesInGame(pProject->Game(), TypeInfos);
+
+        for (CResTypeInfo* pTypeInfo : TypeInfos)
         {
-            debugf( "[SUCCESS] %s", *CookedPath );
-            NumValid++;
+            if (CResourceCooker::CanCookResourceType(pTypeInfo->Type()))
+                Types.push_back(pTypeInfo->Type());
         }
-        else
+
+        std::sort(Types.begin(), Types.end());
+    }
+
+    for (EResourceType Type : Types)
+    {
+        debugf( "Validating output of %s cooker...",
+                TEnumReflection<EResourceType>::ConvertValueToString(Type) );
+    }
+
+    // Load the snapshot to check for changed assets against
+    std::map<uint64, SAssetSnapshotRecord> Snapshot;
+    const bool OnlyChangedAssets = !rkOptions.SinceSnapshotPath.IsEmpty();
+
+    if (OnlyChangedAssets && !ReadAssetSnapshot(rkOptions.SinceSnapshotPath, Snapshot))
+        return false;
+
+    // Gather the assets to validate, grouped by type
+    std::vector<CResourceEntry*> Entries;
+    uint NumUnchanged = 0;
+
+    for (CResourceIterator It(pStore); It; ++It)
+    {
+        if (std::find(Types.begin(), Types.end(), It->ResourceType()) == Types.end() || !It->HasCookedVersion())
+            continue;
+
+        if (OnlyChangedAssets)
         {
-            debugf( "[FAILED: %s] %s", pkInvalidReason, *CookedPath );
-            NumInvalid++;
+            auto Find = Snapshot.find(It->ID().ToLongLong());
+
+            if (Find != Snapshot.end())
+            {
+                const SAssetSnapshotRecord& rkOld = Find->second;
+                const SAssetSnapshotRecord kNew = MakeSnapshotRecord(*It);
+
+                if (rkOld.CookedSize == kNew.CookedSize &&
+                    rkOld.CookedModifiedTime == kNew.CookedModifiedTime &&
+                    rkOld.RawModifiedTime == kNew.RawModifiedTime)
+                {
+                    NumUnchanged++;
+                    continue;
+                }
+            }
         }
 
-        if( DumpInvalidFileContents )
+        Entries.push_back(*It);
+    }
+
+    std::stable_sort(Entries.begin(), Entries.end(), [](CResourceEntry* pLeft, CResourceEntry* pRight) {
+        return pLeft->ResourceType() < pRight->ResourceType();
+    });
+
+    if (OnlyChangedAssets)
+        debugf("Skipping %d assets that haven't changed since the snapshot", NumUnchanged);
+
+    // Resources are loaded and dependency-sensitive types are cooked on the main thread a batch at a time.
+    // The rest of the cooking and all of the file comparisons are then spread across the worker threads.
+    const TString ResourcesDir = pProject->ResourcesDir(false);
+    const uint NumThreads = (rkOptions.NumThreads > 0 ? rkOptions.NumThreads : NParallel::NumWorkerThreads());
+    const size_t BatchSize = NumThreads * 8;
+    const ValidationClock::time_point StartTime = ValidationClock::now();
+
+    std::map<EResourceType, SCookerValidationSummary> Summaries;
+    std::vector<SCookerValidationJob> Jobs;
+    bool Aborted = false;
+
+    for (size_t BatchStart = 0; BatchStart < Entries.size(); BatchStart += BatchSize)
+    {
+        const size_t BatchEnd = Math::Min(BatchStart + BatchSize, Entries.size());
+        Jobs.clear();
+
+        for (size_t EntryIdx = BatchStart; EntryIdx < BatchEnd; EntryIdx++)
         {
-            TString DumpPath = "dump" / CookedPath;
-            FileUtil::MakeDirectory( DumpPath.GetFileDirectory() );
+            CResourceEntry* pEntry = Entries[EntryIdx];
+
+            if (Summaries[pEntry->ResourceType()].NumInvalid >= 100)
+                continue;
+
+            SCookerValidationJob Job;
+            Job.pEntry = pEntry;
+            Job.CookedPath = pEntry->CookedAssetPath(true);
 
-            CFileOutStream DumpFile(DumpPath, EEndian::BigEndian);
-            DumpFile.WriteBytes( NewData.data(), NewData.size() );
-            DumpFile.Close();
+            if (!pEntry->Load())
+            {
+                warnf("Failed to load %s", *Job.CookedPath);
+                continue;
+            }
+
+            if (!CanCookOnWorkerThread(pEntry->ResourceType()))
+                CookValidationJob(Job);
+
+            Jobs.push_back(std::move(Job));
         }
 
-        if( NumInvalid >= 100 )
+        NParallel::ParallelFor(Jobs.size(), [&](size_t JobIdx)
         {
-            debugf( "Test aborted; at least 100 invalid resources. Checked %d resources, %d passed, %d failed",
-                    NumValid + NumInvalid, NumValid, NumInvalid );
-            return false;
+            SCookerValidationJob& rJob = Jobs[JobIdx];
+
+            if (!rJob.IsCooked)
+                CookValidationJob(rJob);
+
+            CompareValidationJob(rJob, ResourcesDir, rkOptions.DumpInvalidFileContents);
+        }, NumThreads);
+
+        // Print test results
+        for (const SCookerValidationJob& rkJob : Jobs)
+        {
+            SCookerValidationSummary& rSummary = Summaries[rkJob.pEntry->ResourceType()];
+            rSummary.NumBytes += rkJob.NewData.size();
+            rSummary.CookSeconds += rkJob.CookSeconds;
+            rSummary.CompareSeconds += rkJob.CompareSeconds;
+
+            if( rkJob.IsValid )
+            {
+                debugf( "[SUCCESS] %s", *rkJob.CookedPath );
+                rSummary.NumValid++;
+            }
+            else
+            {
+                debugf( "[FAILED: %s at offset 0x%llX] %s", rkJob.pkInvalidReason,
+                        static_cast<unsigned long long>(rkJob.FirstMismatchOffset), *rkJob.CookedPath );
+                rSummary.NumInvalid++;
+
+                if( rSummary.NumInvalid == 100 )
+                {
+                    debugf( "%s test aborted; at least 100 invalid resources",
+                            TEnumReflection<EResourceType>::ConvertValueToString(rkJob.pEntry->ResourceType()) );
+                    Aborted = true;
+                }
+            }
         }
+
+        Jobs.clear();
+        pStore->DestroyUnreferencedResources();
     }
 
     // Test complete
-    bool TestSuccess = (NumInvalid == 0);
-    debugf( "Test %s; checked %d resources, %d passed, %d failed",
+    const std::chrono::duration<double> TotalTime = ValidationClock::now() - StartTime;
+    uint TotalValid = 0, TotalInvalid = 0;
+
+    for (EResourceType Type : Types)
+    {
+        const SCookerValidationSummary& rkSummary = Summaries[Type];
+        debugf( "%s: %s; checked %d resources, %d passed, %d failed; cooked %.2f MB in %.3f s, compared in %.3f s",
+                TEnumReflection<EResourceType>::ConvertValueToString(Type),
+                rkSummary.NumInvalid == 0 ? "SUCCEEDED" : "FAILED",
+                rkSummary.NumValid + rkSummary.NumInvalid, rkSummary.NumValid, rkSummary.NumInvalid,
+                rkSummary.NumBytes / (1024.0 * 1024.0), rkSummary.CookSeconds, rkSummary.CompareSeconds );
+
+        TotalValid += rkSummary.NumValid;
+        TotalInvalid += rkSummary.NumInvalid;
+    }
+
+    bool TestSuccess = (TotalInvalid == 0 && !Aborted);
+    debugf( "Test %s; checked %d resources, %d passed, %d failed in %.3f s on %d threads",
             TestSuccess ? "SUCCEEDED" : "FAILED",
-            NumValid + NumInvalid, NumValid, NumInvalid );
+            TotalValid + TotalInvalid, TotalValid, TotalInvalid, TotalTime.count(), NumThreads );
+
+    if (!rkOptions.OutputSnapshotPath.IsEmpty())
+        WriteAssetSnapshot(rkOptions.OutputSnapshotPath);
 
     return TestSuccess;
 }
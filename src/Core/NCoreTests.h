@@ -2,6 +2,28 @@
 #define NCORETESTS_H
 
 #include "Core/Resource/EResType.h"
+#include <Common/BasicTypes.h>
+#include <Common/TString.h>
+#include <vector>
+
+/** Settings for a cooker validation run */
+struct SCookerValidationOptions
+{
+    /** Resource types to validate. If empty, every cookable type is validated. */
+    std::vector<EResourceType> Types;
+
+    /** Write the new cooked data of every validated asset to the dump folder */
+    bool DumpInvalidFileContents = false;
+
+    /** Number of threads used to cook and compare assets; 0 uses all hardware threads */
+    uint NumThreads = 0;
+
+    /** If set, only assets that changed since this snapshot was written are validated */
+    TString SinceSnapshotPath;
+
+    /** If set, a snapshot of the current state of the project is written here after validation */
+    TString OutputSnapshotPath;
+};
 
 /** Unit tests for Core */
 namespace NCoreTests
@@ -13,6 +35,12 @@ bool RunTests(int argc, char *argv[]);
 /** Validate all cooker output for the given resource type matches the original asset data */
 bool ValidateCooker(EResourceType ResourceType, bool DumpInvalidFileContents);
 
+/** Validate cooker output for several resource types in a single pass, cooking and comparing in parallel */
+bool ValidateCookers(const SCookerValidationOptions& rkOptions);
+
+/** Write the size and timestamps of every asset in the current project so later validation runs can skip unchanged assets */
+bool WriteAssetSnapshot(const TString& rkPath);
+
 }
 
 #endif // NCORETESTS_H
@@ -0,0 +1,166 @@
+#include "NParallel.h"
+#include <Common/Math/MathUtil.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NParallel
+{
+
+static thread_local uint gWorkerIndex = 0;
+
+/** One ParallelFor call. Lives on the caller's stack; pool threads join in as helpers while it's queued. */
+struct SJob
+{
+    const std::function<void(size_t)> *pkFunc = nullptr;
+    size_t Count = 0;
+    std::atomic<size_t> NextIndex{0};
+    uint MaxHelpers = 0;
+
+    // Guarded by the pool mutex
+    uint NumHelpers = 0;
+    uint NumActiveHelpers = 0;
+};
+
+static void RunJob(SJob& rJob, uint WorkerIndex)
+{
+    const uint OldWorkerIndex = gWorkerIndex;
+    gWorkerIndex = WorkerIndex;
+
+    for (size_t Index = rJob.NextIndex++; Index < rJob.Count; Index = rJob.NextIndex++)
+        (*rJob.pkFunc)(Index);
+
+    gWorkerIndex = OldWorkerIndex;
+}
+
+/**
+ * Persistent threads shared by every ParallelFor call, so loops that run many small parallel passes
+ * don't pay for creating threads each time. Callers always work on their own job as well and only ever
+ * wait for helpers that are mid-item, so nested calls can't deadlock even when every thread is busy.
+ */
+class CWorkerPool
+{
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mHelperFinished;
+    std::deque<SJob*> mJobs;
+    std::vector<std::thread> mThreads;
+    bool mShuttingDown = false;
+
+    void ThreadMain()
+    {
+        std::unique_lock<std::mutex> Lock(mMutex);
+
+        while (true)
+        {
+            mWorkAvailable.wait(Lock, [this] { return mShuttingDown || !mJobs.empty(); });
+
+            if (mShuttingDown)
+                return;
+
+            SJob *pJob = mJobs.front();
+            const uint HelperIndex = ++pJob->NumHelpers;
+            pJob->NumActiveHelpers++;
+
+            if (pJob->NumHelpers >= pJob->MaxHelpers)
+                mJobs.pop_front();
+
+            Lock.unlock();
+            RunJob(*pJob, HelperIndex);
+            Lock.lock();
+
+            if (--pJob->NumActiveHelpers == 0)
+                mHelperFinished.notify_all();
+        }
+    }
+
+public:
+    ~CWorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(mMutex);
+            mShuttingDown = true;
+        }
+
+        mWorkAvailable.notify_all();
+
+        for (std::thread& rThread : mThreads)
+            rThread.join();
+    }
+
+    void Run(SJob& rJob)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(mMutex);
+
+            // Threads are started on first use and then kept around
+            if (mThreads.empty())
+            {
+                const uint NumThreads = NumWorkerThreads() - 1;
+                mThreads.reserve(NumThreads);
+
+                for (uint ThreadIdx = 0; ThreadIdx < NumThreads; ThreadIdx++)
+                    mThreads.emplace_back(&CWorkerPool::ThreadMain, this);
+            }
+
+            mJobs.push_back(&rJob);
+        }
+
+        mWorkAvailable.notify_all();
+        RunJob(rJob, 0);
+
+        // Every item has been claimed; stop more helpers from joining, then wait for the ones still busy
+        std::unique_lock<std::mutex> Lock(mMutex);
+        const auto It = std::find(mJobs.begin(), mJobs.end(), &rJob);
+
+        if (It != mJobs.end())
+            mJobs.erase(It);
+
+        mHelperFinished.wait(Lock, [&rJob] { return rJob.NumActiveHelpers == 0; });
+    }
+};
+
+uint NumWorkerThreads()
+{
+    static const uint skNumThreads = Math::Max<uint>(std::thread::hardware_concurrency(), 1);
+    return skNumThreads;
+}
+
+void ParallelFor(size_t Count, const std::function<void(size_t)>& Func, uint MaxThreads /*= 0*/)
+{
+    if (Count == 0)
+        return;
+
+    if (MaxThreads == 0)
+        MaxThreads = NumWorkerThreads();
+
+    const size_t NumThreads = Math::Min<size_t>(Math::Min(MaxThreads, NumWorkerThreads()), Count);
+
+    // Don't bother involving other threads if there's nothing to share
+    if (NumThreads <= 1)
+    {
+        for (size_t Index = 0; Index < Count; Index++)
+            Func(Index);
+
+        return;
+    }
+
+    static CWorkerPool sPool;
+
+    SJob Job;
+    Job.pkFunc = &Func;
+    Job.Count = Count;
+    Job.MaxHelpers = static_cast<uint>(NumThreads - 1);
+    sPool.Run(Job);
+}
+
+uint CurrentWorkerIndex()
+{
+    return gWorkerIndex;
+}
+
+}
@@ -0,0 +1,28 @@
+#ifndef NPARALLEL_H
+#define NPARALLEL_H
+
+#include <Common/BasicTypes.h>
+#include <functional>
+
+/** Lightweight helpers for spreading independent work across worker threads */
+namespace NParallel
+{
+
+/** Number of threads parallel operations will use by default (at least 1) */
+uint NumWorkerThreads();
+
+/**
+ * Run Func(Index) for every index in [0, Count) and block until all calls have returned.
+ * Indices are handed out to threads dynamically, so uneven work items balance out.
+ * The calling thread participates in the work, helped by a pool of persistent worker threads, so calling
+ * this in a loop doesn't create threads each time. MaxThreads = 0 or anything above NumWorkerThreads()
+ * uses NumWorkerThreads(). Func must be safe to call concurrently from multiple threads.
+ */
+void ParallelFor(size_t Count, const std::function<void(size_t)>& Func, uint MaxThreads = 0);
+
+/** Returns a small index identifying the calling worker thread within the current ParallelFor (0 = calling thread) */
+uint CurrentWorkerIndex();
+
+}
+
+#endif // NPARALLEL_H
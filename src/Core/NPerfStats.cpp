@@ -0,0 +1,247 @@
+#include "NPerfStats.h"
+#include <Common/FileIO.h>
+#include <Common/Log.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace NPerfStats
+{
+
+static std::atomic<bool> gEnabled{false};
+static std::mutex gStatsMutex;
+static std::map<TString, SPhaseStats> gStats;
+
+static std::atomic<bool> gTraceEnabled{false};
+static std::mutex gTraceMutex;
+static std::vector<STraceEvent> gTraceEvents;
+static Clock::time_point gTraceStartTime;
+
+static std::mutex gThreadIndexMutex;
+static std::set<uint32> gFreeThreadIndices;
+static uint32 gNextThreadIndex = 0;
+
+/** Thread index holder; returns the index for reuse when its thread exits */
+class CThreadIndex
+{
+    uint32 mIndex;
+
+public:
+    CThreadIndex()
+    {
+        std::lock_guard<std::mutex> Lock(gThreadIndexMutex);
+
+        if (gFreeThreadIndices.empty())
+        {
+            mIndex = gNextThreadIndex++;
+        }
+        else
+        {
+            mIndex = *gFreeThreadIndices.begin();
+            gFreeThreadIndices.erase(gFreeThreadIndices.begin());
+        }
+    }
+
+    ~CThreadIndex()
+    {
+        std::lock_guard<std::mutex> Lock(gThreadIndexMutex);
+        gFreeThreadIndices.insert(mIndex);
+    }
+
+    uint32 Get() const  { return mIndex; }
+};
+
+void SetEnabled(bool Enabled)
+{
+    gEnabled = Enabled;
+}
+
+bool IsEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+void Record(const TString& rkPhase, double Seconds, uint64 NumBytes /*= 0*/, uint64 NumItems /*= 0*/)
+{
+    std::lock_guard<std::mutex> Lock(gStatsMutex);
+    SPhaseStats& rStats = gStats[rkPhase];
+
+    if (rStats.NumCalls == 0 || Seconds < rStats.MinSeconds)
+        rStats.MinSeconds = Seconds;
+    if (Seconds > rStats.MaxSeconds)
+        rStats.MaxSeconds = Seconds;
+
+    rStats.NumCalls++;
+    rStats.TotalSeconds += Seconds;
+    rStats.NumBytes += NumBytes;
+    rStats.NumItems += NumItems;
+}
+
+std::map<TString, SPhaseStats> Snapshot()
+{
+    std::lock_guard<std::mutex> Lock(gStatsMutex);
+    return gStats;
+}
+
+void Reset()
+{
+    std::lock_guard<std::mutex> Lock(gStatsMutex);
+    gStats.clear();
+}
+
+bool IsActive()
+{
+    return IsEnabled() || IsTraceEnabled();
+}
+
+void RecordPhase(const TString& rkPhase, Clock::time_point Start, Clock::time_point End, uint64 NumBytes /*= 0*/, uint64 NumItems /*= 0*/)
+{
+    if (IsEnabled())
+    {
+        const std::chrono::duration<double> Elapsed = End - Start;
+        Record(rkPhase, Elapsed.count(), NumBytes, NumItems);
+    }
+
+    if (IsTraceEnabled())
+    {
+        STraceEvent Event;
+        Event.Phase = rkPhase;
+        Event.ThreadIndex = CurrentThreadIndex();
+        Event.DurationMicroseconds = static_cast<uint64>(std::chrono::duration_cast<std::chrono::microseconds>(End - Start).count());
+        Event.NumBytes = NumBytes;
+        Event.NumItems = NumItems;
+
+        std::lock_guard<std::mutex> Lock(gTraceMutex);
+
+        // Phases that began before the trace was started are clipped to its start
+        if (Start < gTraceStartTime)
+            Start = gTraceStartTime;
+
+        Event.StartMicroseconds = static_cast<uint64>(std::chrono::duration_cast<std::chrono::microseconds>(Start - gTraceStartTime).count());
+        gTraceEvents.push_back(std::move(Event));
+    }
+}
+
+void StartTrace()
+{
+    std::lock_guard<std::mutex> Lock(gTraceMutex);
+    gTraceEvents.clear();
+    gTraceStartTime = Clock::now();
+    gTraceEnabled = true;
+}
+
+void StopTrace()
+{
+    gTraceEnabled = false;
+}
+
+bool IsTraceEnabled()
+{
+    return gTraceEnabled.load(std::memory_order_relaxed);
+}
+
+std::vector<STraceEvent> TraceSnapshot()
+{
+    std::lock_guard<std::mutex> Lock(gTraceMutex);
+    return gTraceEvents;
+}
+
+bool WriteChromeTrace(const TString& rkPath)
+{
+    std::vector<STraceEvent> Events = TraceSnapshot();
+
+    // Sort parents before their children so viewers nest them correctly
+    std::sort(Events.begin(), Events.end(), [](const STraceEvent& rkLeft, const STraceEvent& rkRight)
+    {
+        if (rkLeft.ThreadIndex != rkRight.ThreadIndex)
+            return rkLeft.ThreadIndex < rkRight.ThreadIndex;
+        if (rkLeft.StartMicroseconds != rkRight.StartMicroseconds)
+            return rkLeft.StartMicroseconds < rkRight.StartMicroseconds;
+        return rkLeft.DurationMicroseconds > rkRight.DurationMicroseconds;
+    });
+
+    std::string Json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    uint32 NumThreads = 0;
+    char Buffer[256];
+
+    for (const STraceEvent& rkEvent : Events)
+    {
+        NumThreads = std::max(NumThreads, rkEvent.ThreadIndex + 1);
+
+        Json += "\n{\"name\":";
+        Json += *JsonString(rkEvent.Phase);
+        snprintf(Buffer, sizeof(Buffer), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu,\"args\":{\"bytes\":%llu,\"items\":%llu}},",
+                 rkEvent.ThreadIndex,
+                 static_cast<unsigned long long>(rkEvent.StartMicroseconds),
+                 static_cast<unsigned long long>(rkEvent.DurationMicroseconds),
+                 static_cast<unsigned long long>(rkEvent.NumBytes),
+                 static_cast<unsigned long long>(rkEvent.NumItems));
+        Json += Buffer;
+    }
+
+    // Thread name metadata. Index 0 is whichever thread recorded a phase first, usually the main thread.
+    for (uint32 ThreadIdx = 0; ThreadIdx < NumThreads; ThreadIdx++)
+    {
+        snprintf(Buffer, sizeof(Buffer), "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}%s",
+                 ThreadIdx, ThreadIdx, ThreadIdx + 1 < NumThreads ? "," : "");
+        Json += Buffer;
+    }
+
+    // Drop the trailing comma left by the last event if there was no metadata after it
+    if (NumThreads == 0 && Json.back() == ',')
+        Json.pop_back();
+
+    Json += "\n]}\n";
+
+    CFileOutStream TraceFile(rkPath, EEndian::BigEndian);
+
+    if (!TraceFile.IsValid())
+    {
+        errorf("Failed to open trace file for writing: %s", *rkPath);
+        return false;
+    }
+
+    TraceFile.WriteBytes(Json.data(), static_cast<uint32>(Json.size()));
+    debugf("Wrote %d trace events to %s", static_cast<int>(Events.size()), *rkPath);
+    return true;
+}
+
+uint32 CurrentThreadIndex()
+{
+    thread_local const CThreadIndex skThreadIndex;
+    return skThreadIndex.Get();
+}
+
+TString JsonString(const TString& rkString)
+{
+    std::string Out = "\"";
+
+    for (const char* pkChr = *rkString; *pkChr != 0; pkChr++)
+    {
+        const unsigned char Chr = static_cast<unsigned char>(*pkChr);
+
+        if (Chr == '"' || Chr == '\\')
+        {
+            Out += '\\';
+            Out += *pkChr;
+        }
+        else if (Chr < 0x20)
+        {
+            char Escape[8];
+            snprintf(Escape, sizeof(Escape), "\\u%04x", Chr);
+            Out += Escape;
+        }
+        else
+        {
+            Out += *pkChr;
+        }
+    }
+
+    Out += '"';
+    return TString(Out.c_str());
+}
+
+}
@@ -0,0 +1,121 @@
+#ifndef NPERFSTATS_H
+#define NPERFSTATS_H
+
+#include <Common/BasicTypes.h>
+#include <Common/TString.h>
+#include <chrono>
+#include <map>
+#include <vector>
+
+/**
+ * Opt-in timing statistics for hot code paths. Instrumented code marks phases with
+ * CScopedPerfPhase; nothing is recorded (and the clock isn't read) unless collection
+ * has been enabled, which is normally only done by the benchmark tool.
+ *
+ * Separately, a trace can be recorded, which keeps every phase occurrence with its
+ * timestamps and thread so a run can be inspected on a timeline.
+ */
+namespace NPerfStats
+{
+
+using Clock = std::chrono::steady_clock;
+
+/** Accumulated statistics for a single named phase */
+struct SPhaseStats
+{
+    uint64 NumCalls = 0;
+    double TotalSeconds = 0.0;
+    double MinSeconds = 0.0;
+    double MaxSeconds = 0.0;
+    uint64 NumBytes = 0;
+    uint64 NumItems = 0;
+};
+
+/** One timed occurrence of a phase, kept while a trace is being recorded */
+struct STraceEvent
+{
+    TString Phase;
+    uint32 ThreadIndex = 0;
+    uint64 StartMicroseconds = 0; // Relative to the start of the trace
+    uint64 DurationMicroseconds = 0;
+    uint64 NumBytes = 0;
+    uint64 NumItems = 0;
+};
+
+/** Enable or disable collection. Disabling does not clear previously collected stats. */
+void SetEnabled(bool Enabled);
+bool IsEnabled();
+
+/** Add one sample to the named phase. Safe to call from any thread. */
+void Record(const TString& rkPhase, double Seconds, uint64 NumBytes = 0, uint64 NumItems = 0);
+
+/** Get a copy of all stats collected so far, keyed by phase name */
+std::map<TString, SPhaseStats> Snapshot();
+
+/** Discard all collected stats */
+void Reset();
+
+/** Returns whether phases need to be timed at all, i.e. stats collection or trace recording is on */
+bool IsActive();
+
+/** Record one timed occurrence of a phase to the stats and/or the trace, whichever are enabled. Safe to call from any thread. */
+void RecordPhase(const TString& rkPhase, Clock::time_point Start, Clock::time_point End, uint64 NumBytes = 0, uint64 NumItems = 0);
+
+/** Start recording a trace, discarding the previous one */
+void StartTrace();
+
+/** Stop recording. The trace is kept until the next StartTrace. */
+void StopTrace();
+bool IsTraceEnabled();
+
+/** Get a copy of all events recorded in the current trace */
+std::vector<STraceEvent> TraceSnapshot();
+
+/** Write the current trace in the Chrome trace event format (chrome://tracing, Perfetto) */
+bool WriteChromeTrace(const TString& rkPath);
+
+/**
+ * Returns a small index identifying the calling thread in traces. Indices of threads that have exited
+ * are reused, so short-lived ParallelFor workers share a handful of timeline rows.
+ */
+uint32 CurrentThreadIndex();
+
+/** Quote and escape a string for inclusion in a JSON document */
+TString JsonString(const TString& rkString);
+
+}
+
+/** Times the enclosing scope and records it to NPerfStats on destruction */
+class CScopedPerfPhase
+{
+    using Clock = NPerfStats::Clock;
+
+    const char *mpkPhase;
+    Clock::time_point mStartTime;
+    uint64 mNumBytes = 0;
+    uint64 mNumItems = 0;
+    bool mActive;
+
+public:
+    explicit CScopedPerfPhase(const char *pkPhase)
+        : mpkPhase(pkPhase)
+        , mActive(NPerfStats::IsActive())
+    {
+        if (mActive)
+            mStartTime = Clock::now();
+    }
+
+    ~CScopedPerfPhase()
+    {
+        if (mActive)
+            NPerfStats::RecordPhase(mpkPhase, mStartTime, Clock::now(), mNumBytes, mNumItems);
+    }
+
+    CScopedPerfPhase(const CScopedPerfPhase&) = delete;
+    CScopedPerfPhase& operator=(const CScopedPerfPhase&) = delete;
+
+    void AddBytes(uint64 NumBytes)  { mNumBytes += NumBytes; }
+    void AddItems(uint64 NumItems)  { mNumItems += NumItems; }
+};
+
+#endif // NPERFSTATS_H
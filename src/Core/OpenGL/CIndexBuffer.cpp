@@ -77,6 +77,13 @@ void CIndexBuffer::DrawElements(uint offset, uint size)
     Unbind();
 }
 
+void CIndexBuffer::DrawElementsInstanced(uint instanceCount)
+{
+    Bind();
+    glDrawElementsInstanced(mPrimitiveType, mIndices.size(), GL_UNSIGNED_SHORT, nullptr, instanceCount);
+    Unbind();
+}
+
 bool CIndexBuffer::IsBuffered() const
 {
     return mBuffered;
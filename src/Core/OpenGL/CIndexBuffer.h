@@ -25,9 +25,11 @@ public:
     void Unbind();
     void DrawElements();
     void DrawElements(uint offset, uint size);
+    void DrawElementsInstanced(uint instanceCount);
     bool IsBuffered() const;
 
     uint GetSize() const;
+    size_t DataSize() const { return mIndices.size() * sizeof(uint16); }
     GLenum GetPrimitiveType() const;
     void SetPrimitiveType(GLenum type);
 
@@ -0,0 +1,31 @@
+#include "CInstanceBuffer.h"
+
+CInstanceBuffer::~CInstanceBuffer()
+{
+    if (mBuffer != 0)
+        glDeleteBuffers(1, &mBuffer);
+}
+
+void CInstanceBuffer::Upload(const void *pkData, size_t Size)
+{
+    if (mBuffer == 0)
+        glGenBuffers(1, &mBuffer);
+
+    // Respecifying the storage orphans the previous contents, so there's no stall on draws still reading them
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    glBufferData(GL_ARRAY_BUFFER, Size, pkData, GL_STREAM_DRAW);
+}
+
+void CInstanceBuffer::EnableAttrib(GLuint Index, GLint NumComponents, GLsizei Stride, size_t Offset)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    glVertexAttribPointer(Index, NumComponents, GL_FLOAT, GL_FALSE, Stride, reinterpret_cast<const void*>(Offset));
+    glVertexAttribDivisor(Index, 1);
+    glEnableVertexAttribArray(Index);
+}
+
+void CInstanceBuffer::DisableAttrib(GLuint Index)
+{
+    glVertexAttribDivisor(Index, 0);
+    glDisableVertexAttribArray(Index);
+}
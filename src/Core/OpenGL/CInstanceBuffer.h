@@ -0,0 +1,24 @@
+#ifndef CINSTANCEBUFFER_H
+#define CINSTANCEBUFFER_H
+
+#include <Common/BasicTypes.h>
+#include <GL/glew.h>
+
+/**
+ * Per-instance vertex data for instanced draws. The whole buffer is re-uploaded
+ * each time a batch is drawn; attributes are attached to whichever vertex array
+ * is currently bound, so the same buffer can feed any kind of batched geometry.
+ */
+class CInstanceBuffer
+{
+    GLuint mBuffer = 0;
+
+public:
+    CInstanceBuffer() = default;
+    ~CInstanceBuffer();
+    void Upload(const void *pkData, size_t Size);
+    void EnableAttrib(GLuint Index, GLint NumComponents, GLsizei Stride, size_t Offset);
+    void DisableAttrib(GLuint Index);
+};
+
+#endif // CINSTANCEBUFFER_H
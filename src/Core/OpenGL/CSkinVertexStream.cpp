@@ -0,0 +1,85 @@
+#include "CSkinVertexStream.h"
+#include "CVertexArrayManager.h"
+#include <vector>
+
+CSkinVertexStream::CSkinVertexStream(CVertexBuffer *pVBO, CSkin *pSkin)
+    : mpVBO(pVBO)
+    , mpSkin(pSkin)
+{
+}
+
+CSkinVertexStream::~CSkinVertexStream()
+{
+    Clear();
+}
+
+void CSkinVertexStream::Buffer()
+{
+    Clear();
+
+    // Look up the weights of each vertex in the skin
+    const size_t NumVertices = mpVBO->Size();
+    std::vector<TBoneIndices> BoneIndices(NumVertices);
+    std::vector<TBoneWeights> BoneWeights(NumVertices);
+
+    for (size_t iVtx = 0; iVtx < NumVertices; iVtx++)
+    {
+        const SVertexWeights& rkWeights = mpSkin->WeightsForVertex(mpVBO->ArrayPosition(iVtx));
+        BoneIndices[iVtx] = rkWeights.Indices;
+        BoneWeights[iVtx] = rkWeights.Weights;
+    }
+
+    glGenBuffers(static_cast<GLsizei>(mAttribBuffers.size()), mAttribBuffers.data());
+
+    glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, BoneIndices.size() * sizeof(TBoneIndices), BoneIndices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, BoneWeights.size() * sizeof(TBoneWeights), BoneWeights.data(), GL_STATIC_DRAW);
+
+    mBuffered = true;
+}
+
+void CSkinVertexStream::Clear()
+{
+    CVertexArrayManager::DeleteAllArraysForVBO(this);
+
+    if (mBuffered)
+        glDeleteBuffers(static_cast<GLsizei>(mAttribBuffers.size()), mAttribBuffers.data());
+
+    mBuffered = false;
+}
+
+void CSkinVertexStream::Bind()
+{
+    if (!mpVBO->IsBuffered())
+        mpVBO->Buffer();
+
+    if (!mBuffered)
+        Buffer();
+
+    CVertexArrayManager::Current()->BindVAO(this);
+}
+
+void CSkinVertexStream::Unbind()
+{
+    glBindVertexArray(0);
+}
+
+GLuint CSkinVertexStream::CreateVAO()
+{
+    // Start from the regular vertex attributes, then add the skinning attributes on top
+    const GLuint VertexArray = mpVBO->CreateVAO();
+    glBindVertexArray(VertexArray);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[0]);
+    glVertexAttribIPointer(12, 1, GL_UNSIGNED_INT, sizeof(TBoneIndices), nullptr);
+    glEnableVertexAttribArray(12);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[1]);
+    glVertexAttribPointer(13, 4, GL_FLOAT, GL_FALSE, sizeof(TBoneWeights), nullptr);
+    glEnableVertexAttribArray(13);
+
+    glBindVertexArray(0);
+    return VertexArray;
+}
@@ -0,0 +1,37 @@
+#ifndef CSKINVERTEXSTREAM_H
+#define CSKINVERTEXSTREAM_H
+
+#include "CVertexBuffer.h"
+#include "Core/Resource/TResPtr.h"
+#include "Core/Resource/Animation/CSkin.h"
+#include <array>
+#include <GL/glew.h>
+
+/**
+ * Bone indices and weights for the vertices of a CVertexBuffer under one skin.
+ * The stream is bound alongside the vertex buffer it was built for, so the same
+ * model geometry can be drawn with different skins without being rebuilt.
+ */
+class CSkinVertexStream
+{
+    CVertexBuffer *mpVBO;
+    TResPtr<CSkin> mpSkin;
+    std::array<GLuint, 2> mAttribBuffers{};  // Bone indices, bone weights
+    bool mBuffered = false;
+
+public:
+    CSkinVertexStream(CVertexBuffer *pVBO, CSkin *pSkin);
+    ~CSkinVertexStream();
+    void Buffer();
+    void Clear();
+    void Bind();
+    void Unbind();
+    GLuint CreateVAO();
+
+    CVertexBuffer* VertexBuffer() const { return mpVBO; }
+    CSkin* Skin() const                 { return mpSkin; }
+    bool IsBuffered() const             { return mBuffered; }
+    size_t DataSize() const             { return mpVBO->Size() * (sizeof(TBoneIndices) + sizeof(TBoneWeights)); }
+};
+
+#endif // CSKINVERTEXSTREAM_H
@@ -19,6 +19,9 @@ CVertexArrayManager::~CVertexArrayManager()
     for (auto it = mDynamicVBOMap.begin(); it != mDynamicVBOMap.end(); it = mDynamicVBOMap.begin())
         DeleteVAO(it->first);
 
+    for (auto it = mSkinStreamMap.begin(); it != mSkinStreamMap.end(); it = mSkinStreamMap.begin())
+        DeleteVAO(it->first);
+
     sVAManagers.erase(sVAManagers.begin() + mVectorIndex);
 
     if (sVAManagers.size() > mVectorIndex)
@@ -67,6 +70,23 @@ void CVertexArrayManager::BindVAO(CDynamicVertexBuffer *pVBO)
     }
 }
 
+void CVertexArrayManager::BindVAO(CSkinVertexStream *pStream)
+{
+    // Overload for CSkinVertexStream
+    const auto it = mSkinStreamMap.find(pStream);
+
+    if (it != mSkinStreamMap.cend())
+    {
+        glBindVertexArray(it->second);
+    }
+    else
+    {
+        const GLuint VAO = pStream->CreateVAO();
+        mSkinStreamMap.insert_or_assign(pStream, VAO);
+        glBindVertexArray(VAO);
+    }
+}
+
 void CVertexArrayManager::DeleteVAO(CVertexBuffer *pVBO)
 {
     const auto it = mVBOMap.find(pVBO);
@@ -90,6 +110,18 @@ void CVertexArrayManager::DeleteVAO(CDynamicVertexBuffer *pVBO)
     mDynamicVBOMap.erase(it);
 }
 
+void CVertexArrayManager::DeleteVAO(CSkinVertexStream *pStream)
+{
+    // Overload for CSkinVertexStream
+    const auto it = mSkinStreamMap.find(pStream);
+
+    if (it == mSkinStreamMap.cend())
+        return;
+
+    glDeleteVertexArrays(1, &it->second);
+    mSkinStreamMap.erase(it);
+}
+
 // ************ STATIC ************
 CVertexArrayManager* CVertexArrayManager::Current()
 {
@@ -107,3 +139,9 @@ void CVertexArrayManager::DeleteAllArraysForVBO(CDynamicVertexBuffer *pVBO)
     for (auto* vam : sVAManagers)
         vam->DeleteVAO(pVBO);
 }
+
+void CVertexArrayManager::DeleteAllArraysForVBO(CSkinVertexStream *pStream)
+{
+    for (auto* vam : sVAManagers)
+        vam->DeleteVAO(pStream);
+}
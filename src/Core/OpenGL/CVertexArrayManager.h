@@ -2,6 +2,7 @@
 #define CVERTEXARRAYMANAGER_H
 
 #include "CDynamicVertexBuffer.h"
+#include "CSkinVertexStream.h"
 #include "CVertexBuffer.h"
 
 #include <unordered_map>
@@ -12,6 +13,7 @@ class CVertexArrayManager
 {
     std::unordered_map<CVertexBuffer*, GLuint> mVBOMap;
     std::unordered_map<CDynamicVertexBuffer*, GLuint> mDynamicVBOMap;
+    std::unordered_map<CSkinVertexStream*, GLuint> mSkinStreamMap;
     uint32 mVectorIndex = 0;
 
     static std::vector<CVertexArrayManager*> sVAManagers;
@@ -23,12 +25,15 @@ public:
     void SetCurrent();
     void BindVAO(CVertexBuffer *pVBO);
     void BindVAO(CDynamicVertexBuffer *pVBO);
+    void BindVAO(CSkinVertexStream *pStream);
     void DeleteVAO(CVertexBuffer *pVBO);
     void DeleteVAO(CDynamicVertexBuffer *pVBO);
+    void DeleteVAO(CSkinVertexStream *pStream);
 
     static CVertexArrayManager* Current();
     static void DeleteAllArraysForVBO(CVertexBuffer *pVBO);
     static void DeleteAllArraysForVBO(CDynamicVertexBuffer *pVBO);
+    static void DeleteAllArraysForVBO(CSkinVertexStream *pStream);
 };
 
 #endif // CVERTEXARRAYMANAGER_H
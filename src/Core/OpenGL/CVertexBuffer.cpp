@@ -50,14 +50,7 @@ uint16 CVertexBuffer::AddVertex(const CVertex& rkVtx)
             mTexCoords[iMtx].emplace_back(rkVtx.MatrixIndices[iMtx]);
     }
 
-    if (mVtxDesc.HasAnyFlags(EVertexAttribute::BoneIndices | EVertexAttribute::BoneWeights) && mpSkin != nullptr)
-    {
-        const SVertexWeights& rkWeights = mpSkin->WeightsForVertex(rkVtx.ArrayPosition);
-        if ((mVtxDesc & EVertexAttribute::BoneIndices) != 0)
-            mBoneIndices.emplace_back(rkWeights.Indices);
-        if ((mVtxDesc & EVertexAttribute::BoneWeights) != 0)
-            mBoneWeights.emplace_back(rkWeights.Weights);
-    }
+    mArrayPositions.emplace_back(rkVtx.ArrayPosition);
 
     return mPositions.size() - 1;
 }
@@ -110,19 +103,10 @@ uint16 CVertexBuffer::AddIfUnique(const CVertex& rkVtx, uint16 Start)
                 }
             }
 
-            if (!Unique && mpSkin != nullptr && (mVtxDesc.HasAnyFlags(EVertexAttribute::BoneIndices | EVertexAttribute::BoneWeights)))
+            if (!Unique && mSplitByArrayPosition)
             {
-                const SVertexWeights& rkWeights = mpSkin->WeightsForVertex(rkVtx.ArrayPosition);
-
-                for (uint32 iWgt = 0; iWgt < 4; iWgt++)
-                {
-                    if (((mVtxDesc & EVertexAttribute::BoneIndices) != 0 && (rkWeights.Indices[iWgt] != mBoneIndices[iVert][iWgt])) ||
-                        ((mVtxDesc & EVertexAttribute::BoneWeights) != 0 && (rkWeights.Weights[iWgt] != mBoneWeights[iVert][iWgt])))
-                    {
-                        Unique = true;
-                        break;
-                    }
-                }
+                if (rkVtx.ArrayPosition != mArrayPositions[iVert])
+                    Unique = true;
             }
 
             if (!Unique)
@@ -155,11 +139,7 @@ void CVertexBuffer::Reserve(size_t Size)
             mTexCoords[iTex].reserve(ReserveSize);
     }
 
-    if ((mVtxDesc & EVertexAttribute::BoneIndices) != 0)
-        mBoneIndices.reserve(ReserveSize);
-
-    if ((mVtxDesc & EVertexAttribute::BoneWeights) != 0)
-        mBoneWeights.reserve(ReserveSize);
+    mArrayPositions.reserve(ReserveSize);
 }
 
 void CVertexBuffer::Clear()
@@ -176,8 +156,7 @@ void CVertexBuffer::Clear()
     for (auto& coord : mTexCoords)
         coord.clear();
 
-    mBoneIndices.clear();
-    mBoneWeights.clear();
+    mArrayPositions.clear();
 }
 
 void CVertexBuffer::Buffer()
@@ -213,23 +192,13 @@ void CVertexBuffer::Buffer()
             glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
             glBufferData(GL_ARRAY_BUFFER, mColors[Index].size() * sizeof(CColor), mColors[Index].data(), GL_STATIC_DRAW);
         }
-        else if (iAttrib < 12)
+        else
         {
             const auto Index = static_cast<uint8>(iAttrib - 4);
 
             glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
             glBufferData(GL_ARRAY_BUFFER, mTexCoords[Index].size() * sizeof(CVector2f), mTexCoords[Index].data(), GL_STATIC_DRAW);
         }
-        else if (iAttrib == 12)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
-            glBufferData(GL_ARRAY_BUFFER, mBoneIndices.size() * sizeof(TBoneIndices), mBoneIndices.data(), GL_STATIC_DRAW);
-        }
-        else if (iAttrib == 13)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
-            glBufferData(GL_ARRAY_BUFFER, mBoneWeights.size() * sizeof(TBoneWeights), mBoneWeights.data(), GL_STATIC_DRAW);
-        }
     }
 
     mBuffered = true;
@@ -264,10 +233,10 @@ void CVertexBuffer::SetVertexDesc(FVertexDescription Desc)
     mVtxDesc = Desc;
 }
 
-void CVertexBuffer::SetSkin(CSkin *pSkin)
+void CVertexBuffer::SetSplitByArrayPosition(bool Split)
 {
     Clear();
-    mpSkin = pSkin;
+    mSplitByArrayPosition = Split;
 }
 
 size_t CVertexBuffer::Size() const
@@ -275,6 +244,26 @@ size_t CVertexBuffer::Size() const
     return mPositions.size();
 }
 
+/** Size of everything held in memory, including the array positions that never leave the CPU */
+size_t CVertexBuffer::DataSize() const
+{
+    return BufferedDataSize() + mArrayPositions.size() * sizeof(uint32);
+}
+
+/** Size of the vertex attributes that get uploaded to the GPU */
+size_t CVertexBuffer::BufferedDataSize() const
+{
+    size_t Size = mPositions.size() * sizeof(CVector3f) + mNormals.size() * sizeof(CVector3f);
+
+    for (const auto& rkColors : mColors)
+        Size += rkColors.size() * sizeof(CColor);
+
+    for (const auto& rkTexCoords : mTexCoords)
+        Size += rkTexCoords.size() * sizeof(CVector2f);
+
+    return Size;
+}
+
 GLuint CVertexBuffer::CreateVAO()
 {
     GLuint VertexArray;
@@ -299,24 +288,12 @@ GLuint CVertexBuffer::CreateVAO()
             glVertexAttribPointer(iAttrib, 1, GL_UNSIGNED_INT, GL_FALSE, sizeof(CColor), nullptr);
             glEnableVertexAttribArray(iAttrib);
         }
-        else if (iAttrib < 12)
+        else
         {
             glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
             glVertexAttribPointer(iAttrib, 2, GL_FLOAT, GL_FALSE, sizeof(CVector2f), nullptr);
             glEnableVertexAttribArray(iAttrib);
         }
-        else if (iAttrib == 12)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
-            glVertexAttribIPointer(iAttrib, 1, GL_UNSIGNED_INT, sizeof(TBoneIndices), nullptr);
-            glEnableVertexAttribArray(iAttrib);
-        }
-        else if (iAttrib == 13)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, mAttribBuffers[iAttrib]);
-            glVertexAttribPointer(iAttrib, 4, GL_FLOAT, GL_FALSE, sizeof(TBoneWeights), nullptr);
-            glEnableVertexAttribArray(iAttrib);
-        }
     }
 
     glBindVertexArray(0);
@@ -1,8 +1,6 @@
 #ifndef CVERTEXBUFFER_H
 #define CVERTEXBUFFER_H
 
-#include "Core/Resource/TResPtr.h"
-#include "Core/Resource/Animation/CSkin.h"
 #include "Core/Resource/Model/CVertex.h"
 #include "Core/Resource/Model/EVertexAttribute.h"
 #include <array>
@@ -12,14 +10,13 @@
 class CVertexBuffer
 {
     FVertexDescription mVtxDesc;                      // Flags that indicate what vertex attributes are enabled on this vertex buffer
-    std::array<GLuint, 14> mAttribBuffers{};          // Separate GL buffer for each attribute to allow not tracking unused attribs. No support for matrix indices currently.
-    TResPtr<CSkin> mpSkin;                            // Skin for skinned models. Null on unskinned models;
+    std::array<GLuint, 12> mAttribBuffers{};          // Separate GL buffer for each attribute to allow not tracking unused attribs. No support for matrix indices currently.
     std::vector<CVector3f> mPositions;                // Vector of vertex positions
     std::vector<CVector3f> mNormals;                  // Vector of vertex normals
     std::array<std::vector<CColor>, 2> mColors;       // Vectors of vertex colors
     std::array<std::vector<CVector2f>, 8> mTexCoords; // Vectors of texture coordinates
-    std::vector<TBoneIndices> mBoneIndices;           // Vectors of bone indices
-    std::vector<TBoneWeights> mBoneWeights;           // Vectors of bone weights
+    std::vector<uint32> mArrayPositions;              // Source vertex index of each vertex; used to look up skin weights
+    bool mSplitByArrayPosition = false;               // Never merge vertices from different source vertices. Required for skinning.
     bool mBuffered = false;                           // Bool value that indicates whether the attributes have been buffered.
 
 public:
@@ -36,8 +33,12 @@ public:
     bool IsBuffered() const;
     FVertexDescription VertexDesc() const;
     void SetVertexDesc(FVertexDescription Desc);
-    void SetSkin(CSkin *pSkin);
+    void SetSplitByArrayPosition(bool Split);
+    bool IsSplitByArrayPosition() const       { return mSplitByArrayPosition; }
     size_t Size() const;
+    size_t DataSize() const;
+    size_t BufferedDataSize() const;
+    uint32 ArrayPosition(size_t Vertex) const { return mArrayPositions[Vertex]; }
     GLuint CreateVAO();
 };
 
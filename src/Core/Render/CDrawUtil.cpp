@@ -3,6 +3,8 @@
 #include "Core/GameProject/CResourceStore.h"
 #include <Common/Log.h>
 #include <Common/Math/CTransform4f.h>
+#include <algorithm>
+#include <cstddef>
 
 // ************ PUBLIC ************
 void CDrawUtil::DrawGrid(CColor LineColor, CColor BoldLineColor)
@@ -254,6 +256,127 @@ void CDrawUtil::DrawLightBillboard(ELightType Type, const CColor& LightColor, co
 
 }
 
+void CDrawUtil::QueueBillboard(CTexture* pTexture, const CVector3f& Position, const CVector2f& Scale /*= CVector2f::skOne*/, const CColor& Tint /*= CColor::skWhite*/)
+{
+    SQueuedBillboard Billboard;
+    Billboard.pTexture = pTexture;
+    Billboard.Instance.Position = { Position.X, Position.Y, Position.Z };
+    Billboard.Instance.Scale = { Scale.X, Scale.Y };
+    Billboard.Instance.Tint = { Tint.R, Tint.G, Tint.B, Tint.A };
+    mQueuedBillboards.push_back(Billboard);
+}
+
+void CDrawUtil::QueueWireCube(const CAABox& kAABox, const CColor& kColor)
+{
+    const CVector3f Center = kAABox.Center();
+    const CVector3f Size = kAABox.Size();
+
+    SWireCubeInstance Cube;
+    Cube.Center = { Center.X, Center.Y, Center.Z };
+    Cube.Size = { Size.X, Size.Y, Size.Z };
+    Cube.Color = { kColor.R, kColor.G, kColor.B, kColor.A };
+    mQueuedWireCubes.push_back(Cube);
+}
+
+void CDrawUtil::FlushBatches()
+{
+    if (mQueuedBillboards.empty() && mQueuedWireCubes.empty())
+        return;
+
+    Init();
+
+    if (!mInstanceBuffer)
+        mInstanceBuffer.emplace();
+
+    // Same state the immediate draw functions use. Dropping the cached material makes the next material
+    // set its own blend and write masks up again; anything else a batch changes, it puts back itself.
+    CMaterial::KillCachedMaterial();
+    glBlendFunc(GL_ONE, GL_ZERO);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+
+    FlushBillboards();
+    FlushWireCubes();
+}
+
+void CDrawUtil::FlushBillboards()
+{
+    if (mQueuedBillboards.empty())
+        return;
+
+    // Group billboards by texture, then upload all instances at once
+    std::stable_sort(mQueuedBillboards.begin(), mQueuedBillboards.end(), [](const SQueuedBillboard& rkLeft, const SQueuedBillboard& rkRight) {
+        return rkLeft.pTexture < rkRight.pTexture;
+    });
+
+    mBillboardInstances.clear();
+    mBillboardInstances.reserve(mQueuedBillboards.size());
+
+    for (const SQueuedBillboard& rkBillboard : mQueuedBillboards)
+        mBillboardInstances.push_back(rkBillboard.Instance);
+
+    mInstanceBuffer->Upload(mBillboardInstances.data(), mBillboardInstances.size() * sizeof(SBillboardInstance));
+
+    mpBillboardShaderInstanced->SetCurrent();
+
+    // Set default tex coords
+    static constexpr std::array TexCoords{ CVector2f(0.f, 1.f), CVector2f(1.f, 1.f), CVector2f(1.f, 0.f), CVector2f(0.f, 0.f) };
+    mSquareVertices->BufferAttrib(EVertexAttribute::Tex0, TexCoords.data());
+    mSquareVertices->Bind();
+
+    // One draw per texture; each draw points the instance attributes at its own range of the buffer
+    constexpr GLsizei kStride = sizeof(SBillboardInstance);
+    size_t RunStart = 0;
+
+    while (RunStart < mQueuedBillboards.size())
+    {
+        CTexture *pTexture = mQueuedBillboards[RunStart].pTexture;
+        size_t RunEnd = RunStart + 1;
+
+        while (RunEnd < mQueuedBillboards.size() && mQueuedBillboards[RunEnd].pTexture == pTexture)
+            RunEnd++;
+
+        const size_t BaseOffset = RunStart * kStride;
+        mInstanceBuffer->EnableAttrib(12, 3, kStride, BaseOffset + offsetof(SBillboardInstance, Position));
+        mInstanceBuffer->EnableAttrib(13, 2, kStride, BaseOffset + offsetof(SBillboardInstance, Scale));
+        mInstanceBuffer->EnableAttrib(14, 4, kStride, BaseOffset + offsetof(SBillboardInstance, Tint));
+
+        pTexture->Bind(0);
+        mSquareIndices.DrawElementsInstanced(static_cast<uint>(RunEnd - RunStart));
+        RunStart = RunEnd;
+    }
+
+    mInstanceBuffer->DisableAttrib(12);
+    mInstanceBuffer->DisableAttrib(13);
+    mInstanceBuffer->DisableAttrib(14);
+    mSquareVertices->Unbind();
+    mQueuedBillboards.clear();
+}
+
+void CDrawUtil::FlushWireCubes()
+{
+    if (mQueuedWireCubes.empty())
+        return;
+
+    mInstanceBuffer->Upload(mQueuedWireCubes.data(), mQueuedWireCubes.size() * sizeof(SWireCubeInstance));
+    mpColorShaderInstanced->SetCurrent();
+    glLineWidth(1.f);
+
+    constexpr GLsizei kStride = sizeof(SWireCubeInstance);
+    mWireCubeVertices->Bind();
+    mInstanceBuffer->EnableAttrib(12, 3, kStride, offsetof(SWireCubeInstance, Center));
+    mInstanceBuffer->EnableAttrib(13, 3, kStride, offsetof(SWireCubeInstance, Size));
+    mInstanceBuffer->EnableAttrib(14, 4, kStride, offsetof(SWireCubeInstance, Color));
+
+    mWireCubeIndices.DrawElementsInstanced(static_cast<uint>(mQueuedWireCubes.size()));
+
+    mInstanceBuffer->DisableAttrib(12);
+    mInstanceBuffer->DisableAttrib(13);
+    mInstanceBuffer->DisableAttrib(14);
+    mWireCubeVertices->Unbind();
+    mQueuedWireCubes.clear();
+}
+
 void CDrawUtil::UseColorShader(const CColor& kColor)
 {
     Init();
@@ -533,6 +656,8 @@ void CDrawUtil::InitShaders()
     mpTextureShader        = CShader::FromResourceFile("TextureShader");
     mpCollisionShader      = CShader::FromResourceFile("CollisionShader");
     mpTextShader           = CShader::FromResourceFile("TextShader");
+    mpColorShaderInstanced     = CShader::FromResourceFile("ColorShaderInstanced");
+    mpBillboardShaderInstanced = CShader::FromResourceFile("BillboardShaderInstanced");
 }
 
 void CDrawUtil::InitTextures()
@@ -566,5 +691,10 @@ void CDrawUtil::Shutdown()
     mpTextureShader.reset();
     mpCollisionShader.reset();
     mpTextShader.reset();
+    mpColorShaderInstanced.reset();
+    mpBillboardShaderInstanced.reset();
+    mInstanceBuffer.reset();
+    mQueuedBillboards.clear();
+    mQueuedWireCubes.clear();
     mDrawUtilInitialized = false;
 }
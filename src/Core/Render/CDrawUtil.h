@@ -4,11 +4,13 @@
 #include "Core/OpenGL/CVertexBuffer.h"
 #include "Core/OpenGL/CDynamicVertexBuffer.h"
 #include "Core/OpenGL/CIndexBuffer.h"
+#include "Core/OpenGL/CInstanceBuffer.h"
 #include "Core/Resource/Model/CModel.h"
 #include "Core/Resource/CLight.h"
 
 #include <array>
 #include <optional>
+#include <vector>
 
 /**
  * @todo there are a LOT of problems with how this is implemented; trying to
@@ -45,6 +47,32 @@ class CDrawUtil
     // Wire Sphere
     static inline TResPtr<CModel> mpWireSphereModel;
 
+    // Instanced batches
+    struct SBillboardInstance
+    {
+        std::array<float, 3> Position;
+        std::array<float, 2> Scale;
+        std::array<float, 4> Tint;
+    };
+
+    struct SQueuedBillboard
+    {
+        CTexture *pTexture;
+        SBillboardInstance Instance;
+    };
+
+    struct SWireCubeInstance
+    {
+        std::array<float, 3> Center;
+        std::array<float, 3> Size;
+        std::array<float, 4> Color;
+    };
+
+    static inline std::optional<CInstanceBuffer> mInstanceBuffer;
+    static inline std::vector<SQueuedBillboard> mQueuedBillboards;
+    static inline std::vector<SBillboardInstance> mBillboardInstances;
+    static inline std::vector<SWireCubeInstance> mQueuedWireCubes;
+
     // Shaders
     static inline std::unique_ptr<CShader> mpColorShader;
     static inline std::unique_ptr<CShader> mpColorShaderLighting;
@@ -53,6 +81,8 @@ class CDrawUtil
     static inline std::unique_ptr<CShader> mpTextureShader;
     static inline std::unique_ptr<CShader> mpCollisionShader;
     static inline std::unique_ptr<CShader> mpTextShader;
+    static inline std::unique_ptr<CShader> mpColorShaderInstanced;
+    static inline std::unique_ptr<CShader> mpBillboardShaderInstanced;
 
     // Textures
     static inline TResPtr<CTexture> mpCheckerTexture;
@@ -92,6 +122,12 @@ public:
 
     static void DrawLightBillboard(ELightType Type, const CColor& LightColor, const CVector3f& Position, const CVector2f& Scale = CVector2f::One(), const CColor& Tint = CColor::White());
 
+    // Queued draws are collected and drawn with one instanced call per kind (and per texture for billboards).
+    // The renderer flushes them after drawing each render bucket.
+    static void QueueBillboard(CTexture* pTexture, const CVector3f& Position, const CVector2f& Scale = CVector2f::One(), const CColor& Tint = CColor::White());
+    static void QueueWireCube(const CAABox& AABox, const CColor& Color);
+    static void FlushBatches();
+
     static void UseColorShader(const CColor& Color);
     static void UseColorShaderLighting(const CColor& Color);
     static void UseTextureShader();
@@ -116,6 +152,8 @@ private:
     static void InitWireSphere();
     static void InitShaders();
     static void InitTextures();
+    static void FlushBillboards();
+    static void FlushWireCubes();
 
 public:
     static void Shutdown();
@@ -76,6 +76,9 @@ void CRenderBucket::CSubBucket::Draw(const SViewInfo& rkViewInfo)
         else
             rkPtr.pRenderable->Draw(Options, rkPtr.ComponentIndex, rkPtr.Command, rkViewInfo);
     }
+
+    // Draw everything the renderables queued up for instanced drawing
+    CDrawUtil::FlushBatches();
 }
 
 // ************ CRenderBucket ************
@@ -1,6 +1,8 @@
 #include "CGameArea.h"
+#include "Core/Resource/Factory/CAreaLoader.h"
 #include "Core/Resource/Script/CScriptLayer.h"
 #include "Core/Render/CRenderer.h"
+#include <Common/Hash/CFNV1A.h>
 
 CGameArea::CGameArea(CResourceEntry *pEntry)
     : CResource(pEntry)
@@ -44,9 +46,124 @@ std::unique_ptr<CDependencyTree> CGameArea::BuildDependencyTree() const
         pTree->AddScriptLayer(mScriptLayers[iLayer].get(), rkExtras);
     }
 
+    ResetDependencyEdits();
     return pTree;
 }
 
+bool CGameArea::UpdateDependencyTree(CDependencyTree *pTree, std::set<CAssetID>& rNewReferences)
+{
+    if (!mCanUpdateDependencies || pTree->Type() != EDependencyNodeType::Area)
+        return false;
+
+    auto *pAreaTree = static_cast<CAreaDependencyTree*>(pTree);
+
+    if (pAreaTree->NumScriptLayers() != mScriptLayers.size())
+        return false;
+
+    // Replay layer edits so instance nodes line up with the layers again. Added instances are always
+    // marked dirty, so their placeholder nodes are filled in below.
+    for (const SLayerInstanceEdit& rkEdit : mLayerInstanceEdits)
+    {
+        const bool Success = rkEdit.Insert ?
+            pAreaTree->InsertScriptInstance(rkEdit.LayerIndex, rkEdit.InstanceIndex, std::make_unique<CScriptInstanceDependency>()) :
+            pAreaTree->RemoveScriptInstance(rkEdit.LayerIndex, rkEdit.InstanceIndex);
+
+        if (!Success)
+            return false;
+    }
+
+    // Trees from older versions only have nodes for instances that have dependencies
+    for (size_t LayerIdx = 0; LayerIdx < mScriptLayers.size(); LayerIdx++)
+    {
+        if (!pAreaTree->HasScriptInstanceNodes(LayerIdx, mScriptLayers[LayerIdx]->NumInstances()))
+            return false;
+    }
+
+    for (const uint32 InstanceID : mDirtyDependencyInstances)
+    {
+        // Instances can be deleted after being edited
+        const auto Iter = mObjectMap.find(InstanceID);
+
+        if (Iter == mObjectMap.cend())
+            continue;
+
+        CScriptObject *pInstance = Iter->second;
+        auto pNode = CScriptInstanceDependency::BuildTree(pInstance);
+        pNode->GetAllResourceReferences(rNewReferences);
+
+        if (!pAreaTree->SetScriptInstance(pInstance->Layer()->AreaIndex(), pInstance->LayerIndex(), std::move(pNode)))
+            return false;
+    }
+
+    ResetDependencyEdits();
+    return true;
+}
+
+SResourceMemoryUsage CGameArea::MemoryUsage() const
+{
+    // World models are owned by the area rather than the resource store, so they're counted here
+    SResourceMemoryUsage Usage;
+
+    for (const auto& pModel : mWorldModels)
+        Usage += pModel->MemoryUsage();
+
+    for (const auto& pModel : mStaticWorldModels)
+        Usage += pModel->MemoryUsage();
+
+    return Usage;
+}
+
+bool CGameArea::ReadSectionData(const std::set<uint32>& rkRegeneratedSections, std::vector<std::vector<uint8>>& rOutSections) const
+{
+    CResourceEntry *pEntry = Entry();
+
+    if (!pEntry || !pEntry->HasCookedVersion())
+    {
+        errorf("Unable to load area section data; there is no cooked file to read it from");
+        return false;
+    }
+
+    const TString CookedPath = pEntry->CookedAssetPath();
+    CFileInStream MREA(CookedPath, EEndian::BigEndian);
+    rOutSections.clear();
+
+    if (!CAreaLoader::LoadSectionData(MREA, rOutSections) || rOutSections.size() != mSectionData.size())
+    {
+        errorf("%s: Failed to load area section data", *CookedPath);
+        return false;
+    }
+
+    // Make sure the file still contains the data that was there when the area was loaded
+    for (uint32 iSec = 0; iSec < rOutSections.size(); iSec++)
+    {
+        std::vector<uint8>& rData = rOutSections[iSec];
+
+        if (rkRegeneratedSections.count(iSec) != 0)
+        {
+            std::vector<uint8>().swap(rData);
+            continue;
+        }
+
+        const SPassthroughSection& rkSection = mSectionData[iSec];
+
+        if (rData.size() != rkSection.Size || HashSectionData(rData.data(), rkSection.Size) != rkSection.Hash)
+        {
+            errorf("%s: Section %d has changed since the area was loaded", *CookedPath, iSec);
+            rOutSections.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64 CGameArea::HashSectionData(const uint8 *pkData, uint32 Size)
+{
+    CFNV1A Hash(CFNV1A::EHashLength::k64Bit);
+    Hash.HashData(pkData, Size);
+    return Hash.GetHash64();
+}
+
 void CGameArea::AddWorldModel(std::unique_ptr<CModel>&& pModel)
 {
     mVertexCount += pModel->GetVertexCount();
@@ -116,6 +233,7 @@ void CGameArea::ClearTerrain()
 void CGameArea::ClearScriptLayers()
 {
     mScriptLayers.clear();
+    mCanUpdateDependencies = false;
 }
 
 size_t CGameArea::TotalInstanceCount() const
@@ -239,6 +357,39 @@ void CGameArea::ClearExtraDependencies()
     {
         mExtraAreaDeps.clear();
         mExtraLayerDeps.clear();
+        mCanUpdateDependencies = false;
         Entry()->UpdateDependencies();
     }
 }
+
+void CGameArea::OnLayerInstanceAdded(CScriptLayer *pLayer, CScriptObject *pInstance, size_t Index)
+{
+    // Layers that aren't part of the area (such as the generated layer while loading) aren't in the tree
+    const uint32 LayerIdx = pLayer->AreaIndex();
+
+    if (LayerIdx != UINT32_MAX)
+    {
+        mLayerInstanceEdits.push_back(SLayerInstanceEdit{true, LayerIdx, static_cast<uint32>(Index)});
+        mDirtyDependencyInstances.insert(pInstance->InstanceID());
+    }
+}
+
+void CGameArea::OnLayerInstanceRemoved(CScriptLayer *pLayer, size_t Index)
+{
+    const uint32 LayerIdx = pLayer->AreaIndex();
+
+    if (LayerIdx != UINT32_MAX)
+        mLayerInstanceEdits.push_back(SLayerInstanceEdit{false, LayerIdx, static_cast<uint32>(Index)});
+}
+
+void CGameArea::MarkInstanceDependenciesDirty(const CScriptObject *pInstance)
+{
+    mDirtyDependencyInstances.insert(pInstance->InstanceID());
+}
+
+void CGameArea::ResetDependencyEdits() const
+{
+    mLayerInstanceEdits.clear();
+    mDirtyDependencyInstances.clear();
+    mCanUpdateDependencies = true;
+}
@@ -13,6 +13,7 @@
 #include <Common/Math/CTransform4f.h>
 
 #include <memory>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -33,8 +34,17 @@ class CGameArea : public CResource
     CTransform4f mTransform;
     CAABox mAABox;
 
-    // Data saved from the original file to help on recook
-    std::vector<std::vector<uint8>> mSectionDataBuffers;
+    // Data saved from the original file to help on recook. Sections that are passed through unchanged aren't
+    // kept in memory; only their size and hash are recorded on load, and the data is read back from the cooked
+    // file each time the area is cooked.
+    struct SPassthroughSection
+    {
+        uint32 Size = 0;
+        uint64 Hash = 0;
+    };
+    std::vector<SPassthroughSection> mSectionData;
+
+    static uint64 HashSectionData(const uint8 *pkData, uint32 Size);
     uint32 mOriginalWorldMeshCount = 0;
     bool mUsesCompression = false;
 
@@ -66,10 +76,29 @@ class CGameArea : public CResource
     std::vector<CAssetID> mExtraAreaDeps;
     std::vector< std::vector<CAssetID> > mExtraLayerDeps;
 
+    // Script edits made since the dependency tree was last built, so it can be updated in place on save
+    struct SLayerInstanceEdit
+    {
+        bool Insert;
+        uint32 LayerIndex;
+        uint32 InstanceIndex;
+    };
+    mutable std::vector<SLayerInstanceEdit> mLayerInstanceEdits;
+    mutable std::set<uint32> mDirtyDependencyInstances;
+    mutable bool mCanUpdateDependencies = false;
+
 public:
     explicit CGameArea(CResourceEntry *pEntry = nullptr);
     ~CGameArea() override;
     std::unique_ptr<CDependencyTree> BuildDependencyTree() const override;
+    bool UpdateDependencyTree(CDependencyTree *pTree, std::set<CAssetID>& rNewReferences) override;
+    SResourceMemoryUsage MemoryUsage() const override;
+
+    /**
+     * Read passthrough section data back from the cooked file for the cooker. Regenerated sections are skipped, since
+     * a previous cook may have rewritten them. Fails if any other section no longer matches what was loaded.
+     */
+    bool ReadSectionData(const std::set<uint32>& rkRegeneratedSections, std::vector<std::vector<uint8>>& rOutSections) const;
 
     void AddWorldModel(std::unique_ptr<CModel>&& pModel);
     void MergeTerrain();
@@ -88,6 +117,12 @@ public:
     void DeleteInstance(CScriptObject *pInstance);
     void ClearExtraDependencies();
 
+    /** Dependency edit tracking. Script layers report instance moves; callers editing instance properties must mark them dirty. */
+    void OnLayerInstanceAdded(CScriptLayer *pLayer, CScriptObject *pInstance, size_t Index);
+    void OnLayerInstanceRemoved(CScriptLayer *pLayer, size_t Index);
+    void MarkInstanceDependenciesDirty(const CScriptObject *pInstance);
+    void ResetDependencyEdits() const;
+
     // Accessors
     uint32 WorldIndex() const                                    { return mWorldIndex; }
     CTransform4f Transform() const                               { return mTransform; }
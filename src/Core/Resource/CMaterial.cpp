@@ -54,6 +54,21 @@ std::unique_ptr<CMaterial> CMaterial::Clone()
     return pOut;
 }
 
+CMaterial* CMaterial::GetSkinnedVersion()
+{
+    if (!mpSkinnedMaterial)
+    {
+        const FVertexDescription kBoneFlags = (EVertexAttribute::BoneIndices | EVertexAttribute::BoneWeights);
+        mpSkinnedMaterial = Clone();
+        mpSkinnedMaterial->mpBloomMaterial.reset();
+
+        for (CMaterial *pMat = mpSkinnedMaterial.get(); pMat; pMat = pMat->GetNextDrawPass())
+            pMat->SetVertexDescription(pMat->mVtxDesc | kBoneFlags);
+    }
+
+    return mpSkinnedMaterial.get();
+}
+
 void CMaterial::GenerateShader(bool AllowRegen /*= true*/)
 {
     HashParameters(); // Calling HashParameters() may change mShaderStatus so call it before checking
@@ -245,6 +260,7 @@ void CMaterial::Update()
 {
     mRecalcHash = true;
     mShaderStatus = EShaderStatus::NoShader;
+    mpSkinnedMaterial.reset();
 }
 
 void CMaterial::SetNumPasses(size_t NumPasses)
@@ -259,4 +275,5 @@ void CMaterial::SetNumPasses(size_t NumPasses)
     }
 
     mRecalcHash = true;
+    mpSkinnedMaterial.reset();
 }
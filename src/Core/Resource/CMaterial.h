@@ -104,6 +104,10 @@ private:
     // (only set in the head non-bloom CMaterial).
     std::unique_ptr<CMaterial> mpBloomMaterial;
 
+    // Copy of this material with bone attributes added to the vertex description, used to draw
+    // skinned models. Created on first use and dropped whenever this material is modified.
+    std::unique_ptr<CMaterial> mpSkinnedMaterial;
+
     // Reuse shaders between materials that have identical TEV setups
     struct SMaterialShader
     {
@@ -142,14 +146,15 @@ public:
     CMaterialPass* Pass(size_t PassIndex) const  { return mPasses[PassIndex].get(); }
     CMaterial* GetNextDrawPass() const           { return mpNextDrawPassMaterial.get(); }
     CMaterial* GetBloomVersion() const           { return mpBloomMaterial.get(); }
+    CMaterial* GetSkinnedVersion();
 
     void SetName(TString rkName)                        { mName = std::move(rkName); }
     void SetOptions(FMaterialOptions Options)           { mOptions = Options; Update(); }
     void SetVertexDescription(FVertexDescription Desc)  { mVtxDesc = Desc; Update(); }
-    void SetBlendMode(GLenum SrcFac, GLenum DstFac)     { mBlendSrcFac = SrcFac; mBlendDstFac = DstFac; mRecalcHash = true; }
+    void SetBlendMode(GLenum SrcFac, GLenum DstFac)     { mBlendSrcFac = SrcFac; mBlendDstFac = DstFac; mRecalcHash = true; mpSkinnedMaterial.reset(); }
     void SetKonst(const CColor& Konst, size_t KIndex)   { mKonstColors[KIndex] = Konst; Update(); }
-    void SetTevColor(const CColor& Color, ETevOutput Out) { mTevColors[static_cast<size_t>(Out)] = Color; }
-    void SetIndTexture(CTexture *pTex)                  { mpIndirectTexture = pTex; }
+    void SetTevColor(const CColor& Color, ETevOutput Out) { mTevColors[static_cast<size_t>(Out)] = Color; mpSkinnedMaterial.reset(); }
+    void SetIndTexture(CTexture *pTex)                  { mpIndirectTexture = pTex; mpSkinnedMaterial.reset(); }
     void SetLightingEnabled(bool Enabled)               { mLightingEnabled = Enabled; Update(); }
 
     // Static
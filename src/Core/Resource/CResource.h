@@ -3,6 +3,7 @@
 
 #include "CResTypeInfo.h"
 #include "EResType.h"
+#include "SResourceMemoryUsage.h"
 #include "Core/GameProject/CDependencyTree.h"
 #include "Core/GameProject/CResourceEntry.h"
 #include "Core/GameProject/CResourceStore.h"
@@ -11,6 +12,7 @@
 #include <Common/TString.h>
 #include <Common/Serialization/IArchive.h>
 #include <memory>
+#include <set>
 
 // This macro creates functions that allow us to easily identify this resource type.
 // Must be included on every CResource subclass.
@@ -43,9 +45,18 @@ public:
 
     virtual ~CResource() {}
     virtual std::unique_ptr<CDependencyTree> BuildDependencyTree() const { return std::make_unique<CDependencyTree>(); }
+
+    /**
+     * Bring an existing dependency tree up to date with edits made since it was built, without rebuilding it.
+     * Outputs every reference held by the nodes that were rebuilt. Returns false if a full rebuild is needed.
+     */
+    virtual bool UpdateDependencyTree(CDependencyTree* /*pTree*/, std::set<CAssetID>& /*rNewReferences*/) { return false; }
     virtual void Serialize(IArchive& /*rArc*/) {}
     virtual void InitializeNewResource()       {}
 
+    /** Approximate memory held by this resource, used for resident memory accounting */
+    virtual SResourceMemoryUsage MemoryUsage() const { return {}; }
+
     CResourceEntry* Entry() const    { return mpEntry; }
     CResTypeInfo* TypeInfo() const   { return mpEntry->TypeInfo(); }
     EResourceType Type() const       { return mpEntry->TypeInfo()->Type(); }
@@ -54,8 +65,22 @@ public:
     CAssetID ID() const              { return mpEntry ? mpEntry->ID() : CAssetID::skInvalidID64; }
     EGame Game() const               { return mpEntry ? mpEntry->Game() : EGame::Invalid; }
     bool IsReferenced() const        { return mRefCount > 0; }
-    void Lock()                      { mRefCount++; }
-    void Release()                   { mRefCount--; }
+
+    /**
+     * Reference counting, normally done through TResPtr. The count isn't atomic and changes notify the
+     * resource store, so only call these from the thread that owns the store, never from loader workers.
+     */
+    void Lock()
+    {
+        if (mRefCount++ == 0 && mpEntry)
+            mpEntry->ResourceStore()->OnResourceReferenced(mpEntry);
+    }
+
+    void Release()
+    {
+        if (--mRefCount == 0 && mpEntry)
+            mpEntry->ResourceStore()->OnResourceUnreferenced(mpEntry);
+    }
 };
 
 #endif // CRESOURCE_H
@@ -259,6 +259,14 @@ bool CTexture::WriteDDS(IOutputStream& rOut)
     return true;
 }
 
+SResourceMemoryUsage CTexture::MemoryUsage() const
+{
+    SResourceMemoryUsage Usage;
+    Usage.CPUBytes = (mBufferExists ? mImgDataSize : 0);
+    Usage.GPUBytes = (mGLBufferExists ? CalcTotalSize() * (mEnableMultisampling ? 4 : 1) : 0);
+    return Usage;
+}
+
 // ************ STATIC ************
 uint32 CTexture::FormatBPP(ETexelFormat Format)
 {
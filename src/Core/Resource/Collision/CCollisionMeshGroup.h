@@ -2,6 +2,7 @@
 #define CCOLLISIONMESHGROUP_H
 
 #include "CCollisionMesh.h"
+#include "Core/NParallel.h"
 #include "Core/Resource/CResource.h"
 #include "Core/Resource/TResPtr.h"
 #include <Common/Math/CTransform4f.h>
@@ -23,8 +24,10 @@ public:
 
     void BuildRenderData()
     {
-        for (auto& mesh : mMeshes)
-            mesh->BuildRenderData();
+        // Each mesh only touches its own render data, so they can be built in parallel
+        NParallel::ParallelFor(mMeshes.size(), [this](size_t MeshIdx) {
+            mMeshes[MeshIdx]->BuildRenderData();
+        });
     }
 
     void Draw()
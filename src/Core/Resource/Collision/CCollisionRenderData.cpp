@@ -1,10 +1,42 @@
 #include "CCollisionRenderData.h"
 #include <Core/Render/CDrawUtil.h>
+#include <Common/Log.h>
+#include <Common/Math/MathUtil.h>
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-/** Build from collision data */
+namespace
+{
+
+/**
+ * Collision triangles are flat shaded, so two triangles can only share a vertex if they also
+ * share a normal. The normal is quantized so that coplanar triangles reliably end up sharing.
+ */
+uint64 SharedVertexKey(uint16 VertexIndex, const CVector3f& rkNormal)
+{
+    const auto Quantize = [](float Value) -> uint64 {
+        return static_cast<uint16>(static_cast<int16>(std::lround(Math::Clamp(-1.f, 1.f, Value) * 16384.f)));
+    };
+
+    return (static_cast<uint64>(VertexIndex) << 48) | (Quantize(rkNormal.X) << 32) |
+           (Quantize(rkNormal.Y) << 16) | Quantize(rkNormal.Z);
+}
+
+uint32 EdgeKey(uint16 VertA, uint16 VertB)
+{
+    return (static_cast<uint32>(std::min(VertA, VertB)) << 16) | std::max(VertA, VertB);
+}
+
+} // anonymous namespace
+
+/**
+ * Build from collision data. This only fills in the CPU-side buffers, which are uploaded on first draw,
+ * so different render data objects can be built concurrently.
+ */
 void CCollisionRenderData::BuildRenderData(const SCollisionIndexData& kIndexData)
 {
     // Clear any existing data
@@ -21,103 +53,133 @@ void CCollisionRenderData::BuildRenderData(const SCollisionIndexData& kIndexData
     mIndexBuffer.SetPrimitiveType(GL_TRIANGLES);
     mWireframeIndexBuffer.SetPrimitiveType(GL_LINES);
 
-    // Build list of triangle indices sorted by material index
+    // Bucket triangles by material index with a counting sort
     // Apparently some collision meshes have more triangle indices than actual triangles
-    const uint NumTris = std::min(kIndexData.TriangleIndices.size() / 3, kIndexData.TriangleMaterialIndices.size());
-    std::vector<uint16> SortedTris(NumTris);
+    const size_t NumTris = std::min(kIndexData.TriangleIndices.size() / 3, kIndexData.TriangleMaterialIndices.size());
+    const size_t NumMaterials = kIndexData.Materials.size();
+    std::vector<uint32> MaterialTriOffsets(NumMaterials + 1, 0);
 
-    for (uint16 i = 0; i < SortedTris.size(); i++)
+    for (size_t TriIdx = 0; TriIdx < NumTris; TriIdx++)
     {
-        SortedTris[i] = i;
+        const uint8 MaterialIdx = kIndexData.TriangleMaterialIndices[TriIdx];
+
+        if (MaterialIdx < NumMaterials)
+            MaterialTriOffsets[MaterialIdx + 1]++;
     }
 
-    std::sort(SortedTris.begin(), SortedTris.end(), [kIndexData](uint16 Left, uint16 Right) -> bool {
-        return kIndexData.TriangleMaterialIndices[Left] < kIndexData.TriangleMaterialIndices[Right];
-    });
+    for (size_t MatIdx = 0; MatIdx < NumMaterials; MatIdx++)
+    {
+        MaterialTriOffsets[MatIdx + 1] += MaterialTriOffsets[MatIdx];
+    }
 
-    mVertexBuffer.Reserve(SortedTris.size() * 3);
-    mIndexBuffer.Reserve(SortedTris.size() * 3);
-    mWireframeIndexBuffer.Reserve(SortedTris.size() * 6);
-    mMaterialIndexOffsets.reserve(kIndexData.Materials.size());
-    uint8 CurrentMatIdx = 0xFF;
+    std::vector<uint32> SortedTris(MaterialTriOffsets.back());
+    std::vector<uint32> BucketCursors(MaterialTriOffsets.begin(), MaterialTriOffsets.end() - 1);
 
-    for (const size_t TriIdx : SortedTris)
+    for (size_t TriIdx = 0; TriIdx < NumTris; TriIdx++)
     {
         const uint8 MaterialIdx = kIndexData.TriangleMaterialIndices[TriIdx];
-        const CCollisionMaterial& kMaterial = kIndexData.Materials[MaterialIdx];
 
-        if (MaterialIdx != CurrentMatIdx)
+        if (MaterialIdx < NumMaterials)
+            SortedTris[BucketCursors[MaterialIdx]++] = static_cast<uint32>(TriIdx);
+    }
+
+    // Shared vertices are looked up by source vertex + normal. Wireframe edges are looked up by source
+    // vertices, per material, so each edge is only drawn once even if its vertices were split by normal.
+    std::unordered_map<uint64, uint16> SharedVertices;
+    std::unordered_set<uint32> MaterialEdges;
+    SharedVertices.reserve(kIndexData.Vertices.size() * 2);
+
+    mVertexBuffer.Reserve(std::min<size_t>(SortedTris.size() * 3, 0xFFFF));
+    mIndexBuffer.Reserve(SortedTris.size() * 3);
+    mWireframeIndexBuffer.Reserve(SortedTris.size() * 4);
+    mMaterialIndexOffsets.reserve(NumMaterials + 1);
+    mMaterialWireIndexOffsets.reserve(NumMaterials + 1);
+    bool VertexBufferFull = false;
+
+    for (size_t MatIdx = 0; MatIdx < NumMaterials; MatIdx++)
+    {
+        // Note some collision materials have no geometry associated with them as
+        // some materials are exclusively used with edges/vertices.
+        mMaterialIndexOffsets.push_back(mIndexBuffer.GetSize());
+        mMaterialWireIndexOffsets.push_back(mWireframeIndexBuffer.GetSize());
+        MaterialEdges.clear();
+
+        const CCollisionMaterial& kMaterial = kIndexData.Materials[MatIdx];
+
+        for (uint32 SortIdx = MaterialTriOffsets[MatIdx]; SortIdx < MaterialTriOffsets[MatIdx + 1] && !VertexBufferFull; SortIdx++)
         {
-            // Note some collision materials have no geometry associated with them as
-            // some materials are exclusively used with edges/vertices.
-            ASSERT(CurrentMatIdx < MaterialIdx || CurrentMatIdx == 0xFF);
+            const size_t TriIdx = SortedTris[SortIdx];
+            const size_t LineA = kIndexData.TriangleIndices[(TriIdx * 3) + 0];
+            const size_t LineB = kIndexData.TriangleIndices[(TriIdx * 3) + 1];
+            const uint16 LineAVertA = kIndexData.EdgeIndices[(LineA * 2) + 0];
+            const uint16 LineAVertB = kIndexData.EdgeIndices[(LineA * 2) + 1];
+            const uint16 LineBVertA = kIndexData.EdgeIndices[(LineB * 2) + 0];
+            const uint16 LineBVertB = kIndexData.EdgeIndices[(LineB * 2) + 1];
+            std::array<uint16, 3> SourceIndices{
+                LineAVertA,
+                LineAVertB,
+                (LineBVertA != LineAVertA && LineBVertA != LineAVertB ? LineBVertA : LineBVertB)
+            };
 
-            while (CurrentMatIdx != MaterialIdx)
+            // Reverse vertex order if material indicates tri is flipped
+            if (kMaterial & eCF_FlippedTri)
             {
-                mMaterialIndexOffsets.push_back(mIndexBuffer.GetSize());
-                CurrentMatIdx++;
+                std::swap(SourceIndices[0], SourceIndices[2]);
             }
-        }
 
-        const size_t LineA = kIndexData.TriangleIndices[(TriIdx * 3) + 0];
-        const size_t LineB = kIndexData.TriangleIndices[(TriIdx * 3) + 1];
-        const uint16 LineAVertA = kIndexData.EdgeIndices[(LineA * 2) + 0];
-        const uint16 LineAVertB = kIndexData.EdgeIndices[(LineA * 2) + 1];
-        const uint16 LineBVertA = kIndexData.EdgeIndices[(LineB * 2) + 0];
-        const uint16 LineBVertB = kIndexData.EdgeIndices[(LineB * 2) + 1];
-        uint16 VertIdx0 = LineAVertA;
-        uint16 VertIdx1 = LineAVertB;
-        uint16 VertIdx2 = (LineBVertA != LineAVertA && LineBVertA != LineAVertB ? LineBVertA : LineBVertB);
-
-        // Reverse vertex order if material indicates tri is flipped
-        if (kMaterial & eCF_FlippedTri)
-        {
-            std::swap(VertIdx0, VertIdx2);
-        }
+            // Generate vertex data
+            const CVector3f& kVert0 = kIndexData.Vertices[SourceIndices[0]];
+            const CVector3f& kVert1 = kIndexData.Vertices[SourceIndices[1]];
+            const CVector3f& kVert2 = kIndexData.Vertices[SourceIndices[2]];
+            const CVector3f V0toV1 = (kVert1 - kVert0);
+            const CVector3f V0toV2 = (kVert2 - kVert0);
+            const CVector3f TriNormal = V0toV1.Cross(V0toV2).Normalized();
+            std::array<uint16, 3> Indices{};
+
+            // Index buffers are 16-bit; make sure the triangle's vertices still fit
+            if (mVertexBuffer.Size() + 3 > 0xFFFF)
+            {
+                warnf("Collision mesh has too many vertices to render; remaining triangles will be skipped");
+                VertexBufferFull = true;
+                break;
+            }
 
-        // Generate vertex data
-        const CVector3f& kVert0 = kIndexData.Vertices[VertIdx0];
-        const CVector3f& kVert1 = kIndexData.Vertices[VertIdx1];
-        const CVector3f& kVert2 = kIndexData.Vertices[VertIdx2];
-        const CVector3f V0toV1 = (kVert1 - kVert0);
-        const CVector3f V0toV2 = (kVert2 - kVert0);
-        const CVector3f TriNormal = V0toV1.Cross(V0toV2).Normalized();
-        const uint16 Index0 = static_cast<uint16>(mVertexBuffer.Size());
-        const uint16 Index1 = Index0 + 1;
-        const uint16 Index2 = Index1 + 1;
-
-        CVertex Vtx;
-        Vtx.Normal = TriNormal;
-
-        Vtx.Position = kVert0;
-        mVertexBuffer.AddVertex(Vtx);
-        Vtx.Position = kVert1;
-        mVertexBuffer.AddVertex(Vtx);
-        Vtx.Position = kVert2;
-        mVertexBuffer.AddVertex(Vtx);
-
-        mIndexBuffer.AddIndex(Index0);
-        mIndexBuffer.AddIndex(Index1);
-        mIndexBuffer.AddIndex(Index2);
-
-        mWireframeIndexBuffer.AddIndex(Index0);
-        mWireframeIndexBuffer.AddIndex(Index1);
-        mWireframeIndexBuffer.AddIndex(Index1);
-        mWireframeIndexBuffer.AddIndex(Index2);
-        mWireframeIndexBuffer.AddIndex(Index2);
-        mWireframeIndexBuffer.AddIndex(Index0);
-    }
+            for (size_t CornerIdx = 0; CornerIdx < 3; CornerIdx++)
+            {
+                const uint64 Key = SharedVertexKey(SourceIndices[CornerIdx], TriNormal);
+                const auto [Iter, Inserted] = SharedVertices.try_emplace(Key, 0);
+
+                if (Inserted)
+                {
+                    CVertex Vtx;
+                    Vtx.Position = kIndexData.Vertices[SourceIndices[CornerIdx]];
+                    Vtx.Normal = TriNormal;
+                    Iter->second = mVertexBuffer.AddVertex(Vtx);
+                }
+
+                Indices[CornerIdx] = Iter->second;
+            }
 
-    // Fill the rest of the material offsets, adding an extra index at the end
-    for (; CurrentMatIdx <= kIndexData.Materials.size(); CurrentMatIdx++)
-    {
-        mMaterialIndexOffsets.push_back( mIndexBuffer.GetSize() );
+            mIndexBuffer.AddIndices(Indices.data(), Indices.size());
+
+            for (size_t CornerIdx = 0; CornerIdx < 3; CornerIdx++)
+            {
+                const size_t NextIdx = (CornerIdx + 1) % 3;
+
+                if (MaterialEdges.insert(EdgeKey(SourceIndices[CornerIdx], SourceIndices[NextIdx])).second)
+                {
+                    mWireframeIndexBuffer.AddIndex(Indices[CornerIdx]);
+                    mWireframeIndexBuffer.AddIndex(Indices[NextIdx]);
+                }
+            }
+        }
     }
 
+    // Add an extra index at the end, which is the end index for the last material
+    mMaterialIndexOffsets.push_back(mIndexBuffer.GetSize());
+    mMaterialWireIndexOffsets.push_back(mWireframeIndexBuffer.GetSize());
+
     // Done
-    mVertexBuffer.Buffer();
-    mIndexBuffer.Buffer();
-    mWireframeIndexBuffer.Buffer();
     mBuilt = true;
 }
 
@@ -211,9 +273,7 @@ void CCollisionRenderData::BuildBoundingHierarchyRenderData(const SOBBTreeNode*
     // Add an extra index at the end...
     mBoundingDepthOffsets.push_back(mBoundingIndexBuffer.GetSize());
 
-    // Done
-    mBoundingVertexBuffer.Buffer();
-    mBoundingIndexBuffer.Buffer();
+    // Done; buffers are uploaded on first draw
     mBoundingHierarchyBuilt = true;
 }
 
@@ -222,28 +282,25 @@ void CCollisionRenderData::Render(bool Wireframe, int MaterialIndex /*= -1*/)
 {
     mVertexBuffer.Bind();
 
-    //@todo get these ugly OpenGL calls outta here
+    // Wireframe draws the unique edge list instead of the triangles
+    CIndexBuffer& rIndexBuffer = (Wireframe ? mWireframeIndexBuffer : mIndexBuffer);
+    const std::vector<uint>& rkOffsets = (Wireframe ? mMaterialWireIndexOffsets : mMaterialIndexOffsets);
+
     if (Wireframe)
     {
         CDrawUtil::UseColorShader(CColor::Black());
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     }
 
     if (MaterialIndex >= 0)
     {
-        ASSERT( MaterialIndex < mMaterialIndexOffsets.size()-1 );
-        uint FirstIndex = mMaterialIndexOffsets[MaterialIndex];
-        uint NumIndices = mMaterialIndexOffsets[MaterialIndex+1] - FirstIndex;
-        mIndexBuffer.DrawElements(FirstIndex, NumIndices);
+        ASSERT( MaterialIndex < rkOffsets.size()-1 );
+        uint FirstIndex = rkOffsets[MaterialIndex];
+        uint NumIndices = rkOffsets[MaterialIndex+1] - FirstIndex;
+        rIndexBuffer.DrawElements(FirstIndex, NumIndices);
     }
     else
     {
-        mIndexBuffer.DrawElements();
-    }
-
-    if (Wireframe)
-    {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        rIndexBuffer.DrawElements();
     }
 
     mVertexBuffer.Unbind();
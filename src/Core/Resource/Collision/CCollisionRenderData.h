@@ -11,8 +11,8 @@ class CCollidableOBBTree;
 /** Data for rendering a collision model */
 class CCollisionRenderData
 {
-    /** Vertex/index buffer for the collision geometry */
-    CVertexBuffer       mVertexBuffer;
+    /** Vertex/index buffer for the collision geometry. Vertices are shared between triangles with the same normal. */
+    CVertexBuffer       mVertexBuffer{EVertexAttribute::Position | EVertexAttribute::Normal};
     CIndexBuffer        mIndexBuffer;
     CIndexBuffer        mWireframeIndexBuffer;
 
@@ -22,7 +22,7 @@ class CCollisionRenderData
     std::vector<uint>   mMaterialWireIndexOffsets;
 
     /** Cached vertex/index buffer for the bounding hierarchy (octree or OBB tree) */
-    CVertexBuffer       mBoundingVertexBuffer;
+    CVertexBuffer       mBoundingVertexBuffer{EVertexAttribute::Position};
     CIndexBuffer        mBoundingIndexBuffer;
 
     /** Index buffer offset for different depth levels of the bounding hierarchy.
@@ -38,7 +38,7 @@ class CCollisionRenderData
 public:
     CCollisionRenderData() = default;
 
-    /** Build from collision data */
+    /** Build from collision data. GL buffers are created on first draw, so this doesn't need the GL context. */
     void BuildRenderData(const SCollisionIndexData& kIndexData);
     void BuildBoundingHierarchyRenderData(const SOBBTreeNode* pOBBTree);
 
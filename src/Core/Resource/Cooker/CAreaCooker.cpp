@@ -93,7 +93,7 @@ void CAreaCooker::WritePrimeHeader(IOutputStream& rOut)
     rOut.WriteULong(mpArea->mOriginalWorldMeshCount);
     if (mVersion >= EGame::Echoes)
         rOut.WriteULong(static_cast<uint32>(mpArea->mScriptLayers.size()));
-    rOut.WriteULong(static_cast<uint32>(mpArea->mSectionDataBuffers.size()));
+    rOut.WriteULong(static_cast<uint32>(mpArea->mSectionData.size()));
 
     rOut.WriteULong(mGeometrySecNum);
     rOut.WriteULong(mSCLYSecNum);
@@ -136,7 +136,7 @@ void CAreaCooker::WriteCorruptionHeader(IOutputStream& rOut)
     mpArea->mTransform.Write(rOut);
     rOut.WriteULong(mpArea->mOriginalWorldMeshCount);
     rOut.WriteULong(static_cast<uint32>(mpArea->mScriptLayers.size()));
-    rOut.WriteULong(static_cast<uint32>(mpArea->mSectionDataBuffers.size()));
+    rOut.WriteULong(static_cast<uint32>(mpArea->mSectionData.size()));
     rOut.WriteULong(static_cast<uint32>(mCompressedBlocks.size()));
     rOut.WriteULong(static_cast<uint32>(mpArea->mSectionNumbers.size()));
     rOut.WriteToBoundary(32, 0);
@@ -188,37 +188,30 @@ void CAreaCooker::WritePrimeSCLY(IOutputStream& rOut)
     const auto NumLayers = static_cast<uint32>(mpArea->mScriptLayers.size());
     rOut.WriteULong(NumLayers);
 
-    const uint32 LayerSizesStart = rOut.Tell();
-    for (uint32 LayerIdx = 0; LayerIdx < NumLayers; LayerIdx++)
-        rOut.WriteULong(0);
-
     // SCLY
-    CScriptCooker ScriptCooker(mVersion, true);
-    std::vector<uint32> LayerSizes(NumLayers);
+    std::vector<std::vector<char>> LayerData;
+    std::vector<char> GeneratedLayerData;
+    CScriptCooker::CookLayers(mVersion, mpArea->mScriptLayers, LayerData, GeneratedLayerData);
+
+    // Layers are padded to 32 bytes
+    for (uint32 LayerIdx = 0; LayerIdx < NumLayers; LayerIdx++)
+    {
+        const auto LayerSize = static_cast<uint32>(LayerData[LayerIdx].size());
+        rOut.WriteULong((LayerSize + 31) & ~31);
+    }
 
     for (uint32 LayerIdx = 0; LayerIdx < NumLayers; LayerIdx++)
     {
-        const uint32 LayerStart = rOut.Tell();
-        ScriptCooker.WriteLayer(rOut, mpArea->mScriptLayers[LayerIdx].get());
+        const std::vector<char>& rkLayer = LayerData[LayerIdx];
+        rOut.WriteBytes(rkLayer.data(), rkLayer.size());
 
-        // Pad the layer to 32 bytes
-        const uint32 LayerSize = rOut.Tell() - LayerStart;
-        const uint32 PaddedSize = (LayerSize + 31) & ~31;
-        const uint32 NumPadBytes = PaddedSize - LayerSize;
+        const auto LayerSize = static_cast<uint32>(rkLayer.size());
+        const uint32 NumPadBytes = ((LayerSize + 31) & ~31) - LayerSize;
 
         for (uint32 Pad = 0; Pad < NumPadBytes; Pad++)
             rOut.WriteByte(0);
-
-        LayerSizes[LayerIdx] = PaddedSize;
     }
 
-    const uint32 LayersEnd = rOut.Tell();
-    rOut.Seek(LayerSizesStart, SEEK_SET);
-
-    for (uint32 LayerIdx = 0; LayerIdx < NumLayers; LayerIdx++)
-        rOut.WriteULong(LayerSizes[LayerIdx]);
-
-    rOut.Seek(LayersEnd, SEEK_SET);
     FinishSection(false);
 
     // SCGN
@@ -226,7 +219,7 @@ void CAreaCooker::WritePrimeSCLY(IOutputStream& rOut)
     {
         rOut.WriteFourCC(FOURCC('SCGN'));
         rOut.WriteUByte(1);
-        ScriptCooker.WriteGeneratedLayer(rOut);
+        rOut.WriteBytes(GeneratedLayerData.data(), GeneratedLayerData.size());
         FinishSection(false);
     }
 }
@@ -234,21 +227,23 @@ void CAreaCooker::WritePrimeSCLY(IOutputStream& rOut)
 void CAreaCooker::WriteEchoesSCLY(IOutputStream& rOut)
 {
     // SCLY
-    CScriptCooker ScriptCooker(mVersion);
+    std::vector<std::vector<char>> LayerData;
+    std::vector<char> GeneratedLayerData;
+    CScriptCooker::CookLayers(mVersion, mpArea->mScriptLayers, LayerData, GeneratedLayerData);
 
-    for (uint32 LayerIdx = 0; LayerIdx < mpArea->mScriptLayers.size(); LayerIdx++)
+    for (uint32 LayerIdx = 0; LayerIdx < LayerData.size(); LayerIdx++)
     {
         rOut.WriteFourCC(FOURCC('SCLY'));
         rOut.WriteUByte(1);
         rOut.WriteULong(LayerIdx);
-        ScriptCooker.WriteLayer(rOut, mpArea->mScriptLayers[LayerIdx].get());
+        rOut.WriteBytes(LayerData[LayerIdx].data(), LayerData[LayerIdx].size());
         FinishSection(true);
     }
 
     // SCGN
     rOut.WriteFourCC(FOURCC('SCGN'));
     rOut.WriteUByte(1);
-    ScriptCooker.WriteGeneratedLayer(rOut);
+    rOut.WriteBytes(GeneratedLayerData.data(), GeneratedLayerData.size());
     FinishSection(true);
 }
 
@@ -395,6 +390,19 @@ bool CAreaCooker::CookMREA(CGameArea *pArea, IOutputStream& rOut)
     else
         Cooker.DetermineSectionNumbersCorruption();
 
+    // Passthrough sections have to be read back from the cooked file before anything can be written. They're
+    // only held for the duration of the cook; the dependencies, script layers and modules are written fresh.
+    const uint32 PostSCLY = (Cooker.mVersion <= EGame::Prime ? Cooker.mSCLYSecNum + 1 : Cooker.mSCGNSecNum + 1);
+    std::set<uint32> RegeneratedSections { Cooker.mDepsSecNum, Cooker.mModulesSecNum };
+
+    for (uint32 iSec = Cooker.mSCLYSecNum; iSec < PostSCLY; iSec++)
+        RegeneratedSections.insert(iSec);
+
+    std::vector<std::vector<uint8>> Sections;
+
+    if (!pArea->ReadSectionData(RegeneratedSections, Sections))
+        return false;
+
     // Write pre-SCLY data sections
     for (uint32 iSec = 0; iSec < Cooker.mSCLYSecNum; iSec++)
     {
@@ -403,7 +411,7 @@ bool CAreaCooker::CookMREA(CGameArea *pArea, IOutputStream& rOut)
 
         else
         {
-            Cooker.mSectionData.WriteBytes(pArea->mSectionDataBuffers[iSec].data(), pArea->mSectionDataBuffers[iSec].size());
+            Cooker.mSectionData.WriteBytes(Sections[iSec].data(), Sections[iSec].size());
             Cooker.FinishSection(false);
         }
     }
@@ -415,8 +423,7 @@ bool CAreaCooker::CookMREA(CGameArea *pArea, IOutputStream& rOut)
         Cooker.WriteEchoesSCLY(Cooker.mSectionData);
 
     // Write post-SCLY data sections
-    const uint32 PostSCLY = (Cooker.mVersion <= EGame::Prime ? Cooker.mSCLYSecNum + 1 : Cooker.mSCGNSecNum + 1);
-    for (size_t iSec = PostSCLY; iSec < pArea->mSectionDataBuffers.size(); iSec++)
+    for (size_t iSec = PostSCLY; iSec < Sections.size(); iSec++)
     {
         if (iSec == Cooker.mModulesSecNum)
         {
@@ -424,7 +431,7 @@ bool CAreaCooker::CookMREA(CGameArea *pArea, IOutputStream& rOut)
         }
         else
         {
-            Cooker.mSectionData.WriteBytes(pArea->mSectionDataBuffers[iSec].data(), pArea->mSectionDataBuffers[iSec].size());
+            Cooker.mSectionData.WriteBytes(Sections[iSec].data(), Sections[iSec].size());
             Cooker.FinishSection(false);
         }
     }
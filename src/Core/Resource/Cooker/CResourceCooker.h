@@ -17,6 +17,24 @@ class CResourceCooker
     CResourceCooker() = default;
 
 public:
+    static bool CanCookResourceType(EResourceType Type)
+    {
+        switch (Type)
+        {
+        case EResourceType::Area:
+        case EResourceType::Model:
+        case EResourceType::Scan:
+        case EResourceType::StaticGeometryMap:
+        case EResourceType::StringTable:
+        case EResourceType::Tweaks:
+        case EResourceType::World:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
     static bool CookResource(CResourceEntry *pEntry, IOutputStream& rOutput)
     {
         CResource *pRes = pEntry->Load();
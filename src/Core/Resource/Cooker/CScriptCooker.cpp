@@ -1,20 +1,185 @@
 #include "CScriptCooker.h"
+#include "Core/NParallel.h"
 #include "Core/Resource/Script/CLink.h"
 #include <Core/Resource/Script/Property/CArrayProperty.h>
 #include <Core/Resource/Script/Property/CAssetProperty.h>
 #include <Core/Resource/Script/Property/CEnumProperty.h>
 #include <Core/Resource/Script/Property/CFlagsProperty.h>
 
-void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, void* pData, bool InAtomicStruct)
+// ************ SIZE PASS ************
+void CScriptCooker::ResetMeasurements()
+{
+    mPropertySizes.clear();
+    mCookChildFlags.clear();
+    mNextPropertySize = 0;
+    mNextCookChildFlag = 0;
+}
+
+uint32 CScriptCooker::MeasureProperty(IProperty* pProperty, void* pData, bool InAtomicStruct)
+{
+    const bool HasHeader = (mGame >= EGame::EchoesDemo && !InAtomicStruct);
+    const size_t SizeSlot = mPropertySizes.size();
+    uint32 Size = 0;
+
+    if (HasHeader)
+        mPropertySizes.push_back(0);
+
+    switch (pProperty->Type())
+    {
+    case EPropertyType::Bool:
+    case EPropertyType::Byte:
+        Size = 1;
+        break;
+
+    case EPropertyType::Short:
+        Size = 2;
+        break;
+
+    case EPropertyType::Int:
+    case EPropertyType::Float:
+    case EPropertyType::Choice:
+    case EPropertyType::Enum:
+    case EPropertyType::Flags:
+    case EPropertyType::Sound:
+    case EPropertyType::Animation:
+        Size = 4;
+        break;
+
+    case EPropertyType::String:
+        Size = static_cast<uint32>(TPropCast<CStringProperty>(pProperty)->ValueRef(pData).Size()) + 1;
+        break;
+
+    case EPropertyType::Vector:
+        Size = 12;
+        break;
+
+    case EPropertyType::Color:
+        Size = 16;
+        break;
+
+    case EPropertyType::Asset:
+        Size = static_cast<uint32>(TPropCast<CAssetProperty>(pProperty)->ValueRef(pData).Length());
+        break;
+
+    case EPropertyType::AnimationSet:
+    {
+        // The encoding varies with the game and whether a character is set; measure it directly
+        std::vector<char> Scratch;
+        CVectorOutStream ScratchOut(&Scratch, EEndian::BigEndian);
+        TPropCast<CAnimationSetProperty>(pProperty)->ValueRef(pData).Write(ScratchOut);
+        Size = static_cast<uint32>(Scratch.size());
+        break;
+    }
+
+    case EPropertyType::Spline:
+    {
+        // Empty splines are written as a 15-byte default in every game
+        const std::vector<char>& rkBuffer = TPropCast<CSplineProperty>(pProperty)->ValueRef(pData);
+        Size = rkBuffer.empty() ? 15 : static_cast<uint32>(rkBuffer.size());
+        break;
+    }
+
+    case EPropertyType::Guid:
+    {
+        const std::vector<char>& rkBuffer = TPropCast<CGuidProperty>(pProperty)->ValueRef(pData);
+        Size = rkBuffer.empty() ? 16 : static_cast<uint32>(rkBuffer.size());
+        break;
+    }
+
+    case EPropertyType::Struct:
+    {
+        auto* pStruct = TPropCast<CStructProperty>(pProperty);
+        const size_t NumChildren = pStruct->NumChildren();
+
+        if (pStruct->IsAtomic())
+        {
+            for (size_t ChildIdx = 0; ChildIdx < NumChildren; ChildIdx++)
+                Size += MeasureProperty(pStruct->ChildByIndex(ChildIdx), pData, true);
+        }
+        else
+        {
+            // Decide which children to cook before measuring any of them, so the write pass
+            // finds this struct's flags together and can write the child count first
+            const size_t FirstFlag = mCookChildFlags.size();
+
+            for (size_t ChildIdx = 0; ChildIdx < NumChildren; ChildIdx++)
+                mCookChildFlags.push_back(pStruct->ChildByIndex(ChildIdx)->ShouldCook(pData));
+
+            Size = (mGame <= EGame::Prime ? 4 : 2);
+
+            for (size_t ChildIdx = 0; ChildIdx < NumChildren; ChildIdx++)
+            {
+                if (mCookChildFlags[FirstFlag + ChildIdx])
+                    Size += MeasureProperty(pStruct->ChildByIndex(ChildIdx), pData, false);
+            }
+        }
+        break;
+    }
+
+    case EPropertyType::Array:
+    {
+        auto* pArray = TPropCast<CArrayProperty>(pProperty);
+        const uint32 Count = pArray->ArrayCount(pData);
+        Size = 4;
+
+        for (uint32 ElementIdx = 0; ElementIdx < Count; ElementIdx++)
+            Size += MeasureProperty(pArray->ItemArchetype(), pArray->ItemPointer(pData, ElementIdx), true);
+
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (HasHeader)
+    {
+        mPropertySizes[SizeSlot] = Size;
+        Size += 6;
+    }
+
+    return Size;
+}
+
+uint32 CScriptCooker::MeasureInstance(CScriptObject *pInstance)
+{
+    // Instance ID, link count, links, properties
+    const bool IsPrime1 = mGame <= EGame::Prime;
+    const auto NumLinks = static_cast<uint32>(pInstance->NumLinks(ELinkType::Outgoing));
+    const uint32 PropertiesSize = MeasureProperty(pInstance->Template()->Properties(), pInstance->PropertyData(), false);
+    return 4 + (IsPrime1 ? 4 : 2) + (NumLinks * 12) + PropertiesSize;
+}
+
+uint32 CScriptCooker::MeasureInstances(const std::vector<CScriptObject*>& rkInstances, std::vector<uint32>& rOutInstanceSizes)
 {
-    uint32 SizeOffset = 0;
-    uint32 PropStart = 0;
+    // Object type and instance size fields
+    const uint32 InstanceHeaderSize = (mGame <= EGame::Prime ? 5 : 6);
 
-    if (mGame >= EGame::EchoesDemo && !InAtomicStruct)
+    // Layer version and instance count
+    uint32 TotalSize = 5;
+    rOutInstanceSizes.resize(rkInstances.size());
+
+    for (size_t InstIdx = 0; InstIdx < rkInstances.size(); InstIdx++)
     {
+        rOutInstanceSizes[InstIdx] = MeasureInstance(rkInstances[InstIdx]);
+        TotalSize += InstanceHeaderSize + rOutInstanceSizes[InstIdx];
+    }
+
+    return TotalSize;
+}
+
+// ************ WRITE PASS ************
+void CScriptCooker::WriteMeasuredProperty(IOutputStream& rOut, IProperty* pProperty, void* pData, bool InAtomicStruct)
+{
+    [[maybe_unused]] uint32 PropStart = 0;
+    uint32 PropSize = 0;
+    const bool HasHeader = (mGame >= EGame::EchoesDemo && !InAtomicStruct);
+
+    if (HasHeader)
+    {
+        PropSize = mPropertySizes[mNextPropertySize++];
         rOut.WriteULong(pProperty->ID());
-        SizeOffset = rOut.Tell();
-        rOut.WriteUShort(0x0);
+        rOut.WriteUShort(static_cast<uint16>(PropSize));
         PropStart = rOut.Tell();
     }
 
@@ -178,26 +343,36 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, voi
     case EPropertyType::Struct:
     {
         auto* pStruct = TPropCast<CStructProperty>(pProperty);
-        std::vector<IProperty*> PropertiesToWrite;
+        const size_t NumChildren = pStruct->NumChildren();
 
-        for (size_t ChildIdx = 0; ChildIdx < pStruct->NumChildren(); ChildIdx++)
+        if (pStruct->IsAtomic())
         {
-            IProperty *pChild = pStruct->ChildByIndex(ChildIdx);
-
-            if (pStruct->IsAtomic() || pChild->ShouldCook(pData))
-                PropertiesToWrite.push_back(pChild);
+            for (size_t ChildIdx = 0; ChildIdx < NumChildren; ChildIdx++)
+                WriteMeasuredProperty(rOut, pStruct->ChildByIndex(ChildIdx), pData, true);
         }
-
-        if (!pStruct->IsAtomic())
+        else
         {
+            const size_t FirstFlag = mNextCookChildFlag;
+            mNextCookChildFlag += NumChildren;
+            uint32 NumWritten = 0;
+
+            for (size_t ChildIdx = 0; ChildIdx < NumChildren; ChildIdx++)
+            {
+                if (mCookChildFlags[FirstFlag + ChildIdx])
+                    NumWritten++;
+            }
+
             if (mGame <= EGame::Prime)
-                rOut.WriteULong(static_cast<uint32>(PropertiesToWrite.size()));
+                rOut.WriteULong(NumWritten);
             else
-                rOut.WriteUShort(static_cast<uint16>(PropertiesToWrite.size()));
-        }
+                rOut.WriteUShort(static_cast<uint16>(NumWritten));
 
-        for (auto* property : PropertiesToWrite)
-            WriteProperty(rOut, property, pData, pStruct->IsAtomic());
+            for (size_t ChildIdx = 0; ChildIdx < NumChildren; ChildIdx++)
+            {
+                if (mCookChildFlags[FirstFlag + ChildIdx])
+                    WriteMeasuredProperty(rOut, pStruct->ChildByIndex(ChildIdx), pData, false);
+            }
+        }
 
         break;
     }
@@ -208,9 +383,9 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, voi
         const uint32 Count = pArray->ArrayCount(pData);
         rOut.WriteULong(Count);
 
-        for (uint32 ElementIdx = 0; ElementIdx < pArray->ArrayCount(pData); ElementIdx++)
+        for (uint32 ElementIdx = 0; ElementIdx < Count; ElementIdx++)
         {
-            WriteProperty(rOut, pArray->ItemArchetype(), pArray->ItemPointer(pData, ElementIdx), true);
+            WriteMeasuredProperty(rOut, pArray->ItemArchetype(), pArray->ItemPointer(pData, ElementIdx), true);
         }
 
         break;
@@ -219,16 +394,11 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, voi
         break;
     }
 
-    if (SizeOffset != 0)
-    {
-        const uint32 PropEnd = rOut.Tell();
-        rOut.Seek(SizeOffset, SEEK_SET);
-        rOut.WriteUShort(static_cast<uint16>(PropEnd - PropStart));
-        rOut.Seek(PropEnd, SEEK_SET);
-    }
+    if (HasHeader)
+        ASSERT(rOut.Tell() - PropStart == PropSize);
 }
 
-void CScriptCooker::WriteInstance(IOutputStream& rOut, CScriptObject *pInstance)
+void CScriptCooker::WriteMeasuredInstance(IOutputStream& rOut, CScriptObject *pInstance, uint32 InstanceSize)
 {
     ASSERT(pInstance->Area()->Game() == mGame);
 
@@ -238,11 +408,9 @@ void CScriptCooker::WriteInstance(IOutputStream& rOut, CScriptObject *pInstance)
 
     const uint32 ObjectType = pInstance->ObjectTypeID();
     IsPrime1 ? rOut.WriteUByte(static_cast<uint8>(ObjectType)) : rOut.WriteULong(ObjectType);
+    IsPrime1 ? rOut.WriteULong(InstanceSize) : rOut.WriteUShort(static_cast<uint16>(InstanceSize));
 
-    const uint32 SizeOffset = rOut.Tell();
-    IsPrime1 ? rOut.WriteLong(0) : rOut.WriteShort(0);
-
-    const uint32 InstanceStart = rOut.Tell();
+    [[maybe_unused]] const uint32 InstanceStart = rOut.Tell();
     const uint32 InstanceID = (pInstance->Layer()->AreaIndex() << 26) | pInstance->InstanceID();
     rOut.WriteULong(InstanceID);
 
@@ -257,24 +425,27 @@ void CScriptCooker::WriteInstance(IOutputStream& rOut, CScriptObject *pInstance)
         rOut.WriteULong(pLink->ReceiverID());
     }
 
-    WriteProperty(rOut, pInstance->Template()->Properties(), pInstance->PropertyData(), false);
-    const uint32 InstanceEnd = rOut.Tell();
-
-    rOut.Seek(SizeOffset, SEEK_SET);
-    const uint32 Size = InstanceEnd - InstanceStart;
-    IsPrime1 ? rOut.WriteULong(Size) : rOut.WriteUShort(static_cast<uint16>(Size));
-    rOut.Seek(InstanceEnd, SEEK_SET);
+    WriteMeasuredProperty(rOut, pInstance->Template()->Properties(), pInstance->PropertyData(), false);
+    ASSERT(rOut.Tell() - InstanceStart == InstanceSize);
 }
 
-void CScriptCooker::WriteLayer(IOutputStream& rOut, CScriptLayer *pLayer)
+void CScriptCooker::WriteInstanceList(IOutputStream& rOut, uint8 Version, const std::vector<CScriptObject*>& rkInstances)
 {
-    ASSERT(pLayer->Area()->Game() == mGame);
+    ResetMeasurements();
+    std::vector<uint32> InstanceSizes;
+    MeasureInstances(rkInstances, InstanceSizes);
+
+    rOut.WriteUByte(Version);
+    rOut.WriteULong(static_cast<uint32>(rkInstances.size()));
 
-    rOut.WriteByte(mGame <= EGame::Prime ? 0 : 1); // Version
+    for (size_t InstIdx = 0; InstIdx < rkInstances.size(); InstIdx++)
+        WriteMeasuredInstance(rOut, rkInstances[InstIdx], InstanceSizes[InstIdx]);
+}
 
-    const uint32 InstanceCountOffset = rOut.Tell();
-    uint32 NumWrittenInstances = 0;
-    rOut.WriteLong(0);
+void CScriptCooker::SplitLayerInstances(CScriptLayer *pLayer, std::vector<CScriptObject*>& rOutInstances)
+{
+    ASSERT(pLayer->Area()->Game() == mGame);
+    rOutInstances.reserve(pLayer->NumInstances());
 
     for (size_t iInst = 0; iInst < pLayer->NumInstances(); iInst++)
     {
@@ -325,23 +496,74 @@ void CScriptCooker::WriteLayer(IOutputStream& rOut, CScriptLayer *pLayer)
         }
 
         if (ShouldWrite)
-        {
-            WriteInstance(rOut, pInstance);
-            NumWrittenInstances++;
-        }
+            rOutInstances.push_back(pInstance);
     }
+}
+
+// ************ PUBLIC ************
+void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, void* pData, bool InAtomicStruct)
+{
+    ResetMeasurements();
+    MeasureProperty(pProperty, pData, InAtomicStruct);
+    WriteMeasuredProperty(rOut, pProperty, pData, InAtomicStruct);
+}
 
-    const uint32 LayerEnd = rOut.Tell();
-    rOut.GoTo(InstanceCountOffset);
-    rOut.WriteULong(NumWrittenInstances);
-    rOut.GoTo(LayerEnd);
+void CScriptCooker::WriteInstance(IOutputStream& rOut, CScriptObject *pInstance)
+{
+    ResetMeasurements();
+    const uint32 InstanceSize = MeasureInstance(pInstance);
+    WriteMeasuredInstance(rOut, pInstance, InstanceSize);
+}
+
+void CScriptCooker::WriteLayer(IOutputStream& rOut, CScriptLayer *pLayer)
+{
+    std::vector<CScriptObject*> Instances;
+    SplitLayerInstances(pLayer, Instances);
+    WriteInstanceList(rOut, mGame <= EGame::Prime ? 0 : 1, Instances);
 }
 
 void CScriptCooker::WriteGeneratedLayer(IOutputStream& rOut)
 {
-    rOut.WriteByte(1); // Version
-    rOut.WriteULong(static_cast<uint32>(mGeneratedObjects.size()));
+    WriteInstanceList(rOut, 1, mGeneratedObjects);
+}
+
+// ************ STATIC ************
+void CScriptCooker::CookLayers(EGame Game, const std::vector<std::unique_ptr<CScriptLayer>>& rkLayers,
+                               std::vector<std::vector<char>>& rOutLayers, std::vector<char>& rOutGeneratedLayer)
+{
+    // Sorting out generated objects is cheap and determines their order in SCGN, so do it up front.
+    // The last instance list is the generated layer.
+    const size_t NumLayers = rkLayers.size();
+    std::vector<std::vector<CScriptObject*>> InstanceLists(NumLayers + 1);
+    CScriptCooker Splitter(Game);
+
+    for (size_t LayerIdx = 0; LayerIdx < NumLayers; LayerIdx++)
+        Splitter.SplitLayerInstances(rkLayers[LayerIdx].get(), InstanceLists[LayerIdx]);
+
+    InstanceLists[NumLayers] = std::move(Splitter.mGeneratedObjects);
+
+    rOutLayers.clear();
+    rOutLayers.resize(NumLayers);
+    rOutGeneratedLayer.clear();
+
+    NParallel::ParallelFor(NumLayers + 1, [&](size_t ListIdx)
+    {
+        const bool IsGeneratedLayer = (ListIdx == NumLayers);
+        const std::vector<CScriptObject*>& rkInstances = InstanceLists[ListIdx];
+        std::vector<char>& rData = (IsGeneratedLayer ? rOutGeneratedLayer : rOutLayers[ListIdx]);
+
+        CScriptCooker Cooker(Game);
+        std::vector<uint32> InstanceSizes;
+        const uint32 LayerSize = Cooker.MeasureInstances(rkInstances, InstanceSizes);
+        rData.reserve(LayerSize);
+
+        CVectorOutStream Out(&rData, EEndian::BigEndian);
+        Out.WriteUByte(IsGeneratedLayer || Game > EGame::Prime ? 1 : 0); // Version
+        Out.WriteULong(static_cast<uint32>(rkInstances.size()));
+
+        for (size_t InstIdx = 0; InstIdx < rkInstances.size(); InstIdx++)
+            Cooker.WriteMeasuredInstance(Out, rkInstances[InstIdx], InstanceSizes[InstIdx]);
 
-    for (auto* object : mGeneratedObjects)
-        WriteInstance(rOut, object);
+        ASSERT(rData.size() == LayerSize);
+    });
 }
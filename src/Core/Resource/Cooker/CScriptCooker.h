@@ -6,6 +6,8 @@
 #include "Core/Resource/Script/CScriptObject.h"
 #include <Common/EGame.h>
 #include <Common/FileIO.h>
+#include <memory>
+#include <vector>
 
 class CScriptCooker
 {
@@ -13,6 +15,25 @@ class CScriptCooker
     std::vector<CScriptObject*> mGeneratedObjects;
     bool mWriteGeneratedSeparately;
 
+    /**
+     * Results of the size pass, consumed in the same order by the write pass: the payload size of
+     * every property that has an ID/size header, and the cook decision for every child of every
+     * non-atomic struct. This lets sizes be written up front instead of seeking back to patch them.
+     */
+    std::vector<uint32> mPropertySizes;
+    std::vector<bool> mCookChildFlags;
+    size_t mNextPropertySize = 0;
+    size_t mNextCookChildFlag = 0;
+
+    void ResetMeasurements();
+    uint32 MeasureProperty(IProperty* pProperty, void* pData, bool InAtomicStruct);
+    uint32 MeasureInstance(CScriptObject *pInstance);
+    uint32 MeasureInstances(const std::vector<CScriptObject*>& rkInstances, std::vector<uint32>& rOutInstanceSizes);
+    void WriteMeasuredProperty(IOutputStream& rOut, IProperty* pProperty, void* pData, bool InAtomicStruct);
+    void WriteMeasuredInstance(IOutputStream& rOut, CScriptObject *pInstance, uint32 InstanceSize);
+    void WriteInstanceList(IOutputStream& rOut, uint8 Version, const std::vector<CScriptObject*>& rkInstances);
+    void SplitLayerInstances(CScriptLayer *pLayer, std::vector<CScriptObject*>& rOutInstances);
+
 public:
     explicit CScriptCooker(EGame Game, bool WriteGeneratedObjectsSeparately = true)
         : mGame(Game)
@@ -23,6 +44,14 @@ public:
     void WriteInstance(IOutputStream& rOut, CScriptObject *pInstance);
     void WriteLayer(IOutputStream& rOut, CScriptLayer *pLayer);
     void WriteGeneratedLayer(IOutputStream& rOut);
+
+    /**
+     * Cook all script layers of an area concurrently, each into its own buffer sized by a
+     * measuring pass. Generated objects are cooked into rOutGeneratedLayer for games with SCGN.
+     * The output is identical to calling WriteLayer for each layer followed by WriteGeneratedLayer.
+     */
+    static void CookLayers(EGame Game, const std::vector<std::unique_ptr<CScriptLayer>>& rkLayers,
+                           std::vector<std::vector<char>>& rOutLayers, std::vector<char>& rOutGeneratedLayer);
 };
 
 #endif // CSCRIPTCOOKER_H
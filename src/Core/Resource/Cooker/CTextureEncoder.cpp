@@ -1,55 +1,630 @@
 #include "CTextureEncoder.h"
+#include "Core/NParallel.h"
+#include "Core/NPerfStats.h"
 #include <Common/Log.h>
+#include <Common/Math/CVector3f.h>
+#include <Common/Math/MathUtil.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
 
-CTextureEncoder::CTextureEncoder() = default;
+namespace
+{
+// Block dimensions in pixels for each GX texture format
+constexpr std::array gskBlockWidth{
+    8U,
+    8U,
+    8U,
+    4U,
+    8U,
+    8U,
+    4U,
+    4U,
+    4U,
+    4U,
+    8U,
+};
+
+constexpr std::array gskBlockHeight{
+    8U,
+    4U,
+    4U,
+    4U,
+    8U,
+    4U,
+    4U,
+    4U,
+    4U,
+    4U,
+    8U,
+};
+
+// GX supports at most 11 mip levels (1024x1024 down to 1x1)
+constexpr uint32 gskMaxMipMaps = 11;
+
+// Mip chains are generated down to this size; smaller levels aren't worth the padding
+constexpr uint32 gskMinMipSize = 4;
+
+// CMPR only supports 1-bit alpha; pixels below this are encoded as transparent
+constexpr uint8 gskAlphaThreshold = 128;
+
+// Maximum number of pixels sampled when building a C4/C8 palette
+constexpr uint32 gskMaxPaletteSamples = 65536;
 
-void CTextureEncoder::WriteTXTR(IOutputStream& rTXTR)
+uint8 Quantize(uint32 Value, uint32 MaxValue)
 {
-    // Only DXT1->CMPR supported at the moment
-    rTXTR.WriteULong(static_cast<uint>(mOutputFormat));
-    rTXTR.WriteUShort(mpTexture->mWidth);
-    rTXTR.WriteUShort(mpTexture->mHeight);
-    rTXTR.WriteULong(mpTexture->mNumMipMaps);
+    return static_cast<uint8>((Value * MaxValue + 127) / 255);
+}
+
+uint8 Extend3to8(uint8 In)
+{
+    In &= 0x7;
+    return (In << 5) | (In << 2) | (In >> 1);
+}
+
+uint8 Extend4to8(uint8 In)
+{
+    In &= 0xF;
+    return (In << 4) | In;
+}
+
+uint8 Extend5to8(uint8 In)
+{
+    In &= 0x1F;
+    return (In << 3) | (In >> 2);
+}
+
+uint8 Extend6to8(uint8 In)
+{
+    In &= 0x3F;
+    return (In << 2) | (In >> 4);
+}
+
+uint8 Luminance(const uint8 *pkPixel)
+{
+    return static_cast<uint8>((pkPixel[0] * 77 + pkPixel[1] * 150 + pkPixel[2] * 29 + 128) >> 8);
+}
+
+uint16 ReadNativeShort(const uint8 *pkData)
+{
+    uint16 Value;
+    std::memcpy(&Value, pkData, sizeof(Value));
+    return Value;
+}
+
+void WriteBigShort(uint8 *pOut, uint16 Value)
+{
+    pOut[0] = static_cast<uint8>(Value >> 8);
+    pOut[1] = static_cast<uint8>(Value & 0xFF);
+}
+
+uint16 PackRGB565(const uint8 *pkPixel)
+{
+    return static_cast<uint16>((Quantize(pkPixel[0], 31) << 11) | (Quantize(pkPixel[1], 63) << 5) | Quantize(pkPixel[2], 31));
+}
+
+uint16 PackRGB5A3(const uint8 *pkPixel)
+{
+    const uint8 Alpha = Quantize(pkPixel[3], 7);
+
+    if (Alpha == 7)
+        return static_cast<uint16>(0x8000 | (Quantize(pkPixel[0], 31) << 10) | (Quantize(pkPixel[1], 31) << 5) | Quantize(pkPixel[2], 31));
+    else
+        return static_cast<uint16>((Alpha << 12) | (Quantize(pkPixel[0], 15) << 8) | (Quantize(pkPixel[1], 15) << 4) | Quantize(pkPixel[2], 15));
+}
+
+uint16 PackIA8(const uint8 *pkPixel)
+{
+    return static_cast<uint16>((pkPixel[3] << 8) | Luminance(pkPixel));
+}
+
+std::array<uint8, 4> UnpackRGB565(uint16 Value)
+{
+    return { Extend5to8(static_cast<uint8>(Value >> 11)), Extend6to8(static_cast<uint8>(Value >> 5)), Extend5to8(static_cast<uint8>(Value)), 0xFF };
+}
+
+std::array<uint8, 4> UnpackRGB5A3(uint16 Value)
+{
+    if (Value & 0x8000)
+        return { Extend5to8(static_cast<uint8>(Value >> 10)), Extend5to8(static_cast<uint8>(Value >> 5)), Extend5to8(static_cast<uint8>(Value)), 0xFF };
+    else
+        return { Extend4to8(static_cast<uint8>(Value >> 8)), Extend4to8(static_cast<uint8>(Value >> 4)), Extend4to8(static_cast<uint8>(Value)), Extend3to8(static_cast<uint8>(Value >> 12)) };
+}
+
+std::array<uint8, 4> UnpackIA8(uint16 Value)
+{
+    const uint8 Lum = static_cast<uint8>(Value & 0xFF);
+    return { Lum, Lum, Lum, static_cast<uint8>(Value >> 8) };
+}
+
+uint32 ColorDistance(const uint8 *pkA, const uint8 *pkB)
+{
+    const int DR = pkA[0] - pkB[0];
+    const int DG = pkA[1] - pkB[1];
+    const int DB = pkA[2] - pkB[2];
+    const int DA = pkA[3] - pkB[3];
+    return static_cast<uint32>(DR * DR + DG * DG + DB * DB + DA * DA);
+}
+
+uint32 CalcMipCount(uint32 Width, uint32 Height)
+{
+    uint32 Count = 1;
+
+    while (Count < gskMaxMipMaps && (Width / 2) >= gskMinMipSize && (Height / 2) >= gskMinMipSize)
+    {
+        Width /= 2;
+        Height /= 2;
+        Count++;
+    }
+
+    return Count;
+}
+
+// ************ CMPR COMPRESSION ************
+/** 4x4 pixels gathered for CMPR compression. Stored planar so the per-pixel loops vectorize. */
+struct SCMPRBlock
+{
+    std::array<float, 16> R;
+    std::array<float, 16> G;
+    std::array<float, 16> B;
+    std::array<float, 16> Weight; // 1 for opaque pixels, 0 for transparent pixels
+    uint32 NumOpaque = 0;
+};
+
+struct SCMPRResult
+{
+    uint16 Color0 = 0;
+    uint16 Color1 = 0;
+    uint32 Indices = 0; // 2 bits per pixel, pixel 0 in the top bits
+    float Error = FLT_MAX;
+
+    bool IsThreeColor() const   { return Color0 <= Color1; }
+};
+
+uint16 PackRGB565(const CVector3f& rkColor)
+{
+    const uint32 R = static_cast<uint32>(Math::Clamp(0.f, 31.f, rkColor.X * (31.f / 255.f) + 0.5f));
+    const uint32 G = static_cast<uint32>(Math::Clamp(0.f, 63.f, rkColor.Y * (63.f / 255.f) + 0.5f));
+    const uint32 B = static_cast<uint32>(Math::Clamp(0.f, 31.f, rkColor.Z * (31.f / 255.f) + 0.5f));
+    return static_cast<uint16>((R << 11) | (G << 5) | B);
+}
+
+/** Build the palette for a pair of endpoints and pick the closest entry for every pixel */
+SCMPRResult EvaluateCMPR(const SCMPRBlock& rkBlock, uint16 Color0, uint16 Color1, bool ThreeColor)
+{
+    // Four color mode requires Color0 > Color1, so identical endpoints can only be encoded in three color mode
+    if (Color0 == Color1)
+        ThreeColor = true;
+
+    if (ThreeColor ? (Color0 > Color1) : (Color0 < Color1))
+        std::swap(Color0, Color1);
+
+    const std::array<uint8, 4> C0 = UnpackRGB565(Color0);
+    const std::array<uint8, 4> C1 = UnpackRGB565(Color1);
+    std::array<float, 4> PR{ static_cast<float>(C0[0]), static_cast<float>(C1[0]) };
+    std::array<float, 4> PG{ static_cast<float>(C0[1]), static_cast<float>(C1[1]) };
+    std::array<float, 4> PB{ static_cast<float>(C0[2]), static_cast<float>(C1[2]) };
+
+    if (ThreeColor)
+    {
+        PR[2] = (PR[0] + PR[1]) * 0.5f;
+        PG[2] = (PG[0] + PG[1]) * 0.5f;
+        PB[2] = (PB[0] + PB[1]) * 0.5f;
+    }
+    else
+    {
+        PR[2] = (PR[0] * 2.f + PR[1]) / 3.f;
+        PG[2] = (PG[0] * 2.f + PG[1]) / 3.f;
+        PB[2] = (PB[0] * 2.f + PB[1]) / 3.f;
+        PR[3] = (PR[0] + PR[1] * 2.f) / 3.f;
+        PG[3] = (PG[0] + PG[1] * 2.f) / 3.f;
+        PB[3] = (PB[0] + PB[1] * 2.f) / 3.f;
+    }
 
-    uint32 MipW = mpTexture->Width() / 4;
-    uint32 MipH = mpTexture->Height() / 4;
-    CMemoryInStream Image(mpTexture->mpImgDataBuffer, mpTexture->mImgDataSize, EEndian::LittleEndian);
-    uint32 MipOffset = Image.Tell();
+    const uint32 NumColors = (ThreeColor ? 3 : 4);
+    std::array<float, 16> BestDist;
+    std::array<uint32, 16> BestIndex;
+    BestDist.fill(FLT_MAX);
+    BestIndex.fill(0);
 
-    for (uint32 iMip = 0; iMip < mpTexture->mNumMipMaps; iMip++)
+    for (uint32 iColor = 0; iColor < NumColors; iColor++)
     {
-        for (uint32 iBlockY = 0; iBlockY < MipH; iBlockY += 2)
+        for (uint32 iPixel = 0; iPixel < 16; iPixel++)
         {
-            for (uint32 iBlockX = 0; iBlockX < MipW; iBlockX += 2)
+            const float DR = rkBlock.R[iPixel] - PR[iColor];
+            const float DG = rkBlock.G[iPixel] - PG[iColor];
+            const float DB = rkBlock.B[iPixel] - PB[iColor];
+            const float Dist = DR * DR + DG * DG + DB * DB;
+            const bool Closer = Dist < BestDist[iPixel];
+            BestDist[iPixel] = (Closer ? Dist : BestDist[iPixel]);
+            BestIndex[iPixel] = (Closer ? iColor : BestIndex[iPixel]);
+        }
+    }
+
+    SCMPRResult Result;
+    Result.Color0 = Color0;
+    Result.Color1 = Color1;
+    Result.Error = 0.f;
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        const bool Opaque = (rkBlock.Weight[iPixel] > 0.f);
+        const uint32 Index = (Opaque ? BestIndex[iPixel] : 3);
+        Result.Indices |= Index << (30 - (iPixel * 2));
+        Result.Error += (Opaque ? BestDist[iPixel] : 0.f);
+    }
+
+    return Result;
+}
+
+/** Endpoints from the bounding box of the opaque pixels, inset slightly to reduce error at the extremes */
+void FindEndpointsBoundingBox(const SCMPRBlock& rkBlock, CVector3f& rStart, CVector3f& rEnd)
+{
+    CVector3f Min(255.f, 255.f, 255.f);
+    CVector3f Max(0.f, 0.f, 0.f);
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        if (rkBlock.Weight[iPixel] == 0.f)
+            continue;
+
+        Min.X = Math::Min(Min.X, rkBlock.R[iPixel]);
+        Min.Y = Math::Min(Min.Y, rkBlock.G[iPixel]);
+        Min.Z = Math::Min(Min.Z, rkBlock.B[iPixel]);
+        Max.X = Math::Max(Max.X, rkBlock.R[iPixel]);
+        Max.Y = Math::Max(Max.Y, rkBlock.G[iPixel]);
+        Max.Z = Math::Max(Max.Z, rkBlock.B[iPixel]);
+    }
+
+    const CVector3f Inset = (Max - Min) / 16.f;
+    rStart = Max - Inset;
+    rEnd = Min + Inset;
+}
+
+/** Endpoints from the extremes of the opaque pixels projected onto their principal axis */
+void FindEndpointsPrincipalAxis(const SCMPRBlock& rkBlock, CVector3f& rStart, CVector3f& rEnd)
+{
+    CVector3f Mean(0.f, 0.f, 0.f);
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        Mean.X += rkBlock.R[iPixel] * rkBlock.Weight[iPixel];
+        Mean.Y += rkBlock.G[iPixel] * rkBlock.Weight[iPixel];
+        Mean.Z += rkBlock.B[iPixel] * rkBlock.Weight[iPixel];
+    }
+    Mean = Mean / static_cast<float>(rkBlock.NumOpaque);
+
+    // Covariance matrix (symmetric, so only six unique terms)
+    float RR = 0.f, RG = 0.f, RB = 0.f, GG = 0.f, GB = 0.f, BB = 0.f;
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        const float DR = (rkBlock.R[iPixel] - Mean.X) * rkBlock.Weight[iPixel];
+        const float DG = (rkBlock.G[iPixel] - Mean.Y) * rkBlock.Weight[iPixel];
+        const float DB = (rkBlock.B[iPixel] - Mean.Z) * rkBlock.Weight[iPixel];
+        RR += DR * DR;
+        RG += DR * DG;
+        RB += DR * DB;
+        GG += DG * DG;
+        GB += DG * DB;
+        BB += DB * DB;
+    }
+
+    // Power iteration converges on the eigenvector with the largest eigenvalue
+    CVector3f Axis(1.f, 1.f, 1.f);
+
+    for (uint32 iIter = 0; iIter < 8; iIter++)
+    {
+        const CVector3f Next(Axis.X * RR + Axis.Y * RG + Axis.Z * RB,
+                             Axis.X * RG + Axis.Y * GG + Axis.Z * GB,
+                             Axis.X * RB + Axis.Y * GB + Axis.Z * BB);
+        const float Length = Next.Magnitude();
+
+        if (Length < FLT_EPSILON)
+            break;
+
+        Axis = Next / Length;
+    }
+
+    float MinT = FLT_MAX;
+    float MaxT = -FLT_MAX;
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        if (rkBlock.Weight[iPixel] == 0.f)
+            continue;
+
+        const float T = (rkBlock.R[iPixel] - Mean.X) * Axis.X + (rkBlock.G[iPixel] - Mean.Y) * Axis.Y + (rkBlock.B[iPixel] - Mean.Z) * Axis.Z;
+        MinT = Math::Min(MinT, T);
+        MaxT = Math::Max(MaxT, T);
+    }
+
+    rStart = Mean + (Axis * MaxT);
+    rEnd = Mean + (Axis * MinT);
+}
+
+/** Solve for the endpoints that best fit the current index assignment in a least-squares sense */
+bool RefineEndpoints(const SCMPRBlock& rkBlock, const SCMPRResult& rkResult, CVector3f& rStart, CVector3f& rEnd)
+{
+    static constexpr std::array skFourColorWeights{ 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+    static constexpr std::array skThreeColorWeights{ 1.f, 0.f, 0.5f, 0.f };
+    const bool ThreeColor = rkResult.IsThreeColor();
+    const auto& rkWeights = (ThreeColor ? skThreeColorWeights : skFourColorWeights);
+
+    float AA = 0.f, BB = 0.f, AB = 0.f;
+    CVector3f AX(0.f, 0.f, 0.f);
+    CVector3f BX(0.f, 0.f, 0.f);
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        const uint32 Index = (rkResult.Indices >> (30 - (iPixel * 2))) & 0x3;
+
+        if (rkBlock.Weight[iPixel] == 0.f || (ThreeColor && Index == 3))
+            continue;
+
+        const float A = rkWeights[Index];
+        const float B = 1.f - A;
+        const CVector3f Pixel(rkBlock.R[iPixel], rkBlock.G[iPixel], rkBlock.B[iPixel]);
+        AA += A * A;
+        BB += B * B;
+        AB += A * B;
+        AX += Pixel * A;
+        BX += Pixel * B;
+    }
+
+    const float Det = AA * BB - AB * AB;
+
+    if (Math::Abs(Det) < FLT_EPSILON)
+        return false;
+
+    rStart = (AX * BB - BX * AB) / Det;
+    rEnd = (BX * AA - AX * AB) / Det;
+    return true;
+}
+
+/** Nudge each 565 endpoint component by one step at a time and keep any change that lowers the error */
+void LocalSearchCMPR(const SCMPRBlock& rkBlock, SCMPRResult& rBest)
+{
+    static constexpr std::array<uint16, 3> skComponentShift{ 11, 5, 0 };
+    static constexpr std::array<uint16, 3> skComponentMax{ 31, 63, 31 };
+    bool Improved = true;
+
+    for (uint32 iPass = 0; iPass < 8 && Improved; iPass++)
+    {
+        Improved = false;
+
+        for (uint32 iEndpoint = 0; iEndpoint < 2; iEndpoint++)
+        {
+            for (uint32 iComp = 0; iComp < 3; iComp++)
             {
-                for (uint32 iImgY = iBlockY; iImgY < iBlockY + 2; iImgY++)
+                for (int Delta = -1; Delta <= 1; Delta += 2)
                 {
-                    for (uint32 iImgX = iBlockX; iImgX < iBlockX + 2; iImgX++)
+                    std::array<uint16, 2> Colors{ rBest.Color0, rBest.Color1 };
+                    const uint16 Shift = skComponentShift[iComp];
+                    const int Value = ((Colors[iEndpoint] >> Shift) & skComponentMax[iComp]) + Delta;
+
+                    if (Value < 0 || Value > skComponentMax[iComp])
+                        continue;
+
+                    Colors[iEndpoint] = static_cast<uint16>((Colors[iEndpoint] & ~(skComponentMax[iComp] << Shift)) | (Value << Shift));
+                    const SCMPRResult Candidate = EvaluateCMPR(rkBlock, Colors[0], Colors[1], rBest.IsThreeColor());
+
+                    if (Candidate.Error < rBest.Error)
                     {
-                        uint32 SrcPos = ((iImgY * MipW) + iImgX) * 8;
-                        Image.Seek(MipOffset + SrcPos, SEEK_SET);
+                        rBest = Candidate;
+                        Improved = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCMPRResult CompressCMPR(const SCMPRBlock& rkBlock, ETextureEncodeQuality Quality)
+{
+    // Fully transparent block: three color mode with every pixel on the transparent index
+    if (rkBlock.NumOpaque == 0)
+    {
+        SCMPRResult Result;
+        Result.Indices = 0xFFFFFFFF;
+        Result.Error = 0.f;
+        return Result;
+    }
+
+    CVector3f Start, End;
+
+    if (Quality == ETextureEncodeQuality::Fast)
+        FindEndpointsBoundingBox(rkBlock, Start, End);
+    else
+        FindEndpointsPrincipalAxis(rkBlock, Start, End);
+
+    const bool NeedsAlpha = (rkBlock.NumOpaque < 16);
+    SCMPRResult Best = EvaluateCMPR(rkBlock, PackRGB565(Start), PackRGB565(End), NeedsAlpha);
+
+    if (!NeedsAlpha && Quality == ETextureEncodeQuality::Best)
+    {
+        const SCMPRResult Candidate = EvaluateCMPR(rkBlock, PackRGB565(Start), PackRGB565(End), true);
+
+        if (Candidate.Error < Best.Error)
+            Best = Candidate;
+    }
 
-                        ReadSubBlockCMPR(Image, rTXTR);
+    if (Quality != ETextureEncodeQuality::Fast)
+    {
+        const uint32 NumIterations = (Quality == ETextureEncodeQuality::Best ? 4 : 1);
+
+        for (uint32 iIter = 0; iIter < NumIterations && Best.Error > 0.f; iIter++)
+        {
+            if (!RefineEndpoints(rkBlock, Best, Start, End))
+                break;
+
+            const SCMPRResult Candidate = EvaluateCMPR(rkBlock, PackRGB565(Start), PackRGB565(End), Best.IsThreeColor());
+
+            if (Candidate.Error >= Best.Error)
+                break;
+
+            Best = Candidate;
+        }
+    }
+
+    if (Quality == ETextureEncodeQuality::Best && Best.Error > 0.f)
+        LocalSearchCMPR(rkBlock, Best);
+
+    return Best;
+}
+}
+
+CTextureEncoder::CTextureEncoder() = default;
+
+bool CTextureEncoder::WriteTXTR(IOutputStream& rTXTR)
+{
+    CScopedPerfPhase PerfPhase("TXTR.Encode");
+
+    if (!mpTexture->mBufferExists)
+    {
+        errorf("Can't encode texture; no image data is loaded");
+        return false;
+    }
+
+    if (mOutputFormat == ETexelFormat::Invalid)
+        DetermineBestOutputFormat();
+
+    if (mOutputFormat < ETexelFormat::GX_I4 || mOutputFormat > ETexelFormat::GX_CMPR || mOutputFormat == ETexelFormat::GX_C14x2)
+    {
+        errorf("Unsupported texel format for encoding");
+        return false;
+    }
+
+    // DXT1 mips can be copied straight into CMPR blocks, so only levels the source doesn't have need to be encoded
+    const uint32 NumPassthroughMips = (mSourceFormat == ETexelFormat::DXT1 && mOutputFormat == ETexelFormat::GX_CMPR ? mpTexture->mNumMipMaps : 0);
+    const uint32 NumMipMaps = Math::Max(NumPassthroughMips, mGenerateMipMaps ? CalcMipCount(mpTexture->Width(), mpTexture->Height()) : 1U);
+
+    if (NumMipMaps > NumPassthroughMips)
+    {
+        if (mMipChain.empty() && !DecodeSource())
+            return false;
+
+        GenerateMipChain(NumMipMaps);
+
+        if (mOutputFormat == ETexelFormat::GX_C4 || mOutputFormat == ETexelFormat::GX_C8)
+            BuildPalette();
+    }
+
+    const size_t FormatIdx = static_cast<size_t>(mOutputFormat);
+    const uint32 BlockWidth = gskBlockWidth[FormatIdx];
+    const uint32 BlockHeight = gskBlockHeight[FormatIdx];
+    const uint32 BlockSize = BlockWidth * BlockHeight * CTexture::FormatBPP(mOutputFormat) / 8;
+
+    // Allocate output for every mip up front so blocks can be encoded in any order
+    std::vector<std::vector<uint8>> MipData(NumMipMaps);
+    std::vector<uint32> MipBlocksPerRow(NumMipMaps);
+    std::vector<SBlockRow> BlockRows;
+    uint32 SourceOffset = 0;
+
+    for (uint32 iMip = 0; iMip < NumMipMaps; iMip++)
+    {
+        const uint32 MipW = Math::Max(mpTexture->Width() >> iMip, 1U);
+        const uint32 MipH = Math::Max(mpTexture->Height() >> iMip, 1U);
+        const uint32 BlocksX = (MipW + BlockWidth - 1) / BlockWidth;
+        const uint32 BlocksY = (MipH + BlockHeight - 1) / BlockHeight;
+        MipData[iMip].resize(BlocksX * BlocksY * BlockSize);
+        MipBlocksPerRow[iMip] = BlocksX;
+
+        if (iMip < NumPassthroughMips)
+        {
+            CMemoryInStream Image(mpTexture->mpImgDataBuffer, mpTexture->mImgDataSize, EEndian::LittleEndian);
+            CMemoryOutStream Out(MipData[iMip].data(), MipData[iMip].size(), EEndian::BigEndian);
+            const uint32 SrcBlocksX = Math::Max(MipW / 4, 1U);
+            const uint32 SrcBlocksY = Math::Max(MipH / 4, 1U);
+
+            // Small mips are padded out to a full 8x8 block by repeating the edge subblocks
+            for (uint32 iBlockY = 0; iBlockY < BlocksY * 2; iBlockY += 2)
+            {
+                for (uint32 iBlockX = 0; iBlockX < BlocksX * 2; iBlockX += 2)
+                {
+                    for (uint32 iImgY = iBlockY; iImgY < iBlockY + 2; iImgY++)
+                    {
+                        for (uint32 iImgX = iBlockX; iImgX < iBlockX + 2; iImgX++)
+                        {
+                            const uint32 SrcX = Math::Min(iImgX, SrcBlocksX - 1);
+                            const uint32 SrcY = Math::Min(iImgY, SrcBlocksY - 1);
+                            Image.Seek(SourceOffset + (((SrcY * SrcBlocksX) + SrcX) * 8), SEEK_SET);
+                            ReadSubBlockCMPR(Image, Out);
+                        }
                     }
                 }
             }
+
+            SourceOffset += SrcBlocksX * SrcBlocksY * 8;
+        }
+        else
+        {
+            for (uint32 iBlockY = 0; iBlockY < BlocksY; iBlockY++)
+                BlockRows.push_back(SBlockRow{iMip, iBlockY});
         }
+    }
+
+    NParallel::ParallelFor(BlockRows.size(), [&](size_t RowIdx)
+    {
+        const SBlockRow& rkRow = BlockRows[RowIdx];
+        const SMipLevel& rkMip = mMipChain[rkRow.MipIndex];
+        const uint32 BlocksX = MipBlocksPerRow[rkRow.MipIndex];
+        uint8 *pOut = MipData[rkRow.MipIndex].data() + (rkRow.BlockY * BlocksX * BlockSize);
+
+        for (uint32 iBlockX = 0; iBlockX < BlocksX; iBlockX++)
+            EncodeBlock(rkMip, iBlockX, rkRow.BlockY, pOut + (iBlockX * BlockSize));
+    });
 
-        MipOffset += MipW * MipH * 8;
-        MipW /= 2;
-        MipH /= 2;
+    // Write TXTR
+    const uint32 StartOffset = rTXTR.Tell();
+    rTXTR.WriteULong(static_cast<uint32>(mOutputFormat));
+    rTXTR.WriteUShort(mpTexture->mWidth);
+    rTXTR.WriteUShort(mpTexture->mHeight);
+    rTXTR.WriteULong(NumMipMaps);
 
-        if (MipW < 2)
-            MipW = 2;
+    if (mOutputFormat == ETexelFormat::GX_C4 || mOutputFormat == ETexelFormat::GX_C8)
+    {
+        rTXTR.WriteULong(static_cast<uint32>(mPaletteFormat));
+        rTXTR.WriteUShort(1);
+        rTXTR.WriteUShort(static_cast<uint16>(mPalette.size()));
 
-        if (MipH < 2)
-            MipH = 2;
+        for (const uint16 Entry : mPalette)
+            rTXTR.WriteUShort(Entry);
     }
+
+    for (const std::vector<uint8>& rkData : MipData)
+        rTXTR.WriteBytes(rkData.data(), rkData.size());
+
+    PerfPhase.AddBytes(rTXTR.Tell() - StartOffset);
+    return true;
 }
 
 void CTextureEncoder::DetermineBestOutputFormat()
 {
-    // todo
+    switch (mSourceFormat)
+    {
+    case ETexelFormat::Luminance:       mOutputFormat = ETexelFormat::GX_I8;        return;
+    case ETexelFormat::LuminanceAlpha:  mOutputFormat = ETexelFormat::GX_IA8;       return;
+    case ETexelFormat::RGBA4:           mOutputFormat = ETexelFormat::GX_RGB5A3;    return;
+    case ETexelFormat::RGB565:          mOutputFormat = ETexelFormat::GX_RGB565;    return;
+    case ETexelFormat::DXT1:            mOutputFormat = ETexelFormat::GX_CMPR;      return;
+    default:                            break;
+    }
+
+    // RGBA8: CMPR covers opaque images and images with 1-bit alpha; smooth alpha needs RGB5A3
+    if (mMipChain.empty() && !DecodeSource())
+    {
+        mOutputFormat = ETexelFormat::GX_RGBA8;
+        return;
+    }
+
+    const std::vector<uint8>& rkPixels = mMipChain[0].Pixels;
+    bool HasPartialAlpha = false;
+
+    for (size_t iPixel = 3; iPixel < rkPixels.size() && !HasPartialAlpha; iPixel += 4)
+        HasPartialAlpha = (rkPixels[iPixel] > 0x10 && rkPixels[iPixel] < 0xF0);
+
+    mOutputFormat = (HasPartialAlpha ? ETexelFormat::GX_RGB5A3 : ETexelFormat::GX_CMPR);
 }
 
 void CTextureEncoder::ReadSubBlockCMPR(IInputStream& rSource, IOutputStream& rDest)
@@ -65,26 +640,518 @@ void CTextureEncoder::ReadSubBlockCMPR(IInputStream& rSource, IOutputStream& rDe
     }
 }
 
-// ************ STATIC ************
-void CTextureEncoder::EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex)
+bool CTextureEncoder::DecodeSource()
+{
+    const uint32 Width = mpTexture->Width();
+    const uint32 Height = mpTexture->Height();
+    const uint32 RequiredSize = Width * Height * CTexture::FormatBPP(mSourceFormat) / 8;
+
+    if (Width == 0 || Height == 0 || RequiredSize > mpTexture->mImgDataSize)
+    {
+        errorf("Can't encode texture; image data is missing or truncated");
+        return false;
+    }
+
+    mMipChain.resize(1);
+    SMipLevel& rTop = mMipChain[0];
+    rTop.Width = Width;
+    rTop.Height = Height;
+    rTop.Pixels.resize(Width * Height * 4);
+
+    const uint8 *pkSrc = mpTexture->mpImgDataBuffer;
+    uint8 *pDst = rTop.Pixels.data();
+
+    if (mSourceFormat == ETexelFormat::DXT1)
+    {
+        const uint32 BlocksX = Math::Max(Width / 4, 1U);
+        const uint32 BlocksY = Math::Max(Height / 4, 1U);
+
+        for (uint32 iBlock = 0; iBlock < BlocksX * BlocksY; iBlock++)
+        {
+            const uint8 *pkBlock = pkSrc + (iBlock * 8);
+            const uint16 Color0 = static_cast<uint16>(pkBlock[0] | (pkBlock[1] << 8));
+            const uint16 Color1 = static_cast<uint16>(pkBlock[2] | (pkBlock[3] << 8));
+            std::array<std::array<uint8, 4>, 4> Palette{ UnpackRGB565(Color0), UnpackRGB565(Color1) };
+
+            for (uint32 iComp = 0; iComp < 3; iComp++)
+            {
+                if (Color0 > Color1)
+                {
+                    Palette[2][iComp] = static_cast<uint8>((Palette[0][iComp] * 2 + Palette[1][iComp]) / 3);
+                    Palette[3][iComp] = static_cast<uint8>((Palette[0][iComp] + Palette[1][iComp] * 2) / 3);
+                }
+                else
+                {
+                    Palette[2][iComp] = static_cast<uint8>((Palette[0][iComp] + Palette[1][iComp]) / 2);
+                }
+            }
+            Palette[2][3] = 0xFF;
+            Palette[3][3] = (Color0 > Color1 ? 0xFF : 0x00);
+
+            const uint32 BaseX = (iBlock % BlocksX) * 4;
+            const uint32 BaseY = (iBlock / BlocksX) * 4;
+
+            for (uint32 iRow = 0; iRow < 4 && BaseY + iRow < Height; iRow++)
+            {
+                for (uint32 iCol = 0; iCol < 4 && BaseX + iCol < Width; iCol++)
+                {
+                    const uint32 Index = (pkBlock[4 + iRow] >> (iCol * 2)) & 0x3;
+                    std::memcpy(pDst + ((((BaseY + iRow) * Width) + BaseX + iCol) * 4), Palette[Index].data(), 4);
+                }
+            }
+        }
+
+        return true;
+    }
+
+    for (uint32 iPixel = 0; iPixel < Width * Height; iPixel++)
+    {
+        uint8 *pPixel = pDst + (iPixel * 4);
+
+        switch (mSourceFormat)
+        {
+        case ETexelFormat::Luminance:
+            pPixel[0] = pPixel[1] = pPixel[2] = pkSrc[iPixel];
+            pPixel[3] = 0xFF;
+            break;
+
+        case ETexelFormat::LuminanceAlpha:
+            pPixel[0] = pPixel[1] = pPixel[2] = pkSrc[iPixel * 2];
+            pPixel[3] = pkSrc[iPixel * 2 + 1];
+            break;
+
+        case ETexelFormat::RGB565:
+        {
+            const std::array<uint8, 4> Color = UnpackRGB565(ReadNativeShort(pkSrc + (iPixel * 2)));
+            std::memcpy(pPixel, Color.data(), 4);
+            break;
+        }
+
+        case ETexelFormat::RGBA4:
+        {
+            const uint16 Value = ReadNativeShort(pkSrc + (iPixel * 2));
+            pPixel[0] = Extend4to8(static_cast<uint8>(Value >> 12));
+            pPixel[1] = Extend4to8(static_cast<uint8>(Value >> 8));
+            pPixel[2] = Extend4to8(static_cast<uint8>(Value >> 4));
+            pPixel[3] = Extend4to8(static_cast<uint8>(Value));
+            break;
+        }
+
+        case ETexelFormat::RGBA8:
+            std::memcpy(pPixel, pkSrc + (iPixel * 4), 4);
+            break;
+
+        default:
+            errorf("Unsupported texel format for encoding");
+            mMipChain.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CTextureEncoder::GenerateMipChain(uint32 NumMipMaps)
 {
-    if (pTex->mTexelFormat != ETexelFormat::DXT1)
+    mMipChain.resize(NumMipMaps);
+
+    for (uint32 iMip = 1; iMip < NumMipMaps; iMip++)
     {
-        errorf("Unsupported texel format for decoding");
+        const SMipLevel& rkSrc = mMipChain[iMip - 1];
+        SMipLevel& rDst = mMipChain[iMip];
+
+        if (!rDst.Pixels.empty())
+            continue;
+
+        rDst.Width = Math::Max(rkSrc.Width / 2, 1U);
+        rDst.Height = Math::Max(rkSrc.Height / 2, 1U);
+        rDst.Pixels.resize(rDst.Width * rDst.Height * 4);
+
+        // 2x2 box filter. Color is weighted by alpha so transparent texels don't bleed into the visible ones.
+        NParallel::ParallelFor(rDst.Height, [&](size_t Y)
+        {
+            const uint32 SrcY0 = Math::Min(static_cast<uint32>(Y * 2), rkSrc.Height - 1);
+            const uint32 SrcY1 = Math::Min(SrcY0 + 1, rkSrc.Height - 1);
+
+            for (uint32 X = 0; X < rDst.Width; X++)
+            {
+                const uint32 SrcX0 = Math::Min(X * 2, rkSrc.Width - 1);
+                const uint32 SrcX1 = Math::Min(SrcX0 + 1, rkSrc.Width - 1);
+                const std::array<const uint8*, 4> Samples{
+                    &rkSrc.Pixels[((SrcY0 * rkSrc.Width) + SrcX0) * 4],
+                    &rkSrc.Pixels[((SrcY0 * rkSrc.Width) + SrcX1) * 4],
+                    &rkSrc.Pixels[((SrcY1 * rkSrc.Width) + SrcX0) * 4],
+                    &rkSrc.Pixels[((SrcY1 * rkSrc.Width) + SrcX1) * 4],
+                };
+
+                uint32 AlphaSum = 0;
+                std::array<uint32, 3> WeightedSum{};
+                std::array<uint32, 3> PlainSum{};
+
+                for (const uint8 *pkSample : Samples)
+                {
+                    AlphaSum += pkSample[3];
+
+                    for (uint32 iComp = 0; iComp < 3; iComp++)
+                    {
+                        WeightedSum[iComp] += pkSample[iComp] * pkSample[3];
+                        PlainSum[iComp] += pkSample[iComp];
+                    }
+                }
+
+                uint8 *pOut = &rDst.Pixels[((Y * rDst.Width) + X) * 4];
+
+                for (uint32 iComp = 0; iComp < 3; iComp++)
+                    pOut[iComp] = static_cast<uint8>(AlphaSum > 0 ? (WeightedSum[iComp] + AlphaSum / 2) / AlphaSum : (PlainSum[iComp] + 2) / 4);
+
+                pOut[3] = static_cast<uint8>((AlphaSum + 2) / 4);
+            }
+        });
+    }
+}
+
+void CTextureEncoder::BuildPalette()
+{
+    const SMipLevel& rkTop = mMipChain[0];
+    const uint32 NumEntries = (mOutputFormat == ETexelFormat::GX_C4 ? 16 : 256);
+    const uint32 NumPixels = rkTop.Width * rkTop.Height;
+
+    // Pick the palette format that fits the image contents
+    bool IsGrayscale = true;
+    bool IsOpaque = true;
+
+    for (uint32 iPixel = 0; iPixel < NumPixels; iPixel++)
+    {
+        const uint8 *pkPixel = &rkTop.Pixels[iPixel * 4];
+        IsGrayscale &= (pkPixel[0] == pkPixel[1] && pkPixel[1] == pkPixel[2]);
+        IsOpaque &= (pkPixel[3] == 0xFF);
+    }
+
+    if (IsGrayscale)    mPaletteFormat = EGXPaletteFormat::IA8;
+    else if (IsOpaque)  mPaletteFormat = EGXPaletteFormat::RGB565;
+    else                mPaletteFormat = EGXPaletteFormat::RGB5A3;
+
+    // Median cut over a subsample of the image
+    using SColor = std::array<uint8, 4>;
+    const uint32 Stride = Math::Max(NumPixels / gskMaxPaletteSamples, 1U);
+    std::vector<SColor> Samples;
+    Samples.reserve(NumPixels / Stride + 1);
+
+    for (uint32 iPixel = 0; iPixel < NumPixels; iPixel += Stride)
+    {
+        SColor Color;
+        std::memcpy(Color.data(), &rkTop.Pixels[iPixel * 4], 4);
+        Samples.push_back(Color);
+    }
+
+    struct SBox
+    {
+        uint32 Begin;
+        uint32 End;
+        uint32 Channel;
+        uint32 Range;
+    };
+
+    auto MakeBox = [&Samples](uint32 Begin, uint32 End)
+    {
+        SColor Min{ 0xFF, 0xFF, 0xFF, 0xFF };
+        SColor Max{ 0, 0, 0, 0 };
+
+        for (uint32 iSample = Begin; iSample < End; iSample++)
+        {
+            for (uint32 iComp = 0; iComp < 4; iComp++)
+            {
+                Min[iComp] = Math::Min(Min[iComp], Samples[iSample][iComp]);
+                Max[iComp] = Math::Max(Max[iComp], Samples[iSample][iComp]);
+            }
+        }
+
+        SBox Box{ Begin, End, 0, 0 };
+
+        for (uint32 iComp = 0; iComp < 4; iComp++)
+        {
+            const uint32 Range = Max[iComp] - Min[iComp];
+
+            if (Range > Box.Range)
+            {
+                Box.Channel = iComp;
+                Box.Range = Range;
+            }
+        }
+
+        return Box;
+    };
+
+    std::vector<SBox> Boxes{ MakeBox(0, static_cast<uint32>(Samples.size())) };
+
+    while (Boxes.size() < NumEntries)
+    {
+        // Split the box with the widest channel range at its median
+        SBox *pSplit = nullptr;
+
+        for (SBox& rBox : Boxes)
+        {
+            if (rBox.End - rBox.Begin >= 2 && rBox.Range > 0 && (!pSplit || rBox.Range > pSplit->Range))
+                pSplit = &rBox;
+        }
+
+        if (!pSplit)
+            break;
+
+        const SBox Box = *pSplit;
+        const uint32 Mid = (Box.Begin + Box.End) / 2;
+        std::nth_element(Samples.begin() + Box.Begin, Samples.begin() + Mid, Samples.begin() + Box.End,
+                         [Channel = Box.Channel](const SColor& rkA, const SColor& rkB) { return rkA[Channel] < rkB[Channel]; });
+
+        *pSplit = MakeBox(Box.Begin, Mid);
+        Boxes.push_back(MakeBox(Mid, Box.End));
+    }
+
+    std::vector<std::array<float, 4>> Centers(Boxes.size());
+
+    for (size_t iBox = 0; iBox < Boxes.size(); iBox++)
+    {
+        std::array<float, 4> Sum{};
+
+        for (uint32 iSample = Boxes[iBox].Begin; iSample < Boxes[iBox].End; iSample++)
+        {
+            for (uint32 iComp = 0; iComp < 4; iComp++)
+                Sum[iComp] += Samples[iSample][iComp];
+        }
+
+        const float Count = static_cast<float>(Math::Max(Boxes[iBox].End - Boxes[iBox].Begin, 1U));
+
+        for (uint32 iComp = 0; iComp < 4; iComp++)
+            Centers[iBox][iComp] = Sum[iComp] / Count;
+    }
+
+    // Refine with a few k-means iterations
+    const uint32 NumIterations = (mQuality == ETextureEncodeQuality::Fast ? 0 : mQuality == ETextureEncodeQuality::Normal ? 2 : 8);
+    std::vector<uint16> Assignment(Samples.size());
+
+    for (uint32 iIter = 0; iIter < NumIterations; iIter++)
+    {
+        NParallel::ParallelFor(Samples.size(), [&](size_t iSample)
+        {
+            float BestDist = FLT_MAX;
+
+            for (size_t iCenter = 0; iCenter < Centers.size(); iCenter++)
+            {
+                float Dist = 0.f;
+
+                for (uint32 iComp = 0; iComp < 4; iComp++)
+                {
+                    const float Delta = Samples[iSample][iComp] - Centers[iCenter][iComp];
+                    Dist += Delta * Delta;
+                }
+
+                if (Dist < BestDist)
+                {
+                    BestDist = Dist;
+                    Assignment[iSample] = static_cast<uint16>(iCenter);
+                }
+            }
+        });
+
+        std::vector<std::array<float, 4>> Sums(Centers.size(), std::array<float, 4>{});
+        std::vector<uint32> Counts(Centers.size(), 0);
+
+        for (size_t iSample = 0; iSample < Samples.size(); iSample++)
+        {
+            for (uint32 iComp = 0; iComp < 4; iComp++)
+                Sums[Assignment[iSample]][iComp] += Samples[iSample][iComp];
+
+            Counts[Assignment[iSample]]++;
+        }
+
+        for (size_t iCenter = 0; iCenter < Centers.size(); iCenter++)
+        {
+            if (Counts[iCenter] == 0)
+                continue;
+
+            for (uint32 iComp = 0; iComp < 4; iComp++)
+                Centers[iCenter][iComp] = Sums[iCenter][iComp] / Counts[iCenter];
+        }
+    }
+
+    // Quantize to the palette format. Unused entries repeat the last color.
+    mPalette.resize(NumEntries);
+    mDecodedPalette.resize(NumEntries);
+
+    for (uint32 iEntry = 0; iEntry < NumEntries; iEntry++)
+    {
+        const std::array<float, 4>& rkCenter = Centers[Math::Min<size_t>(iEntry, Centers.size() - 1)];
+        SColor Color;
+
+        for (uint32 iComp = 0; iComp < 4; iComp++)
+            Color[iComp] = static_cast<uint8>(Math::Clamp(0.f, 255.f, rkCenter[iComp] + 0.5f));
+
+        switch (mPaletteFormat)
+        {
+        case EGXPaletteFormat::IA8:
+            mPalette[iEntry] = PackIA8(Color.data());
+            mDecodedPalette[iEntry] = UnpackIA8(mPalette[iEntry]);
+            break;
+        case EGXPaletteFormat::RGB565:
+            mPalette[iEntry] = PackRGB565(Color.data());
+            mDecodedPalette[iEntry] = UnpackRGB565(mPalette[iEntry]);
+            break;
+        case EGXPaletteFormat::RGB5A3:
+            mPalette[iEntry] = PackRGB5A3(Color.data());
+            mDecodedPalette[iEntry] = UnpackRGB5A3(mPalette[iEntry]);
+            break;
+        }
+    }
+}
+
+uint8 CTextureEncoder::FindPaletteIndex(const uint8 *pkPixel) const
+{
+    uint32 BestDist = UINT32_MAX;
+    uint8 BestIndex = 0;
+
+    for (size_t iEntry = 0; iEntry < mDecodedPalette.size() && BestDist > 0; iEntry++)
+    {
+        const uint32 Dist = ColorDistance(pkPixel, mDecodedPalette[iEntry].data());
+
+        if (Dist < BestDist)
+        {
+            BestDist = Dist;
+            BestIndex = static_cast<uint8>(iEntry);
+        }
+    }
+
+    return BestIndex;
+}
+
+void CTextureEncoder::EncodeBlock(const SMipLevel& rkMip, uint32 BlockX, uint32 BlockY, uint8 *pOut) const
+{
+    const size_t FormatIdx = static_cast<size_t>(mOutputFormat);
+    const uint32 BlockWidth = gskBlockWidth[FormatIdx];
+    const uint32 BlockHeight = gskBlockHeight[FormatIdx];
+    const uint32 BaseX = BlockX * BlockWidth;
+    const uint32 BaseY = BlockY * BlockHeight;
+
+    // Pixels past the edge of small or odd-sized mips repeat the edge pixels
+    auto Pixel = [&rkMip, BaseX, BaseY](uint32 X, uint32 Y) -> const uint8*
+    {
+        X = Math::Min(BaseX + X, rkMip.Width - 1);
+        Y = Math::Min(BaseY + Y, rkMip.Height - 1);
+        return &rkMip.Pixels[((Y * rkMip.Width) + X) * 4];
+    };
+
+    if (mOutputFormat == ETexelFormat::GX_CMPR)
+    {
+        EncodeSubBlockCMPR(rkMip, BaseX, BaseY, pOut);
+        EncodeSubBlockCMPR(rkMip, BaseX + 4, BaseY, pOut + 8);
+        EncodeSubBlockCMPR(rkMip, BaseX, BaseY + 4, pOut + 16);
+        EncodeSubBlockCMPR(rkMip, BaseX + 4, BaseY + 4, pOut + 24);
         return;
     }
 
-    CTextureEncoder Encoder;
-    Encoder.mpTexture = pTex;
-    Encoder.mSourceFormat = ETexelFormat::DXT1;
-    Encoder.mOutputFormat = ETexelFormat::GX_CMPR;
-    Encoder.WriteTXTR(rTXTR);
+    if (mOutputFormat == ETexelFormat::GX_RGBA8)
+    {
+        // AR pairs for the whole block, followed by GB pairs
+        for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+        {
+            const uint8 *pkPixel = Pixel(iPixel % 4, iPixel / 4);
+            pOut[iPixel * 2] = pkPixel[3];
+            pOut[iPixel * 2 + 1] = pkPixel[0];
+            pOut[32 + iPixel * 2] = pkPixel[1];
+            pOut[32 + iPixel * 2 + 1] = pkPixel[2];
+        }
+        return;
+    }
+
+    for (uint32 Y = 0; Y < BlockHeight; Y++)
+    {
+        for (uint32 X = 0; X < BlockWidth; X++)
+        {
+            const uint8 *pkPixel = Pixel(X, Y);
+
+            switch (mOutputFormat)
+            {
+            case ETexelFormat::GX_I4:
+            case ETexelFormat::GX_C4:
+            {
+                // Two pixels per byte, first pixel in the high nibble
+                const uint8 Value = (mOutputFormat == ETexelFormat::GX_I4 ? Quantize(Luminance(pkPixel), 15) : FindPaletteIndex(pkPixel));
+
+                if ((X & 1) == 0)
+                    *pOut = static_cast<uint8>(Value << 4);
+                else
+                    *pOut++ |= Value;
+                break;
+            }
+            case ETexelFormat::GX_I8:
+                *pOut++ = Luminance(pkPixel);
+                break;
+            case ETexelFormat::GX_IA4:
+                *pOut++ = static_cast<uint8>((Quantize(pkPixel[3], 15) << 4) | Quantize(Luminance(pkPixel), 15));
+                break;
+            case ETexelFormat::GX_IA8:
+                WriteBigShort(pOut, PackIA8(pkPixel));
+                pOut += 2;
+                break;
+            case ETexelFormat::GX_C8:
+                *pOut++ = FindPaletteIndex(pkPixel);
+                break;
+            case ETexelFormat::GX_RGB565:
+                WriteBigShort(pOut, PackRGB565(pkPixel));
+                pOut += 2;
+                break;
+            case ETexelFormat::GX_RGB5A3:
+                WriteBigShort(pOut, PackRGB5A3(pkPixel));
+                pOut += 2;
+                break;
+            default:
+                break;
+            }
+        }
+    }
 }
 
-void CTextureEncoder::EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex, ETexelFormat /*OutputFormat*/)
+void CTextureEncoder::EncodeSubBlockCMPR(const SMipLevel& rkMip, uint32 PixelX, uint32 PixelY, uint8 *pOut) const
 {
-    // todo: support for encoding a specific format
-    EncodeTXTR(rTXTR, pTex);
+    SCMPRBlock Block;
+
+    for (uint32 iPixel = 0; iPixel < 16; iPixel++)
+    {
+        const uint32 X = Math::Min(PixelX + (iPixel % 4), rkMip.Width - 1);
+        const uint32 Y = Math::Min(PixelY + (iPixel / 4), rkMip.Height - 1);
+        const uint8 *pkPixel = &rkMip.Pixels[((Y * rkMip.Width) + X) * 4];
+        const bool Opaque = (pkPixel[3] >= gskAlphaThreshold);
+
+        Block.R[iPixel] = pkPixel[0];
+        Block.G[iPixel] = pkPixel[1];
+        Block.B[iPixel] = pkPixel[2];
+        Block.Weight[iPixel] = (Opaque ? 1.f : 0.f);
+        Block.NumOpaque += (Opaque ? 1 : 0);
+    }
+
+    const SCMPRResult Result = CompressCMPR(Block, mQuality);
+    WriteBigShort(pOut, Result.Color0);
+    WriteBigShort(pOut + 2, Result.Color1);
+
+    for (uint32 iRow = 0; iRow < 4; iRow++)
+        pOut[4 + iRow] = static_cast<uint8>(Result.Indices >> (24 - (iRow * 8)));
+}
+
+// ************ STATIC ************
+bool CTextureEncoder::EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex)
+{
+    return EncodeTXTR(rTXTR, pTex, ETexelFormat::Invalid);
+}
+
+bool CTextureEncoder::EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex, ETexelFormat OutputFormat,
+                                 ETextureEncodeQuality Quality /*= ETextureEncodeQuality::Normal*/, bool GenerateMipMaps /*= true*/)
+{
+    CTextureEncoder Encoder;
+    Encoder.mpTexture = pTex;
+    Encoder.mSourceFormat = pTex->mTexelFormat;
+    Encoder.mOutputFormat = OutputFormat;
+    Encoder.mQuality = Quality;
+    Encoder.mGenerateMipMaps = GenerateMipMaps;
+    return Encoder.WriteTXTR(rTXTR);
 }
 
 ETexelFormat CTextureEncoder::GetGXFormat(ETexelFormat Format)
@@ -105,12 +1172,16 @@ ETexelFormat CTextureEncoder::GetFormat(ETexelFormat Format)
 {
     switch (Format)
     {
-    case ETexelFormat::GX_I4:   return ETexelFormat::Luminance;
-    case ETexelFormat::GX_I8:   return ETexelFormat::Luminance;
-    case ETexelFormat::GX_IA4:  return ETexelFormat::LuminanceAlpha;
-    case ETexelFormat::GX_IA8:  return ETexelFormat::LuminanceAlpha;
-        // todo rest of these
-    case ETexelFormat::GX_CMPR: return ETexelFormat::DXT1;
-    default:                    return ETexelFormat::Invalid;
+    case ETexelFormat::GX_I4:       return ETexelFormat::Luminance;
+    case ETexelFormat::GX_I8:       return ETexelFormat::Luminance;
+    case ETexelFormat::GX_IA4:      return ETexelFormat::LuminanceAlpha;
+    case ETexelFormat::GX_IA8:      return ETexelFormat::LuminanceAlpha;
+    case ETexelFormat::GX_C4:       return ETexelFormat::RGBA8;
+    case ETexelFormat::GX_C8:       return ETexelFormat::RGBA8;
+    case ETexelFormat::GX_RGB565:   return ETexelFormat::RGB565;
+    case ETexelFormat::GX_RGB5A3:   return ETexelFormat::RGBA8;
+    case ETexelFormat::GX_RGBA8:    return ETexelFormat::RGBA8;
+    case ETexelFormat::GX_CMPR:     return ETexelFormat::DXT1;
+    default:                        return ETexelFormat::Invalid;
     }
 }
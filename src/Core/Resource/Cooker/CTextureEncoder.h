@@ -3,23 +3,66 @@
 
 #include "Core/Resource/CTexture.h"
 #include "Core/Resource/TResPtr.h"
+#include <array>
+#include <vector>
 
-// Class contains basic functionality right now - only supports directly converting DXT1 to CMPR
-// More advanced functions (including actual encoding!) coming later
+/** Speed/quality trade-off used when compressing CMPR blocks and building C4/C8 palettes */
+enum class ETextureEncodeQuality
+{
+    Fast,   // Bounding box endpoints, no palette refinement
+    Normal, // Principal axis endpoints with a least-squares refinement pass
+    Best    // Normal, plus a local search around the refined endpoints
+};
+
+/**
+ * Encodes textures to GX TXTR files. The source texture is decoded to RGBA8, a mip chain is
+ * generated from the top level, and every block of every mip is encoded in parallel.
+ * DXT1 textures encoded to CMPR with their existing mips are passed through without recompressing.
+ */
 class CTextureEncoder
 {
+    /** One decoded mip level, 4 bytes per pixel in R/G/B/A order */
+    struct SMipLevel
+    {
+        uint32 Width = 0;
+        uint32 Height = 0;
+        std::vector<uint8> Pixels;
+    };
+
+    /** One unit of parallel work: a row of blocks in a mip level */
+    struct SBlockRow
+    {
+        uint32 MipIndex;
+        uint32 BlockY;
+    };
+
     TResPtr<CTexture> mpTexture{nullptr};
     ETexelFormat mSourceFormat{};
     ETexelFormat mOutputFormat{};
+    ETextureEncodeQuality mQuality{ETextureEncodeQuality::Normal};
+    bool mGenerateMipMaps = true;
+
+    std::vector<SMipLevel> mMipChain;
+    EGXPaletteFormat mPaletteFormat{EGXPaletteFormat::RGB5A3};
+    std::vector<uint16> mPalette;
+    std::vector<std::array<uint8, 4>> mDecodedPalette;
 
     CTextureEncoder();
-    void WriteTXTR(IOutputStream& rTXTR);
+    bool WriteTXTR(IOutputStream& rTXTR);
     void DetermineBestOutputFormat();
     void ReadSubBlockCMPR(IInputStream& rSource, IOutputStream& rDest);
 
+    bool DecodeSource();
+    void GenerateMipChain(uint32 NumMipMaps);
+    void BuildPalette();
+    uint8 FindPaletteIndex(const uint8 *pkPixel) const;
+    void EncodeBlock(const SMipLevel& rkMip, uint32 BlockX, uint32 BlockY, uint8 *pOut) const;
+    void EncodeSubBlockCMPR(const SMipLevel& rkMip, uint32 PixelX, uint32 PixelY, uint8 *pOut) const;
+
 public:
-    static void EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex);
-    static void EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex, ETexelFormat OutputFormat);
+    static bool EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex);
+    static bool EncodeTXTR(IOutputStream& rTXTR, CTexture *pTex, ETexelFormat OutputFormat,
+                           ETextureEncodeQuality Quality = ETextureEncodeQuality::Normal, bool GenerateMipMaps = true);
     static ETexelFormat GetGXFormat(ETexelFormat Format);
     static ETexelFormat GetFormat(ETexelFormat Format);
 };
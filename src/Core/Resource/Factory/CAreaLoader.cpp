@@ -4,6 +4,7 @@
 #include "CMaterialLoader.h"
 #include "CScriptLoader.h"
 #include "Core/CompressionUtil.h"
+#include "Core/NPerfStats.h"
 #include <Common/Log.h>
 
 #include <Common/CFourCC.h>
@@ -48,6 +49,7 @@ void CAreaLoader::ReadHeaderPrime()
 
 void CAreaLoader::ReadGeometryPrime()
 {
+    CScopedPerfPhase PerfPhase("MREA.Geometry");
     mpSectionMgr->ToSection(mGeometryBlockNum);
 
     // Materials
@@ -94,6 +96,7 @@ void CAreaLoader::ReadGeometryPrime()
 
 void CAreaLoader::ReadSCLYPrime()
 {
+    CScopedPerfPhase PerfPhase("MREA.ScriptLayers");
     // Prime, Echoes Demo
     mpSectionMgr->ToSection(mScriptLayerBlockNum);
 
@@ -265,6 +268,7 @@ void CAreaLoader::ReadHeaderEchoes()
 
 void CAreaLoader::ReadSCLYEchoes()
 {
+    CScopedPerfPhase PerfPhase("MREA.ScriptLayers");
     // MP2, MP3 Proto, MP3, DKCR
     mpSectionMgr->ToSection(mScriptLayerBlockNum);
     mpArea->mScriptLayers.resize(mNumLayers);
@@ -349,6 +353,7 @@ void CAreaLoader::ReadHeaderCorruption()
 
 void CAreaLoader::ReadGeometryCorruption()
 {
+    CScopedPerfPhase PerfPhase("MREA.Geometry");
     mpSectionMgr->ToSection(mGeometryBlockNum);
 
     // Materials
@@ -537,6 +542,9 @@ void CAreaLoader::Decompress()
     // It should be called at the beginning of the first compressed cluster.
     if (mVersion < EGame::Echoes) return;
 
+    CScopedPerfPhase PerfPhase("MREA.Decompress");
+    PerfPhase.AddBytes(mTotalDecmpSize);
+
     // Decompress clusters
     mpDecmpBuffer = new uint8[mTotalDecmpSize];
     uint32 Offset = 0;
@@ -577,20 +585,36 @@ void CAreaLoader::Decompress()
 
 void CAreaLoader::LoadSectionDataBuffers()
 {
-   mpArea->mSectionDataBuffers.resize(mpSectionMgr->NumSections());
-   mpSectionMgr->ToSection(0);
-
-   for (size_t iSec = 0; iSec < mpSectionMgr->NumSections(); iSec++)
-   {
-       const uint32 Size = mpSectionMgr->CurrentSectionSize();
-       mpArea->mSectionDataBuffers[iSec].resize(Size);
-       mpMREA->ReadBytes(mpArea->mSectionDataBuffers[iSec].data(), mpArea->mSectionDataBuffers[iSec].size());
-       mpSectionMgr->ToNextSection();
-   }
+    // Sections are only hashed here; the data itself is read back from the cooked file when the area is cooked
+    const size_t NumSections = mpSectionMgr->NumSections();
+    mpArea->mSectionData.resize(NumSections);
+    std::vector<uint8> Buffer;
+
+    if (mpSectionDataOut)
+        mpSectionDataOut->resize(NumSections);
+
+    mpSectionMgr->ToSection(0);
+
+    for (size_t iSec = 0; iSec < NumSections; iSec++)
+    {
+        const uint32 Size = mpSectionMgr->CurrentSectionSize();
+        Buffer.resize(Size);
+        mpMREA->ReadBytes(Buffer.data(), Size);
+
+        CGameArea::SPassthroughSection& rSection = mpArea->mSectionData[iSec];
+        rSection.Size = Size;
+        rSection.Hash = CGameArea::HashSectionData(Buffer.data(), Size);
+
+        if (mpSectionDataOut)
+            (*mpSectionDataOut)[iSec] = Buffer;
+
+        mpSectionMgr->ToNextSection();
+    }
 }
 
 void CAreaLoader::ReadCollision()
 {
+    CScopedPerfPhase PerfPhase("MREA.Collision");
     mpSectionMgr->ToSection(mCollisionBlockNum);
     mpArea->mpCollision = CCollisionLoader::LoadAreaCollision(*mpMREA);
 }
@@ -701,6 +725,7 @@ void CAreaLoader::SetUpObjects(CScriptLayer *pGenLayer)
 // ************ STATIC ************
 std::unique_ptr<CGameArea> CAreaLoader::LoadMREA(IInputStream& MREA, CResourceEntry *pEntry)
 {
+    CScopedPerfPhase PerfPhase("MREA.Load");
     CAreaLoader Loader;
 
     // Validation
@@ -786,9 +811,48 @@ std::unique_ptr<CGameArea> CAreaLoader::LoadMREA(IInputStream& MREA, CResourceEn
 
     // Cleanup
     delete Loader.mpSectionMgr;
+
+    // The cached dependency tree matches the area as loaded, so track edits from here
+    ptr->ResetDependencyEdits();
     return ptr;
 }
 
+bool CAreaLoader::LoadSectionData(IInputStream& MREA, std::vector<std::vector<uint8>>& rOutSections)
+{
+    if (!MREA.IsValid() || MREA.ReadULong() != 0xdeadbeef)
+        return false;
+
+    // Only the header is read, into a scratch area, so the area being cooked isn't touched
+    auto pScratchArea = std::make_unique<CGameArea>();
+    CAreaLoader Loader;
+    Loader.mpArea = pScratchArea.get();
+    Loader.mVersion = GetFormatVersion(MREA.ReadULong());
+    Loader.mpMREA = &MREA;
+    Loader.mpSectionDataOut = &rOutSections;
+
+    switch (Loader.mVersion)
+    {
+        case EGame::PrimeDemo:
+        case EGame::Prime:
+            Loader.ReadHeaderPrime();
+            break;
+        case EGame::EchoesDemo:
+        case EGame::Echoes:
+            Loader.ReadHeaderEchoes();
+            break;
+        case EGame::CorruptionProto:
+        case EGame::Corruption:
+        case EGame::DKCReturns:
+            Loader.ReadHeaderCorruption();
+            break;
+        default:
+            return false;
+    }
+
+    delete Loader.mpSectionMgr;
+    return true;
+}
+
 EGame CAreaLoader::GetFormatVersion(uint32 Version)
 {
     switch (Version)
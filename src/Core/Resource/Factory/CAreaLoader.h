@@ -24,6 +24,9 @@ class CAreaLoader
     // Object connections
     std::unordered_map<uint32, std::vector<CLink*>> mConnectionMap;
 
+    // When set, passthrough section data is copied here instead of only being hashed
+    std::vector<std::vector<uint8>> *mpSectionDataOut = nullptr;
+
     // Compression
     uint8 *mpDecmpBuffer = nullptr;
     bool mHasDecompressedBuffer = false;
@@ -86,6 +89,9 @@ class CAreaLoader
 
 public:
     static std::unique_ptr<CGameArea> LoadMREA(IInputStream& rMREA, CResourceEntry *pEntry);
+
+    /** Read the raw data of every section in an MREA, decompressing it if needed, without loading the area itself */
+    static bool LoadSectionData(IInputStream& rMREA, std::vector<std::vector<uint8>>& rOutSections);
     static EGame GetFormatVersion(uint32 Version);
 };
 
@@ -10,7 +10,7 @@
 
 class CCollisionLoader
 {
-    TResPtr<CCollisionMeshGroup> mpGroup;
+    CCollisionMeshGroup *mpGroup = nullptr;
     CCollisionMesh *mpMesh;
     EGame mVersion;
 
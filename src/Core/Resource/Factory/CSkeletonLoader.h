@@ -2,13 +2,12 @@
 #define CSKELETONLOADER_H
 
 #include "Core/Resource/Animation/CSkeleton.h"
-#include "Core/Resource/TResPtr.h"
 #include <Common/EGame.h>
 #include <memory>
 
 class CSkeletonLoader
 {
-    TResPtr<CSkeleton> mpSkeleton;
+    CSkeleton *mpSkeleton = nullptr;
     EGame mVersion{};
 
     CSkeletonLoader() = default;
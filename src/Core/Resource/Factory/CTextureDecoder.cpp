@@ -1,4 +1,5 @@
 #include "CTextureDecoder.h"
+#include "Core/NPerfStats.h"
 #include <Common/Log.h>
 #include <Common/CColor.h>
 #include <array>
@@ -203,6 +204,9 @@ std::unique_ptr<CTexture> CTextureDecoder::CreateTexture()
 // ************ STATIC ************
 std::unique_ptr<CTexture> CTextureDecoder::LoadTXTR(IInputStream& rTXTR, CResourceEntry *pEntry)
 {
+    CScopedPerfPhase PerfPhase("TXTR.Decode");
+    PerfPhase.AddBytes(rTXTR.Size());
+
     CTextureDecoder Decoder;
     Decoder.mpEntry = pEntry;
     Decoder.ReadTXTR(rTXTR);
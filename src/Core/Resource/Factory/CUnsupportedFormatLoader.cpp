@@ -3,38 +3,49 @@
 #include "Core/GameProject/CResourceIterator.h"
 #include "Core/Resource/CWorld.h"
 
-void CUnsupportedFormatLoader::PerformCheating(IInputStream& rFile, EGame Game, std::list<CAssetID>& rAssetList)
+void CUnsupportedFormatLoader::PerformCheating(IInputStream& rFile, CResourceEntry *pEntry, std::list<CAssetID>& rAssetList)
 {
-    // Analyze file contents and check every sequence of 4/8 bytes for asset IDs
-    std::vector<uint8> Data(rFile.Size() - rFile.Tell());
-    rFile.ReadBytes(Data.data(), Data.size());
-
-    const uint32 MaxIndex = (Game <= EGame::Echoes ? Data.size() - 3 : Data.size() - 7);
-    CAssetID ID;
+    // Analyze file contents and check every sequence of 4/8 bytes for asset IDs.
+    // During database rebuilds the whole file has usually been scanned in advance, so just pick out the results past our position.
+    const uint32 StartOffset = rFile.Tell();
+    const SAssetScanResult *pkPrescan = gpResourceStore->FindPrescannedReferences(pEntry->ID());
 
-    for (uint32 iByte = 0; iByte < MaxIndex; iByte++)
+    if (pkPrescan && pkPrescan->ScannedSize == rFile.Size())
     {
-        if (Game <= EGame::Echoes)
+        for (const auto& rkHit : pkPrescan->Hits)
         {
-            ID = (Data[iByte + 0] << 24) |
-                 (Data[iByte + 1] << 16) |
-                 (Data[iByte + 2] << 8) |
-                 (Data[iByte + 3] << 0);
-        }
-        else
-        {
-            ID = (static_cast<uint64>(Data[iByte + 0]) << 56) |
-                 (static_cast<uint64>(Data[iByte + 1]) << 48) |
-                 (static_cast<uint64>(Data[iByte + 2]) << 40) |
-                 (static_cast<uint64>(Data[iByte + 3]) << 32) |
-                 (static_cast<uint64>(Data[iByte + 4]) << 24) |
-                 (static_cast<uint64>(Data[iByte + 5]) << 16) |
-                 (static_cast<uint64>(Data[iByte + 6]) << 8) |
-                 (static_cast<uint64>(Data[iByte + 7]) << 0);
+            if (rkHit.Offset >= StartOffset)
+                rAssetList.push_back(rkHit.ID);
         }
 
-        if (gpResourceStore->IsResourceRegistered(ID))
-            rAssetList.push_back(ID);
+        rFile.Seek(rFile.Size(), SEEK_SET);
+        return;
+    }
+
+    std::vector<uint8> Data(rFile.Size() - StartOffset);
+    rFile.ReadBytes(Data.data(), Data.size());
+
+    std::vector<SAssetIDHit> Hits;
+    const std::shared_ptr<const CAssetIDSet> pkIDSet = gpResourceStore->RegisteredIDSet();
+    CAssetIDScanner::Scan(Data.data(), Data.size(), CAssetID::GameIDLength(pEntry->Game()), *pkIDSet, Hits);
+
+    for (const auto& rkHit : Hits)
+        rAssetList.push_back(rkHit.ID);
+}
+
+bool CUnsupportedFormatLoader::UsesReferenceScan(const CResourceEntry *pkEntry)
+{
+    switch (pkEntry->ResourceType())
+    {
+    case EResourceType::BinaryData:
+        return true;
+
+    case EResourceType::AudioMacro:
+    case EResourceType::StateMachine:
+        return pkEntry->Game() == EGame::DKCReturns;
+
+    default:
+        return false;
     }
 }
 
@@ -57,7 +68,7 @@ std::unique_ptr<CAudioMacro> CUnsupportedFormatLoader::LoadCAUD(IInputStream& rC
     if (Game == EGame::DKCReturns)
     {
         std::list<CAssetID> AssetList;
-        PerformCheating(rCAUD, pEntry->Game(), AssetList);
+        PerformCheating(rCAUD, pEntry, AssetList);
 
         for (const auto& asset : AssetList)
             pMacro->mSamples.push_back(asset);
@@ -111,7 +122,7 @@ std::unique_ptr<CDependencyGroup> CUnsupportedFormatLoader::LoadDUMB(IInputStrea
     auto pGroup = std::make_unique<CDependencyGroup>(pEntry);
 
     std::list<CAssetID> DepList;
-    PerformCheating(rDUMB, pEntry->Game(), DepList);
+    PerformCheating(rDUMB, pEntry, DepList);
 
     for (const auto& dep : DepList)
         pGroup->AddDependency(dep);
@@ -344,7 +355,7 @@ std::unique_ptr<CDependencyGroup> CUnsupportedFormatLoader::LoadFSMC(IInputStrea
     auto pGroup = std::make_unique<CDependencyGroup>(pEntry);
 
     std::list<CAssetID> AssetList;
-    PerformCheating(rFSMC, pEntry->Game(), AssetList);
+    PerformCheating(rFSMC, pEntry, AssetList);
 
     for (const auto& asset : AssetList)
         pGroup->AddDependency(asset);
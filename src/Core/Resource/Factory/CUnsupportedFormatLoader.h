@@ -13,9 +13,11 @@ class CUnsupportedFormatLoader
 {
     CUnsupportedFormatLoader() = default;
 
-    static void PerformCheating(IInputStream& rFile, EGame Game, std::list<CAssetID>& rAssetList);
+    static void PerformCheating(IInputStream& rFile, CResourceEntry *pEntry, std::list<CAssetID>& rAssetList);
 
 public:
+    static bool UsesReferenceScan(const CResourceEntry *pkEntry);
+
     static std::unique_ptr<CAudioMacro>      LoadCAUD(IInputStream& rCAUD, CResourceEntry *pEntry);
     static std::unique_ptr<CDependencyGroup> LoadCSNG(IInputStream& rCSNG, CResourceEntry *pEntry);
     static std::unique_ptr<CDependencyGroup> LoadDUMB(IInputStream& rDUMB, CResourceEntry *pEntry);
@@ -9,6 +9,11 @@ bool CUnsupportedParticleLoader::ParseParticleParameter(IInputStream& rPART)
     if (Param == FOURCC('_END'))
         return false;
 
+    // When compiling, each parameter gets its own program
+    CParticleProgramBuilder ParamBuilder;
+    CParticleProgramBuilder *pOuterBuilder = mpBuilder;
+    if (mpEffect) mpBuilder = &ParamBuilder;
+
     switch (Param.ToLong())
     {
     // Bool Constant
@@ -178,6 +183,11 @@ bool CUnsupportedParticleLoader::ParseParticleParameter(IInputStream& rPART)
 
     // UV
     case FOURCC('TEXR'):
+        mLastAssetID = CAssetID();
+        ParseUVFunction(rPART);
+        if (mpEffect) mpEffect->SetTextureID(mLastAssetID);
+        break;
+
     case FOURCC('TIND'):
         ParseUVFunction(rPART);
         break;
@@ -213,9 +223,15 @@ bool CUnsupportedParticleLoader::ParseParticleParameter(IInputStream& rPART)
 
     default:
         errorf("%s [0x%X]: Unknown PART parameter: %s", *rPART.GetSourceString(), ParamOffset, *Param.ToString());
+        mpBuilder = pOuterBuilder;
         return false;
     }
 
+    mpBuilder = pOuterBuilder;
+
+    if (mpEffect && ParamBuilder.HasValue())
+        mpEffect->SetProgram(Param.ToLong(), ParamBuilder.Finish());
+
     return true;
 }
 
@@ -891,12 +907,16 @@ void CUnsupportedParticleLoader::ParseBool(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
     case FOURCC('CNST'):
-        rFile.Seek(0x1, SEEK_CUR);
+    {
+        const bool Value = rFile.ReadBool();
+        if (mpBuilder) mpBuilder->PushConstant(Value ? 1.f : 0.f);
         break;
+    }
 
     case FOURCC('NONE'):
         break;
@@ -905,18 +925,24 @@ void CUnsupportedParticleLoader::ParseBool(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown bool constant function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Bool, Func);
 }
 
 void CUnsupportedParticleLoader::ParseBoolFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
     case FOURCC('CNST'):
-        rFile.Seek(0x1, SEEK_CUR);
+    {
+        const bool Value = rFile.ReadBool();
+        if (mpBuilder) mpBuilder->PushConstant(Value ? 1.f : 0.f);
         break;
+    }
 
     case FOURCC('MIRR'):
     case FOURCC('P50H'):
@@ -936,6 +962,8 @@ void CUnsupportedParticleLoader::ParseBoolFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown bool function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Bool, Func);
 }
 
 void CUnsupportedParticleLoader::ParseBitfieldFunction(IInputStream& rFile)
@@ -948,6 +976,7 @@ void CUnsupportedParticleLoader::ParseIntFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -999,15 +1028,16 @@ void CUnsupportedParticleLoader::ParseIntFunction(IInputStream& rFile)
 
     case FOURCC('CNST'):
     {
-        [[maybe_unused]] const uint32 Value = rFile.ReadULong();
+        const uint32 Value = rFile.ReadULong();
         ASSERT(gpResourceStore->FindEntry(CAssetID(Value)) == nullptr);
+        if (mpBuilder) mpBuilder->PushConstant(static_cast<float>(static_cast<int32>(Value)));
         break;
     }
 
     case FOURCC('KEYE'):
     case FOURCC('KEYF'):
     case FOURCC('KEYP'):
-        ParseKeyframeEmitterData(rFile, Func, 0x4);
+        ParseKeyframeEmitterData(rFile, Func, 0x4, true);
         break;
 
     case FOURCC('TSCL'):
@@ -1029,12 +1059,15 @@ void CUnsupportedParticleLoader::ParseIntFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown int function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Int, Func);
 }
 
 void CUnsupportedParticleLoader::ParseFloatFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1113,8 +1146,11 @@ void CUnsupportedParticleLoader::ParseFloatFunction(IInputStream& rFile)
         break;
 
     case FOURCC('CNST'):
-        rFile.Seek(0x4, SEEK_CUR);
+    {
+        const float Value = rFile.ReadFloat();
+        if (mpBuilder) mpBuilder->PushConstant(Value);
         break;
+    }
 
     case FOURCC('CRNG'):
         ParseFloatFunction(rFile);
@@ -1219,12 +1255,15 @@ void CUnsupportedParticleLoader::ParseFloatFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown float function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Float, Func);
 }
 
 void CUnsupportedParticleLoader::ParseVectorFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1352,12 +1391,15 @@ void CUnsupportedParticleLoader::ParseVectorFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown vector function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Vector, Func);
 }
 
 void CUnsupportedParticleLoader::ParseModVectorFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1440,12 +1482,15 @@ void CUnsupportedParticleLoader::ParseModVectorFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown mod vector function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::ModVector, Func);
 }
 
 void CUnsupportedParticleLoader::ParseColorFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1521,12 +1566,15 @@ void CUnsupportedParticleLoader::ParseColorFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown color function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Color, Func);
 }
 
 void CUnsupportedParticleLoader::ParseRotationFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1578,12 +1626,15 @@ void CUnsupportedParticleLoader::ParseRotationFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown rotation function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Rotation, Func);
 }
 
 void CUnsupportedParticleLoader::ParseUVFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1615,6 +1666,8 @@ void CUnsupportedParticleLoader::ParseUVFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown UV function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::UV, Func);
 }
 
 void CUnsupportedParticleLoader::ParseEmitterFunction(IInputStream& rFile)
@@ -1628,14 +1681,18 @@ void CUnsupportedParticleLoader::ParseEmitterFunction(IInputStream& rFile)
         break;
 
     case FOURCC('ASPH'):
-        ParseVectorFunction(rFile);
-        ParseFloatFunction(rFile);
-        ParseFloatFunction(rFile);
+    {
+        // Previewed as a plain sphere; the angle ranges are ignored
+        CParticleProgram Origin = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseVectorFunction);
+        CParticleProgram Radius = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseFloatFunction);
+        CParticleProgram Speed = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseFloatFunction);
         ParseFloatFunction(rFile);
         ParseFloatFunction(rFile);
         ParseFloatFunction(rFile);
         ParseFloatFunction(rFile);
+        if (mpEffect) SetSphereEmitter(std::move(Origin), std::move(Radius), std::move(Speed));
         break;
+    }
 
     case FOURCC('ELPS'):
         ParseVectorFunction(rFile);
@@ -1655,20 +1712,42 @@ void CUnsupportedParticleLoader::ParseEmitterFunction(IInputStream& rFile)
         break;
 
     case FOURCC('SEMR'):
-        ParseVectorFunction(rFile);
-        ParseVectorFunction(rFile);
+    {
+        CParticleProgram Origin = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseVectorFunction);
+        CParticleProgram Velocity = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseVectorFunction);
+
+        if (mpEffect)
+        {
+            SParticleEmitterDesc& rEmitter = mpEffect->Emitter();
+            rEmitter.Shape = EParticleEmitterShape::Point;
+            rEmitter.Origin = std::move(Origin);
+            rEmitter.Velocity = std::move(Velocity);
+        }
         break;
+    }
 
     case FOURCC('SETR'):
         ParseParticleParameter(rFile);
         ParseParticleParameter(rFile);
+
+        // The nested parameters are ILOC and IVEC
+        if (mpEffect)
+        {
+            SParticleEmitterDesc& rEmitter = mpEffect->Emitter();
+            rEmitter.Shape = EParticleEmitterShape::Point;
+            if (const CParticleProgram *pkOrigin = mpEffect->Program(FOURCC('ILOC'))) rEmitter.Origin = *pkOrigin;
+            if (const CParticleProgram *pkVelocity = mpEffect->Program(FOURCC('IVEC'))) rEmitter.Velocity = *pkVelocity;
+        }
         break;
 
     case FOURCC('SPHE'):
-        ParseVectorFunction(rFile);
-        ParseFloatFunction(rFile);
-        ParseFloatFunction(rFile);
+    {
+        CParticleProgram Origin = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseVectorFunction);
+        CParticleProgram Radius = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseFloatFunction);
+        CParticleProgram Speed = CompileFunction(rFile, &CUnsupportedParticleLoader::ParseFloatFunction);
+        if (mpEffect) SetSphereEmitter(std::move(Origin), std::move(Radius), std::move(Speed));
         break;
+    }
 
     default:
         errorf("%s [0x%X]: Unknown emitter function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
@@ -1680,6 +1759,7 @@ void CUnsupportedParticleLoader::ParseSoundFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
     
     switch (Func.ToLong())
     {
@@ -1703,12 +1783,15 @@ void CUnsupportedParticleLoader::ParseSoundFunction(IInputStream& rFile)
         errorf("%s [0x%X]: Unknown sound function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Sound, Func);
 }
 
 void CUnsupportedParticleLoader::ParseAssetFunction(IInputStream& rFile)
 {
     uint32 FuncOffset = rFile.Tell();
     CFourCC Func = rFile.ReadLong();
+    const CParticleProgramBuilder::SMark Mark = BeginFunction();
 
     switch (Func.ToLong())
     {
@@ -1716,13 +1799,16 @@ void CUnsupportedParticleLoader::ParseAssetFunction(IInputStream& rFile)
         break;
 
     case FOURCC('CNST'):
-        mpGroup->AddDependency( CAssetID(rFile, mpGroup->Game()) );
+        mLastAssetID = CAssetID(rFile, mpGroup->Game());
+        mpGroup->AddDependency(mLastAssetID);
         break;
 
     default:
         errorf("%s [0x%X]: Unknown asset function: %s", *rFile.GetSourceString(), FuncOffset, *Func.ToString());
         break;
     }
+
+    EndFunction(Mark, EParticleValueType::Asset, Func);
 }
 
 void CUnsupportedParticleLoader::ParseSpawnSystemKeyframeData(IInputStream& rFile)
@@ -1747,19 +1833,77 @@ void CUnsupportedParticleLoader::ParseSpawnSystemKeyframeData(IInputStream& rFil
     }
 }
 
-void CUnsupportedParticleLoader::ParseKeyframeEmitterData(IInputStream& rFile, const CFourCC& rkFunc, uint32 ElemSize)
+void CUnsupportedParticleLoader::ParseKeyframeEmitterData(IInputStream& rFile, const CFourCC& rkFunc, uint32 ElemSize, bool IntKeys /*= false*/)
 {
+    SParticleKeyframes Table;
+    Table.Percent = (rkFunc == "KEYP");
+    rFile.Seek(0x8, SEEK_CUR); // Skip percent and unknown value
+    Table.Loop = rFile.ReadBool();
+    rFile.Seek(0x1, SEEK_CUR);
+    Table.LoopEnd = rFile.ReadLong();
+    Table.LoopStart = rFile.ReadLong();
+
     // Skip unneeded values
-    if (rkFunc == "KEYE" || rkFunc == "KEYP")
-        rFile.Seek(0x12, SEEK_CUR);
-    else if (rkFunc == "KEYF")
-        rFile.Seek(0x1A, SEEK_CUR);
+    if (rkFunc == "KEYF")
+        rFile.Seek(0x8, SEEK_CUR);
 
     uint32 KeyCount = rFile.ReadLong();
-    rFile.Seek(KeyCount * ElemSize, SEEK_CUR);
+    uint32 TableIndex = 0;
+
+    if (mpBuilder)
+    {
+        // Keys are stored as 1, 3 or 4 components depending on the function type
+        const uint32 NumComponents = ElemSize / 4;
+        std::vector<std::array<float, 4>> Keys(KeyCount, std::array<float, 4>{ 0.f, 0.f, 0.f, 0.f });
+
+        for (std::array<float, 4>& rKey : Keys)
+        {
+            for (uint32 iComp = 0; iComp < NumComponents; iComp++)
+                rKey[iComp] = (IntKeys ? static_cast<float>(rFile.ReadLong()) : rFile.ReadFloat());
+        }
+
+        TableIndex = mpBuilder->AddKeyframes(Table, Keys);
+    }
+    else
+        rFile.Seek(KeyCount * ElemSize, SEEK_CUR);
 
     if (rkFunc == "KEYF")
         ParseFloatFunction(rFile);
+
+    if (mpBuilder)
+        mpBuilder->EmitKeyframes(TableIndex, rkFunc == "KEYF");
+}
+
+// ************ COMPILATION ************
+CParticleProgramBuilder::SMark CUnsupportedParticleLoader::BeginFunction() const
+{
+    return mpBuilder ? mpBuilder->Begin() : CParticleProgramBuilder::SMark();
+}
+
+void CUnsupportedParticleLoader::EndFunction(const CParticleProgramBuilder::SMark& rkMark, EParticleValueType Type, const CFourCC& rkFunc)
+{
+    if (mpBuilder)
+        mpBuilder->End(rkMark, Type, rkFunc.ToLong());
+}
+
+CParticleProgram CUnsupportedParticleLoader::CompileFunction(IInputStream& rFile, void (CUnsupportedParticleLoader::*pParseFunc)(IInputStream&))
+{
+    CParticleProgramBuilder Builder;
+    CParticleProgramBuilder *pOuterBuilder = mpBuilder;
+    if (mpEffect) mpBuilder = &Builder;
+
+    (this->*pParseFunc)(rFile);
+    mpBuilder = pOuterBuilder;
+    return Builder.HasValue() ? Builder.Finish() : CParticleProgram();
+}
+
+void CUnsupportedParticleLoader::SetSphereEmitter(CParticleProgram&& rrOrigin, CParticleProgram&& rrRadius, CParticleProgram&& rrSpeed)
+{
+    SParticleEmitterDesc& rEmitter = mpEffect->Emitter();
+    rEmitter.Shape = EParticleEmitterShape::Sphere;
+    rEmitter.Origin = std::move(rrOrigin);
+    rEmitter.Radius = std::move(rrRadius);
+    rEmitter.Speed = std::move(rrSpeed);
 }
 
 // ************ STATIC ************
@@ -1812,3 +1956,30 @@ std::unique_ptr<CDependencyGroup> CUnsupportedParticleLoader::LoadParticle(IInpu
 
     return std::move(Loader.mpGroup);
 }
+
+std::unique_ptr<CParticleEffect> CUnsupportedParticleLoader::CompileParticle(IInputStream& rPART, CResourceEntry *pEntry)
+{
+    CUnsupportedParticleLoader Loader;
+    Loader.mpGroup = std::make_unique<CDependencyGroup>(pEntry);
+    auto pEffect = std::make_unique<CParticleEffect>();
+    Loader.mpEffect = pEffect.get();
+
+    if (pEntry->Game() == EGame::DKCReturns)
+    {
+        uint32 AssetHeader = rPART.ReadLong();
+
+        if (AssetHeader != 0x6E190001)
+        {
+            errorf("Invalid DKCR particle header: %08X", AssetHeader);
+            return nullptr;
+        }
+    }
+
+    // Only generic particle systems can be previewed
+    CFourCC Magic = rPART.ReadLong();
+    if (Magic.ToLong() != FOURCC('GPSM'))
+        return nullptr;
+
+    while (Loader.ParseParticleParameter(rPART)) {}
+    return pEffect;
+}
@@ -2,6 +2,7 @@
 #define CUNSUPPORTEDPARTICLELOADER_H
 
 #include "Core/Resource/CDependencyGroup.h"
+#include "Core/Resource/Particle/CParticleEffect.h"
 #include <memory>
 
 // This class is responsible for loading particle formats that aren't yet fully supported.
@@ -9,6 +10,12 @@
 class CUnsupportedParticleLoader
 {
     std::unique_ptr<CDependencyGroup> mpGroup;
+
+    // Compilation state; only set when compiling a particle for previewing
+    CParticleEffect *mpEffect = nullptr;
+    CParticleProgramBuilder *mpBuilder = nullptr;
+    CAssetID mLastAssetID;
+
     CUnsupportedParticleLoader() = default;
 
     // Format-Specific Parameter Loading
@@ -39,10 +46,19 @@ class CUnsupportedParticleLoader
     void ParseSoundFunction(IInputStream& rFile);
     void ParseAssetFunction(IInputStream& rFile);
     void ParseSpawnSystemKeyframeData(IInputStream& rFile);
-    void ParseKeyframeEmitterData(IInputStream& rFile, const CFourCC& rkFunc, uint32 ElemSize);
+    void ParseKeyframeEmitterData(IInputStream& rFile, const CFourCC& rkFunc, uint32 ElemSize, bool IntKeys = false);
+
+    // Compilation
+    CParticleProgramBuilder::SMark BeginFunction() const;
+    void EndFunction(const CParticleProgramBuilder::SMark& rkMark, EParticleValueType Type, const CFourCC& rkFunc);
+    CParticleProgram CompileFunction(IInputStream& rFile, void (CUnsupportedParticleLoader::*pParseFunc)(IInputStream&));
+    void SetSphereEmitter(CParticleProgram&& rrOrigin, CParticleProgram&& rrRadius, CParticleProgram&& rrSpeed);
 
 public:
     static std::unique_ptr<CDependencyGroup> LoadParticle(IInputStream& rPART, CResourceEntry *pEntry);
+
+    /** Compile a PART particle system for previewing. Returns null for other particle formats. */
+    static std::unique_ptr<CParticleEffect> CompileParticle(IInputStream& rPART, CResourceEntry *pEntry);
 };
 
 #endif // CUNSUPPORTEDPARTICLELOADER_H
@@ -48,3 +48,24 @@ SSurface* CBasicModel::GetSurface(size_t Surface)
 {
     return mSurfaces[Surface];
 }
+
+SResourceMemoryUsage CBasicModel::MemoryUsage() const
+{
+    SResourceMemoryUsage Usage;
+    Usage.CPUBytes = mVBO.DataSize();
+
+    if (mVBO.IsBuffered())
+        Usage.GPUBytes = mVBO.BufferedDataSize();
+
+    // Surfaces may be shared with another model; only count them once
+    if (mHasOwnSurfaces)
+    {
+        for (const SSurface *pkSurface : mSurfaces)
+        {
+            for (const SSurface::SPrimitive& rkPrimitive : pkSurface->Primitives)
+                Usage.CPUBytes += rkPrimitive.Vertices.size() * sizeof(CVertex);
+        }
+    }
+
+    return Usage;
+}
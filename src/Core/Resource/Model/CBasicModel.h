@@ -31,6 +31,7 @@ public:
     size_t GetSurfaceCount() const;
     CAABox GetSurfaceAABox(size_t Surface) const;
     SSurface* GetSurface(size_t Surface);
+    SResourceMemoryUsage MemoryUsage() const override;
     virtual void ClearGLBuffer() = 0;
 };
 
@@ -4,6 +4,7 @@
 #include "Core/Resource/Area/CGameArea.h"
 #include "Core/OpenGL/GLCommon.h"
 #include <Common/Macros.h>
+#include <algorithm>
 
 CModel::CModel(CResourceEntry *pEntry)
     : CBasicModel(pEntry)
@@ -52,51 +53,60 @@ void CModel::BufferGL()
 {
     if (!mBuffered)
     {
-        mVBO.Clear();
-        mSurfaceIndexBuffers.clear();
+        BuildBufferData();
 
-        mSurfaceIndexBuffers.resize(mSurfaces.size());
+        for (auto& surfaceIBOs : mSurfaceIndexBuffers)
+        {
+            for (auto& ibo : surfaceIBOs)
+                ibo.Buffer();
+        }
+
+        mBuffered = true;
+    }
+}
+
+void CModel::BuildBufferData()
+{
+    // CPU side of BufferGL; fills the vertex/index buffers without uploading anything to GL
+    mVBO.Clear();
+    mSurfaceIndexBuffers.clear();
+
+    mSurfaceIndexBuffers.resize(mSurfaces.size());
+
+    for (size_t iSurf = 0; iSurf < mSurfaces.size(); iSurf++)
+    {
+        SSurface *pSurf = mSurfaces[iSurf];
+
+        uint16 VBOStartOffset = (uint16) mVBO.Size();
+        mVBO.Reserve((uint16) pSurf->VertexCount);
 
-        for (size_t iSurf = 0; iSurf < mSurfaces.size(); iSurf++)
+        for (SSurface::SPrimitive& pPrim : pSurf->Primitives)
         {
-            SSurface *pSurf = mSurfaces[iSurf];
+            CIndexBuffer *pIBO = InternalGetIBO(iSurf, pPrim.Type);
+            pIBO->Reserve(pPrim.Vertices.size() + 1); // Allocate enough space for this primitive, plus the restart index
 
-            uint16 VBOStartOffset = (uint16) mVBO.Size();
-            mVBO.Reserve((uint16) pSurf->VertexCount);
+            std::vector<uint16> Indices(pPrim.Vertices.size());
+            for (size_t iVert = 0; iVert < pPrim.Vertices.size(); iVert++)
+                Indices[iVert] = mVBO.AddIfUnique(pPrim.Vertices[iVert], VBOStartOffset);
 
-            for (SSurface::SPrimitive& pPrim : pSurf->Primitives)
+            // then add the indices to the IBO. We convert some primitives to strips to minimize draw calls.
+            switch (pPrim.Type)
             {
-                CIndexBuffer *pIBO = InternalGetIBO(iSurf, pPrim.Type);
-                pIBO->Reserve(pPrim.Vertices.size() + 1); // Allocate enough space for this primitive, plus the restart index
-
-                std::vector<uint16> Indices(pPrim.Vertices.size());
-                for (size_t iVert = 0; iVert < pPrim.Vertices.size(); iVert++)
-                    Indices[iVert] = mVBO.AddIfUnique(pPrim.Vertices[iVert], VBOStartOffset);
-
-                // then add the indices to the IBO. We convert some primitives to strips to minimize draw calls.
-                switch (pPrim.Type)
-                {
-                    case EPrimitiveType::Triangles:
-                        pIBO->TrianglesToStrips(Indices.data(), Indices.size());
-                        break;
-                    case EPrimitiveType::TriangleFan:
-                        pIBO->FansToStrips(Indices.data(), Indices.size());
-                        break;
-                    case EPrimitiveType::Quads:
-                        pIBO->QuadsToStrips(Indices.data(), Indices.size());
-                        break;
-                    default:
-                        pIBO->AddIndices(Indices.data(), Indices.size());
-                        pIBO->AddIndex(0xFFFF); // primitive restart
-                        break;
-                }
+                case EPrimitiveType::Triangles:
+                    pIBO->TrianglesToStrips(Indices.data(), Indices.size());
+                    break;
+                case EPrimitiveType::TriangleFan:
+                    pIBO->FansToStrips(Indices.data(), Indices.size());
+                    break;
+                case EPrimitiveType::Quads:
+                    pIBO->QuadsToStrips(Indices.data(), Indices.size());
+                    break;
+                default:
+                    pIBO->AddIndices(Indices.data(), Indices.size());
+                    pIBO->AddIndex(0xFFFF); // primitive restart
+                    break;
             }
-
-            for (auto& ibo : mSurfaceIndexBuffers[iSurf])
-                ibo.Buffer();
         }
-
-        mBuffered = true;
     }
 }
 
@@ -106,8 +116,16 @@ void CModel::GenerateMaterialShaders()
     {
         for (size_t i = 0; i < set->NumMaterials(); i++)
         {
-            set->MaterialByIndex(i, false)->GenerateShader(false);
-            set->MaterialByIndex(i, true)->GenerateShader(false);
+            for (int iBloom = 0; iBloom < 2; iBloom++)
+            {
+                CMaterial *pMat = set->MaterialByIndex(i, iBloom != 0);
+
+                if (IsSkinned())
+                    pMat = pMat->GetSkinnedVersion();
+
+                for (; pMat; pMat = pMat->GetNextDrawPass())
+                    pMat->GenerateShader(false);
+            }
         }
     }
 }
@@ -116,9 +134,35 @@ void CModel::ClearGLBuffer()
 {
     mVBO.Clear();
     mSurfaceIndexBuffers.clear();
+    mSkinStreams.clear();
     mBuffered = false;
 }
 
+SResourceMemoryUsage CModel::MemoryUsage() const
+{
+    SResourceMemoryUsage Usage = CBasicModel::MemoryUsage();
+
+    for (const std::vector<CIndexBuffer>& rkSurfaceIBOs : mSurfaceIndexBuffers)
+    {
+        for (const CIndexBuffer& rkIBO : rkSurfaceIBOs)
+        {
+            Usage.CPUBytes += rkIBO.DataSize();
+
+            if (rkIBO.IsBuffered())
+                Usage.GPUBytes += rkIBO.DataSize();
+        }
+    }
+
+    // Bone indices and weights only live in GL buffers; the CPU copies are dropped after upload
+    for (const auto& pkStream : mSkinStreams)
+    {
+        if (pkStream->IsBuffered())
+            Usage.GPUBytes += pkStream->DataSize();
+    }
+
+    return Usage;
+}
+
 void CModel::Draw(FRenderOptions Options, size_t MatSet)
 {
     if (!mBuffered)
@@ -137,10 +181,17 @@ void CModel::DrawSurface(FRenderOptions Options, size_t Surface, size_t MatSet)
     if (MatSet >= mMaterialSets.size())
         MatSet = mMaterialSets.size() - 1;
 
-    auto DoDraw = [this, Surface]()
+    // Skinned models draw with the bone weights of the current skin bound alongside the model's own vertices
+    CSkinVertexStream *pSkinStream = CurrentSkinStream();
+
+    auto DoDraw = [this, Surface, pSkinStream]()
     {
         // Draw IBOs
-        mVBO.Bind();
+        if (pSkinStream)
+            pSkinStream->Bind();
+        else
+            mVBO.Bind();
+
         glLineWidth(1.f);
 
         for (auto& ibo : mSurfaceIndexBuffers[Surface])
@@ -160,6 +211,9 @@ void CModel::DrawSurface(FRenderOptions Options, size_t Surface, size_t MatSet)
         if (!Options.HasFlag(ERenderOption::EnableOccluders) && pMat->Options().HasFlag(EMaterialOption::Occluder))
             return;
 
+        if (pSkinStream)
+            pMat = pMat->GetSkinnedVersion();
+
         for (CMaterial* passMat = pMat; passMat; passMat = passMat->GetNextDrawPass())
         {
             passMat->SetCurrent(Options);
@@ -197,44 +251,20 @@ void CModel::SetSkin(CSkin *pSkin)
     // Assert commented out because it actually failed somewhere! Needs to be addressed.
     //ASSERT(!mpSkin || !pSkin || mpSkin == pSkin); // This is to verify no model has more than one unique skin applied
 
-    //@todo this is actually really dumb and could be handled much better (and much more inline with how the game does it)
-    // by simply storing skinning data in a different vertex buffer that isn't tied to the model's vertex buffer
-    if (mpSkin != pSkin)
-    {
-        const FVertexDescription kBoneFlags = (EVertexAttribute::BoneIndices | EVertexAttribute::BoneWeights);
-
-        mpSkin = pSkin;
-        mVBO.SetSkin(pSkin);
-        ClearGLBuffer();
+    if (mpSkin == pSkin)
+        return;
 
-        if (pSkin && !mVBO.VertexDesc().HasAllFlags(kBoneFlags))
-            mVBO.SetVertexDesc(mVBO.VertexDesc() | kBoneFlags);
-        else if (!pSkin && mVBO.VertexDesc().HasAnyFlags(kBoneFlags))
-            mVBO.SetVertexDesc(mVBO.VertexDesc() & ~kBoneFlags);
+    // Skinning data lives in a separate vertex stream per skin and skinned models draw with a copy of each
+    // material that has the bone attributes added, so the model's materials don't change here
+    mpSkin = pSkin;
 
-        for (CMaterialSet* set : mMaterialSets)
-        {
-            for (size_t iMat = 0; iMat < set->NumMaterials(); iMat++)
-            {
-                for (bool iBloom = false; !iBloom; iBloom = true)
-                {
-                    CMaterial *pMat = set->MaterialByIndex(iMat, iBloom);
-                    FVertexDescription VtxDesc = pMat->VtxDesc();
-
-                    if (pSkin && !VtxDesc.HasAllFlags(kBoneFlags))
-                    {
-                        VtxDesc |= kBoneFlags;
-                        pMat->SetVertexDescription(VtxDesc);
-                    }
-
-                    else if (!pSkin && VtxDesc.HasAnyFlags(kBoneFlags))
-                    {
-                        VtxDesc &= ~kBoneFlags;
-                        pMat->SetVertexDescription(VtxDesc);
-                    }
-                }
-            }
-        }
+    // Bone weights are looked up per source vertex, so skinned models can't merge vertices that came from different
+    // ones. That costs buffer memory, so it's only turned on for the first skin; the buffer then stays split, which
+    // means switching between skins afterwards doesn't rebuild it.
+    if (pSkin && !mVBO.IsSplitByArrayPosition())
+    {
+        ClearGLBuffer();
+        mVBO.SetSplitByArrayPosition(true);
     }
 }
 
@@ -309,6 +339,28 @@ bool CModel::IsLightmapped() const
     return false;
 }
 
+CSkinVertexStream* CModel::CurrentSkinStream()
+{
+    if (!mpSkin)
+        return nullptr;
+
+    // Most recently used stream is kept at the back
+    for (auto It = mSkinStreams.begin(); It != mSkinStreams.end(); ++It)
+    {
+        if ((*It)->Skin() == mpSkin)
+        {
+            std::rotate(It, It + 1, mSkinStreams.end());
+            return mSkinStreams.back().get();
+        }
+    }
+
+    // Streams keep their skin loaded, so only hang on to the few that were used last
+    if (mSkinStreams.size() >= skMaxSkinStreams)
+        mSkinStreams.erase(mSkinStreams.begin());
+
+    return mSkinStreams.emplace_back(std::make_unique<CSkinVertexStream>(&mVBO, mpSkin)).get();
+}
+
 CIndexBuffer* CModel::InternalGetIBO(size_t Surface, EPrimitiveType Primitive)
 {
     std::vector<CIndexBuffer>& pIBOs = mSurfaceIndexBuffers[Surface];
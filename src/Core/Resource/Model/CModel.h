@@ -7,6 +7,7 @@
 #include "Core/Resource/Animation/CSkeleton.h"
 #include "Core/Resource/Animation/CSkin.h"
 #include "Core/OpenGL/CIndexBuffer.h"
+#include "Core/OpenGL/CSkinVertexStream.h"
 #include "Core/OpenGL/GLCommon.h"
 #include "Core/Render/FRenderOptions.h"
 
@@ -18,6 +19,8 @@ class CModel : public CBasicModel
     TResPtr<CSkin> mpSkin;
     std::vector<CMaterialSet*> mMaterialSets;
     std::vector<std::vector<CIndexBuffer>> mSurfaceIndexBuffers;
+    std::vector<std::unique_ptr<CSkinVertexStream>> mSkinStreams;
+    static constexpr size_t skMaxSkinStreams = 4;
     bool mHasOwnMaterials;
     
 public:
@@ -27,8 +30,10 @@ public:
 
     std::unique_ptr<CDependencyTree> BuildDependencyTree() const override;
     void BufferGL();
+    void BuildBufferData();
     void GenerateMaterialShaders();
     void ClearGLBuffer() override;
+    SResourceMemoryUsage MemoryUsage() const override;
     void Draw(FRenderOptions Options, size_t MatSet);
     void DrawSurface(FRenderOptions Options, size_t Surface, size_t MatSet);
     void DrawWireframe(FRenderOptions Options, CColor WireColor = CColor::White());
@@ -47,6 +52,7 @@ public:
 
 private:
     CIndexBuffer* InternalGetIBO(size_t Surface, EPrimitiveType Primitive);
+    CSkinVertexStream* CurrentSkinStream();
 };
 
 #endif // MODEL_H
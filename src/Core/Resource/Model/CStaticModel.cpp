@@ -102,6 +102,21 @@ void CStaticModel::ClearGLBuffer()
     mBuffered = false;
 }
 
+SResourceMemoryUsage CStaticModel::MemoryUsage() const
+{
+    SResourceMemoryUsage Usage = CBasicModel::MemoryUsage();
+
+    for (const CIndexBuffer& rkIBO : mIBOs)
+    {
+        Usage.CPUBytes += rkIBO.DataSize();
+
+        if (rkIBO.IsBuffered())
+            Usage.GPUBytes += rkIBO.DataSize();
+    }
+
+    return Usage;
+}
+
 void CStaticModel::Draw(FRenderOptions Options)
 {
     if (!mBuffered)
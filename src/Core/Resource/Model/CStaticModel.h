@@ -24,6 +24,7 @@ public:
     void BufferGL();
     void GenerateMaterialShaders();
     void ClearGLBuffer() override;
+    SResourceMemoryUsage MemoryUsage() const override;
     void Draw(FRenderOptions Options);
     void DrawSurface(FRenderOptions Options, uint32 Surface);
     void DrawWireframe(FRenderOptions Options, CColor WireColor = CColor::White());
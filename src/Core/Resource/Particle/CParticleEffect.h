@@ -0,0 +1,56 @@
+#ifndef CPARTICLEEFFECT_H
+#define CPARTICLEEFFECT_H
+
+#include "CParticleProgram.h"
+#include <Common/CAssetID.h>
+#include <map>
+
+/** Shape particles are spawned in */
+enum class EParticleEmitterShape
+{
+    None,
+    Point,
+    Sphere
+};
+
+/** Compiled emitter function */
+struct SParticleEmitterDesc
+{
+    EParticleEmitterShape Shape = EParticleEmitterShape::None;
+
+    /** Point emitters: initial position and velocity. Sphere emitters: sphere center. */
+    CParticleProgram Origin;
+    CParticleProgram Velocity;
+
+    /** Sphere emitters only */
+    CParticleProgram Radius;
+    CParticleProgram Speed;
+};
+
+/**
+ * Compiled description of a PART particle system, used to simulate previews in the editor.
+ * Holds one program for each parameter that could be compiled, keyed by parameter FourCC.
+ */
+class CParticleEffect
+{
+    std::map<uint32, CParticleProgram> mPrograms;
+    SParticleEmitterDesc mEmitter;
+    CAssetID mTextureID;
+
+public:
+    void SetProgram(uint32 Param, CParticleProgram&& rrProgram)    { mPrograms[Param] = std::move(rrProgram); }
+    void SetTextureID(const CAssetID& rkID)                         { mTextureID = rkID; }
+
+    const CParticleProgram* Program(uint32 Param) const
+    {
+        auto Iter = mPrograms.find(Param);
+        return (Iter == mPrograms.end() ? nullptr : &Iter->second);
+    }
+
+    SParticleEmitterDesc& Emitter()                 { return mEmitter; }
+    const SParticleEmitterDesc& Emitter() const     { return mEmitter; }
+    CAssetID TextureID() const                      { return mTextureID; }
+    uint32 NumPrograms() const                      { return static_cast<uint32>(mPrograms.size()); }
+};
+
+#endif // CPARTICLEEFFECT_H
@@ -0,0 +1,596 @@
+#include "CParticleProgram.h"
+#include <Common/CFourCC.h>
+#include <Common/Macros.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+constexpr float kDegToRad = 3.14159265358979f / 180.f;
+
+/** Returns a random value in [0, 1) for the given lane, instruction, salt and component */
+float LaneRandom(uint32 Seed, uint32 PC, uint32 Salt, uint32 Component)
+{
+    const uint32 Hash = ParticleHash(Seed ^ ParticleHash(PC * 0x9E3779B9 + Salt * 0x85EBCA6B + Component * 0x68E31DA4));
+    return static_cast<float>(Hash >> 8) * (1.f / 16777216.f);
+}
+
+template<typename FuncType>
+void ApplyBinary(SParticleValues& rA, const SParticleValues& rkB, uint32 NumLanes, FuncType Func)
+{
+    for (uint32 Comp = 0; Comp < 4; Comp++)
+    {
+        float *pA = rA.Comp[Comp];
+        const float *pkB = rkB.Comp[Comp];
+
+        for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            pA[Lane] = Func(pA[Lane], pkB[Lane]);
+    }
+}
+
+/** Per lane select; writes rkB into rA for every lane where Pred(Lane) is false */
+template<typename PredType>
+void SelectLanes(SParticleValues& rA, const SParticleValues& rkB, uint32 NumLanes, PredType Pred)
+{
+    for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+    {
+        if (!Pred(Lane))
+        {
+            for (uint32 Comp = 0; Comp < 4; Comp++)
+                rA.Comp[Comp][Lane] = rkB.Comp[Comp][Lane];
+        }
+    }
+}
+
+void ClearValues(SParticleValues& rValues, uint32 NumLanes)
+{
+    for (uint32 Comp = 0; Comp < 4; Comp++)
+        std::fill(rValues.Comp[Comp], rValues.Comp[Comp] + NumLanes, 0.f);
+}
+
+}
+
+// ************ CParticleProgram ************
+void CParticleProgram::Evaluate(const SParticleLanes& rkLanes, SParticleValues& rOut) const
+{
+    const uint32 NumLanes = rkLanes.NumLanes;
+    ASSERT(NumLanes <= SParticleLanes::skMaxLanes);
+
+    if (mCode.empty())
+    {
+        ClearValues(rOut, NumLanes);
+        return;
+    }
+
+    const float *pkAge = rkLanes.pkAge;
+    const float *pkLifetime = rkLanes.pkLifetime;
+    const uint32 *pkSeed = rkLanes.pkSeed;
+
+    SParticleValues Stack[skMaxStackDepth];
+    uint32 SP = 0;
+
+    for (uint32 PC = 0; PC < mCode.size(); PC++)
+    {
+        const EParticleOp Op = DecodeOp(mCode[PC]);
+        const uint32 Operand = DecodeOperand(mCode[PC]);
+
+        switch (Op)
+        {
+        case EParticleOp::Constant:
+        {
+            SParticleValues& rDst = Stack[SP++];
+            const std::array<float, 4>& rkConstant = mConstants[Operand];
+
+            for (uint32 Comp = 0; Comp < 4; Comp++)
+                std::fill(rDst.Comp[Comp], rDst.Comp[Comp] + NumLanes, rkConstant[Comp]);
+            break;
+        }
+
+        case EParticleOp::Default:
+            ClearValues(Stack[SP++], NumLanes);
+            break;
+
+        case EParticleOp::MakeVector:
+        case EParticleOp::MakeColor:
+        {
+            const uint32 NumComps = (Op == EParticleOp::MakeVector ? 3 : 4);
+            SP -= NumComps;
+            SParticleValues& rDst = Stack[SP];
+
+            // Component 0 is already in place
+            for (uint32 Comp = 1; Comp < NumComps; Comp++)
+                std::copy(Stack[SP + Comp].Comp[0], Stack[SP + Comp].Comp[0] + NumLanes, rDst.Comp[Comp]);
+
+            if (NumComps == 3)
+                std::fill(rDst.Comp[3], rDst.Comp[3] + NumLanes, 0.f);
+
+            SP++;
+            break;
+        }
+
+        case EParticleOp::Add:
+            SP--;
+            ApplyBinary(Stack[SP - 1], Stack[SP], NumLanes, [](float A, float B) { return A + B; });
+            break;
+
+        case EParticleOp::Sub:
+            SP--;
+            ApplyBinary(Stack[SP - 1], Stack[SP], NumLanes, [](float A, float B) { return A - B; });
+            break;
+
+        case EParticleOp::Mul:
+            SP--;
+            ApplyBinary(Stack[SP - 1], Stack[SP], NumLanes, [](float A, float B) { return A * B; });
+            break;
+
+        case EParticleOp::Random:
+        case EParticleOp::InitialRandom:
+        case EParticleOp::RandomInt:
+        {
+            SP--;
+            SParticleValues& rMin = Stack[SP - 1];
+            const SParticleValues& rkMax = Stack[SP];
+            const uint32 Salt = (Op == EParticleOp::InitialRandom ? 0 : rkLanes.Frame + 1);
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                const float Rand = LaneRandom(pkSeed[Lane], PC, Salt, 0);
+                const float Min = rMin.Comp[0][Lane];
+                const float Max = rkMax.Comp[0][Lane];
+
+                if (Op == EParticleOp::RandomInt)
+                    rMin.Comp[0][Lane] = std::floor(Min + Rand * (Max - Min + 1.f));
+                else
+                    rMin.Comp[0][Lane] = Min + Rand * (Max - Min);
+            }
+            break;
+        }
+
+        case EParticleOp::Clamp:
+        {
+            SP -= 2;
+            SParticleValues& rMin = Stack[SP - 1];
+            const SParticleValues& rkMax = Stack[SP];
+            const SParticleValues& rkValue = Stack[SP + 1];
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+                rMin.Comp[0][Lane] = std::min(std::max(rkValue.Comp[0][Lane], rMin.Comp[0][Lane]), rkMax.Comp[0][Lane]);
+            break;
+        }
+
+        case EParticleOp::Sine:
+        {
+            SP -= 2;
+            SParticleValues& rFreq = Stack[SP - 1];
+            const SParticleValues& rkAmp = Stack[SP];
+            const SParticleValues& rkPhase = Stack[SP + 1];
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                const float Angle = (pkAge[Lane] * rFreq.Comp[0][Lane] + rkPhase.Comp[0][Lane]) * kDegToRad;
+                rFreq.Comp[0][Lane] = std::sin(Angle) * rkAmp.Comp[0][Lane];
+            }
+            break;
+        }
+
+        case EParticleOp::LifetimeTween:
+        {
+            SP--;
+            SParticleValues& rA = Stack[SP - 1];
+            const SParticleValues& rkB = Stack[SP];
+
+            for (uint32 Comp = 0; Comp < 4; Comp++)
+            {
+                for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+                {
+                    const float T = std::min(std::max(pkAge[Lane] / std::max(pkLifetime[Lane], 1.f), 0.f), 1.f);
+                    rA.Comp[Comp][Lane] += (rkB.Comp[Comp][Lane] - rA.Comp[Comp][Lane]) * T;
+                }
+            }
+            break;
+        }
+
+        case EParticleOp::Chan:
+        {
+            SP -= 2;
+            SParticleValues& rA = Stack[SP - 1];
+            const SParticleValues& rkFrames = Stack[SP + 1];
+            SelectLanes(rA, Stack[SP], NumLanes, [&](uint32 Lane) { return pkAge[Lane] < rkFrames.Comp[0][Lane]; });
+            break;
+        }
+
+        case EParticleOp::InitialSwitch:
+            SP--;
+            SelectLanes(Stack[SP - 1], Stack[SP], NumLanes, [&](uint32 Lane) { return pkAge[Lane] < 1.f; });
+            break;
+
+        case EParticleOp::Pulse:
+        {
+            SP -= 3;
+            SParticleValues& rAFrames = Stack[SP - 1];
+            const SParticleValues& rkBFrames = Stack[SP];
+            const SParticleValues& rkA = Stack[SP + 1];
+            const SParticleValues& rkB = Stack[SP + 2];
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                const float AFrames = std::max(rAFrames.Comp[0][Lane], 0.f) + 1.f;
+                const float Period = AFrames + std::max(rkBFrames.Comp[0][Lane], 0.f) + 1.f;
+                const bool UseA = std::fmod(pkAge[Lane], Period) < AFrames;
+
+                for (uint32 Comp = 0; Comp < 4; Comp++)
+                    rAFrames.Comp[Comp][Lane] = (UseA ? rkA.Comp[Comp][Lane] : rkB.Comp[Comp][Lane]);
+            }
+            break;
+        }
+
+        case EParticleOp::Fade:
+        {
+            SP -= 2;
+            SParticleValues& rA = Stack[SP - 1];
+            const SParticleValues& rkB = Stack[SP];
+            const SParticleValues& rkFrames = Stack[SP + 1];
+
+            for (uint32 Comp = 0; Comp < 4; Comp++)
+            {
+                for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+                {
+                    const float T = std::min(std::max(pkAge[Lane] / std::max(rkFrames.Comp[0][Lane], 1.f), 0.f), 1.f);
+                    rA.Comp[Comp][Lane] += (rkB.Comp[Comp][Lane] - rA.Comp[Comp][Lane]) * T;
+                }
+            }
+            break;
+        }
+
+        case EParticleOp::Keyframes:
+        case EParticleOp::KeyframesBy:
+        {
+            const SParticleKeyframes& rkTable = mKeyframes[Operand];
+            SParticleValues& rDst = (Op == EParticleOp::KeyframesBy ? Stack[SP - 1] : Stack[SP++]);
+
+            if (rkTable.NumKeys == 0)
+            {
+                ClearValues(rDst, NumLanes);
+                break;
+            }
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                int32 Key;
+
+                if (Op == EParticleOp::KeyframesBy)
+                    Key = static_cast<int32>(std::min(std::max(rDst.Comp[0][Lane], 0.f), 65535.f));
+                else if (rkTable.Percent)
+                    Key = static_cast<int32>(std::min(std::max(pkAge[Lane] / std::max(pkLifetime[Lane], 1.f), 0.f), 1.f) * 100.f);
+                else
+                {
+                    Key = static_cast<int32>(std::min(std::max(pkAge[Lane], 0.f), 16777216.f));
+
+                    if (rkTable.Loop && rkTable.LoopEnd > rkTable.LoopStart && Key >= rkTable.LoopEnd)
+                        Key = rkTable.LoopStart + (Key - rkTable.LoopStart) % (rkTable.LoopEnd - rkTable.LoopStart);
+                }
+
+                Key = std::min(Key, static_cast<int32>(rkTable.NumKeys) - 1);
+                const std::array<float, 4>& rkKey = mKeys[rkTable.FirstKey + Key];
+
+                for (uint32 Comp = 0; Comp < 4; Comp++)
+                    rDst.Comp[Comp][Lane] = rkKey[Comp];
+            }
+            break;
+        }
+
+        case EParticleOp::Cone:
+        case EParticleOp::RandomVector:
+        {
+            // Cone: random direction within Magnitude of the input direction, keeping its length
+            // RandomVector: random direction with length Magnitude
+            const bool IsCone = (Op == EParticleOp::Cone);
+            if (IsCone) SP--;
+
+            SParticleValues& rDst = Stack[SP - 1];
+            const SParticleValues& rkMagnitude = Stack[IsCone ? SP : SP - 1];
+            const uint32 Salt = (IsCone ? 0 : rkLanes.Frame + 1);
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                float Dir[3];
+                const float Magnitude = rkMagnitude.Comp[0][Lane];
+
+                for (uint32 Comp = 0; Comp < 3; Comp++)
+                    Dir[Comp] = LaneRandom(pkSeed[Lane], PC, Salt, Comp) * 2.f - 1.f;
+
+                float Length = 1.f;
+
+                if (IsCone)
+                {
+                    Length = std::sqrt(rDst.Comp[0][Lane] * rDst.Comp[0][Lane] +
+                                       rDst.Comp[1][Lane] * rDst.Comp[1][Lane] +
+                                       rDst.Comp[2][Lane] * rDst.Comp[2][Lane]);
+                    const float InvLength = (Length > 0.f ? 1.f / Length : 0.f);
+
+                    for (uint32 Comp = 0; Comp < 3; Comp++)
+                        Dir[Comp] = rDst.Comp[Comp][Lane] * InvLength + Dir[Comp] * Magnitude;
+                }
+                else
+                    Length = Magnitude;
+
+                const float DirLength = std::sqrt(Dir[0] * Dir[0] + Dir[1] * Dir[1] + Dir[2] * Dir[2]);
+                const float Scale = (DirLength > 0.f ? Length / DirLength : 0.f);
+
+                for (uint32 Comp = 0; Comp < 3; Comp++)
+                    rDst.Comp[Comp][Lane] = Dir[Comp] * Scale;
+
+                rDst.Comp[3][Lane] = 0.f;
+            }
+            break;
+        }
+
+        case EParticleOp::Normalize:
+        case EParticleOp::Length:
+        {
+            SParticleValues& rDst = Stack[SP - 1];
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                const float Length = std::sqrt(rDst.Comp[0][Lane] * rDst.Comp[0][Lane] +
+                                               rDst.Comp[1][Lane] * rDst.Comp[1][Lane] +
+                                               rDst.Comp[2][Lane] * rDst.Comp[2][Lane]);
+
+                if (Op == EParticleOp::Length)
+                    rDst.Comp[0][Lane] = Length;
+                else
+                {
+                    const float InvLength = (Length > 0.f ? 1.f / Length : 0.f);
+
+                    for (uint32 Comp = 0; Comp < 3; Comp++)
+                        rDst.Comp[Comp][Lane] *= InvLength;
+                }
+            }
+            break;
+        }
+
+        case EParticleOp::Dot:
+        {
+            SP--;
+            SParticleValues& rA = Stack[SP - 1];
+            const SParticleValues& rkB = Stack[SP];
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                rA.Comp[0][Lane] = rA.Comp[0][Lane] * rkB.Comp[0][Lane] +
+                                   rA.Comp[1][Lane] * rkB.Comp[1][Lane] +
+                                   rA.Comp[2][Lane] * rkB.Comp[2][Lane];
+            }
+            break;
+        }
+
+        case EParticleOp::Extract:
+        {
+            SParticleValues& rDst = Stack[SP - 1];
+
+            if (Operand != 0)
+                std::copy(rDst.Comp[Operand], rDst.Comp[Operand] + NumLanes, rDst.Comp[0]);
+            break;
+        }
+
+        case EParticleOp::ColorToVector:
+            std::fill(Stack[SP - 1].Comp[3], Stack[SP - 1].Comp[3] + NumLanes, 0.f);
+            break;
+        }
+    }
+
+    ASSERT(SP == 1);
+    rOut = Stack[0];
+}
+
+std::array<float, 4> CParticleProgram::EvaluateSingle(float Age, float Lifetime, uint32 Seed, uint32 Frame) const
+{
+    SParticleLanes Lanes;
+    Lanes.pkAge = &Age;
+    Lanes.pkLifetime = &Lifetime;
+    Lanes.pkSeed = &Seed;
+    Lanes.NumLanes = 1;
+    Lanes.Frame = Frame;
+
+    SParticleValues Values;
+    Evaluate(Lanes, Values);
+    return { Values.Comp[0][0], Values.Comp[1][0], Values.Comp[2][0], Values.Comp[3][0] };
+}
+
+// ************ CParticleProgramBuilder ************
+CParticleProgramBuilder::SMark CParticleProgramBuilder::Begin() const
+{
+    SMark Mark;
+    Mark.CodeSize = static_cast<uint32>(mProgram.mCode.size());
+    Mark.NumConstants = static_cast<uint32>(mProgram.mConstants.size());
+    Mark.NumKeys = static_cast<uint32>(mProgram.mKeys.size());
+    Mark.NumKeyframes = static_cast<uint32>(mProgram.mKeyframes.size());
+    Mark.Depth = mDepth;
+    return Mark;
+}
+
+void CParticleProgramBuilder::End(const SMark& rkMark, EParticleValueType Type, uint32 Func)
+{
+    const uint32 NumArgs = mDepth - rkMark.Depth;
+
+    // Constants and keyframes emit their own instructions while they're parsed
+    const bool IsScalar = (Type == EParticleValueType::Bool || Type == EParticleValueType::Int || Type == EParticleValueType::Float);
+    const bool IsPassthrough = (Func == FOURCC('KEYE') || Func == FOURCC('KEYF') || Func == FOURCC('KEYP') || Func == FOURCC('KPIN') ||
+                                (Func == FOURCC('CNST') && IsScalar) ||
+                                (Func == FOURCC('GRAV') && Type == EParticleValueType::ModVector));
+
+    if (IsPassthrough && NumArgs == 1)
+        return;
+
+    EParticleOp Op;
+    uint32 Operand = 0;
+
+    if (!mOverflow && FindOp(Type, Func, NumArgs, Op, Operand))
+        Emit(Op, Operand, NumArgs);
+
+    // Unsupported function; replace the whole subtree with a default value
+    else
+    {
+        Rewind(rkMark);
+        PushDefault();
+    }
+}
+
+void CParticleProgramBuilder::PushConstant(float X, float Y /*= 0.f*/, float Z /*= 0.f*/, float W /*= 0.f*/)
+{
+    mProgram.mConstants.push_back({ X, Y, Z, W });
+    Emit(EParticleOp::Constant, static_cast<uint32>(mProgram.mConstants.size() - 1), 0);
+}
+
+void CParticleProgramBuilder::PushDefault()
+{
+    Emit(EParticleOp::Default, 0, 0);
+}
+
+uint32 CParticleProgramBuilder::AddKeyframes(const SParticleKeyframes& rkTable, const std::vector<std::array<float, 4>>& rkKeys)
+{
+    SParticleKeyframes Table = rkTable;
+    Table.FirstKey = static_cast<uint32>(mProgram.mKeys.size());
+    Table.NumKeys = static_cast<uint32>(rkKeys.size());
+    mProgram.mKeys.insert(mProgram.mKeys.end(), rkKeys.begin(), rkKeys.end());
+    mProgram.mKeyframes.push_back(Table);
+    return static_cast<uint32>(mProgram.mKeyframes.size() - 1);
+}
+
+void CParticleProgramBuilder::EmitKeyframes(uint32 TableIndex, bool ByChildValue)
+{
+    Emit(ByChildValue ? EParticleOp::KeyframesBy : EParticleOp::Keyframes, TableIndex, ByChildValue ? 1 : 0);
+}
+
+CParticleProgram CParticleProgramBuilder::Finish()
+{
+    CParticleProgram Program = std::move(mProgram);
+    mProgram = CParticleProgram();
+    mDepth = 0;
+    mOverflow = false;
+    return Program;
+}
+
+void CParticleProgramBuilder::Emit(EParticleOp Op, uint32 Operand, uint32 NumPopped)
+{
+    std::vector<uint32>& rCode = mProgram.mCode;
+    std::vector<std::array<float, 4>>& rConstants = mProgram.mConstants;
+
+    // Fold vectors and colors built entirely out of constants into a single constant
+    if ((Op == EParticleOp::MakeVector || Op == EParticleOp::MakeColor) && rCode.size() >= NumPopped)
+    {
+        bool AllConstant = true;
+
+        for (uint32 Idx = static_cast<uint32>(rCode.size()) - NumPopped; Idx < rCode.size(); Idx++)
+            AllConstant &= (CParticleProgram::DecodeOp(rCode[Idx]) == EParticleOp::Constant);
+
+        if (AllConstant)
+        {
+            std::array<float, 4> Folded = { 0.f, 0.f, 0.f, 0.f };
+
+            for (uint32 Comp = 0; Comp < NumPopped; Comp++)
+                Folded[Comp] = rConstants[CParticleProgram::DecodeOperand(rCode[rCode.size() - NumPopped + Comp])][0];
+
+            rConstants.resize(rConstants.size() - NumPopped);
+            rCode.resize(rCode.size() - NumPopped);
+            mDepth -= NumPopped;
+            rConstants.push_back(Folded);
+            Op = EParticleOp::Constant;
+            Operand = static_cast<uint32>(rConstants.size() - 1);
+            NumPopped = 0;
+        }
+    }
+
+    rCode.push_back(CParticleProgram::Encode(Op, Operand));
+    mDepth = mDepth - NumPopped + 1;
+
+    if (mDepth > CParticleProgram::skMaxStackDepth)
+        mOverflow = true;
+    else
+        mProgram.mMaxStackDepth = std::max(mProgram.mMaxStackDepth, mDepth);
+}
+
+void CParticleProgramBuilder::Rewind(const SMark& rkMark)
+{
+    mProgram.mCode.resize(rkMark.CodeSize);
+    mProgram.mConstants.resize(rkMark.NumConstants);
+    mProgram.mKeys.resize(rkMark.NumKeys);
+    mProgram.mKeyframes.resize(rkMark.NumKeyframes);
+    mDepth = rkMark.Depth;
+}
+
+bool CParticleProgramBuilder::FindOp(EParticleValueType Type, uint32 Func, uint32 NumArgs, EParticleOp& rOutOp, uint32& rOutOperand)
+{
+    struct SOpInfo
+    {
+        EParticleValueType Type;
+        uint32 Func;
+        uint32 NumArgs;
+        EParticleOp Op;
+        uint32 Operand;
+    };
+
+    static const SOpInfo skOps[] = {
+        { EParticleValueType::Int,       FOURCC('ADD_'), 2, EParticleOp::Add,           0 },
+        { EParticleValueType::Int,       FOURCC('SUB_'), 2, EParticleOp::Sub,           0 },
+        { EParticleValueType::Int,       FOURCC('MULT'), 2, EParticleOp::Mul,           0 },
+        { EParticleValueType::Int,       FOURCC('RAND'), 2, EParticleOp::RandomInt,     0 },
+        { EParticleValueType::Int,       FOURCC('IRND'), 2, EParticleOp::InitialRandom, 0 },
+        { EParticleValueType::Int,       FOURCC('CLMP'), 3, EParticleOp::Clamp,         0 },
+        { EParticleValueType::Int,       FOURCC('CHAN'), 3, EParticleOp::Chan,          0 },
+        { EParticleValueType::Int,       FOURCC('ISWT'), 2, EParticleOp::InitialSwitch, 0 },
+        { EParticleValueType::Int,       FOURCC('PULS'), 4, EParticleOp::Pulse,         0 },
+        { EParticleValueType::Float,     FOURCC('ADD_'), 2, EParticleOp::Add,           0 },
+        { EParticleValueType::Float,     FOURCC('SUB_'), 2, EParticleOp::Sub,           0 },
+        { EParticleValueType::Float,     FOURCC('MULT'), 2, EParticleOp::Mul,           0 },
+        { EParticleValueType::Float,     FOURCC('RAND'), 2, EParticleOp::Random,        0 },
+        { EParticleValueType::Float,     FOURCC('IRND'), 2, EParticleOp::InitialRandom, 0 },
+        { EParticleValueType::Float,     FOURCC('CLMP'), 3, EParticleOp::Clamp,         0 },
+        { EParticleValueType::Float,     FOURCC('CHAN'), 3, EParticleOp::Chan,          0 },
+        { EParticleValueType::Float,     FOURCC('ISWT'), 2, EParticleOp::InitialSwitch, 0 },
+        { EParticleValueType::Float,     FOURCC('PULS'), 4, EParticleOp::Pulse,         0 },
+        { EParticleValueType::Float,     FOURCC('LFTW'), 2, EParticleOp::LifetimeTween, 0 },
+        { EParticleValueType::Float,     FOURCC('SINE'), 3, EParticleOp::Sine,          0 },
+        { EParticleValueType::Float,     FOURCC('DOTP'), 2, EParticleOp::Dot,           0 },
+        { EParticleValueType::Float,     FOURCC('VMAG'), 1, EParticleOp::Length,        0 },
+        { EParticleValueType::Float,     FOURCC('VXTR'), 1, EParticleOp::Extract,       0 },
+        { EParticleValueType::Float,     FOURCC('VYTR'), 1, EParticleOp::Extract,       1 },
+        { EParticleValueType::Float,     FOURCC('VZTR'), 1, EParticleOp::Extract,       2 },
+        { EParticleValueType::Float,     FOURCC('GTCR'), 1, EParticleOp::Extract,       0 },
+        { EParticleValueType::Float,     FOURCC('GTCG'), 1, EParticleOp::Extract,       1 },
+        { EParticleValueType::Float,     FOURCC('GTCB'), 1, EParticleOp::Extract,       2 },
+        { EParticleValueType::Float,     FOURCC('GTCA'), 1, EParticleOp::Extract,       3 },
+        { EParticleValueType::Vector,    FOURCC('CNST'), 3, EParticleOp::MakeVector,    0 },
+        { EParticleValueType::Vector,    FOURCC('ADD_'), 2, EParticleOp::Add,           0 },
+        { EParticleValueType::Vector,    FOURCC('SUB_'), 2, EParticleOp::Sub,           0 },
+        { EParticleValueType::Vector,    FOURCC('MULT'), 2, EParticleOp::Mul,           0 },
+        { EParticleValueType::Vector,    FOURCC('CHAN'), 3, EParticleOp::Chan,          0 },
+        { EParticleValueType::Vector,    FOURCC('ISWT'), 2, EParticleOp::InitialSwitch, 0 },
+        { EParticleValueType::Vector,    FOURCC('PULS'), 4, EParticleOp::Pulse,         0 },
+        { EParticleValueType::Vector,    FOURCC('CONE'), 2, EParticleOp::Cone,          0 },
+        { EParticleValueType::Vector,    FOURCC('RNDV'), 1, EParticleOp::RandomVector,  0 },
+        { EParticleValueType::Vector,    FOURCC('NORM'), 1, EParticleOp::Normalize,     0 },
+        { EParticleValueType::Vector,    FOURCC('CTVC'), 1, EParticleOp::ColorToVector, 0 },
+        { EParticleValueType::ModVector, FOURCC('CHAN'), 3, EParticleOp::Chan,          0 },
+        { EParticleValueType::ModVector, FOURCC('PULS'), 4, EParticleOp::Pulse,         0 },
+        { EParticleValueType::Color,     FOURCC('CNST'), 4, EParticleOp::MakeColor,     0 },
+        { EParticleValueType::Color,     FOURCC('MULT'), 2, EParticleOp::Mul,           0 },
+        { EParticleValueType::Color,     FOURCC('CHAN'), 3, EParticleOp::Chan,          0 },
+        { EParticleValueType::Color,     FOURCC('ISWT'), 2, EParticleOp::InitialSwitch, 0 },
+        { EParticleValueType::Color,     FOURCC('PULS'), 4, EParticleOp::Pulse,         0 },
+        { EParticleValueType::Color,     FOURCC('FADE'), 3, EParticleOp::Fade,          0 },
+    };
+
+    for (const SOpInfo& rkInfo : skOps)
+    {
+        if (rkInfo.Type == Type && rkInfo.Func == Func && rkInfo.NumArgs == NumArgs)
+        {
+            rOutOp = rkInfo.Op;
+            rOutOperand = rkInfo.Operand;
+            return true;
+        }
+    }
+
+    return false;
+}
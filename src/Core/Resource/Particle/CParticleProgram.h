@@ -0,0 +1,172 @@
+#ifndef CPARTICLEPROGRAM_H
+#define CPARTICLEPROGRAM_H
+
+#include <Common/BasicTypes.h>
+#include <array>
+#include <vector>
+
+/** lowbias32 integer hash; the source of all per-particle randomness */
+inline uint32 ParticleHash(uint32 Value)
+{
+    Value ^= Value >> 16;
+    Value *= 0x7FEB352D;
+    Value ^= Value >> 15;
+    Value *= 0x846CA68B;
+    Value ^= Value >> 16;
+    return Value;
+}
+
+/** Value types produced by particle functions */
+enum class EParticleValueType
+{
+    Bool,
+    Int,
+    Float,
+    Vector,
+    ModVector,
+    Color,
+    Rotation,
+    UV,
+    Asset,
+    Sound,
+    Bitfield
+};
+
+/** Instructions of the compiled particle function bytecode. Operand order is the order the children appear in the file. */
+enum class EParticleOp : uint8
+{
+    Constant,       // Push constant [Operand]
+    Default,        // Push zero
+    MakeVector,     // x, y, z -> (x, y, z)
+    MakeColor,      // r, g, b, a -> (r, g, b, a)
+    Add,            // a, b -> a + b
+    Sub,            // a, b -> a - b
+    Mul,            // a, b -> a * b
+    Random,         // min, max -> random value in [min, max], rerolled every frame
+    InitialRandom,  // min, max -> random value in [min, max], fixed for the particle's lifetime
+    RandomInt,      // min, max -> random integer in [min, max], rerolled every frame
+    Clamp,          // min, max, value -> clamped value
+    Sine,           // frequency, amplitude, phase -> sine wave over age
+    LifetimeTween,  // a, b -> lerp from a to b over lifetime
+    Chan,           // a, b, frames -> a for the given number of frames, b afterwards
+    InitialSwitch,  // a, b -> a on the first frame, b afterwards
+    Pulse,          // a frames, b frames, a, b -> alternates between a and b
+    Fade,           // a, b, frames -> lerp from a to b over the given number of frames
+    Keyframes,      // Sample keyframe table [Operand] by age or lifetime percentage
+    KeyframesBy,    // t -> sample keyframe table [Operand] at index t
+    Cone,           // direction, magnitude -> random vector within a cone around direction
+    RandomVector,   // magnitude -> random vector with the given length
+    Normalize,      // v -> v / |v|
+    Length,         // v -> |v|
+    Dot,            // a, b -> a . b
+    Extract,        // v -> component [Operand] of v
+    ColorToVector   // c -> (r, g, b)
+};
+
+/** Keyframe table referenced by the Keyframes instructions */
+struct SParticleKeyframes
+{
+    uint32 FirstKey = 0;
+    uint32 NumKeys = 0;
+    int32 LoopStart = 0;
+    int32 LoopEnd = 0;
+    bool Loop = false;
+    bool Percent = false;
+};
+
+/** Per-particle inputs to a program evaluation; one lane per particle */
+struct SParticleLanes
+{
+    static constexpr uint32 skMaxLanes = 32;
+
+    const float *pkAge = nullptr;
+    const float *pkLifetime = nullptr;
+    const uint32 *pkSeed = nullptr;
+    uint32 NumLanes = 0;
+
+    /** Frame counter used to reroll per-frame random values */
+    uint32 Frame = 0;
+};
+
+/** Program output; four component values for each lane */
+struct SParticleValues
+{
+    alignas(16) float Comp[4][SParticleLanes::skMaxLanes];
+};
+
+/**
+ * Compiled particle function tree.
+ * Function trees are flattened into a compact postfix bytecode when the particle
+ * is loaded, and evaluated for a whole batch of particles at once, one instruction
+ * at a time, with each value component laid out contiguously across lanes.
+ */
+class CParticleProgram
+{
+    friend class CParticleProgramBuilder;
+
+    std::vector<uint32> mCode;
+    std::vector<std::array<float, 4>> mConstants;
+    std::vector<std::array<float, 4>> mKeys;
+    std::vector<SParticleKeyframes> mKeyframes;
+    uint32 mMaxStackDepth = 0;
+
+public:
+    static constexpr uint32 skMaxStackDepth = 16;
+
+    /** Evaluate the program for each lane in rkLanes */
+    void Evaluate(const SParticleLanes& rkLanes, SParticleValues& rOut) const;
+
+    /** Evaluate the program for a single particle */
+    std::array<float, 4> EvaluateSingle(float Age, float Lifetime, uint32 Seed, uint32 Frame) const;
+
+    bool IsConstant() const                 { return mCode.size() == 1 && DecodeOp(mCode[0]) == EParticleOp::Constant; }
+    uint32 NumInstructions() const          { return static_cast<uint32>(mCode.size()); }
+
+    static uint32 Encode(EParticleOp Op, uint32 Operand)   { return static_cast<uint32>(Op) | (Operand << 8); }
+    static EParticleOp DecodeOp(uint32 Instruction)         { return static_cast<EParticleOp>(Instruction & 0xFF); }
+    static uint32 DecodeOperand(uint32 Instruction)         { return Instruction >> 8; }
+};
+
+/**
+ * Builds a CParticleProgram while a function tree is parsed.
+ * Each function calls Begin() before parsing its children and End() afterwards;
+ * End() emits the instruction for the function if it's supported and the children
+ * produced the expected number of values, or replaces the whole subtree with a
+ * default value otherwise.
+ */
+class CParticleProgramBuilder
+{
+    CParticleProgram mProgram;
+    uint32 mDepth = 0;
+    bool mOverflow = false;
+
+public:
+    struct SMark
+    {
+        uint32 CodeSize = 0;
+        uint32 NumConstants = 0;
+        uint32 NumKeys = 0;
+        uint32 NumKeyframes = 0;
+        uint32 Depth = 0;
+    };
+
+    SMark Begin() const;
+    void End(const SMark& rkMark, EParticleValueType Type, uint32 Func);
+    void PushConstant(float X, float Y = 0.f, float Z = 0.f, float W = 0.f);
+    void PushDefault();
+
+    /** Add a keyframe table. Keys are read by the caller; the instruction is emitted with EmitKeyframes(). */
+    uint32 AddKeyframes(const SParticleKeyframes& rkTable, const std::vector<std::array<float, 4>>& rkKeys);
+    void EmitKeyframes(uint32 TableIndex, bool ByChildValue);
+
+    /** Returns whether the builder holds exactly one complete value */
+    bool HasValue() const                   { return mDepth == 1 && !mOverflow; }
+    CParticleProgram Finish();
+
+private:
+    void Emit(EParticleOp Op, uint32 Operand, uint32 NumPopped);
+    void Rewind(const SMark& rkMark);
+    static bool FindOp(EParticleValueType Type, uint32 Func, uint32 NumArgs, EParticleOp& rOutOp, uint32& rOutOperand);
+};
+
+#endif // CPARTICLEPROGRAM_H
@@ -0,0 +1,350 @@
+#include "CParticleSimulator.h"
+#include "Core/GameProject/CResourceEntry.h"
+#include "Core/GameProject/CResourceStore.h"
+#include "Core/Render/CDrawUtil.h"
+#include "Core/Resource/Factory/CUnsupportedParticleLoader.h"
+#include <Common/FileIO.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+float SeedRandom(uint32 Seed, uint32 Stream)
+{
+    return static_cast<float>(ParticleHash(Seed + Stream * 0x9E3779B9) >> 8) * (1.f / 16777216.f);
+}
+
+float EvaluateScalar(const CParticleProgram *pkProgram, float Default)
+{
+    return pkProgram ? pkProgram->EvaluateSingle(0.f, 1.f, 0, 0)[0] : Default;
+}
+
+}
+
+CParticleSimulator::CParticleSimulator(std::shared_ptr<const CParticleEffect> pEffect)
+    : mpEffect(std::move(pEffect))
+{
+    ASSERT(mpEffect);
+
+    if (mpEffect->TextureID().IsValid())
+        mpTexture = gpResourceStore->LoadResource<CTexture>(mpEffect->TextureID());
+
+    mpkLifetime = mpEffect->Program(FOURCC('LTME'));
+    mpkGenRate = mpEffect->Program(FOURCC('GRTE'));
+    mpkSize = mpEffect->Program(FOURCC('SIZE'));
+    mpkColor = mpEffect->Program(FOURCC('COLR'));
+
+    const uint32 kVelocityModifierParams[] = { FOURCC('VEL1'), FOURCC('VEL2'), FOURCC('VEL3'), FOURCC('VEL4') };
+
+    for (const uint32 Param : kVelocityModifierParams)
+    {
+        if (const CParticleProgram *pkModifier = mpEffect->Program(Param))
+            mVelocityModifiers.push_back(pkModifier);
+    }
+
+    const float MaxParticles = EvaluateScalar(mpEffect->Program(FOURCC('MAXP')), 256.f);
+    mMaxParticles = static_cast<uint32>(std::min(std::max(MaxParticles, 0.f), static_cast<float>(skMaxParticles)));
+    const float SystemLifetime = EvaluateScalar(mpEffect->Program(FOURCC('PSLT')), 0.f);
+    mSystemLifetime = static_cast<uint32>(std::min(std::max(SystemLifetime, 0.f), 1000000.f));
+
+    for (std::vector<float>* pArray : { &mPosX, &mPosY, &mPosZ, &mVelX, &mVelY, &mVelZ, &mAge, &mLifetime })
+        pArray->resize(mMaxParticles);
+
+    mSeed.resize(mMaxParticles);
+}
+
+void CParticleSimulator::Reset()
+{
+    mNumParticles = 0;
+    mFrame = 0;
+    mSpawnAccumulator = 0.f;
+}
+
+void CParticleSimulator::Update(double CurrentTime)
+{
+    if (mLastUpdateTime < 0.0 || CurrentTime < mLastUpdateTime)
+        mLastUpdateTime = CurrentTime;
+
+    mTimeAccumulator += CurrentTime - mLastUpdateTime;
+    mLastUpdateTime = CurrentTime;
+
+    // Don't try to catch up after long stalls; just drop the time
+    uint32 NumFrames = 0;
+
+    while (mTimeAccumulator >= skFrameTime && NumFrames < skMaxFramesPerUpdate)
+    {
+        StepFrame();
+        mTimeAccumulator -= skFrameTime;
+        NumFrames++;
+    }
+
+    if (NumFrames == skMaxFramesPerUpdate)
+        mTimeAccumulator = 0.0;
+}
+
+void CParticleSimulator::StepFrame()
+{
+    // Age particles and remove dead ones
+    for (uint32 ParticleIdx = 0; ParticleIdx < mNumParticles; )
+    {
+        mAge[ParticleIdx] += 1.f;
+
+        if (mAge[ParticleIdx] >= mLifetime[ParticleIdx])
+            KillParticle(ParticleIdx);
+        else
+            ParticleIdx++;
+    }
+
+    // Apply velocity modifiers
+    if (!mVelocityModifiers.empty())
+    {
+        SParticleLanes Lanes;
+        SParticleValues Values;
+
+        for (uint32 First = 0; First < mNumParticles; First += SParticleLanes::skMaxLanes)
+        {
+            const uint32 Count = std::min(mNumParticles - First, SParticleLanes::skMaxLanes);
+            SetupLanes(Lanes, First, Count);
+
+            for (const CParticleProgram *pkModifier : mVelocityModifiers)
+            {
+                pkModifier->Evaluate(Lanes, Values);
+
+                for (uint32 Lane = 0; Lane < Count; Lane++)
+                {
+                    mVelX[First + Lane] += Values.Comp[0][Lane];
+                    mVelY[First + Lane] += Values.Comp[1][Lane];
+                    mVelZ[First + Lane] += Values.Comp[2][Lane];
+                }
+            }
+        }
+    }
+
+    // Integrate
+    for (uint32 ParticleIdx = 0; ParticleIdx < mNumParticles; ParticleIdx++)
+    {
+        mPosX[ParticleIdx] += mVelX[ParticleIdx];
+        mPosY[ParticleIdx] += mVelY[ParticleIdx];
+        mPosZ[ParticleIdx] += mVelZ[ParticleIdx];
+    }
+
+    // Spawn new particles
+    const bool IsEmitting = (mSystemLifetime == 0 || mFrame < mSystemLifetime);
+
+    if (IsEmitting && mpkGenRate)
+    {
+        const float SystemAge = static_cast<float>(mFrame);
+        const float Lifetime = static_cast<float>(std::max<uint32>(mSystemLifetime, 1));
+        mSpawnAccumulator += std::max(mpkGenRate->EvaluateSingle(SystemAge, Lifetime, 0, mFrame)[0], 0.f);
+
+        const uint32 NumToSpawn = static_cast<uint32>(std::min(mSpawnAccumulator, static_cast<float>(skMaxParticles)));
+        mSpawnAccumulator -= static_cast<float>(NumToSpawn);
+        SpawnParticles(std::min(NumToSpawn, mMaxParticles - mNumParticles));
+    }
+
+    mFrame++;
+
+    // Loop finished systems so the preview keeps playing
+    if (!IsEmitting && mNumParticles == 0)
+        Reset();
+}
+
+void CParticleSimulator::Draw(const CVector3f& rkOrigin, const CColor& rkTint) const
+{
+    if (!mpTexture || mNumParticles == 0)
+        return;
+
+    SParticleLanes Lanes;
+    SParticleValues Sizes;
+    SParticleValues Colors;
+
+    for (uint32 First = 0; First < mNumParticles; First += SParticleLanes::skMaxLanes)
+    {
+        const uint32 Count = std::min(mNumParticles - First, SParticleLanes::skMaxLanes);
+        SetupLanes(Lanes, First, Count);
+
+        if (mpkSize)
+            mpkSize->Evaluate(Lanes, Sizes);
+        else
+            std::fill(Sizes.Comp[0], Sizes.Comp[0] + Count, 1.f);
+
+        if (mpkColor)
+            mpkColor->Evaluate(Lanes, Colors);
+        else
+        {
+            for (uint32 Comp = 0; Comp < 4; Comp++)
+                std::fill(Colors.Comp[Comp], Colors.Comp[Comp] + Count, 1.f);
+        }
+
+        for (uint32 Lane = 0; Lane < Count; Lane++)
+        {
+            const uint32 ParticleIdx = First + Lane;
+            const float Size = Sizes.Comp[0][Lane];
+
+            if (Size <= 0.f)
+                continue;
+
+            const CVector3f Position(rkOrigin.X + mPosX[ParticleIdx], rkOrigin.Y + mPosY[ParticleIdx], rkOrigin.Z + mPosZ[ParticleIdx]);
+            const CColor Color(Colors.Comp[0][Lane], Colors.Comp[1][Lane], Colors.Comp[2][Lane], Colors.Comp[3][Lane]);
+            CDrawUtil::QueueBillboard(mpTexture, Position, CVector2f(Size, Size), Color * rkTint);
+        }
+    }
+}
+
+std::shared_ptr<const CParticleEffect> CParticleSimulator::LoadEffect(CResourceEntry *pEntry)
+{
+    if (pEntry == nullptr || pEntry->ResourceType() != EResourceType::Particle || !pEntry->HasCookedVersion())
+        return nullptr;
+
+    // Effects stay cached on their store for as long as any preview is using them
+    auto& rCache = pEntry->ResourceStore()->ParticleEffectCache();
+
+    for (auto It = rCache.begin(); It != rCache.end(); )
+    {
+        if (It->second.expired())
+            It = rCache.erase(It);
+        else
+            ++It;
+    }
+
+    std::weak_ptr<const CParticleEffect>& rCached = rCache[pEntry->ID()];
+
+    if (auto pEffect = rCached.lock())
+        return pEffect;
+
+    CFileInStream File(pEntry->CookedAssetPath(), EEndian::BigEndian);
+
+    if (!File.IsValid())
+        return nullptr;
+
+    std::shared_ptr<const CParticleEffect> pEffect = CUnsupportedParticleLoader::CompileParticle(File, pEntry);
+
+    if (pEffect && pEffect->NumPrograms() == 0)
+        pEffect.reset();
+
+    rCached = pEffect;
+    return pEffect;
+}
+
+// ************ PRIVATE ************
+void CParticleSimulator::SpawnParticles(uint32 Count)
+{
+    const SParticleEmitterDesc& rkEmitter = mpEffect->Emitter();
+    SParticleLanes Lanes;
+    SParticleValues Values;
+
+    while (Count > 0)
+    {
+        const uint32 First = mNumParticles;
+        const uint32 NumLanes = std::min(Count, SParticleLanes::skMaxLanes);
+
+        for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+        {
+            const uint32 ParticleIdx = First + Lane;
+            mSeed[ParticleIdx] = ParticleHash(mNextSeed++);
+            mAge[ParticleIdx] = 0.f;
+            mLifetime[ParticleIdx] = 1.f;
+            mPosX[ParticleIdx] = mPosY[ParticleIdx] = mPosZ[ParticleIdx] = 0.f;
+            mVelX[ParticleIdx] = mVelY[ParticleIdx] = mVelZ[ParticleIdx] = 0.f;
+        }
+
+        SetupLanes(Lanes, First, NumLanes);
+
+        // Lifetime
+        if (mpkLifetime)
+        {
+            mpkLifetime->Evaluate(Lanes, Values);
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+                mLifetime[First + Lane] = std::max(Values.Comp[0][Lane], 1.f);
+        }
+        else
+            std::fill(&mLifetime[First], &mLifetime[First] + NumLanes, 60.f);
+
+        // Initial position and velocity
+        if (rkEmitter.Shape != EParticleEmitterShape::None)
+        {
+            rkEmitter.Origin.Evaluate(Lanes, Values);
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                mPosX[First + Lane] = Values.Comp[0][Lane];
+                mPosY[First + Lane] = Values.Comp[1][Lane];
+                mPosZ[First + Lane] = Values.Comp[2][Lane];
+            }
+        }
+
+        if (rkEmitter.Shape == EParticleEmitterShape::Point)
+        {
+            rkEmitter.Velocity.Evaluate(Lanes, Values);
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                mVelX[First + Lane] = Values.Comp[0][Lane];
+                mVelY[First + Lane] = Values.Comp[1][Lane];
+                mVelZ[First + Lane] = Values.Comp[2][Lane];
+            }
+        }
+        else if (rkEmitter.Shape == EParticleEmitterShape::Sphere)
+        {
+            SParticleValues Speeds;
+            rkEmitter.Radius.Evaluate(Lanes, Values);
+            rkEmitter.Speed.Evaluate(Lanes, Speeds);
+
+            for (uint32 Lane = 0; Lane < NumLanes; Lane++)
+            {
+                const uint32 ParticleIdx = First + Lane;
+                float DirX = SeedRandom(mSeed[ParticleIdx], 1) * 2.f - 1.f;
+                float DirY = SeedRandom(mSeed[ParticleIdx], 2) * 2.f - 1.f;
+                float DirZ = SeedRandom(mSeed[ParticleIdx], 3) * 2.f - 1.f;
+                const float Length = std::sqrt(DirX * DirX + DirY * DirY + DirZ * DirZ);
+                const float InvLength = (Length > 0.f ? 1.f / Length : 0.f);
+                DirX *= InvLength;
+                DirY *= InvLength;
+                DirZ *= InvLength;
+
+                const float Radius = Values.Comp[0][Lane];
+                const float Speed = Speeds.Comp[0][Lane];
+                mPosX[ParticleIdx] += DirX * Radius;
+                mPosY[ParticleIdx] += DirY * Radius;
+                mPosZ[ParticleIdx] += DirZ * Radius;
+                mVelX[ParticleIdx] = DirX * Speed;
+                mVelY[ParticleIdx] = DirY * Speed;
+                mVelZ[ParticleIdx] = DirZ * Speed;
+            }
+        }
+
+        mNumParticles += NumLanes;
+        Count -= NumLanes;
+    }
+}
+
+void CParticleSimulator::KillParticle(uint32 Index)
+{
+    const uint32 Last = mNumParticles - 1;
+
+    if (Index != Last)
+    {
+        mPosX[Index] = mPosX[Last];
+        mPosY[Index] = mPosY[Last];
+        mPosZ[Index] = mPosZ[Last];
+        mVelX[Index] = mVelX[Last];
+        mVelY[Index] = mVelY[Last];
+        mVelZ[Index] = mVelZ[Last];
+        mAge[Index] = mAge[Last];
+        mLifetime[Index] = mLifetime[Last];
+        mSeed[Index] = mSeed[Last];
+    }
+
+    mNumParticles--;
+}
+
+void CParticleSimulator::SetupLanes(SParticleLanes& rLanes, uint32 First, uint32 Count) const
+{
+    rLanes.pkAge = mAge.data() + First;
+    rLanes.pkLifetime = mLifetime.data() + First;
+    rLanes.pkSeed = mSeed.data() + First;
+    rLanes.NumLanes = Count;
+    rLanes.Frame = mFrame;
+}
@@ -0,0 +1,78 @@
+#ifndef CPARTICLESIMULATOR_H
+#define CPARTICLESIMULATOR_H
+
+#include "CParticleEffect.h"
+#include "Core/Resource/TResPtr.h"
+#include "Core/Resource/CTexture.h"
+#include <Common/CColor.h>
+#include <Common/Math/CVector3f.h>
+#include <memory>
+#include <vector>
+
+class CResourceEntry;
+
+/**
+ * Lightweight particle simulation used to preview PART particle systems in the viewport.
+ * Particles are kept in a fixed-capacity structure-of-arrays pool and stepped at the
+ * game's fixed frame rate, with all per-particle functions evaluated in batches through
+ * the effect's compiled programs. This is a preview, not an accurate reproduction of
+ * the in-game effect; unsupported functions fall back to default values.
+ */
+class CParticleSimulator
+{
+    std::shared_ptr<const CParticleEffect> mpEffect;
+    TResPtr<CTexture> mpTexture;
+
+    const CParticleProgram *mpkLifetime = nullptr;
+    const CParticleProgram *mpkGenRate = nullptr;
+    const CParticleProgram *mpkSize = nullptr;
+    const CParticleProgram *mpkColor = nullptr;
+    std::vector<const CParticleProgram*> mVelocityModifiers;
+    uint32 mMaxParticles = 0;
+    uint32 mSystemLifetime = 0;
+
+    // Particle pool
+    std::vector<float> mPosX, mPosY, mPosZ;
+    std::vector<float> mVelX, mVelY, mVelZ;
+    std::vector<float> mAge;
+    std::vector<float> mLifetime;
+    std::vector<uint32> mSeed;
+    uint32 mNumParticles = 0;
+
+    // System state
+    uint32 mFrame = 0;
+    uint32 mNextSeed = 0;
+    float mSpawnAccumulator = 0.f;
+    double mLastUpdateTime = -1.0;
+    double mTimeAccumulator = 0.0;
+
+public:
+    static constexpr uint32 skMaxParticles = 1024;
+    static constexpr double skFrameTime = 1.0 / 60.0;
+    static constexpr uint32 skMaxFramesPerUpdate = 8;
+
+    explicit CParticleSimulator(std::shared_ptr<const CParticleEffect> pEffect);
+
+    /** Kill all particles and restart the system */
+    void Reset();
+
+    /** Advance the simulation to CurrentTime (in seconds), stepping as many fixed frames as needed */
+    void Update(double CurrentTime);
+    void StepFrame();
+
+    /** Queue a billboard for every live particle, relative to the emitter origin */
+    void Draw(const CVector3f& rkOrigin, const CColor& rkTint) const;
+
+    uint32 NumParticles() const     { return mNumParticles; }
+    bool CanDraw() const            { return mpTexture != nullptr; }
+
+    /** Compile the particle system for an entry. Effects are shared between all previews of the same asset. */
+    static std::shared_ptr<const CParticleEffect> LoadEffect(CResourceEntry *pEntry);
+
+private:
+    void SpawnParticles(uint32 Count);
+    void KillParticle(uint32 Index);
+    void SetupLanes(SParticleLanes& rLanes, uint32 First, uint32 Count) const;
+};
+
+#endif // CPARTICLESIMULATOR_H
@@ -0,0 +1,29 @@
+#ifndef SRESOURCEMEMORYUSAGE_H
+#define SRESOURCEMEMORYUSAGE_H
+
+#include <Common/BasicTypes.h>
+
+/** Approximate memory held by a loaded resource, split into CPU-side data and GL buffers/textures */
+struct SResourceMemoryUsage
+{
+    uint64 CPUBytes = 0;
+    uint64 GPUBytes = 0;
+
+    uint64 Total() const    { return CPUBytes + GPUBytes; }
+
+    SResourceMemoryUsage& operator+=(const SResourceMemoryUsage& rkOther)
+    {
+        CPUBytes += rkOther.CPUBytes;
+        GPUBytes += rkOther.GPUBytes;
+        return *this;
+    }
+
+    SResourceMemoryUsage& operator-=(const SResourceMemoryUsage& rkOther)
+    {
+        CPUBytes -= rkOther.CPUBytes;
+        GPUBytes -= rkOther.GPUBytes;
+        return *this;
+    }
+};
+
+#endif // SRESOURCEMEMORYUSAGE_H
@@ -38,8 +38,11 @@ public:
         }
         else
         {
+            Index = static_cast<uint32>(mInstances.size());
             mInstances.push_back(pObject);
         }
+
+        mpArea->OnLayerInstanceAdded(this, pObject, Index);
     }
 
     void RemoveInstance(const CScriptObject *pInstance)
@@ -50,12 +53,13 @@ public:
         if (it == mInstances.cend())
             return;
 
-        mInstances.erase(it);
+        RemoveInstanceByIndex(std::distance(mInstances.cbegin(), it));
     }
 
     void RemoveInstanceByIndex(size_t Index)
     {
         mInstances.erase(mInstances.begin() + Index);
+        mpArea->OnLayerInstanceRemoved(this, Index);
     }
 
     void RemoveInstanceByID(uint32 ID)
@@ -66,7 +70,7 @@ public:
         if (it == mInstances.cend())
             return;
 
-        mInstances.erase(it);
+        RemoveInstanceByIndex(std::distance(mInstances.cbegin(), it));
     }
 
     void Reserve(size_t Amount)
@@ -28,13 +28,7 @@ CScriptTemplate::CScriptTemplate(CGameTemplate* pInGame, uint32 InObjectID, cons
     // Post load initialization
     mSourceFile = kInFilePath;
     mpProperties->Initialize(nullptr, this, 0);
-
-    if (!mNameIDString.IsEmpty())               mpNameProperty = TPropCast<CStringProperty>( mpProperties->ChildByIDString(mNameIDString) );
-    if (!mPositionIDString.IsEmpty())           mpPositionProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mPositionIDString) );
-    if (!mRotationIDString.IsEmpty())           mpRotationProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mRotationIDString) );
-    if (!mScaleIDString.IsEmpty())              mpScaleProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mScaleIDString) );
-    if (!mActiveIDString.IsEmpty())             mpActiveProperty = TPropCast<CBoolProperty>( mpProperties->ChildByIDString(mActiveIDString) );
-    if (!mLightParametersIDString.IsEmpty())    mpLightParametersProperty = TPropCast<CStructProperty>( mpProperties->ChildByIDString(mLightParametersIDString) );
+    ResolvePropertyBindings();
 }
 
 CScriptTemplate::~CScriptTemplate() = default;
@@ -124,13 +118,59 @@ float CScriptTemplate::VolumeScale(CScriptObject *pObj)
     return mVolumeScale;
 }
 
+/**
+ * Resolve every ID string the template refers to into a property pointer, so evaluating an instance
+ * (which happens on every property edit) doesn't need to parse ID strings and search the property tree.
+ */
+void CScriptTemplate::ResolvePropertyBindings()
+{
+    if (!mNameIDString.IsEmpty())               mpNameProperty = TPropCast<CStringProperty>( mpProperties->ChildByIDString(mNameIDString) );
+    if (!mPositionIDString.IsEmpty())           mpPositionProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mPositionIDString) );
+    if (!mRotationIDString.IsEmpty())           mpRotationProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mRotationIDString) );
+    if (!mScaleIDString.IsEmpty())              mpScaleProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mScaleIDString) );
+    if (!mActiveIDString.IsEmpty())             mpActiveProperty = TPropCast<CBoolProperty>( mpProperties->ChildByIDString(mActiveIDString) );
+    if (!mLightParametersIDString.IsEmpty())    mpLightParametersProperty = TPropCast<CStructProperty>( mpProperties->ChildByIDString(mLightParametersIDString) );
+
+    if (mpLightParametersProperty)
+    {
+        if (Game() <= EGame::Prime)
+        {
+            mpWorldLightingOptionsProperty = mpLightParametersProperty->ChildByIndex(0x7);
+            mpLightLayerProperty = TPropCast<CIntProperty>( mpLightParametersProperty->ChildByIndex(0xD) );
+        }
+        else
+        {
+            mpWorldLightingOptionsProperty = mpLightParametersProperty->ChildByID(0x6B5E7509);
+            mpLightLayerProperty = TPropCast<CIntProperty>( mpLightParametersProperty->ChildByID(0x1F715FD3) );
+        }
+    }
+
+    if (mVolumeShape == EVolumeShape::ConditionalShape)
+    {
+        mpVolumeConditionProperty = mpProperties->ChildByIDString(mVolumeConditionIDString);
+
+        if (!mpVolumeConditionProperty)
+            errorf("%s template has an invalid volume condition property: %s", *Name(), *mVolumeConditionIDString);
+    }
+
+    for (SEditorAsset& rAsset : mAssets)
+    {
+        if (rAsset.AssetSource != SEditorAsset::EAssetSource::Property)
+            continue;
+
+        rAsset.pProperty = mpProperties->ChildByIDString(rAsset.AssetLocation);
+
+        if (!rAsset.pProperty)
+            errorf("%s template has an invalid editor asset property: %s", *Name(), *rAsset.AssetLocation);
+    }
+}
+
 int32 CScriptTemplate::CheckVolumeConditions(CScriptObject *pObj, bool LogErrors)
 {
     // Private function
-    if (mVolumeShape == EVolumeShape::ConditionalShape)
+    if (mVolumeShape == EVolumeShape::ConditionalShape && mpVolumeConditionProperty)
     {
-        const TIDString PropID = mVolumeConditionIDString;
-        IProperty* pProp = pObj->Template()->Properties()->ChildByIDString(PropID);
+        IProperty* pProp = mpVolumeConditionProperty;
 
         // Get value of the condition test property (only boolean, integral, and enum types supported)
         void* pData = pObj->PropertyData();
@@ -187,7 +227,7 @@ CResource* CScriptTemplate::FindDisplayAsset(void* pPropertyData, uint32& rOutCh
 
     for (const auto& asset : mAssets)
     {
-        if (asset.AssetType == SEditorAsset::EAssetType::Collision)
+        if (asset.AssetType == SEditorAsset::EAssetType::Collision || asset.AssetType == SEditorAsset::EAssetType::Particle)
             continue;
 
         CResource *pRes = nullptr;
@@ -197,10 +237,8 @@ CResource* CScriptTemplate::FindDisplayAsset(void* pPropertyData, uint32& rOutCh
         {
             pRes = gpEditorStore->LoadResource(asset.AssetLocation);
         }
-        else // Property
+        else if (IProperty* pProp = asset.pProperty) // Property
         {
-            IProperty* pProp = mpProperties->ChildByIDString(asset.AssetLocation);
-
             if (asset.AssetType == SEditorAsset::EAssetType::AnimParams && pProp->Type() == EPropertyType::AnimationSet)
             {
                 auto* pAnimSet = TPropCast<CAnimationSetProperty>(pProp);
@@ -251,10 +289,8 @@ CCollisionMeshGroup* CScriptTemplate::FindCollision(void* pPropertyData)
         {
             pRes = gpResourceStore->LoadResource(asset.AssetLocation);
         }
-        else // Property
+        else if (IProperty* pProp = asset.pProperty) // Property
         {
-            IProperty* pProp = mpProperties->ChildByIDString(asset.AssetLocation);
-
             if (pProp->Type() == EPropertyType::Asset)
             {
                 auto* pAsset = TPropCast<CAssetProperty>(pProp);
@@ -270,6 +306,38 @@ CCollisionMeshGroup* CScriptTemplate::FindCollision(void* pPropertyData)
     return nullptr;
 }
 
+/** Particle previews compile the cooked file themselves, so this only looks the entry up without loading it */
+CResourceEntry* CScriptTemplate::FindParticle(void* pPropertyData)
+{
+    for (const auto& asset : mAssets)
+    {
+        if (asset.AssetType != SEditorAsset::EAssetType::Particle)
+            continue;
+
+        CResourceEntry *pEntry = nullptr;
+
+        // File
+        if (asset.AssetSource == SEditorAsset::EAssetSource::File)
+        {
+            pEntry = gpResourceStore->FindEntry(asset.AssetLocation);
+        }
+        else if (IProperty* pProp = asset.pProperty) // Property
+        {
+            if (pProp->Type() == EPropertyType::Asset)
+            {
+                auto* pAsset = TPropCast<CAssetProperty>(pProp);
+                pEntry = gpResourceStore->FindEntry( pAsset->Value(pPropertyData) );
+            }
+        }
+
+        // Verify entry exists + is correct type
+        if (pEntry != nullptr && pEntry->ResourceType() == EResourceType::Particle)
+            return pEntry;
+    }
+
+    return nullptr;
+}
+
 
 // ************ OBJECT TRACKING ************
 uint32 CScriptTemplate::NumObjects() const
@@ -54,7 +54,7 @@ public:
     struct SEditorAsset
     {
         enum class EAssetType {
-            Model, AnimParams, Billboard, Collision
+            Model, AnimParams, Billboard, Collision, Particle
         } AssetType;
 
         enum class EAssetSource {
@@ -63,6 +63,7 @@ public:
 
         TIDString AssetLocation;
         int32 ForceNodeIndex; // Force animsets to use specific node instead of one from property
+        IProperty* pProperty = nullptr; // Property source only; resolved from AssetLocation on load
 
         void Serialize(IArchive& Arc)
         {
@@ -108,6 +109,9 @@ private:
     CVectorProperty* mpScaleProperty = nullptr;
     CBoolProperty* mpActiveProperty = nullptr;
     CStructProperty* mpLightParametersProperty = nullptr;
+    CIntProperty* mpLightLayerProperty = nullptr;
+    IProperty* mpWorldLightingOptionsProperty = nullptr;
+    IProperty* mpVolumeConditionProperty = nullptr;
 
     struct SVolumeCondition {
         uint32 Value;
@@ -142,6 +146,7 @@ public:
     float VolumeScale(CScriptObject *pObj);
     CResource* FindDisplayAsset(void* pPropertyData, uint32& rOutCharIndex, uint32& rOutAnimIndex, bool& rOutIsInGame);
     CCollisionMeshGroup* FindCollision(void* pPropertyData);
+    CResourceEntry* FindParticle(void* pPropertyData);
 
     // Accessors
     CGameTemplate* GameTemplate() const              { return mpGame; }
@@ -163,6 +168,8 @@ public:
     CVectorProperty* ScaleProperty() const               { return mpScaleProperty; }
     CBoolProperty* ActiveProperty() const                { return mpActiveProperty; }
     CStructProperty* LightParametersProperty() const     { return mpLightParametersProperty; }
+    CIntProperty* LightLayerProperty() const             { return mpLightLayerProperty; }
+    IProperty* WorldLightingOptionsProperty() const      { return mpWorldLightingOptionsProperty; }
 
     void SetVisible(bool Visible)    { mVisible = Visible; }
     void MarkDirty()                 { mDirty = true; }
@@ -176,6 +183,7 @@ public:
     void SortObjects();
 
 private:
+    void ResolvePropertyBindings();
     int32 CheckVolumeConditions(CScriptObject *pObj, bool LogErrors);
 };
 
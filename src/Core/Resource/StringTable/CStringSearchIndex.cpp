@@ -0,0 +1,344 @@
+#include "CStringSearchIndex.h"
+#include "CStringTable.h"
+#include "Core/GameProject/CResourceEntry.h"
+#include "Core/GameProject/CResourceIterator.h"
+#include "Core/Resource/Factory/CStringLoader.h"
+#include <Common/FileIO.h>
+#include <Common/Log.h>
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <memory>
+
+CStringSearchIndex::~CStringSearchIndex()
+{
+    Clear();
+}
+
+/** Discard the current contents and start indexing every STRG in the store in the background */
+void CStringSearchIndex::Build(CResourceStore *pStore)
+{
+    Clear();
+
+    if (!pStore)
+        return;
+
+    // Gather file paths up front; the worker never touches the store itself
+    std::vector<SBuildSource> Sources;
+
+    for (TResourceIterator<EResourceType::StringTable> It(pStore); It; ++It)
+    {
+        if (It->IsMarkedForDeletion())
+            continue;
+
+        SBuildSource Source;
+        Source.pEntry = *It;
+        Source.AssetID = It->ID();
+        Source.RawPath = It->HasRawVersion() ? It->RawAssetPath() : "";
+        Source.CookedPath = It->HasCookedVersion() ? It->CookedAssetPath() : "";
+        Sources.push_back(std::move(Source));
+    }
+
+    mBuilding = true;
+    mBuildThread = std::thread(&CStringSearchIndex::RunBuild, this, std::move(Sources));
+}
+
+/** Cancel any running build and discard the index */
+void CStringSearchIndex::Clear()
+{
+    if (mBuildThread.joinable())
+    {
+        mCancelBuild = true;
+        mBuildThread.join();
+        mCancelBuild = false;
+    }
+
+    std::lock_guard<std::mutex> Lock(mMutex);
+    mData = SIndexData();
+    mPendingUpdates.clear();
+    mBuilding = false;
+}
+
+/** Re-index a single table; call after the table has been modified and saved */
+void CStringSearchIndex::UpdateTable(const CStringTable& rkTable)
+{
+    STableStrings Table = ExtractStrings(rkTable.ID(), rkTable);
+    std::lock_guard<std::mutex> Lock(mMutex);
+
+    // A running build may have read the old file; reapply the update once it finishes
+    if (mBuilding)
+        mPendingUpdates[Table.AssetID] = Table;
+
+    AddTable(mData, std::move(Table));
+}
+
+/** Find all strings containing the query as a phrase */
+std::vector<SStringSearchMatch> CStringSearchIndex::Search(const TString& rkQuery, ELanguage Language, uint32 MaxResults) const
+{
+    std::vector<SStringSearchMatch> Out;
+    const std::string Query = Normalize(rkQuery);
+
+    if (Query.empty() || MaxResults == 0)
+        return Out;
+
+    std::vector<std::string> Tokens;
+
+    for (size_t Start = 0; Start < Query.size();)
+    {
+        const size_t End = std::min(Query.find(' ', Start), Query.size());
+        Tokens.push_back(Query.substr(Start, End - Start));
+        Start = End + 1;
+    }
+
+    std::lock_guard<std::mutex> Lock(mMutex);
+
+    // The last word is still being typed, so take the union of every token it's a prefix of
+    const std::string& rkLastToken = Tokens.back();
+    std::vector<uint32> Candidates;
+
+    for (auto It = mData.Postings.lower_bound(rkLastToken);
+         It != mData.Postings.end() && It->first.compare(0, rkLastToken.size(), rkLastToken) == 0;
+         ++It)
+    {
+        Candidates.insert(Candidates.end(), It->second.begin(), It->second.end());
+    }
+
+    std::sort(Candidates.begin(), Candidates.end());
+    Candidates.erase(std::unique(Candidates.begin(), Candidates.end()), Candidates.end());
+
+    // Every other word must match exactly
+    for (size_t TokenIdx = 0; TokenIdx + 1 < Tokens.size() && !Candidates.empty(); TokenIdx++)
+    {
+        const auto It = mData.Postings.find(Tokens[TokenIdx]);
+
+        if (It == mData.Postings.end())
+            return Out;
+
+        std::vector<uint32> Intersection;
+        std::set_intersection(Candidates.begin(), Candidates.end(), It->second.begin(), It->second.end(),
+                              std::back_inserter(Intersection));
+        Candidates = std::move(Intersection);
+    }
+
+    // Postings don't record word positions, so multi-word queries are verified against the string text
+    const std::string Phrase = ' ' + Query;
+
+    for (const uint32 StringIdx : Candidates)
+    {
+        const SIndexedString& rkString = mData.Strings[StringIdx];
+
+        if (mData.StaleTables[rkString.TableSlot])
+            continue;
+
+        if (Language != ELanguage::Invalid && rkString.Language != Language)
+            continue;
+
+        if (Tokens.size() > 1 && (' ' + rkString.Text).find(Phrase) == std::string::npos)
+            continue;
+
+        Out.push_back({mData.Tables[rkString.TableSlot], rkString.Language, rkString.StringIndex});
+
+        if (Out.size() >= MaxResults)
+            break;
+    }
+
+    return Out;
+}
+
+// ************ PRIVATE ************
+void CStringSearchIndex::RunBuild(std::vector<SBuildSource> Sources)
+{
+    SIndexData Data;
+
+    for (const SBuildSource& rkSource : Sources)
+    {
+        if (mCancelBuild)
+            return;
+
+        // Prefer the raw version, same as CResourceEntry::Load
+        std::unique_ptr<CStringTable> pTable;
+
+        if (!rkSource.RawPath.IsEmpty())
+        {
+            pTable = std::make_unique<CStringTable>(rkSource.pEntry);
+
+            if (!CResourceEntry::ReadRawAsset(rkSource.RawPath, *pTable))
+                pTable.reset();
+        }
+
+        if (!pTable && !rkSource.CookedPath.IsEmpty())
+        {
+            CFileInStream File(rkSource.CookedPath, EEndian::BigEndian);
+            pTable = CStringLoader::LoadSTRG(File, rkSource.pEntry);
+        }
+
+        if (!pTable)
+        {
+            warnf("Failed to index string table %s", *rkSource.AssetID.ToString());
+            continue;
+        }
+
+        AddTable(Data, ExtractStrings(rkSource.AssetID, *pTable));
+    }
+
+    std::lock_guard<std::mutex> Lock(mMutex);
+
+    for (auto& [ID, Table] : mPendingUpdates)
+        AddTable(Data, std::move(Table));
+
+    mPendingUpdates.clear();
+    mData = std::move(Data);
+    mBuilding = false;
+
+    debugf("Indexed %d strings from %d string tables", static_cast<int>(mData.Strings.size()), static_cast<int>(mData.Tables.size()));
+}
+
+CStringSearchIndex::STableStrings CStringSearchIndex::ExtractStrings(const CAssetID& rkID, const CStringTable& rkTable)
+{
+    STableStrings Out;
+    Out.AssetID = rkID;
+
+    for (size_t LangIdx = 0; LangIdx < rkTable.NumLanguages(); LangIdx++)
+    {
+        const ELanguage Language = rkTable.LanguageByIndex(LangIdx);
+
+        for (size_t StringIdx = 0; StringIdx < rkTable.NumStrings(); StringIdx++)
+        {
+            std::string Text = Normalize(rkTable.GetString(Language, StringIdx));
+
+            if (!Text.empty())
+                Out.Strings.push_back({0, Language, static_cast<uint32>(StringIdx), std::move(Text)});
+        }
+    }
+
+    return Out;
+}
+
+void CStringSearchIndex::AddTable(SIndexData& rData, STableStrings Table)
+{
+    const auto Slot = static_cast<uint32>(rData.Tables.size());
+    const auto SlotIt = rData.TableSlots.find(Table.AssetID);
+
+    if (SlotIt != rData.TableSlots.end())
+    {
+        RemoveTableSlot(rData, SlotIt->second);
+        SlotIt->second = Slot;
+    }
+    else
+    {
+        rData.TableSlots.emplace(Table.AssetID, Slot);
+    }
+
+    const auto FirstString = static_cast<uint32>(rData.Strings.size());
+    rData.Tables.push_back(Table.AssetID);
+    rData.TableStringRanges.emplace_back(FirstString, FirstString + static_cast<uint32>(Table.Strings.size()));
+    rData.StaleTables.push_back(false);
+
+    for (SIndexedString& rString : Table.Strings)
+    {
+        const auto StringIdx = static_cast<uint32>(rData.Strings.size());
+        rString.TableSlot = Slot;
+
+        for (size_t Start = 0; Start < rString.Text.size();)
+        {
+            const size_t End = std::min(rString.Text.find(' ', Start), rString.Text.size());
+            std::vector<uint32>& rPostings = rData.Postings[rString.Text.substr(Start, End - Start)];
+
+            if (rPostings.empty() || rPostings.back() != StringIdx)
+                rPostings.push_back(StringIdx);
+
+            Start = End + 1;
+        }
+
+        rData.Strings.push_back(std::move(rString));
+    }
+
+    // Tables that keep getting edited would otherwise grow the index without bound
+    if (rData.NumStaleStrings > rData.Strings.size() / 2)
+        Compact(rData);
+}
+
+void CStringSearchIndex::RemoveTableSlot(SIndexData& rData, uint32 Slot)
+{
+    rData.StaleTables[Slot] = true;
+    const auto [Begin, End] = rData.TableStringRanges[Slot];
+
+    for (uint32 StringIdx = Begin; StringIdx < End; StringIdx++)
+    {
+        SIndexedString& rString = rData.Strings[StringIdx];
+
+        for (size_t Start = 0; Start < rString.Text.size();)
+        {
+            const size_t TokenEnd = std::min(rString.Text.find(' ', Start), rString.Text.size());
+            const auto PostingsIt = rData.Postings.find(rString.Text.substr(Start, TokenEnd - Start));
+
+            if (PostingsIt != rData.Postings.end())
+            {
+                std::vector<uint32>& rPostings = PostingsIt->second;
+                const auto It = std::lower_bound(rPostings.begin(), rPostings.end(), StringIdx);
+
+                if (It != rPostings.end() && *It == StringIdx)
+                    rPostings.erase(It);
+
+                if (rPostings.empty())
+                    rData.Postings.erase(PostingsIt);
+            }
+
+            Start = TokenEnd + 1;
+        }
+
+        std::string().swap(rString.Text);
+    }
+
+    rData.NumStaleStrings += End - Begin;
+}
+
+void CStringSearchIndex::Compact(SIndexData& rData)
+{
+    // Re-adding the live tables to an empty index renumbers the strings and slots without the stale ones
+    SIndexData Compacted;
+
+    for (uint32 Slot = 0; Slot < rData.Tables.size(); Slot++)
+    {
+        if (rData.StaleTables[Slot])
+            continue;
+
+        STableStrings Table;
+        Table.AssetID = rData.Tables[Slot];
+        const auto [Begin, End] = rData.TableStringRanges[Slot];
+        Table.Strings.reserve(End - Begin);
+        std::move(rData.Strings.begin() + Begin, rData.Strings.begin() + End, std::back_inserter(Table.Strings));
+        AddTable(Compacted, std::move(Table));
+    }
+
+    rData = std::move(Compacted);
+}
+
+std::string CStringSearchIndex::Normalize(const TString& rkString)
+{
+    const TString Stripped = CStringTable::StripFormatting(rkString);
+    std::string Out;
+    Out.reserve(Stripped.Size());
+    bool InToken = false;
+
+    for (uint32 CharIdx = 0; CharIdx < Stripped.Size(); CharIdx++)
+    {
+        const auto Char = static_cast<uint8>(Stripped[CharIdx]);
+
+        // Bytes of UTF-8 sequences are treated as word characters; only ASCII is case-folded
+        if (Char >= 0x80 || std::isalnum(Char))
+        {
+            if (!InToken && !Out.empty())
+                Out += ' ';
+
+            Out += static_cast<char>(Char < 0x80 ? std::tolower(Char) : Char);
+            InToken = true;
+        }
+        else
+        {
+            InToken = false;
+        }
+    }
+
+    return Out;
+}
@@ -0,0 +1,121 @@
+#ifndef CSTRINGSEARCHINDEX_H
+#define CSTRINGSEARCHINDEX_H
+
+#include "ELanguage.h"
+#include <Common/BasicTypes.h>
+#include <Common/CAssetID.h>
+#include <Common/TString.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CResourceEntry;
+class CResourceStore;
+class CStringTable;
+
+/** One string matched by a string index search */
+struct SStringSearchMatch
+{
+    CAssetID AssetID;
+    ELanguage Language;
+    uint32 StringIndex;
+};
+
+/**
+ * Project-wide full-text index over every STRG asset. Strings are stripped of formatting tags,
+ * case-folded and split into word tokens; each token maps to the list of language/string pairs
+ * that contain it. The index is built on a worker thread directly from the asset files so that
+ * no string tables need to be loaded into the resource store. Queries return nothing until
+ * the build finishes.
+ */
+class CStringSearchIndex
+{
+    /** A single indexed string with its normalized search text */
+    struct SIndexedString
+    {
+        uint32 TableSlot;
+        ELanguage Language;
+        uint32 StringIndex;
+        std::string Text; // Space-separated case-folded tokens
+    };
+
+    /** Indexed strings of one table, extracted before they're merged into the index */
+    struct STableStrings
+    {
+        CAssetID AssetID;
+        std::vector<SIndexedString> Strings;
+    };
+
+    struct SIndexData
+    {
+        /**
+         * Asset ID and range in Strings per table slot. Slots replaced by an update are marked stale and
+         * their strings dropped from the postings; they're only erased once enough of them pile up.
+         */
+        std::vector<CAssetID> Tables;
+        std::vector<std::pair<uint32, uint32>> TableStringRanges;
+        std::vector<bool> StaleTables;
+        std::map<CAssetID, uint32> TableSlots;
+        std::vector<SIndexedString> Strings;
+        uint32 NumStaleStrings = 0;
+
+        /** Token -> ascending indices into Strings */
+        std::map<std::string, std::vector<uint32>> Postings;
+    };
+
+    /** Location of a STRG asset on disk, gathered on the main thread before the build starts */
+    struct SBuildSource
+    {
+        CResourceEntry *pEntry;
+        CAssetID AssetID;
+        TString RawPath;
+        TString CookedPath;
+    };
+
+    SIndexData mData;
+    std::map<CAssetID, STableStrings> mPendingUpdates;
+    mutable std::mutex mMutex;
+
+    std::thread mBuildThread;
+    std::atomic<bool> mBuilding{false};
+    std::atomic<bool> mCancelBuild{false};
+
+    void RunBuild(std::vector<SBuildSource> Sources);
+
+    static STableStrings ExtractStrings(const CAssetID& rkID, const CStringTable& rkTable);
+    static void AddTable(SIndexData& rData, STableStrings Table);
+    static void RemoveTableSlot(SIndexData& rData, uint32 Slot);
+    static void Compact(SIndexData& rData);
+    static std::string Normalize(const TString& rkString);
+
+public:
+    CStringSearchIndex() = default;
+    ~CStringSearchIndex();
+
+    CStringSearchIndex(const CStringSearchIndex&) = delete;
+    CStringSearchIndex& operator=(const CStringSearchIndex&) = delete;
+
+    /** Discard the current contents and start indexing every STRG in the store in the background */
+    void Build(CResourceStore *pStore);
+
+    /** Cancel any running build and discard the index */
+    void Clear();
+
+    /** Re-index a single table; call after the table has been modified and saved */
+    void UpdateTable(const CStringTable& rkTable);
+
+    /**
+     * Find all strings containing the query as a phrase. Every query word except the last must
+     * match a whole word; the last is matched as a prefix, so results update sensibly while typing.
+     * Pass ELanguage::Invalid to search all languages.
+     */
+    std::vector<SStringSearchMatch> Search(const TString& rkQuery, ELanguage Language = ELanguage::Invalid,
+                                           uint32 MaxResults = UINT32_MAX) const;
+
+    bool IsBuilding() const     { return mBuilding; }
+};
+
+#endif // CSTRINGSEARCHINDEX_H
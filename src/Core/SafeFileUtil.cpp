@@ -0,0 +1,34 @@
+#include "SafeFileUtil.h"
+#include <Common/FileUtil.h>
+#include <Common/Log.h>
+
+namespace SafeFileUtil
+{
+
+bool ReplaceFile(const TString& rkNewPath, const TString& rkPath)
+{
+    if (!FileUtil::Exists(rkPath))
+        return FileUtil::MoveFile(rkNewPath, rkPath);
+
+    // A backup left behind by an earlier replace that was interrupted is stale by now
+    const TString BackupPath = rkPath + ".bak";
+
+    if (FileUtil::Exists(BackupPath))
+        FileUtil::DeleteFile(BackupPath);
+
+    if (!FileUtil::MoveFile(rkPath, BackupPath))
+        return false;
+
+    if (!FileUtil::MoveFile(rkNewPath, rkPath))
+    {
+        if (!FileUtil::MoveFile(BackupPath, rkPath))
+            errorf("Unable to restore %s; the previous version was left at %s", *rkPath, *BackupPath);
+
+        return false;
+    }
+
+    FileUtil::DeleteFile(BackupPath);
+    return true;
+}
+
+}
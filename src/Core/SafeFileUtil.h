@@ -0,0 +1,16 @@
+#ifndef SAFEFILEUTIL_H
+#define SAFEFILEUTIL_H
+
+#include <Common/TString.h>
+
+namespace SafeFileUtil
+{
+    /**
+     * Moves a freshly written file over an existing one. The existing file is moved aside rather than
+     * deleted until the new one is in place, and is put back if that fails, so a failed replace never
+     * leaves neither version on disk. Returns false if the new file couldn't be moved into place.
+     */
+    bool ReplaceFile(const TString& rkNewPath, const TString& rkPath);
+}
+
+#endif // SAFEFILEUTIL_H
@@ -0,0 +1,283 @@
+#include "CAreaLightGrid.h"
+#include "Core/Resource/Area/CGameArea.h"
+#include "Core/Resource/CLight.h"
+#include <Common/Math/MathUtil.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+
+/** Maximum number of cells along each axis of a layer grid */
+constexpr int32 kMaxCellsPerAxis = 32;
+
+/** Lights whose bounds span more than this many cells are tested globally instead of binned */
+constexpr uint64 kMaxCellsPerLight = 512;
+
+std::array<float, 3> Components(const CVector3f& rkVec)
+{
+    return { rkVec.X, rkVec.Y, rkVec.Z };
+}
+
+/** Convert a grid-space coordinate to a cell index on an axis with NumCells cells */
+int32 CellCoord(float Coord, int32 NumCells)
+{
+    const float Clamped = std::clamp(Coord, 0.f, static_cast<float>(NumCells - 1));
+    return static_cast<int32>(std::floor(Clamped));
+}
+
+}
+
+void CAreaLightGrid::Build(CGameArea *pArea)
+{
+    Clear();
+    mpArea = pArea;
+
+    if (!mpArea)
+        return;
+
+    mLayers.resize(mpArea->NumLightLayers());
+
+    for (size_t LayerIdx = 0; LayerIdx < mLayers.size(); LayerIdx++)
+        RebuildLayer(LayerIdx);
+}
+
+void CAreaLightGrid::RebuildLayer(size_t LayerIndex)
+{
+    if (!mpArea || LayerIndex >= mLayers.size())
+        return;
+
+    SLayerGrid& rLayer = mLayers[LayerIndex];
+    rLayer = SLayerGrid();
+    rLayer.NumLights = static_cast<uint32>(mpArea->NumLights(LayerIndex));
+
+    // Default ambient color to white if there are no lights on the layer
+    rLayer.AmbientColor = (rLayer.NumLights == 0 ? CColor::TransparentWhite() : CColor::TransparentBlack());
+
+    // Gather light data. GetRadius() updates a cache on the light, so this must happen here rather than during queries.
+    CVector3f BoundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    CVector3f BoundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    std::vector<uint32> BinnedLights;
+
+    for (uint32 LightIdx = 0; LightIdx < rLayer.NumLights; LightIdx++)
+    {
+        CLight *pLight = mpArea->Light(LayerIndex, LightIdx);
+
+        if (pLight->Type() == ELightType::LocalAmbient)
+        {
+            rLayer.AmbientColor = pLight->Color();
+            continue;
+        }
+
+        const SGridLight Light{ pLight, pLight->Position(), pLight->GetRadius() };
+        const uint32 Index = static_cast<uint32>(rLayer.Lights.size());
+        rLayer.Lights.push_back(Light);
+
+        if (!std::isfinite(Light.Radius) || Light.Radius >= FLT_MAX * 0.5f)
+        {
+            rLayer.GlobalLights.push_back(Index);
+            continue;
+        }
+
+        BinnedLights.push_back(Index);
+        BoundsMin.X = Math::Min(BoundsMin.X, Light.Position.X - Light.Radius);
+        BoundsMin.Y = Math::Min(BoundsMin.Y, Light.Position.Y - Light.Radius);
+        BoundsMin.Z = Math::Min(BoundsMin.Z, Light.Position.Z - Light.Radius);
+        BoundsMax.X = Math::Max(BoundsMax.X, Light.Position.X + Light.Radius);
+        BoundsMax.Y = Math::Max(BoundsMax.Y, Light.Position.Y + Light.Radius);
+        BoundsMax.Z = Math::Max(BoundsMax.Z, Light.Position.Z + Light.Radius);
+    }
+
+    if (BinnedLights.empty())
+        return;
+
+    // Size the grid so the longest axis has at most kMaxCellsPerAxis cells
+    const CVector3f Extent = BoundsMax - BoundsMin;
+    const float LongestAxis = Math::Max(Extent.X, Math::Max(Extent.Y, Extent.Z));
+    rLayer.GridMin = BoundsMin;
+    rLayer.CellSize = Math::Max(LongestAxis / kMaxCellsPerAxis, 1.f);
+
+    const std::array<float, 3> ExtentAxes = Components(Extent);
+    const std::array<float, 3> GridMin = Components(rLayer.GridMin);
+
+    for (int32 Axis = 0; Axis < 3; Axis++)
+    {
+        const int32 NumCells = static_cast<int32>(std::ceil(ExtentAxes[Axis] / rLayer.CellSize));
+        rLayer.Dims[Axis] = std::clamp(NumCells, 1, kMaxCellsPerAxis);
+    }
+
+    const size_t NumCells = static_cast<size_t>(rLayer.Dims[0]) * rLayer.Dims[1] * rLayer.Dims[2];
+
+    // Find the cell range covered by each light, pulling out lights that cover too much of the grid
+    struct SCellRange { std::array<int32, 3> Min, Max; };
+    std::vector<SCellRange> Ranges(rLayer.Lights.size());
+    std::vector<uint32> CellCounts(NumCells, 0);
+
+    auto CellIndex = [&rLayer](int32 X, int32 Y, int32 Z) -> size_t
+    {
+        return (static_cast<size_t>(Z) * rLayer.Dims[1] + Y) * rLayer.Dims[0] + X;
+    };
+
+    auto ForEachCell = [](const SCellRange& rkRange, auto&& Func)
+    {
+        for (int32 Z = rkRange.Min[2]; Z <= rkRange.Max[2]; Z++)
+            for (int32 Y = rkRange.Min[1]; Y <= rkRange.Max[1]; Y++)
+                for (int32 X = rkRange.Min[0]; X <= rkRange.Max[0]; X++)
+                    Func(X, Y, Z);
+    };
+
+    std::vector<uint32> GridLights;
+    GridLights.reserve(BinnedLights.size());
+
+    for (const uint32 LightIdx : BinnedLights)
+    {
+        const SGridLight& rkLight = rLayer.Lights[LightIdx];
+        const std::array<float, 3> Center = Components(rkLight.Position);
+        SCellRange& rRange = Ranges[LightIdx];
+        uint64 NumCovered = 1;
+
+        for (int32 Axis = 0; Axis < 3; Axis++)
+        {
+            const float Lo = (Center[Axis] - rkLight.Radius - GridMin[Axis]) / rLayer.CellSize;
+            const float Hi = (Center[Axis] + rkLight.Radius - GridMin[Axis]) / rLayer.CellSize;
+            rRange.Min[Axis] = CellCoord(Lo, rLayer.Dims[Axis]);
+            rRange.Max[Axis] = CellCoord(Hi, rLayer.Dims[Axis]);
+            NumCovered *= static_cast<uint64>(rRange.Max[Axis] - rRange.Min[Axis] + 1);
+        }
+
+        if (NumCovered > kMaxCellsPerLight)
+        {
+            rLayer.GlobalLights.push_back(LightIdx);
+            continue;
+        }
+
+        ForEachCell(rRange, [&](int32 X, int32 Y, int32 Z) { CellCounts[CellIndex(X, Y, Z)]++; });
+        GridLights.push_back(LightIdx);
+    }
+
+    // Pack cell contents into one array
+    rLayer.CellOffsets.resize(NumCells + 1);
+    uint32 Total = 0;
+
+    for (size_t CellIdx = 0; CellIdx < NumCells; CellIdx++)
+    {
+        rLayer.CellOffsets[CellIdx] = Total;
+        Total += CellCounts[CellIdx];
+    }
+
+    rLayer.CellOffsets[NumCells] = Total;
+    rLayer.CellLights.resize(Total);
+
+    for (const uint32 LightIdx : GridLights)
+    {
+        ForEachCell(Ranges[LightIdx], [&](int32 X, int32 Y, int32 Z)
+        {
+            const size_t CellIdx = CellIndex(X, Y, Z);
+            const uint32 Slot = rLayer.CellOffsets[CellIdx + 1] - CellCounts[CellIdx]--;
+            rLayer.CellLights[Slot] = LightIdx;
+        });
+    }
+
+    std::sort(rLayer.GlobalLights.begin(), rLayer.GlobalLights.end());
+}
+
+void CAreaLightGrid::Clear()
+{
+    mpArea = nullptr;
+    mLayers.clear();
+}
+
+size_t CAreaLightGrid::EffectiveLayer(size_t LayerIndex) const
+{
+    if (mLayers.size() <= LayerIndex || mLayers[LayerIndex].NumLights == 0)
+        return 0;
+
+    return LayerIndex;
+}
+
+void CAreaLightGrid::FindLights(size_t LayerIndex, const CAABox& rkBounds, const CVector3f& rkPosition, SNodeLightList& rOut) const
+{
+    rOut.NumLights = 0;
+    rOut.AmbientColor = CColor::TransparentWhite();
+
+    if (mLayers.empty())
+        return;
+
+    const SLayerGrid& rkLayer = mLayers[EffectiveLayer(LayerIndex)];
+    rOut.AmbientColor = rkLayer.AmbientColor;
+
+    if (rkLayer.Lights.empty())
+        return;
+
+    // Collect candidates; light indices follow layer order so ties sort the same way as a full scan
+    std::vector<uint32> Candidates(rkLayer.GlobalLights);
+
+    if (!rkLayer.CellOffsets.empty())
+    {
+        const std::array<float, 3> BoundsMin = Components(rkBounds.Min());
+        const std::array<float, 3> BoundsMax = Components(rkBounds.Max());
+        const std::array<float, 3> GridMin = Components(rkLayer.GridMin);
+        std::array<int32, 3> Min, Max;
+        bool Overlaps = true;
+
+        for (int32 Axis = 0; Axis < 3 && Overlaps; Axis++)
+        {
+            const float Lo = (BoundsMin[Axis] - GridMin[Axis]) / rkLayer.CellSize;
+            const float Hi = (BoundsMax[Axis] - GridMin[Axis]) / rkLayer.CellSize;
+            Overlaps = (Hi >= 0.f && Lo < static_cast<float>(rkLayer.Dims[Axis]));
+            Min[Axis] = CellCoord(Lo, rkLayer.Dims[Axis]);
+            Max[Axis] = CellCoord(Hi, rkLayer.Dims[Axis]);
+        }
+
+        if (Overlaps)
+        {
+            for (int32 Z = Min[2]; Z <= Max[2]; Z++)
+            {
+                for (int32 Y = Min[1]; Y <= Max[1]; Y++)
+                {
+                    for (int32 X = Min[0]; X <= Max[0]; X++)
+                    {
+                        const size_t CellIdx = (static_cast<size_t>(Z) * rkLayer.Dims[1] + Y) * rkLayer.Dims[0] + X;
+                        Candidates.insert(Candidates.end(),
+                                          rkLayer.CellLights.begin() + rkLayer.CellOffsets[CellIdx],
+                                          rkLayer.CellLights.begin() + rkLayer.CellOffsets[CellIdx + 1]);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(Candidates.begin(), Candidates.end());
+    Candidates.erase(std::unique(Candidates.begin(), Candidates.end()), Candidates.end());
+
+    struct SLightEntry
+    {
+        uint32 Index;
+        float Distance;
+
+        bool operator<(const SLightEntry& rkOther) const
+        {
+            return (Distance < rkOther.Distance) || (Distance == rkOther.Distance && Index < rkOther.Index);
+        }
+    };
+
+    std::vector<SLightEntry> LightEntries;
+    LightEntries.reserve(Candidates.size());
+
+    for (const uint32 LightIdx : Candidates)
+    {
+        const SGridLight& rkLight = rkLayer.Lights[LightIdx];
+
+        if (rkBounds.IntersectsSphere(rkLight.Position, rkLight.Radius))
+            LightEntries.push_back(SLightEntry{ LightIdx, rkPosition.Distance(rkLight.Position) });
+    }
+
+    // Determine which lights are closest
+    const size_t NumClosest = Math::Min<size_t>(LightEntries.size(), rOut.Lights.size());
+    std::partial_sort(LightEntries.begin(), LightEntries.begin() + NumClosest, LightEntries.end());
+    rOut.NumLights = static_cast<uint32>(NumClosest);
+
+    for (uint32 iLight = 0; iLight < rOut.NumLights; iLight++)
+        rOut.Lights[iLight] = rkLayer.Lights[LightEntries[iLight].Index].pLight;
+}
@@ -0,0 +1,68 @@
+#ifndef CAREALIGHTGRID_H
+#define CAREALIGHTGRID_H
+
+#include <Common/BasicTypes.h>
+#include <Common/CColor.h>
+#include <Common/Math/CAABox.h>
+#include <Common/Math/CVector3f.h>
+#include <array>
+#include <vector>
+
+class CGameArea;
+class CLight;
+
+/** Lights selected for a single scene node */
+struct SNodeLightList
+{
+    std::array<CLight*, 8> Lights{};
+    uint32 NumLights = 0;
+    CColor AmbientColor;
+};
+
+/**
+ * Uniform grid over the influence spheres of an area's lights, one grid per light layer.
+ * Lets scene nodes find the lights that reach them without testing every light in the layer.
+ * Light positions and radii are copied in when the grid is built, so queries are read-only
+ * and can run on several threads at once.
+ */
+class CAreaLightGrid
+{
+    struct SGridLight
+    {
+        CLight *pLight;
+        CVector3f Position;
+        float Radius;
+    };
+
+    struct SLayerGrid
+    {
+        uint32 NumLights = 0;
+        CColor AmbientColor;
+        std::vector<SGridLight> Lights;     // Every non-ambient light in the layer
+        std::vector<uint32> GlobalLights;   // Lights too large to be worth binning; tested by every query
+
+        CVector3f GridMin;
+        float CellSize = 1.f;
+        std::array<int32, 3> Dims{};
+        std::vector<uint32> CellOffsets;    // Start of each cell's run in CellLights; one extra entry at the end
+        std::vector<uint32> CellLights;
+    };
+
+    CGameArea *mpArea = nullptr;
+    std::vector<SLayerGrid> mLayers;
+
+public:
+    void Build(CGameArea *pArea);
+    void RebuildLayer(size_t LayerIndex);
+    void Clear();
+
+    /** Returns the layer that nodes assigned to LayerIndex actually take their lights from */
+    size_t EffectiveLayer(size_t LayerIndex) const;
+
+    /** Find the ambient color and up to eight closest lights reaching the given bounds */
+    void FindLights(size_t LayerIndex, const CAABox& rkBounds, const CVector3f& rkPosition, SNodeLightList& rOut) const;
+
+    bool IsBuilt() const { return mpArea != nullptr; }
+};
+
+#endif // CAREALIGHTGRID_H
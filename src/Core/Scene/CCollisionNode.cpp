@@ -102,7 +102,7 @@ void CCollisionNode::Draw(FRenderOptions /*Options*/, int /*ComponentIndex*/, ER
     {
         if (Parent() && Parent()->NodeType() == ENodeType::Root && Game != EGame::DKCReturns)
         {
-            CDrawUtil::DrawWireCube(mpCollision->MeshByIndex(0)->Bounds(), CColor::Red());
+            CDrawUtil::QueueWireCube(mpCollision->MeshByIndex(0)->Bounds(), CColor::Red());
         }
     }
 }
@@ -1,4 +1,5 @@
 #include "CLightNode.h"
+#include "CScene.h"
 #include "Core/Render/CDrawUtil.h"
 #include "Core/Render/CGraphics.h"
 #include "Core/Render/CRenderer.h"
@@ -140,6 +141,8 @@ void CLightNode::PropertyModified(IProperty* pProperty)
 
     if (pProperty->Name() == "Position")
         SetPosition( mpLight->Position() );
+
+    mpScene->OnLightModified(mpLight);
 }
 
 CVector2f CLightNode::BillboardScale() const
@@ -164,6 +164,14 @@ SRayIntersection CModelNode::RayNodeIntersectTest(const CRay& rkRay, uint32 Asse
     return Out;
 }
 
+bool CModelNode::GetRaySurfaceTest(uint32 AssetID, SRaySurfaceTest& rOut) const
+{
+    rOut.pkSurface = mpModel->GetSurface(AssetID);
+    rOut.Transform = Transform();
+    rOut.pOwner = mpModel.RawPointer();
+    return true;
+}
+
 CColor CModelNode::TintColor(const SViewInfo& /*rkViewInfo*/) const
 {
     return mTintColor;
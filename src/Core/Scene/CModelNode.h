@@ -24,6 +24,7 @@ public:
     void DrawSelection() override;
     void RayAABoxIntersectTest(CRayCollisionTester& Tester, const SViewInfo& rkViewInfo) override;
     SRayIntersection RayNodeIntersectTest(const CRay& Ray, uint32 AssetID, const SViewInfo& rkViewInfo) override;
+    bool GetRaySurfaceTest(uint32 AssetID, SRaySurfaceTest& rOut) const override;
     CColor TintColor(const SViewInfo& rkViewInfo) const override;
 
     // Setters
@@ -4,11 +4,13 @@
 #include "Core/Resource/CPoiToWorld.h"
 #include "Core/Resource/Script/CScriptLayer.h"
 #include "Core/CRayCollisionTester.h"
+#include "Core/NParallel.h"
 
 #include <Common/FileIO/CFileInStream.h>
 #include <Common/TString.h>
 #include <Common/Math/CRay.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
 
@@ -56,6 +58,7 @@ CModelNode* CScene::CreateModelNode(CModel *pModel, uint32 NodeID)
     mNodes[ENodeType::Model].push_back(pNode);
     mNodeMap.insert_or_assign(ID, pNode);
     mNumNodes++;
+    mRevision++;
     return pNode;
 }
 
@@ -69,6 +72,7 @@ CStaticNode* CScene::CreateStaticNode(CStaticModel *pModel, uint32 NodeID)
     mNodes[ENodeType::Static].push_back(pNode);
     mNodeMap.insert_or_assign(ID, pNode);
     mNumNodes++;
+    mRevision++;
     return pNode;
 }
 
@@ -82,6 +86,7 @@ CCollisionNode* CScene::CreateCollisionNode(CCollisionMeshGroup *pMesh, uint32 N
     mNodes[ENodeType::Collision].push_back(pNode);
     mNodeMap.insert_or_assign(ID, pNode);
     mNumNodes++;
+    mRevision++;
     return pNode;
 }
 
@@ -97,7 +102,8 @@ CScriptNode* CScene::CreateScriptNode(CScriptObject *pObj, uint32 NodeID)
     mNodes[ENodeType::Script].push_back(pNode);
     mNodeMap.insert_or_assign(ID, pNode);
     mScriptMap.insert_or_assign(InstanceID, pNode);
-    pNode->BuildLightList(mpArea);
+
+    MarkLightListDirty(pNode);
 
     // AreaAttributes check
     switch (pObj->ObjectTypeID())
@@ -109,6 +115,7 @@ CScriptNode* CScene::CreateScriptNode(CScriptObject *pObj, uint32 NodeID)
     }
 
     mNumNodes++;
+    mRevision++;
     return pNode;
 }
 
@@ -122,20 +129,30 @@ CLightNode* CScene::CreateLightNode(CLight *pLight, uint32 NodeID)
     mNodes[ENodeType::Light].push_back(pNode);
     mNodeMap.insert_or_assign(ID, pNode);
     mNumNodes++;
+    mRevision++;
     return pNode;
 }
 
 void CScene::DeleteNode(CSceneNode *pNode)
 {
+    WaitForAsyncRayCast();
+    mRevision++;
+
     const ENodeType Type = pNode->NodeType();
-    auto& nodeEntry = mNodes[Type];
 
-    for (auto it = nodeEntry.begin(); it != nodeEntry.end(); ++it)
+    // Inside a transaction, removing the node from its type list is deferred so a batch of deletes only
+    // needs one pass over the list. The node stays allocated until then so iterators can skip it.
+    if (mTransactionDepth == 0)
     {
-        if (*it == pNode)
+        auto& nodeEntry = mNodes[Type];
+
+        for (auto it = nodeEntry.begin(); it != nodeEntry.end(); ++it)
         {
-            nodeEntry.erase(it);
-            break;
+            if (*it == pNode)
+            {
+                nodeEntry.erase(it);
+                break;
+            }
         }
     }
 
@@ -166,8 +183,55 @@ void CScene::DeleteNode(CSceneNode *pNode)
     }
 
     pNode->Unparent();
-    delete pNode;
     mNumNodes--;
+    mDirtyLightLists.erase(pNode);
+
+    if (mTransactionDepth > 0)
+    {
+        // The node outlives its instance until the transaction ends
+        if (Type == ENodeType::Script)
+            static_cast<CScriptNode*>(pNode)->DetachInstance();
+
+        mPendingDeletes.push_back(pNode);
+        mPendingDeleteSet.insert(pNode);
+    }
+    else
+    {
+        delete pNode;
+    }
+}
+
+/**
+ * Start a batch of node creations/deletions. Until the outermost transaction ends, deleted nodes are
+ * only unlinked from the scene. Transactions can nest.
+ */
+void CScene::BeginTransaction()
+{
+    mTransactionDepth++;
+}
+
+void CScene::EndTransaction()
+{
+    ASSERT(mTransactionDepth > 0);
+
+    if (--mTransactionDepth > 0)
+        return;
+
+    if (!mPendingDeletes.empty())
+    {
+        for (auto& [Type, rNodes] : mNodes)
+        {
+            rNodes.erase(std::remove_if(rNodes.begin(), rNodes.end(), [this](CSceneNode *pNode) {
+                return mPendingDeleteSet.count(pNode) != 0;
+            }), rNodes.end());
+        }
+
+        for (CSceneNode *pNode : mPendingDeletes)
+            delete pNode;
+
+        mPendingDeletes.clear();
+        mPendingDeleteSet.clear();
+    }
 }
 
 void CScene::SetActiveArea(CWorld *pWorld, CGameArea *pArea)
@@ -179,6 +243,10 @@ void CScene::SetActiveArea(CWorld *pWorld, CGameArea *pArea)
     mpWorld = pWorld;
     mpArea = pArea;
     mpAreaRootNode = new CRootNode(this, UINT32_MAX, mpSceneRootNode);
+    mLightGrid.Build(mpArea);
+
+    // Light lists are built for all script nodes at once after they've been positioned
+    mDeferLightLists = true;
 
     // Create static nodes
     size_t Count = mpArea->NumStaticModels();
@@ -222,9 +290,11 @@ void CScene::SetActiveArea(CWorld *pWorld, CGameArea *pArea)
     {
         CScriptNode *pScript = static_cast<CScriptNode*>(*It);
         pScript->GeneratePosition();
-        pScript->BuildLightList(mpArea);
     }
 
+    mDeferLightLists = false;
+    UpdateLightLists();
+
     const size_t NumLightLayers = mpArea->NumLightLayers();
     CGraphics::sAreaAmbientColor = CColor::TransparentBlack();
 
@@ -255,6 +325,16 @@ void CScene::PostLoad()
 
 void CScene::ClearScene()
 {
+    WaitForAsyncRayCast();
+    mRevision++;
+
+    for (CSceneNode *pNode : mPendingDeletes)
+        delete pNode;
+
+    mPendingDeletes.clear();
+    mPendingDeleteSet.clear();
+    mDirtyLightLists.clear();
+
     if (mpAreaRootNode)
     {
         mpAreaRootNode->Unparent();
@@ -268,16 +348,107 @@ void CScene::ClearScene()
     mScriptMap.clear();
     mNumNodes = 0;
 
+    mLightGrid.Clear();
     mpArea = nullptr;
     mpWorld = nullptr;
 }
 
+void CScene::UpdateLightLists()
+{
+    const auto Iter = mNodes.find(ENodeType::Script);
+
+    if (Iter != mNodes.cend())
+        UpdateLightLists(Iter->second);
+}
+
+void CScene::UpdateLightLists(const std::vector<CSceneNode*>& rkNodes)
+{
+    if (!mLightGrid.IsBuilt())
+        return;
+
+    // Bounding boxes are calculated lazily and read parent transforms, so resolve them up front.
+    // After that, each node only writes to its own light list and the grid is read-only.
+    for (CSceneNode *pNode : rkNodes)
+        pNode->AABox();
+
+    NParallel::ParallelFor(rkNodes.size(), [&](size_t NodeIdx)
+    {
+        rkNodes[NodeIdx]->BuildLightList(mLightGrid);
+    });
+}
+
+/** Queue a node's light list to be rebuilt, so nodes that change several times per frame only rebuild once */
+void CScene::MarkLightListDirty(CSceneNode *pNode)
+{
+    // While an area is being set up, every light list is built in one go at the end
+    if (!mDeferLightLists)
+        mDirtyLightLists.insert(pNode);
+}
+
+void CScene::UpdateDirtyLightLists()
+{
+    if (mDirtyLightLists.empty())
+        return;
+
+    const std::vector<CSceneNode*> Nodes(mDirtyLightLists.begin(), mDirtyLightLists.end());
+    mDirtyLightLists.clear();
+    UpdateLightLists(Nodes);
+}
+
+void CScene::OnLightModified(CLight *pLight)
+{
+    if (!mpArea || !mLightGrid.IsBuilt())
+        return;
+
+    // Find which layer the light is on and rebuild only that layer
+    const size_t NumLightLayers = mpArea->NumLightLayers();
+
+    for (size_t iLyr = 0; iLyr < NumLightLayers; iLyr++)
+    {
+        const size_t NumLights = mpArea->NumLights(iLyr);
+
+        for (size_t iLit = 0; iLit < NumLights; iLit++)
+        {
+            if (mpArea->Light(iLyr, iLit) != pLight)
+                continue;
+
+            mLightGrid.RebuildLayer(iLyr);
+
+            // Only nodes that take their lights from this layer are affected
+            for (CSceneIterator It(this, ENodeType::Script, true); It; ++It)
+            {
+                if (mLightGrid.EffectiveLayer(It->LightLayerIndex()) == iLyr)
+                    MarkLightListDirty(*It);
+            }
+
+            return;
+        }
+    }
+}
+
+/** Advance everything in the scene that animates on its own, such as particle previews */
+void CScene::Tick(double Time)
+{
+    const auto Iter = mNodes.find(ENodeType::Script);
+
+    if (Iter == mNodes.cend())
+        return;
+
+    for (CSceneNode *pNode : Iter->second)
+    {
+        if (!IsNodePendingDelete(pNode))
+            static_cast<CScriptNode*>(pNode)->TickParticlePreview(Time);
+    }
+}
+
 void CScene::AddSceneToRenderer(CRenderer *pRenderer, const SViewInfo& rkViewInfo)
 {
     // Call PostLoad the first time the scene is rendered to ensure the OpenGL context has been created before it runs.
     if (!mRanPostLoad)
         PostLoad();
 
+    UpdateDirtyLightLists();
+
     // Override show flags in game mode
     const FShowFlags ShowFlags = rkViewInfo.GameMode ? gkGameModeShowFlags : rkViewInfo.ShowFlags;
     const FNodeFlags NodeFlags = NodeFlagsForShowFlags(ShowFlags);
@@ -304,6 +475,63 @@ SRayIntersection CScene::SceneRayCast(const CRay& rkRay, const SViewInfo& rkView
     return Tester.TestNodes(rkViewInfo);
 }
 
+/**
+ * Start a ray cast whose geometry tests run on a worker thread. The bounding box tests run immediately
+ * and the tester takes a snapshot of the transforms and surfaces it needs, so the scene can keep changing
+ * while the cast is in flight. Returns false if a previous async ray cast hasn't been collected yet.
+ */
+bool CScene::BeginAsyncRayCast(const CRay& rkRay, const SViewInfo& rkViewInfo)
+{
+    if (mAsyncRayCast.valid())
+        return false;
+
+    const FShowFlags ShowFlags = rkViewInfo.GameMode ? gkGameModeShowFlags : rkViewInfo.ShowFlags;
+    const FNodeFlags NodeFlags = NodeFlagsForShowFlags(ShowFlags);
+    mpAsyncRayTester = std::make_unique<CRayCollisionTester>(rkRay);
+
+    for (CSceneIterator It(this, NodeFlags, false); It; ++It)
+    {
+        if (It->IsVisible())
+            It->RayAABoxIntersectTest(*mpAsyncRayTester, rkViewInfo);
+    }
+
+    mpAsyncRayTester->CreateSnapshot(rkViewInfo);
+    mAsyncRayCastRevision = mRevision;
+
+    const CRayCollisionTester *pkTester = mpAsyncRayTester.get();
+    mAsyncRayCast = std::async(std::launch::async, [pkTester] { return pkTester->TestSnapshot(); });
+    return true;
+}
+
+/**
+ * Collect the result of the async ray cast if it has finished. Returns false if it's still running, or if
+ * the scene changed after it started; in that case the node pointers in the result can't be trusted.
+ */
+bool CScene::FinishAsyncRayCast(SRayIntersection& rOut)
+{
+    if (!mAsyncRayCast.valid() || mAsyncRayCast.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    const SRayIntersection Result = mAsyncRayCast.get();
+    mpAsyncRayTester.reset();
+
+    if (mAsyncRayCastRevision != mRevision)
+        return false;
+
+    rOut = Result;
+    return true;
+}
+
+void CScene::WaitForAsyncRayCast()
+{
+    if (!mAsyncRayCast.valid())
+        return;
+
+    mAsyncRayCast.wait();
+    mAsyncRayCast = std::future<SRayIntersection>();
+    mpAsyncRayTester.reset();
+}
+
 CSceneNode* CScene::NodeByID(uint32 NodeID)
 {
     const auto it = mNodeMap.find(NodeID);
@@ -2,6 +2,7 @@
 #define CSCENE_H
 
 #include "CSceneNode.h"
+#include "CAreaLightGrid.h"
 #include "CRootNode.h"
 #include "CLightNode.h"
 #include "CModelNode.h"
@@ -17,7 +18,10 @@
 #include "Core/SRayIntersection.h"
 #include <Common/BasicTypes.h>
 
+#include <future>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 /** Needs lots of changes, see CSceneNode for most of my thoughts on this */
@@ -36,6 +40,11 @@ class CScene
     TResPtr<CWorld> mpWorld;
     CRootNode *mpAreaRootNode = nullptr;
 
+    // Lighting
+    CAreaLightGrid mLightGrid;
+    bool mDeferLightLists = false;
+    std::unordered_set<CSceneNode*> mDirtyLightLists; // Rebuilt together before the scene is next rendered
+
     // Environment
     std::vector<CAreaAttributes> mAreaAttributesObjects;
 
@@ -43,6 +52,17 @@ class CScene
     std::unordered_map<uint32, CSceneNode*> mNodeMap;
     std::unordered_map<uint32, CScriptNode*> mScriptMap;
 
+    // Transactions
+    uint32 mTransactionDepth = 0;
+    std::vector<CSceneNode*> mPendingDeletes;
+    std::unordered_set<CSceneNode*> mPendingDeleteSet;
+
+    // Ray casts
+    uint32 mRevision = 0;
+    std::unique_ptr<CRayCollisionTester> mpAsyncRayTester;
+    std::future<SRayIntersection> mAsyncRayCast;
+    uint32 mAsyncRayCastRevision = 0;
+
 public:
     CScene();
     ~CScene();
@@ -57,17 +77,36 @@ public:
     CScriptNode* CreateScriptNode(CScriptObject *pObj, uint32 NodeID = UINT32_MAX);
     CLightNode* CreateLightNode(CLight *pLight, uint32 NodeID = UINT32_MAX);
     void DeleteNode(CSceneNode *pNode);
+    void BeginTransaction();
+    void EndTransaction();
     void SetActiveArea(CWorld *pWorld, CGameArea *pArea);
     void PostLoad();
     void ClearScene();
+    void UpdateLightLists();
+    void UpdateLightLists(const std::vector<CSceneNode*>& rkNodes);
+    void MarkLightListDirty(CSceneNode *pNode);
+    void UpdateDirtyLightLists();
+    void OnLightModified(CLight *pLight);
+    void Tick(double Time);
     void AddSceneToRenderer(CRenderer *pRenderer, const SViewInfo& rkViewInfo);
     SRayIntersection SceneRayCast(const CRay& rkRay, const SViewInfo& rkViewInfo);
+    bool BeginAsyncRayCast(const CRay& rkRay, const SViewInfo& rkViewInfo);
+    bool FinishAsyncRayCast(SRayIntersection& rOut);
+    void WaitForAsyncRayCast();
     CSceneNode* NodeByID(uint32 NodeID);
     CScriptNode* NodeForInstanceID(uint32 InstanceID);
     CScriptNode* NodeForInstance(CScriptObject *pObj);
     CLightNode* NodeForLight(CLight *pLight);
     CModel* ActiveSkybox();
     CGameArea* ActiveArea();
+    const CAreaLightGrid& LightGrid() const { return mLightGrid; }
+    bool IsAsyncRayCastPending() const      { return mAsyncRayCast.valid(); }
+    bool IsInTransaction() const            { return mTransactionDepth > 0; }
+    bool IsNodePendingDelete(CSceneNode *pNode) const { return !mPendingDeleteSet.empty() && mPendingDeleteSet.count(pNode) != 0; }
+
+    /** Incremented whenever something that can change the result of a ray cast changes, eg nodes moving or being hidden */
+    uint32 Revision() const                 { return mRevision; }
+    void IncrementRevision()                { mRevision++; }
 
     // Static
     static FShowFlags ShowFlagsForNodeFlags(FNodeFlags NodeFlags);
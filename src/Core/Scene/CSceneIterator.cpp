@@ -38,8 +38,8 @@ void CSceneIterator::InternalFindNext()
         {
             CSceneNode *pNode = *mVectorIterator;
 
-            // Check node visibility
-            if (mAllowHiddenNodes || pNode->IsVisible())
+            // Skip nodes deleted in the current transaction, then check node visibility
+            if (!mpScene->IsNodePendingDelete(pNode) && (mAllowHiddenNodes || pNode->IsVisible()))
             {
                 mpCurNode = pNode;
                 FoundNext = true;
@@ -1,8 +1,10 @@
 #include "CSceneNode.h"
+#include "CScene.h"
 #include "Core/GameProject/CResourceStore.h"
 #include "Core/Render/CRenderer.h"
 #include "Core/Render/CGraphics.h"
 #include "Core/Render/CDrawUtil.h"
+#include "CAreaLightGrid.h"
 #include "Core/Resource/Area/CGameArea.h"
 #include <Common/Macros.h>
 #include <Common/Math/CTransform4f.h>
@@ -33,7 +35,7 @@ CSceneNode::~CSceneNode()
 void CSceneNode::DrawSelection()
 {
     // Default implementation for virtual function
-    CDrawUtil::DrawWireCube(AABox(), CColor::White());
+    CDrawUtil::QueueWireCube(AABox(), CColor::White());
 }
 
 void CSceneNode::RayAABoxIntersectTest(CRayCollisionTester& rTester, const SViewInfo& /*rkViewInfo*/)
@@ -116,60 +118,14 @@ void CSceneNode::LoadModelMatrix()
     CGraphics::UpdateMVPBlock();
 }
 
-void CSceneNode::BuildLightList(CGameArea *pArea)
+void CSceneNode::BuildLightList(const CAreaLightGrid& rkLightGrid)
 {
-    mLightCount = 0;
-    mAmbientColor = CColor::TransparentBlack();
+    SNodeLightList LightList;
+    rkLightGrid.FindLights(mLightLayerIndex, AABox(), mPosition, LightList);
 
-    size_t Index = mLightLayerIndex;
-    if (pArea->NumLightLayers() <= Index || pArea->NumLights(Index) == 0)
-        Index = 0;
-
-    struct SLightEntry {
-        CLight *pLight;
-        float Distance;
-
-        SLightEntry(CLight *_pLight, float _Distance)
-            : pLight(_pLight), Distance(_Distance) {}
-
-        bool operator<(const SLightEntry& rkOther) const {
-            return (Distance < rkOther.Distance);
-        }
-    };
-    std::vector<SLightEntry> LightEntries;
-
-    // Default ambient color to white if there are no lights on the selected layer
-    const size_t NumLights = pArea->NumLights(Index);
-    if (NumLights == 0)
-        mAmbientColor = CColor::TransparentWhite();
-
-    for (size_t iLight = 0; iLight < NumLights; iLight++)
-    {
-        CLight* pLight = pArea->Light(Index, iLight);
-
-        // Ambient lights should only be present one per layer; need to check how the game deals with multiple ambients
-        if (pLight->Type() == ELightType::LocalAmbient)
-        {
-            mAmbientColor = pLight->Color();
-        }
-        else // Other lights will be used depending which are closest to the node
-        {
-            const bool IsInRange = AABox().IntersectsSphere(pLight->Position(), pLight->GetRadius());
-
-            if (IsInRange)
-            {
-                const float Dist = mPosition.Distance(pLight->Position());
-                LightEntries.push_back(SLightEntry(pLight, Dist));
-            }
-        }
-    }
-
-    // Determine which lights are closest
-    std::sort(LightEntries.begin(), LightEntries.end());
-    mLightCount = (LightEntries.size() > 8) ? 8 : LightEntries.size();
-
-    for (uint32 iLight = 0; iLight < mLightCount; iLight++)
-        mLights[iLight] = LightEntries[iLight].pLight;
+    mAmbientColor = LightList.AmbientColor;
+    mLightCount = LightList.NumLights;
+    mLights = LightList.Lights;
 }
 
 void CSceneNode::LoadLights(const SViewInfo& rkViewInfo)
@@ -246,7 +202,7 @@ void CSceneNode::DrawModelParts(CModel *pModel, FRenderOptions Options, size_t M
 
 void CSceneNode::DrawBoundingBox() const
 {
-    CDrawUtil::DrawWireCube(AABox(), CColor::White());
+    CDrawUtil::QueueWireCube(AABox(), CColor::White());
 }
 
 void CSceneNode::DrawRotationArrow() const
@@ -334,9 +290,20 @@ void CSceneNode::MarkTransformChanged() const
             child->MarkTransformChanged();
     }
 
+    if (mpScene)
+        mpScene->IncrementRevision();
+
     _mTransformDirty = true;
 }
 
+void CSceneNode::SetVisible(bool Visible)
+{
+    if (mVisible != Visible && mpScene)
+        mpScene->IncrementRevision();
+
+    mVisible = Visible;
+}
+
 const CTransform4f& CSceneNode::Transform() const
 {
     if (_mTransformDirty)
@@ -17,6 +17,7 @@
 #include <Common/Math/ETransformSpace.h>
 #include <array>
 
+class CAreaLightGrid;
 class CRenderer;
 class CScene;
 
@@ -111,6 +112,7 @@ public:
     void DrawSelection() override;
     virtual void RayAABoxIntersectTest(CRayCollisionTester& rTester, const SViewInfo& rkViewInfo);
     virtual SRayIntersection RayNodeIntersectTest(const CRay& rkRay, uint32 AssetID, const SViewInfo& rkViewInfo) = 0;
+    virtual bool GetRaySurfaceTest(uint32 /*AssetID*/, SRaySurfaceTest& /*rOut*/) const { return false; }
     virtual bool AllowsTranslate() const { return true; }
     virtual bool AllowsRotate() const { return true; }
     virtual bool AllowsScale() const { return true; }
@@ -126,7 +128,7 @@ public:
     void DeleteChildren();
     void SetInheritance(bool InheritPos, bool InheritRot, bool InheritScale);
     void LoadModelMatrix();
-    void BuildLightList(CGameArea *pArea);
+    void BuildLightList(const CAreaLightGrid& rkLightGrid);
     void LoadLights(const SViewInfo& rkViewInfo);
     void AddModelToRenderer(CRenderer *pRenderer, CModel *pModel, size_t MatSet);
     void DrawModelParts(CModel *pModel, FRenderOptions Options, size_t MatSet, ERenderCommand RenderCommand);
@@ -177,7 +179,7 @@ public:
     void SetLightLayerIndex(uint32 Index)           { mLightLayerIndex = Index; }
     void SetMouseHovering(bool Hovering)            { mMouseHovering = Hovering; }
     void SetSelected(bool Selected)                 { mSelected = Selected; }
-    void SetVisible(bool Visible)                   { mVisible = Visible; }
+    void SetVisible(bool Visible);
 
     // Static
     static int NumNodes() { return smNumNodes; }
@@ -38,6 +38,7 @@ CScriptNode::CScriptNode(CScene *pScene, uint32 NodeID, CSceneNode *pParent, CSc
         // Determine display assets
         SetDisplayAsset(mpInstance->DisplayAsset());
         mpCollisionNode->SetCollision(mpInstance->Collision());
+        UpdateParticlePreview();
 
         // Create preview volume node
         mpVolumePreviewNode = new CModelNode(pScene, -1, this, nullptr);
@@ -61,7 +62,7 @@ CScriptNode::CScriptNode(CScene *pScene, uint32 NodeID, CSceneNode *pParent, CSc
         }
 
         // Fetch LightParameters
-        mpLightParameters = std::make_unique<CLightParameters>(mpInstance->LightParameters(), mpInstance->GameTemplate()->Game());
+        mpLightParameters = std::make_unique<CLightParameters>(mpInstance->PropertyData(), pTemp);
         SetLightLayerIndex(mpLightParameters->LightLayerIndex());
     }
     else
@@ -103,6 +104,8 @@ void CScriptNode::OnTransformed()
             mpInstance->SetScale(LocalScale());
     }
 
+    mpScene->MarkLightListDirty(this);
+
     if (mpExtra != nullptr)
         mpExtra->OnTransformed();
 }
@@ -224,8 +227,12 @@ void CScriptNode::Draw(FRenderOptions Options, int /*ComponentIndex*/, ERenderCo
     // Draw billboard
     else if (mpDisplayAsset->Type() == EResourceType::Texture)
     {
-        CDrawUtil::DrawBillboard(ActiveBillboard(), mPosition, BillboardScale(), TintColor(rkViewInfo));
+        CDrawUtil::QueueBillboard(ActiveBillboard(), mPosition, BillboardScale(), TintColor(rkViewInfo));
     }
+
+    // Draw particle preview; models with transparency draw in two passes, so only do it in one of them
+    if (mpParticlePreview && Command != ERenderCommand::DrawOpaqueParts)
+        mpParticlePreview->Draw(mPosition, TintColor(rkViewInfo));
 }
 
 void CScriptNode::DrawSelection()
@@ -431,6 +438,23 @@ SRayIntersection CScriptNode::RayNodeIntersectTest(const CRay& rkRay, uint32 Ass
     return Out;
 }
 
+bool CScriptNode::GetRaySurfaceTest(uint32 AssetID, SRaySurfaceTest& rOut) const
+{
+    // Billboards face the camera, so they're tested on the main thread instead
+    if (!UsesModel())
+        return false;
+
+    CModel *pModel = ActiveModel();
+    rOut.pOwner = pModel;
+
+    if (!pModel)
+        pModel = CDrawUtil::GetCubeModel();
+
+    rOut.pkSurface = pModel->GetSurface(AssetID);
+    rOut.Transform = Transform();
+    return true;
+}
+
 bool CScriptNode::AllowsRotate() const
 {
     return Template()->RotationType() == CScriptTemplate::ERotationType::RotationEnabled;
@@ -444,7 +468,7 @@ bool CScriptNode::AllowsScale() const
 bool CScriptNode::IsVisible() const
 {
     // Reimplementation of CSceneNode::IsVisible() to allow for layer and template visiblity to be taken into account
-    return mVisible && mpInstance->Layer()->IsVisible() && Template()->IsVisible();
+    return mVisible && mpInstance != nullptr && mpInstance->Layer()->IsVisible() && Template()->IsVisible();
 }
 
 CColor CScriptNode::TintColor(const SViewInfo& ViewInfo) const
@@ -503,6 +527,10 @@ void CScriptNode::PropertyModified(IProperty* pProp)
             mpInstance->EvaluateCollisionModel();
             mpCollisionNode->SetCollision(mpInstance->Collision());
         }
+        else if (rkFilter.Accepts(EResourceType::Particle))
+        {
+            UpdateParticlePreview();
+        }
     }
 
     // Update other editor properties
@@ -519,6 +547,7 @@ void CScriptNode::PropertyModified(IProperty* pProp)
 
     MarkTransformChanged();
     SetLightLayerIndex(mpLightParameters->LightLayerIndex());
+    mpScene->MarkLightListDirty(this);
 
     // Notify attachments
     for (auto* pAttachNode : mAttachments)
@@ -569,6 +598,21 @@ void CScriptNode::UpdatePreviewVolume()
     }
 }
 
+void CScriptNode::UpdateParticlePreview()
+{
+    mpParticlePreview.reset();
+
+    if (auto pEffect = CParticleSimulator::LoadEffect(Template()->FindParticle(mpInstance->PropertyData())))
+        mpParticlePreview = std::make_unique<CParticleSimulator>(std::move(pEffect));
+}
+
+/** Called by the scene tick; the simulation steps at a fixed rate regardless of how often the viewport draws */
+void CScriptNode::TickParticlePreview(double Time)
+{
+    if (mpParticlePreview)
+        mpParticlePreview->Update(Time);
+}
+
 void CScriptNode::GeneratePosition()
 {
     if (!mHasValidPosition)
@@ -652,6 +696,12 @@ CScriptObject* CScriptNode::Instance() const
     return mpInstance;
 }
 
+/** Called when the node is deleted; the instance is usually deleted right after, so the node can't keep pointing at it */
+void CScriptNode::DetachInstance()
+{
+    mpInstance = nullptr;
+}
+
 CScriptTemplate* CScriptNode::Template() const
 {
     return mpInstance->Template();
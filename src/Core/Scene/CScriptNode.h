@@ -7,6 +7,7 @@
 #include "CCollisionNode.h"
 #include "Core/Resource/Script/CScriptObject.h"
 #include "Core/CLightParameters.h"
+#include "Core/Resource/Particle/CParticleSimulator.h"
 
 class CScriptExtra;
 
@@ -26,6 +27,7 @@ class CScriptNode : public CSceneNode
     CModelNode *mpVolumePreviewNode = nullptr;
 
     std::unique_ptr<CLightParameters> mpLightParameters;
+    std::unique_ptr<CParticleSimulator> mpParticlePreview;
 
 public:
     enum class EGameModeVisibility
@@ -45,6 +47,7 @@ public:
     void DrawSelection() override;
     void RayAABoxIntersectTest(CRayCollisionTester& rTester, const SViewInfo& rkViewInfo) override;
     SRayIntersection RayNodeIntersectTest(const CRay& rkRay, uint32 AssetID, const SViewInfo& rkViewInfo) override;
+    bool GetRaySurfaceTest(uint32 AssetID, SRaySurfaceTest& rOut) const override;
     bool AllowsRotate() const override;
     bool AllowsScale() const override;
     bool IsVisible() const override;
@@ -55,9 +58,12 @@ public:
 
     void LinksModified();
     void UpdatePreviewVolume();
+    void UpdateParticlePreview();
+    void TickParticlePreview(double Time);
     void GeneratePosition();
     void TestGameModeVisibility();
     CScriptObject* Instance() const;
+    void DetachInstance();
     CScriptTemplate* Template() const;
     CScriptExtra* Extra() const;
     bool HasPreviewVolume() const;
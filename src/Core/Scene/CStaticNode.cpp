@@ -145,3 +145,11 @@ SRayIntersection CStaticNode::RayNodeIntersectTest(const CRay& rkRay, uint32 Ass
 
     return Out;
 }
+
+bool CStaticNode::GetRaySurfaceTest(uint32 AssetID, SRaySurfaceTest& rOut) const
+{
+    // Static models belong to the area, which the scene keeps loaded until it's cleared
+    rOut.pkSurface = mpModel->GetSurface(AssetID);
+    rOut.Transform = Transform();
+    return true;
+}
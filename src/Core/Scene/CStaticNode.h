@@ -17,6 +17,7 @@ public:
     void DrawSelection() override;
     void RayAABoxIntersectTest(CRayCollisionTester& rTester, const SViewInfo& rkViewInfo) override;
     SRayIntersection RayNodeIntersectTest(const CRay& rkRay, uint32 AssetID, const SViewInfo& rkViewInfo) override;
+    bool GetRaySurfaceTest(uint32 AssetID, SRaySurfaceTest& rOut) const override;
 };
 
 #endif // CSTATICNODE_H
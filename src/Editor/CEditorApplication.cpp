@@ -15,11 +15,15 @@
 
 #include <Common/Macros.h>
 #include <Common/CTimer.h>
+#include <Core/GameProject/CAsyncResourceLoader.h>
 #include <Core/GameProject/CGameProject.h>
 
 #include <QFuture>
+#include <QSettings>
 #include <QtConcurrent/QtConcurrentRun>
 
+const char* const gkResourceMemoryBudgetSetting = "Resources/MemoryBudgetMB";
+
 CEditorApplication::CEditorApplication(int& rArgc, char **ppArgv)
     : QApplication(rArgc, ppArgv)
     , mLastUpdate{CTimer::GlobalTime()}
@@ -71,6 +75,9 @@ bool CEditorApplication::CloseProject()
     // Close any active quickplay sessions
     NDolphinIntegration::KillQuickplay();
 
+    // The index build reads entries from the project's store, so stop it before the store goes away
+    mStringIndex.Clear();
+
     // Emit before actually deleting the project to allow editor references to clean up
     auto pOldProj = std::move(mpActiveProject);
     emit ActiveProjectChanged(nullptr);
@@ -96,6 +103,13 @@ bool CEditorApplication::OpenProject(const QString& rkProjPath)
     if (mpActiveProject)
     {
         gpResourceStore = mpActiveProject->ResourceStore();
+
+        // Unreferenced resources are unloaded once resident memory exceeds this budget
+        QSettings Settings;
+        const uint64 BudgetMB = Settings.value(gkResourceMemoryBudgetSetting, 1024).toULongLong();
+        gpResourceStore->SetMemoryBudget(BudgetMB * 1024 * 1024);
+
+        mStringIndex.Build(gpResourceStore);
         emit ActiveProjectChanged(mpActiveProject.get());
         return true;
     }
@@ -120,6 +134,9 @@ void CEditorApplication::EditResource(CResourceEntry *pEntry)
 
     else
     {
+        // Read the asset's dependencies in the background while it loads and the editor sets itself up
+        CScopedResourcePrefetch Prefetch(pEntry->ResourceStore()->AsyncLoader(), pEntry->ID());
+
         // Attempt to load asset
         CResource *pRes = pEntry->Load();
 
@@ -273,6 +290,7 @@ bool CEditorApplication::RebuildResourceDatabase()
         // Fake-close the project, but keep it in memory so we can modify the resource store
         auto pProj = std::move(mpActiveProject);
         pProj->TweakManager()->ClearTweaks();
+        mStringIndex.Clear();
         emit ActiveProjectChanged(nullptr);
 
         // Rebuild
@@ -287,6 +305,7 @@ bool CEditorApplication::RebuildResourceDatabase()
         // Set project to active again
         mpActiveProject = std::move(pProj);
         mpActiveProject->TweakManager()->LoadTweaks();
+        mStringIndex.Build(mpActiveProject->ResourceStore());
         emit ActiveProjectChanged(mpActiveProject.get());
 
         UICommon::InfoMsg(mpWorldEditor, tr("Success"), tr("Resource database rebuilt successfully!"));
@@ -314,8 +333,14 @@ void CEditorApplication::TickEditors()
         gpEditorStore->ConditionalSaveStore();
 
     if (gpResourceStore)
+    {
         gpResourceStore->ConditionalSaveStore();
 
+        // Evict here rather than during loads, since nothing is mid-load holding raw resource pointers
+        gpResourceStore->TrimResidentMemory();
+        gpResourceStore->AsyncLoader()->Update();
+    }
+
     // Tick each editor window and redraw their viewports
     for (IEditor *pEditor : mEditorWindows)
     {
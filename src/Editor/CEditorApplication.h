@@ -2,6 +2,7 @@
 #define CEDITORAPPLICATION_H
 
 #include <Core/GameProject/CGameProject.h>
+#include <Core/Resource/StringTable/CStringSearchIndex.h>
 #include <QApplication>
 #include <QTimer>
 #include <QVector>
@@ -21,6 +22,7 @@ class CEditorApplication : public QApplication
     Q_OBJECT
 
     std::unique_ptr<CGameProject> mpActiveProject;
+    CStringSearchIndex mStringIndex; // Declared after the project so it's destroyed (and its build joined) first
     CWorldEditor *mpWorldEditor = nullptr;
     CResourceBrowser *mpResourceBrowser = nullptr;
     CProjectSettingsDialog *mpProjectDialog = nullptr;
@@ -55,6 +57,7 @@ public:
     CGameProject* ActiveProject() const              { return mpActiveProject.get(); }
     CWorldEditor* WorldEditor() const                { return mpWorldEditor; }
     CProjectSettingsDialog* ProjectDialog() const    { return mpProjectDialog; }
+    CStringSearchIndex* StringIndex()                { return &mStringIndex; }
     EGame CurrentGame() const                        { return mpActiveProject ? mpActiveProject->Game() : EGame::Invalid; }
 
     void SetEditorTicksEnabled(bool Enabled)         { Enabled ? mRefreshTimer.start(gkTickFrequencyMS) : mRefreshTimer.stop(); }
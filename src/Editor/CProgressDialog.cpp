@@ -80,7 +80,7 @@ void CProgressDialog::CancelButtonClicked()
     mpUI->CancelButton->setEnabled(false);
 }
 
-void CProgressDialog::UpdateUI(const QString& rkTaskDesc, const QString& rkStepDesc, float ProgressPercent)
+void CProgressDialog::UpdateUI(const QString& rkTaskDesc, const QString& rkStepDesc, float ProgressPercent, const QString& rkTelemetryDesc)
 {
     mpUI->TaskLabel->setText(rkTaskDesc);
     mpUI->StepLabel->setText(rkStepDesc);
@@ -102,6 +102,7 @@ void CProgressDialog::UpdateUI(const QString& rkTaskDesc, const QString& rkStepD
     {
         int ProgressValue = 10000 * ProgressPercent;
         mpUI->ProgressBar->setValue(ProgressValue);
+        mpUI->ProgressBar->setFormat(rkTelemetryDesc.isEmpty() ? QString("%p%") : QString("%p% - ") + rkTelemetryDesc);
 
 #ifdef WIN32
         if (mpTaskbarProgress)
@@ -48,7 +48,7 @@ public slots:
     void closeEvent(QCloseEvent *pEvent) override;
     void FinishAndClose();
     void CancelButtonClicked();
-    void UpdateUI(const QString& rkTaskDesc, const QString& rkStepDesc, float ProgressPercent) override;
+    void UpdateUI(const QString& rkTaskDesc, const QString& rkStepDesc, float ProgressPercent, const QString& rkTelemetryDesc) override;
 
     // Results
 protected:
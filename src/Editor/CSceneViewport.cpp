@@ -106,29 +106,23 @@ SRayIntersection CSceneViewport::SceneRayCast(const CRay& rkRay)
     }
 
     SRayIntersection Intersect = mpScene->SceneRayCast(rkRay, mViewInfo);
-
-    if (Intersect.Hit)
-    {
-        if (mpHoverNode)
-            mpHoverNode->SetMouseHovering(false);
-
-        mpHoverNode = Intersect.pNode;
-        mpHoverNode->SetMouseHovering(true);
-        mHoverPoint = rkRay.PointOnRay(Intersect.Distance);
-    }
-
-    else
-    {
-        mHoverPoint = rkRay.PointOnRay(10.f);
-        ResetHover();
-    }
-
+    ApplyHoverResult(rkRay, Intersect);
+    mHoverKey = MakeHoverKey(rkRay);
+    mHoverValid = true;
     return Intersect;
 }
 
 void CSceneViewport::ResetHover()
 {
     if (mpHoverNode) mpHoverNode->SetMouseHovering(false);
+
+    // Don't keep handing out a cached result that points at the node
+    if (mpHoverNode && mRayIntersection.pNode == mpHoverNode)
+    {
+        mRayIntersection = SRayIntersection();
+        mHoverValid = false;
+    }
+
     mpHoverNode = nullptr;
 }
 
@@ -241,6 +235,74 @@ QMouseEvent CSceneViewport::CreateMouseEvent()
     return QMouseEvent(QEvent::MouseMove, mapFromGlobal(QCursor::pos()), Qt::NoButton, qApp->mouseButtons(), qApp->keyboardModifiers());
 }
 
+CSceneViewport::SHoverKey CSceneViewport::MakeHoverKey(const CRay& rkRay) const
+{
+    SHoverKey Key;
+    Key.RayOrigin = rkRay.Origin();
+    Key.RayDirection = rkRay.Direction();
+    Key.ShowFlags = mViewInfo.ShowFlags.ToInt32();
+    Key.RenderOptions = mpRenderer->RenderOptions().ToInt32();
+    Key.SceneRevision = mpScene->Revision();
+    Key.GameMode = mViewInfo.GameMode;
+    return Key;
+}
+
+void CSceneViewport::UpdateHover(const CRay& rkRay)
+{
+    const SHoverKey Key = MakeHoverKey(rkRay);
+
+    // Nothing changed since the last cast; the current result still stands
+    if (mHoverValid && Key == mHoverKey)
+        return;
+
+    // The scene changed. Keep the current hover until the new cast finishes so it doesn't flicker on every edit.
+    // Deleted nodes are reset through NotifyNodeAboutToBeDeleted; nodes that were hidden are dropped here.
+    if (mHoverValid && Key.SceneRevision != mHoverKey.SceneRevision && mpHoverNode != nullptr &&
+        (mpScene->IsNodePendingDelete(mpHoverNode) || !mpHoverNode->IsVisible()))
+    {
+        ResetHover();
+    }
+
+    // Apply the last cast if it finished. It may be a frame behind the mouse, but it's valid for the current scene.
+    SRayIntersection Intersect;
+
+    if (mpScene->FinishAsyncRayCast(Intersect))
+    {
+        ApplyHoverResult(mPendingHoverRay, Intersect);
+        mRayIntersection = Intersect;
+        mHoverKey = mPendingHoverKey;
+        mHoverValid = true;
+
+        if (Key == mHoverKey)
+            return;
+    }
+
+    if (mpScene->BeginAsyncRayCast(rkRay, mViewInfo))
+    {
+        mPendingHoverKey = Key;
+        mPendingHoverRay = rkRay;
+    }
+}
+
+void CSceneViewport::ApplyHoverResult(const CRay& rkRay, const SRayIntersection& rkIntersect)
+{
+    if (rkIntersect.Hit)
+    {
+        if (mpHoverNode)
+            mpHoverNode->SetMouseHovering(false);
+
+        mpHoverNode = rkIntersect.pNode;
+        mpHoverNode->SetMouseHovering(true);
+        mHoverPoint = rkRay.PointOnRay(rkIntersect.Distance);
+    }
+
+    else
+    {
+        mHoverPoint = rkRay.PointOnRay(10.f);
+        ResetHover();
+    }
+}
+
 void CSceneViewport::FindConnectedObjects(uint32 InstanceID, bool SearchOutgoing, bool SearchIncoming, QList<uint32>& rIDList)
 {
     CScriptNode *pScript = mpScene->NodeForInstanceID(InstanceID);
@@ -291,11 +353,16 @@ void CSceneViewport::CheckUserInput()
             CheckGizmoInput(Ray);
 
         if (!mpEditor->Gizmo()->IsTransforming())
-            mRayIntersection = SceneRayCast(Ray);
+            UpdateHover(Ray);
     }
 
     else
+    {
+        // Layer and template visibility can be toggled elsewhere without touching the scene revision,
+        // so don't trust the cached result once the mouse has left the viewport.
         mRayIntersection = SRayIntersection();
+        mHoverValid = false;
+    }
 
     QMouseEvent Event = CreateMouseEvent();
     emit InputProcessed(mRayIntersection, &Event);
@@ -425,9 +492,16 @@ void CSceneViewport::OnMouseRelease(QMouseEvent *pEvent)
             mGizmoTransforming = false;
         }
 
-        // Object selection/deselection
+        // Object selection/deselection. Make sure the click uses a result for the current mouse position.
         else
+        {
+            const CRay Ray = CastRay();
+
+            if (!mHoverValid || MakeHoverKey(Ray) != mHoverKey)
+                mRayIntersection = SceneRayCast(Ray);
+
             emit ViewportClick(mRayIntersection, pEvent);
+        }
     }
 }
 
@@ -477,11 +551,13 @@ void CSceneViewport::OnHideNode()
 void CSceneViewport::OnHideType()
 {
     static_cast<CScriptNode*>(mpMenuNode)->Template()->SetVisible(false);
+    mpScene->IncrementRevision();
 }
 
 void CSceneViewport::OnHideLayer()
 {
     static_cast<CScriptNode*>(mpMenuNode)->Instance()->Layer()->SetVisible(false);
+    mpScene->IncrementRevision();
 }
 
 void CSceneViewport::OnUnhideAll()
@@ -514,6 +590,8 @@ void CSceneViewport::OnUnhideAll()
 
         ++it;
     }
+
+    mpScene->IncrementRevision();
 }
 
 void CSceneViewport::OnPlayFromHere()
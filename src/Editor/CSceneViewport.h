@@ -22,6 +22,29 @@ class CSceneViewport : public CBasicViewport
     CSceneNode *mpHoverNode = nullptr;
     CVector3f mHoverPoint{CVector3f::Zero()};
 
+    /** Everything a hover ray cast result depends on; if none of it changed, the last result is still valid */
+    struct SHoverKey
+    {
+        CVector3f RayOrigin{CVector3f::Zero()};
+        CVector3f RayDirection{CVector3f::Zero()};
+        uint32 ShowFlags = 0;
+        uint32 RenderOptions = 0;
+        uint32 SceneRevision = 0;
+        bool GameMode = false;
+
+        bool operator==(const SHoverKey& rkOther) const
+        {
+            return RayOrigin == rkOther.RayOrigin && RayDirection == rkOther.RayDirection &&
+                   ShowFlags == rkOther.ShowFlags && RenderOptions == rkOther.RenderOptions &&
+                   SceneRevision == rkOther.SceneRevision && GameMode == rkOther.GameMode;
+        }
+        bool operator!=(const SHoverKey& rkOther) const { return !(*this == rkOther); }
+    };
+    SHoverKey mHoverKey;
+    SHoverKey mPendingHoverKey;
+    CRay mPendingHoverRay;
+    bool mHoverValid = false;
+
     // Context Menu
     QMenu *mpContextMenu = nullptr;
     QAction *mpToggleSelectAction;
@@ -76,6 +99,9 @@ public:
 protected:
     void CreateContextMenu();
     QMouseEvent CreateMouseEvent();
+    SHoverKey MakeHoverKey(const CRay& rkRay) const;
+    void UpdateHover(const CRay& rkRay);
+    void ApplyHoverResult(const CRay& rkRay, const SRayIntersection& rkIntersect);
     void FindConnectedObjects(uint32 InstanceID, bool SearchOutgoing, bool SearchIncoming, QList<uint32>& rIDList);
 
 signals:
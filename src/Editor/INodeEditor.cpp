@@ -266,24 +266,86 @@ void INodeEditor::NotifySelectionTransformed()
 
 void INodeEditor::NotifyNodeAboutToBeSpawned()
 {
+    if (mNodeBatchDepth > 0)
+    {
+        if (!mNodeBatchModified)
+        {
+            mNodeBatchModified = true;
+            emit NodeBatchAboutToChange();
+        }
+        return;
+    }
+
     emit NodeAboutToBeSpawned();
 }
 
 void INodeEditor::NotifyNodeSpawned(CSceneNode *pNode)
 {
+    if (mNodeBatchDepth > 0)
+    {
+        mNodeBatchSpawnedNodes.push_back(pNode);
+        return;
+    }
+
     emit NodeSpawned(pNode);
 }
 
 void INodeEditor::NotifyNodeAboutToBeDeleted(CSceneNode *pNode)
 {
+    if (mNodeBatchDepth > 0)
+    {
+        if (!mNodeBatchModified)
+        {
+            mNodeBatchModified = true;
+            emit NodeBatchAboutToChange();
+        }
+
+        if (!mNodeBatchSpawnedNodes.isEmpty())
+            mNodeBatchSpawnedNodes.removeOne(pNode);
+
+        return;
+    }
+
     emit NodeAboutToBeDeleted(pNode);
 }
 
 void INodeEditor::NotifyNodeDeleted()
 {
+    if (mNodeBatchDepth > 0)
+        return;
+
     emit NodeDeleted();
 }
 
+/**
+ * Start a batch of node spawns/deletes, eg for pasting or deleting many nodes at once. Until the outermost
+ * batch ends, the scene defers its per-node bookkeeping and the per-node spawn/delete signals are replaced
+ * by a single NodeBatchAboutToChange()/NodeBatchChanged() pair. Batches can nest.
+ */
+void INodeEditor::BeginNodeBatch()
+{
+    if (mNodeBatchDepth++ == 0)
+        mScene.BeginTransaction();
+}
+
+void INodeEditor::EndNodeBatch()
+{
+    ASSERT(mNodeBatchDepth > 0);
+
+    if (--mNodeBatchDepth > 0)
+        return;
+
+    mScene.EndTransaction();
+
+    if (mNodeBatchModified)
+    {
+        const QList<CSceneNode*> SpawnedNodes = std::move(mNodeBatchSpawnedNodes);
+        mNodeBatchSpawnedNodes.clear();
+        mNodeBatchModified = false;
+        emit NodeBatchChanged(SpawnedNodes);
+    }
+}
+
 // ************ PUBLIC SLOTS ************
 void INodeEditor::OnSelectionModified()
 {
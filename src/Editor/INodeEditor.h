@@ -29,6 +29,11 @@ protected:
     CNodeSelection *mpSelection;
     bool mSelectionLocked = false;
 
+    // Node batches; see BeginNodeBatch()
+    uint32 mNodeBatchDepth = 0;
+    bool mNodeBatchModified = false;
+    QList<CSceneNode*> mNodeBatchSpawnedNodes;
+
     // Gizmo
     CGizmo mGizmo;
     bool mShowGizmo = false;
@@ -84,12 +89,16 @@ public:
     virtual void NotifyNodeSpawned(CSceneNode *pNode);
     virtual void NotifyNodeAboutToBeDeleted(CSceneNode *pNode);
     virtual void NotifyNodeDeleted();
+    void BeginNodeBatch();
+    void EndNodeBatch();
 
 signals:
     void NodeAboutToBeSpawned();
     void NodeSpawned(CSceneNode *pNode);
     void NodeAboutToBeDeleted(CSceneNode *pNode);
     void NodeDeleted();
+    void NodeBatchAboutToChange();
+    void NodeBatchChanged(const QList<CSceneNode*>& rkSpawnedNodes);
     void SelectionModified();
     void SelectionTransformed();
 
@@ -4,6 +4,7 @@
 #include "UICommon.h"
 #include <Core/IProgressNotifier.h>
 #include <QDialog>
+#include <QStringList>
 
 // IProgressNotifier subclass for UI classes (dialogs, etc)
 class IProgressNotifierUI : public QDialog, public IProgressNotifier
@@ -14,7 +15,7 @@ public:
     {}
 
 public slots:
-    virtual void UpdateUI(const QString& rkTaskDesc, const QString& rkStepDesc, float ProgressPercent) = 0;
+    virtual void UpdateUI(const QString& rkTaskDesc, const QString& rkStepDesc, float ProgressPercent, const QString& rkTelemetryDesc) = 0;
 
 private:
     void UpdateProgress(const TString& rkTaskDesc, const TString& rkStepDesc, float ProgressPercent) final
@@ -23,7 +24,35 @@ private:
         QMetaObject::invokeMethod(this, "UpdateUI", Qt::AutoConnection,
                                   Q_ARG(QString, TO_QSTRING(rkTaskDesc)),
                                   Q_ARG(QString, TO_QSTRING(rkStepDesc)),
-                                  Q_ARG(float, ProgressPercent) );
+                                  Q_ARG(float, ProgressPercent),
+                                  Q_ARG(QString, TelemetryDescription(Telemetry())) );
+    }
+
+    /** Format throughput and time remaining, e.g. "12.5 MB/s, 40 items/s, 1:05 remaining" */
+    static QString TelemetryDescription(const SProgressTelemetry& rkTelemetry)
+    {
+        // Rates aren't meaningful for the first moment of a task
+        if (rkTelemetry.ElapsedSeconds < 1.0)
+            return QString();
+
+        QStringList Parts;
+
+        if (rkTelemetry.NumBytes > 0)
+        {
+            const double MBPerSecond = rkTelemetry.BytesPerSecond() / (1024.0 * 1024.0);
+            Parts << QString("%1 MB/s").arg(MBPerSecond, 0, 'f', 1);
+        }
+
+        if (rkTelemetry.NumItems > 0)
+            Parts << QString("%1 items/s").arg(rkTelemetry.ItemsPerSecond(), 0, 'f', 0);
+
+        if (rkTelemetry.RemainingSeconds >= 0.0)
+        {
+            const int Seconds = static_cast<int>(rkTelemetry.RemainingSeconds + 0.5);
+            Parts << QString("%1:%2 remaining").arg(Seconds / 60).arg(Seconds % 60, 2, 10, QChar('0'));
+        }
+
+        return Parts.join(", ");
     }
 };
 
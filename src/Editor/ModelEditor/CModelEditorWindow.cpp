@@ -793,9 +793,9 @@ void CModelEditorWindow::ConvertToTXTR()
     auto pTex = CTextureDecoder::LoadDDS(InTextureFile, nullptr);
     TString OutName = TexFilename.GetFilePathWithoutExtension() + ".txtr";
 
-    if ((pTex->TexelFormat() != ETexelFormat::DXT1) || (pTex->NumMipMaps() > 1))
+    if (!pTex)
     {
-        QMessageBox::warning(this, tr("Error"), tr("Can't convert DDS to TXTR! Save your texture as a DXT1 DDS with no mipmaps, then try again."));
+        QMessageBox::warning(this, tr("Error"), tr("Can't convert DDS to TXTR! Couldn't load the input DDS."));
     }
     else
     {
@@ -804,9 +804,12 @@ void CModelEditorWindow::ConvertToTXTR()
         {
             QMessageBox::warning(this, tr("Error"), tr("Couldn't open output TXTR!"));
         }
+        else if (!CTextureEncoder::EncodeTXTR(Out, pTex.get()))
+        {
+            QMessageBox::warning(this, tr("Error"), tr("Can't convert DDS to TXTR! The texture format isn't supported."));
+        }
         else
         {
-            CTextureEncoder::EncodeTXTR(Out, pTex.get(), ETexelFormat::GX_CMPR);
             QMessageBox::information(this, tr("Success"), tr("Successfully converted to TXTR!"));
         }
     }
@@ -20,6 +20,7 @@
 #include <QInputDialog>
 #include <QMenu>
 #include <QMessageBox>
+#include <QSet>
 #include <QtConcurrent/QtConcurrentRun>
 
 CResourceBrowser::CResourceBrowser(QWidget *pParent)
@@ -117,6 +118,7 @@ CResourceBrowser::CResourceBrowser(QWidget *pParent)
     pOptionsMenu->addAction(pDisplayAssetIDsAction);
 
     pOptionsMenu->addAction(tr("Find Asset by ID"), this, &CResourceBrowser::FindAssetByID);
+    pOptionsMenu->addAction(tr("Find String in String Tables"), this, &CResourceBrowser::FindString);
     pOptionsMenu->addAction(tr("Rebuild Database"), this, &CResourceBrowser::RebuildResourceDB);
     mpUI->OptionsToolButton->setMenu(pOptionsMenu);
 
@@ -868,6 +870,47 @@ void CResourceBrowser::FindAssetByID()
     // User entered nothing, don't do anything
 }
 
+void CResourceBrowser::FindString()
+{
+    if (!mpStore)
+        return;
+
+    const QString Query = QInputDialog::getText(this, tr("Find String"), tr("Find string tables containing:"));
+
+    if (!Query.trimmed().isEmpty())
+        ShowStringSearchResults(Query);
+}
+
+void CResourceBrowser::ShowStringSearchResults(const QString& rkQuery, ELanguage Language)
+{
+    CStringSearchIndex *pIndex = gpEdApp->StringIndex();
+
+    if (pIndex->IsBuilding())
+    {
+        UICommon::InfoMsg(this, tr("Find String"), tr("The string index is still being built. Try again in a moment."));
+        return;
+    }
+
+    const std::vector<SStringSearchMatch> Matches = pIndex->Search(TO_TSTRING(rkQuery), Language);
+    QList<CResourceEntry*> EntryList;
+    QSet<CResourceEntry*> AddedEntries;
+
+    for (const SStringSearchMatch& rkMatch : Matches)
+    {
+        CResourceEntry *pEntry = mpStore->FindEntry(rkMatch.AssetID);
+
+        if (pEntry && !AddedEntries.contains(pEntry))
+        {
+            AddedEntries.insert(pEntry);
+            EntryList.push_back(pEntry);
+        }
+    }
+
+    const QString ListDesc = tr("String tables containing \"%1\"").arg(rkQuery);
+    mpModel->DisplayEntryList(EntryList, ListDesc);
+    ClearFilters();
+}
+
 void CResourceBrowser::SetAssetIDDisplayEnabled(bool Enable)
 {
     mpDelegate->SetDisplayAssetIDs(Enable);
@@ -5,6 +5,7 @@
 #include "CResourceProxyModel.h"
 #include "CResourceTableModel.h"
 #include "CVirtualDirectoryModel.h"
+#include <Core/Resource/StringTable/ELanguage.h>
 
 #include <QCheckBox>
 #include <QMenu>
@@ -103,6 +104,8 @@ public slots:
     void OnDoubleClickTable(QModelIndex Index);
     void OnResourceSelectionChanged(const QModelIndex& rkNewIndex);
     void FindAssetByID();
+    void FindString();
+    void ShowStringSearchResults(const QString& rkQuery, ELanguage Language = ELanguage::Invalid);
     void SetAssetIDDisplayEnabled(bool Enable);
 
     void UpdateStore();
@@ -1,6 +1,7 @@
 #include "CResourceTableContextMenu.h"
 #include "CResourceBrowser.h"
 #include "Editor/CEditorApplication.h"
+#include "Editor/UICommon.h"
 
 #include <Core/Resource/Scan/CScan.h>
 
@@ -67,6 +68,13 @@ void CResourceTableContextMenu::InitMenu()
         addAction(tr("Copy Path"), this, &CResourceTableContextMenu::CopyPath);
         addAction(tr("Copy ID"), this, &CResourceTableContextMenu::CopyID);
         addSeparator();
+
+        if (mpClickedEntry->TypeInfo()->CanBeSerialized())
+        {
+            addAction(tr("Export Raw XML..."), this, &CResourceTableContextMenu::ExportRawXML);
+            addAction(tr("Import Raw XML..."), this, &CResourceTableContextMenu::ImportRawXML);
+            addSeparator();
+        }
     }
 
     QMenu* pCreate = addMenu(tr("Create..."));
@@ -247,6 +255,24 @@ void CResourceTableContextMenu::CopyID()
     gpEdApp->clipboard()->setText( TO_QSTRING(mpClickedEntry->ID().ToString()) );
 }
 
+void CResourceTableContextMenu::ExportRawXML()
+{
+    ASSERT(mpClickedEntry);
+    const QString DefaultPath = TO_QSTRING(mpClickedEntry->Name() + "." + mpClickedEntry->CookedExtension().ToString() + ".xml");
+    const QString Path = UICommon::SaveFileDialog(mpBrowser, tr("Export Raw XML"), tr("XML (*.xml)"), DefaultPath);
+
+    if (!Path.isEmpty() && !mpClickedEntry->ExportRawXML(TO_TSTRING(Path)))
+        UICommon::ErrorMsg(mpBrowser, tr("Failed to export raw XML. Check the log for details."));
+}
+
+void CResourceTableContextMenu::ImportRawXML()
+{
+    ASSERT(mpClickedEntry);
+    const QString Path = UICommon::OpenFileDialog(mpBrowser, tr("Import Raw XML"), tr("XML (*.xml)"));
+
+    if (!Path.isEmpty() && !mpClickedEntry->ImportRawXML(TO_TSTRING(Path)))
+        UICommon::ErrorMsg(mpBrowser, tr("Failed to import raw XML. Make sure the asset isn't open in an editor, and check the log for details."));
+}
 
 // Asset Specific
 void CResourceTableContextMenu::CreateSCAN()
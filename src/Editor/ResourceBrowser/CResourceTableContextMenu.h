@@ -41,6 +41,8 @@ public slots:
     void CopyName();
     void CopyPath();
     void CopyID();
+    void ExportRawXML();
+    void ImportRawXML();
 
     // Asset Specific
     void CreateSCAN();
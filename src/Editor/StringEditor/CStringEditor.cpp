@@ -2,9 +2,12 @@
 #include "ui_CStringEditor.h"
 
 #include "CStringDelegate.h"
+#include "Editor/CEditorApplication.h"
 #include "Editor/UICommon.h"
+#include "Editor/ResourceBrowser/CResourceBrowser.h"
 #include "Editor/Undo/TSerializeUndoCommand.h"
 
+#include <QInputDialog>
 #include <QSettings>
 #include <QShortcut>
 
@@ -61,6 +64,7 @@ bool CStringEditor::Save()
     }
     else
     {
+        gpEdApp->StringIndex()->UpdateTable(*mpStringTable);
         UndoStack().setClean();
         setWindowModified(false);
         return true;
@@ -126,6 +130,7 @@ void CStringEditor::InitUI()
 
     connect(mpUI->ActionSave, &QAction::triggered, this, &CStringEditor::Save);
     connect(mpUI->ActionSaveAndCook, &QAction::triggered, this, &CStringEditor::SaveAndRepack);
+    connect(mpUI->ActionFindString, &QAction::triggered, this, &CStringEditor::OnFindString);
 
     connect(&UndoStack(), &QUndoStack::indexChanged, this, &CStringEditor::UpdateUI);
 
@@ -384,6 +389,72 @@ void CStringEditor::OnMoveString(int StringIndex, int NewIndex)
     UndoStack().endMacro();
 }
 
+void CStringEditor::OnFindString()
+{
+    bool Ok = false;
+    const QString Query = QInputDialog::getText(this, tr("Find String"), tr("Find in all string tables:"),
+                                                QLineEdit::Normal, mLastSearchQuery, &Ok);
+
+    if (!Ok || Query.trimmed().isEmpty())
+        return;
+
+    mLastSearchQuery = Query;
+    CStringSearchIndex *pIndex = gpEdApp->StringIndex();
+
+    if (pIndex->IsBuilding())
+    {
+        UICommon::InfoMsg(this, tr("Find String"), tr("The string index is still being built. Try again in a moment."));
+        return;
+    }
+
+    // Jump to the next match in this table, wrapping around to the first one.
+    // Unsaved edits aren't indexed, so matches are from the last saved version of the table.
+    const std::vector<SStringSearchMatch> Matches = pIndex->Search(TO_TSTRING(Query), mCurrentLanguage);
+    const CAssetID TableID = mpStringTable->ID();
+    int FirstMatch = -1;
+    int NextMatch = -1;
+    int NumLocalMatches = 0;
+
+    for (const SStringSearchMatch& rkMatch : Matches)
+    {
+        if (rkMatch.AssetID != TableID || rkMatch.StringIndex >= mpStringTable->NumStrings())
+            continue;
+
+        NumLocalMatches++;
+
+        if (FirstMatch == -1)
+            FirstMatch = static_cast<int>(rkMatch.StringIndex);
+
+        if (NextMatch == -1 && mCurrentStringIndex != UINT32_MAX && rkMatch.StringIndex > mCurrentStringIndex)
+            NextMatch = static_cast<int>(rkMatch.StringIndex);
+    }
+
+    if (NumLocalMatches > 0)
+    {
+        const int NewIndex = (NextMatch != -1 ? NextMatch : FirstMatch);
+
+        if (static_cast<uint32>(NewIndex) != mCurrentStringIndex)
+        {
+            IUndoCommand* pCommand = new CSetStringIndexCommand(this, mCurrentStringIndex, NewIndex);
+            UndoStack().push(pCommand);
+        }
+
+        mpUI->StatusBar->showMessage(tr("%1 matches in this table, %2 in the project")
+                                     .arg(NumLocalMatches).arg(Matches.size()));
+    }
+
+    // Nothing here; list the other tables that contain it in the resource browser
+    else if (!Matches.empty())
+    {
+        gpEdApp->ResourceBrowser()->ShowStringSearchResults(Query, mCurrentLanguage);
+        mpUI->StatusBar->showMessage(tr("No matches in this table; matching string tables are listed in the resource browser"));
+    }
+    else
+    {
+        UICommon::InfoMsg(this, tr("Find String"), tr("No strings found matching \"%1\".").arg(Query));
+    }
+}
+
 void CStringEditor::IncrementStringIndex()
 {
     const uint32 NewIndex = mCurrentStringIndex + 1;
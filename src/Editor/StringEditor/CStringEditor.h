@@ -37,6 +37,9 @@ class CStringEditor : public IEditor
     /** Model for the string list view */
     CStringListModel* mpListModel = nullptr;
 
+    /** Last query entered into the project-wide string search */
+    QString mLastSearchQuery;
+
     /** Editor state flags */
     bool mIsEditingStringName = false;
     bool mIsEditingStringData = false;
@@ -68,6 +71,7 @@ public slots:
     void OnAddString();
     void OnRemoveString();
     void OnMoveString(int StringIndex, int NewIndex);
+    void OnFindString();
     
     void IncrementStringIndex();
     void DecrementStringIndex();
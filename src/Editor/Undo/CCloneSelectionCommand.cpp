@@ -32,6 +32,7 @@ void CCloneSelectionCommand::undo()
 {
     QList<CSceneNode*> ClonedNodes = mClonedNodes.DereferenceList();
     mpEditor->Selection()->Clear();
+    mpEditor->BeginNodeBatch();
 
     for (CSceneNode *pNode : ClonedNodes)
     {
@@ -43,6 +44,7 @@ void CCloneSelectionCommand::undo()
         mpEditor->NotifyNodeDeleted();
     }
 
+    mpEditor->EndNodeBatch();
     mClonedNodes.clear();
     mpEditor->OnLinksModified(mLinkedInstances.DereferenceList());
     mpEditor->Selection()->SetSelectedNodes(mOriginalSelection.DereferenceList());
@@ -56,6 +58,8 @@ void CCloneSelectionCommand::redo()
     QList<uint32> ClonedInstanceIDs;
 
     // Clone nodes
+    mpEditor->BeginNodeBatch();
+
     for (CSceneNode *pNode : ToClone)
     {
         mpEditor->NotifyNodeAboutToBeSpawned();
@@ -104,6 +108,8 @@ void CCloneSelectionCommand::redo()
     for (CSceneNode *pNode : ClonedNodes)
         pNode->OnLoadFinished();
 
+    mpEditor->EndNodeBatch();
+
     mpEditor->OnLinksModified(mLinkedInstances.DereferenceList());
     mpEditor->Selection()->SetSelectedNodes(mClonedNodes.DereferenceList());
 }
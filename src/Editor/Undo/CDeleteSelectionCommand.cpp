@@ -91,6 +91,8 @@ void CDeleteSelectionCommand::undo()
     QList<uint32> NewInstanceIDs;
 
     // Spawn nodes
+    mpEditor->BeginNodeBatch();
+
     for (SDeletedNode& rNode : mDeletedNodes)
     {
         mpEditor->NotifyNodeAboutToBeSpawned();
@@ -143,6 +145,8 @@ void CDeleteSelectionCommand::undo()
     for (CSceneNode *pNode : NewNodes)
         pNode->OnLoadFinished();
 
+    mpEditor->EndNodeBatch();
+
     // Add selection and done
     mpEditor->Selection()->SetSelectedNodes(mOldSelection.DereferenceList());
     mpEditor->OnLinksModified(mLinkedInstances.DereferenceList());
@@ -151,6 +155,7 @@ void CDeleteSelectionCommand::undo()
 void CDeleteSelectionCommand::redo()
 {
     mpEditor->Selection()->SetSelectedNodes(mNewSelection.DereferenceList());
+    mpEditor->BeginNodeBatch();
 
     for (SDeletedNode& rNode : mDeletedNodes)
     {
@@ -163,5 +168,6 @@ void CDeleteSelectionCommand::redo()
         mpEditor->NotifyNodeDeleted();
     }
 
+    mpEditor->EndNodeBatch();
     mpEditor->OnLinksModified(mLinkedInstances.DereferenceList());
 }
@@ -45,6 +45,29 @@ public:
         for (int i = 0; i < mInstances.size(); i++)
             OutPointers[i] = mInstances[i]->PropertyData();
     }
+
+    void undo() override
+    {
+        IEditPropertyCommand::undo();
+        MarkDependenciesDirty();
+    }
+
+    void redo() override
+    {
+        IEditPropertyCommand::redo();
+        MarkDependenciesDirty();
+    }
+
+private:
+    /** Let the area know these instances need their dependencies rebuilt the next time it's saved */
+    void MarkDependenciesDirty()
+    {
+        for (const CInstancePtr& rkInstance : mInstances)
+        {
+            if (CScriptObject *pInstance = *rkInstance)
+                pInstance->Area()->MarkInstanceDependenciesDirty(pInstance);
+        }
+    }
 };
 
 #endif // CEDITSCRIPTPROPERTYCOMMAND_H
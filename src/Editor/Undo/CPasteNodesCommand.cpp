@@ -24,6 +24,7 @@ void CPasteNodesCommand::undo()
 {
     mpEditor->Selection()->SetSelectedNodes(mOriginalSelection.DereferenceList());
     QList<CSceneNode*> PastedNodes = mPastedNodes.DereferenceList();
+    mpEditor->BeginNodeBatch();
 
     for (CSceneNode *pNode : PastedNodes)
     {
@@ -34,6 +35,8 @@ void CPasteNodesCommand::undo()
         mpEditor->NotifyNodeDeleted();
     }
 
+    mpEditor->EndNodeBatch();
+
     mpEditor->OnLinksModified(mLinkedInstances.DereferenceList());
     mLinkedInstances.clear();
     mPastedNodes.clear();
@@ -48,6 +51,7 @@ void CPasteNodesCommand::redo()
     CScene *pScene = mpEditor->Scene();
     CGameArea *pArea = mpEditor->ActiveArea();
     QList<CSceneNode*> PastedNodes;
+    mpEditor->BeginNodeBatch();
 
     for (const CNodeCopyMimeData::SCopiedNode& rkNode : rkNodes)
     {
@@ -131,6 +135,7 @@ void CPasteNodesCommand::redo()
     for (CSceneNode *pNode : PastedNodes)
         pNode->OnLoadFinished();
 
+    mpEditor->EndNodeBatch();
     mpEditor->Selection()->SetSelectedNodes(PastedNodes);
 
     mpEditor->OnLinksModified(mLinkedInstances.DereferenceList());
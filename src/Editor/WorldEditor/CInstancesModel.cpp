@@ -5,6 +5,7 @@
 #include <Core/Scene/CScriptNode.h>
 #include <QApplication>
 #include <QIcon>
+#include <QSet>
 
 /*
  * The tree has 3 levels:
@@ -40,6 +41,8 @@ CInstancesModel::CInstancesModel(CWorldEditor *pEditor, QObject *pParent)
     connect(mpEditor, &CWorldEditor::NodeSpawned, this, &CInstancesModel::NodeCreated);
     connect(mpEditor, &CWorldEditor::NodeAboutToBeDeleted, this, &CInstancesModel::NodeAboutToBeDeleted);
     connect(mpEditor, &CWorldEditor::NodeDeleted, this, &CInstancesModel::NodeDeleted);
+    connect(mpEditor, &CWorldEditor::NodeBatchAboutToChange, this, &CInstancesModel::NodeBatchAboutToChange);
+    connect(mpEditor, &CWorldEditor::NodeBatchChanged, this, &CInstancesModel::NodeBatchChanged);
     connect(mpEditor, &CWorldEditor::PropertyModified, this, &CInstancesModel::PropertyModified);
     connect(mpEditor, &CWorldEditor::InstancesLayerAboutToChange, this, &CInstancesModel::InstancesLayerPreChange);
     connect(mpEditor, &CWorldEditor::InstancesLayerChanged, this, &CInstancesModel::InstancesLayerPostChange);
@@ -474,6 +477,55 @@ void CInstancesModel::NodeDeleted()
     mChangingLayout = false;
 }
 
+void CInstancesModel::NodeBatchAboutToChange()
+{
+    // A batch can add and remove any number of rows anywhere in the tree, so the model is reset rather than laid out again
+    beginResetModel();
+}
+
+void CInstancesModel::NodeBatchChanged(const QList<CSceneNode*>& rkSpawnedNodes)
+{
+    if (mModelType == EInstanceModelType::Types)
+    {
+        // Sort each affected template once for the whole batch instead of once per node
+        QSet<CScriptTemplate*> SpawnedTemplates;
+
+        for (CSceneNode *pNode : rkSpawnedNodes)
+        {
+            if (pNode->NodeType() == ENodeType::Script)
+                SpawnedTemplates.insert(static_cast<CScriptNode*>(pNode)->Template());
+        }
+
+        for (CScriptTemplate *pTemp : SpawnedTemplates)
+            pTemp->SortObjects();
+
+        // Remove templates that lost their last object and add ones that gained their first
+        for (int TempIdx = mTemplateList.size() - 1; TempIdx >= 0; TempIdx--)
+        {
+            if (mTemplateList[TempIdx]->NumObjects() == 0)
+                mTemplateList.removeAt(TempIdx);
+        }
+
+        for (CScriptTemplate *pTemp : SpawnedTemplates)
+        {
+            if (pTemp->NumObjects() == 0 || mTemplateList.contains(pTemp))
+                continue;
+
+            int NewIndex = 0;
+
+            for (; NewIndex < mTemplateList.size(); NewIndex++)
+            {
+                if (mTemplateList[NewIndex]->Name() > pTemp->Name())
+                    break;
+            }
+
+            mTemplateList.insert(NewIndex, pTemp);
+        }
+    }
+
+    endResetModel();
+}
+
 void CInstancesModel::PropertyModified(IProperty *pProp, CScriptObject *pInst)
 {
     if (pProp->Name() != "Name")
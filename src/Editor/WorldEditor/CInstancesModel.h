@@ -60,6 +60,8 @@ public slots:
     void NodeCreated(CSceneNode *pNode);
     void NodeAboutToBeDeleted(CSceneNode *pNode);
     void NodeDeleted();
+    void NodeBatchAboutToChange();
+    void NodeBatchChanged(const QList<CSceneNode*>& rkSpawnedNodes);
 
     void PropertyModified(IProperty *pProp, CScriptObject *pInst);
     void InstancesLayerPreChange();
@@ -21,7 +21,10 @@
 #include "Editor/Widgets/WVectorEditor.h"
 #include "Editor/Undo/UndoCommands.h"
 
+#include <Common/CTimer.h>
 #include <Common/Log.h>
+#include <Core/NPerfStats.h>
+#include <Core/GameProject/CAsyncResourceLoader.h>
 #include <Core/GameProject/CGameProject.h>
 #include <Core/Render/CDrawUtil.h>
 #include <Core/Resource/Script/NGameList.h>
@@ -188,6 +191,7 @@ CWorldEditor::CWorldEditor(QWidget *parent)
 
     connect(ui->ActionEditTweaks, SIGNAL(triggered()), mpTweakEditor, SLOT(show()));
     connect(ui->ActionEditLayers, SIGNAL(triggered()), this, SLOT(EditLayers()));
+    connect(ui->ActionRecordPerformanceTrace, SIGNAL(toggled(bool)), this, SLOT(TogglePerformanceTrace(bool)));
     if (gTemplatesWritable)
         connect(ui->ActionGeneratePropertyNames, SIGNAL(triggered()), mpGeneratePropertyNamesDialog, SLOT(show()));
     else
@@ -265,16 +269,20 @@ bool CWorldEditor::SetArea(CWorld *pWorld, int AreaIndex)
     ClearSelection();
     UndoStack().clear();
 
-    // Load new area
+    // Load new area. Its dependencies are read and parsed on worker threads while the area
+    // and its script objects are loaded, and the scene picks them up as it creates nodes.
     mpWorld = pWorld;
     CAssetID AreaID = mpWorld->AreaResourceID(AreaIndex);
     CResourceEntry *pAreaEntry = gpResourceStore->FindEntry(AreaID);
     ASSERT(pAreaEntry);
 
-    mpArea = pAreaEntry->Load();
-    ASSERT(mpArea);
-    mpWorld->SetAreaLayerInfo(mpArea);
-    mScene.SetActiveArea(mpWorld, mpArea);
+    {
+        CScopedResourcePrefetch Prefetch(gpResourceStore->AsyncLoader(), AreaID);
+        mpArea = pAreaEntry->Load();
+        ASSERT(mpArea);
+        mpWorld->SetAreaLayerInfo(mpArea);
+        mScene.SetActiveArea(mpWorld, mpArea);
+    }
 
     // Snap camera to new area
     CCamera *pCamera = &ui->MainViewport->Camera();
@@ -348,6 +356,8 @@ void CWorldEditor::EditorTick(float)
 {
     // Update new link line
     UpdateNewLinkLine();
+
+    mScene.Tick(CTimer::GlobalTime());
 }
 
 void CWorldEditor::NotifyNodeAboutToBeDeleted(CSceneNode *pNode)
@@ -1354,3 +1364,18 @@ void CWorldEditor::EditLayers()
     Editor.SetArea(mpArea);
     Editor.exec();
 }
+
+void CWorldEditor::TogglePerformanceTrace(bool Enabled)
+{
+    if (Enabled)
+    {
+        NPerfStats::StartTrace();
+        return;
+    }
+
+    NPerfStats::StopTrace();
+    const QString TracePath = UICommon::SaveFileDialog(this, tr("Save Performance Trace"), tr("Chrome Trace (*.json)"));
+
+    if (!TracePath.isEmpty() && !NPerfStats::WriteChromeTrace(TO_TSTRING(TracePath)))
+        UICommon::ErrorMsg(this, tr("Failed to write the performance trace to %1").arg(TracePath));
+}
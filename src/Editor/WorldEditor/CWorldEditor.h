@@ -183,6 +183,7 @@ private slots:
     void IncrementGizmo();
     void DecrementGizmo();
     void EditLayers();
+    void TogglePerformanceTrace(bool Enabled);
 
 signals:
     void MapChanged(CWorld *pNewWorld, CGameArea *pNewArea);